@@ -0,0 +1,51 @@
+#include<fast_io.h>
+#include<fast_io_device.h>
+
+using namespace fast_io::io;
+
+/*
+10M println to a file through obuf_file and through a buffer_mode::direct buffer over a file opened with
+open_mode::direct, then the same file read back both ways. The direct runs bypass the page cache, so they show
+device bandwidth rather than memcpy into cached pages.
+*/
+
+inline double seconds(fast_io::unix_timestamp t)
+{
+	return static_cast<double>(t.seconds)+static_cast<double>(t.subseconds)/static_cast<double>(fast_io::uint_least64_subseconds_per_second);
+}
+
+template<typename output,std::size_t n>
+inline void run_output(char const* name,char8_t const (&filename)[n],fast_io::open_mode om)
+{
+	constexpr std::size_t N(10000000);
+	auto const t0{fast_io::posix_clock_gettime(fast_io::posix_clock_id::monotonic)};
+	{
+		output obf(filename,om);
+		for(std::size_t i{};i!=N;++i)
+			println(obf,i);
+	}
+	println(fast_io::mnp::os_c_str(name),": ",seconds(fast_io::posix_clock_gettime(fast_io::posix_clock_id::monotonic)-t0),"s");
+}
+
+template<typename input,std::size_t n>
+inline void run_input(char const* name,char8_t const (&filename)[n],fast_io::open_mode om)
+{
+	auto const t0{fast_io::posix_clock_gettime(fast_io::posix_clock_id::monotonic)};
+	std::size_t sum{};
+	{
+		input ibf(filename,om);
+		for(std::size_t v;scan<true>(ibf,v);)
+			sum+=v;
+	}
+	println(fast_io::mnp::os_c_str(name),": ",seconds(fast_io::posix_clock_gettime(fast_io::posix_clock_id::monotonic)-t0),"s (sum ",sum,")");
+}
+
+int main()
+{
+	using direct_output = fast_io::basic_io_buffer<fast_io::native_file,fast_io::buffer_mode::out|fast_io::buffer_mode::direct>;
+	using direct_input = fast_io::basic_io_buffer<fast_io::native_file,fast_io::buffer_mode::in|fast_io::buffer_mode::direct>;
+	run_output<fast_io::obuf_file>("obuf_file",u8"obuf_file.txt",fast_io::open_mode::out);
+	run_output<direct_output>("obuf_file direct",u8"obuf_file_direct.txt",fast_io::open_mode::out|fast_io::open_mode::direct);
+	run_input<fast_io::ibuf_file>("ibuf_file",u8"obuf_file.txt",fast_io::open_mode::in);
+	run_input<direct_input>("ibuf_file direct",u8"obuf_file_direct.txt",fast_io::open_mode::in|fast_io::open_mode::direct);
+}
@@ -0,0 +1,37 @@
+#include<fast_io.h>
+#include<fast_io_device.h>
+
+using namespace fast_io::io;
+
+/*
+10M println to a file through obuf_file and through the same buffer with buffer_mode::write_behind. Besides wall
+time, the producer thread's CPU time shows how much of the write syscalls left the producer's thread.
+*/
+
+inline double seconds(fast_io::unix_timestamp t)
+{
+	return static_cast<double>(t.seconds)+static_cast<double>(t.subseconds)/static_cast<double>(fast_io::uint_least64_subseconds_per_second);
+}
+
+template<typename output,std::size_t n>
+inline void run(char const* name,char8_t const (&filename)[n])
+{
+	constexpr std::size_t N(10000000);
+	auto const wall0{fast_io::posix_clock_gettime(fast_io::posix_clock_id::monotonic)};
+	auto const cpu0{fast_io::posix_clock_gettime(fast_io::posix_clock_id::thread_cputime_id)};
+	{
+		output obf(filename);
+		for(std::size_t i{};i!=N;++i)
+			println(obf,i);
+	}
+	auto const cpu{seconds(fast_io::posix_clock_gettime(fast_io::posix_clock_id::thread_cputime_id)-cpu0)};
+	auto const wall{seconds(fast_io::posix_clock_gettime(fast_io::posix_clock_id::monotonic)-wall0)};
+	println(fast_io::mnp::os_c_str(name),": wall ",wall,"s, producer cpu ",cpu,"s");
+}
+
+int main()
+{
+	run<fast_io::obuf_file>("obuf_file",u8"obuf_file.txt");
+	run<fast_io::basic_io_buffer<fast_io::onative_file,fast_io::buffer_mode::out|fast_io::buffer_mode::write_behind>>(
+		"obuf_file write_behind",u8"obuf_file_write_behind.txt");
+}
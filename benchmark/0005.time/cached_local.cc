@@ -0,0 +1,44 @@
+#include<fast_io.h>
+#include<fast_io_device.h>
+#include<fast_io_driver/timer.h>
+using namespace fast_io::io;
+
+/*
+A logger stamping every line with local time: consecutive timestamps a few microseconds apart.
+*/
+int main()
+{
+	constexpr std::size_t N(10000000);
+	auto const start{fast_io::posix_clock_gettime(fast_io::posix_clock_id::realtime)};
+	constexpr std::uint_least64_t step{fast_io::uint_least64_subseconds_per_second/1000000u*3u};
+	{
+	fast_io::timer timer(u8"local");
+	fast_io::obuf_file obf(u8"local.txt");
+	auto ts{start};
+	for(std::size_t i{};i!=N;++i)
+	{
+		println(obf,local(ts));
+		ts.subseconds+=step;
+		if(fast_io::uint_least64_subseconds_per_second<=ts.subseconds)
+		{
+			ts.subseconds-=fast_io::uint_least64_subseconds_per_second;
+			++ts.seconds;
+		}
+	}
+	}
+	{
+	fast_io::timer timer(u8"cached_local");
+	fast_io::obuf_file obf(u8"cached_local.txt");
+	auto ts{start};
+	for(std::size_t i{};i!=N;++i)
+	{
+		println(obf,cached_local(ts));
+		ts.subseconds+=step;
+		if(fast_io::uint_least64_subseconds_per_second<=ts.subseconds)
+		{
+			ts.subseconds-=fast_io::uint_least64_subseconds_per_second;
+			++ts.seconds;
+		}
+	}
+	}
+}
@@ -0,0 +1,51 @@
+#include<string>
+#include<string_view>
+#include<fast_io.h>
+#include<fast_io_device.h>
+#include<fast_io_driver/timer.h>
+using namespace fast_io::io;
+
+/*
+In-memory UTF-8 <-> UTF-16/UTF-32 transcoding over 64 MiB corpora of different scripts.
+*/
+
+template<typename dest_char_type,typename src_char_type>
+inline std::size_t convert(std::u8string_view name,std::basic_string<src_char_type> const& src,std::basic_string<dest_char_type>& dst)
+{
+	constexpr std::size_t rounds{16};
+	dst.resize(src.size()*(sizeof(src_char_type)==1?1:(sizeof(src_char_type)==2?3:4)));
+	dest_char_type* p{};
+	{
+		fast_io::timer t(name);
+		for(std::size_t i{};i!=rounds;++i)
+			p=fast_io::details::codecvt::general_code_cvt_full(src.data(),src.data()+src.size(),dst.data());
+	}
+	return static_cast<std::size_t>(p-dst.data());
+}
+
+inline void run(std::u8string_view name,std::u8string_view line)
+{
+	constexpr std::size_t total{static_cast<std::size_t>(64)<<20};
+	std::u8string u8;
+	u8.reserve(total+line.size());
+	while(u8.size()<total)
+		u8.append(line);
+	std::u16string u16;
+	std::u32string u32;
+	std::u8string back;
+	println(fast_io::u8out(),name,u8" (16 rounds over ",u8.size(),u8" bytes)");
+	u16.resize(convert(u8"utf8->utf16",u8,u16));
+	u32.resize(convert(u8"utf8->utf32",u8,u32));
+	convert(u8"utf16->utf8",u16,back);
+	convert(u8"utf32->utf8",u32,back);
+}
+
+int main()
+{
+	run(u8"ascii",u8"The quick brown fox jumps over the lazy dog 0123456789\n");
+	run(u8"latin",u8"Größe naïve café déjà vu Ærøskøbing señor façade\n");
+	run(u8"cyrillic",u8"Съешь же ещё этих мягких французских булок, да выпей чаю\n");
+	run(u8"cjk",u8"快速输入输出库的编码转换，日本語のテキスト，한국어 문장\n");
+	run(u8"emoji",u8"😀😃😄😁😆😅🤣😂🙂🙃\n");
+	run(u8"mixed",u8"Größe Привет 快速输入输出 😀🚀 mixed text\n");
+}
@@ -0,0 +1,49 @@
+#include<fast_io.h>
+#include<fast_io_crypto.h>
+#include<fast_io_driver/timer.h>
+#include<random>
+#include<vector>
+
+/*
+100000 chunks of 1-16 KiB, the content-addressed storage case: one context per chunk versus fast_io::hash_batch.
+*/
+
+template<typename context>
+inline void run(std::u8string_view name,std::vector<std::byte> const& data)
+{
+	std::mt19937_64 eng;
+	constexpr std::size_t chunks{100000};
+	std::vector<fast_io::hash_batch_entry> entries(chunks);
+	std::vector<std::byte> digests(chunks*context::digest_size);
+	for(std::size_t i{},off{};i!=chunks;++i)
+	{
+		std::size_t const len{1024u+static_cast<std::size_t>(eng()%(15u*1024u))};
+		if(data.size()<off+len)
+			off=0;
+		entries[i]={data.data()+off,data.data()+off+len,digests.data()+i*context::digest_size};
+		off+=len;
+	}
+	{
+		fast_io::timer t(name);
+		for(auto const& e : entries)
+		{
+			context ctx;
+			ctx.update(e.first,e.last);
+			ctx.do_final();
+			ctx.digest_to_byte_ptr(e.digest);
+		}
+	}
+	{
+		fast_io::timer t(u8"hash_batch");
+		fast_io::hash_batch<context>(entries.data(),entries.data()+entries.size());
+	}
+}
+
+int main()
+{
+	std::vector<std::byte> data(static_cast<std::size_t>(256)<<20);
+	for(std::size_t i{};i!=data.size();++i)
+		data[i]=static_cast<std::byte>(i*7u);
+	run<fast_io::sha256_context>(u8"sha256_context",data);
+	run<fast_io::sha512_context>(u8"sha512_context",data);
+}
@@ -0,0 +1,38 @@
+#include<fast_io.h>
+#include<fast_io_crypto.h>
+#include<fast_io_driver/timer.h>
+#include<vector>
+
+/*
+1 GiB in memory: one sequential context versus fast_io::tree_hash on one thread and on every online CPU.
+The tree digest differs from the plain one by construction; only the times are comparable.
+*/
+
+template<typename context>
+inline void run(std::u8string_view name,std::vector<std::byte> const& data)
+{
+	{
+		fast_io::timer t(name);
+		context ctx;
+		ctx.update(data.data(),data.data()+data.size());
+		ctx.do_final();
+	}
+	std::byte digest[context::digest_size];
+	{
+		fast_io::timer t(u8"tree_hash threads=1");
+		fast_io::tree_hash<context>(data.data(),data.data()+data.size(),digest,1);
+	}
+	{
+		fast_io::timer t(u8"tree_hash threads=all");
+		fast_io::tree_hash<context>(data.data(),data.data()+data.size(),digest);
+	}
+}
+
+int main()
+{
+	std::vector<std::byte> data(static_cast<std::size_t>(1)<<30);
+	for(std::size_t i{};i!=data.size();++i)
+		data[i]=static_cast<std::byte>(i*2654435761u>>24);
+	run<fast_io::sha256_context>(u8"sha256",data);
+	run<fast_io::sha512_context>(u8"sha512",data);
+}
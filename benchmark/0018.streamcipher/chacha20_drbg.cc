@@ -0,0 +1,44 @@
+#include<fast_io.h>
+#include<fast_io_crypto.h>
+#include<fast_io_driver/timer.h>
+#include<vector>
+
+/*
+10 million size_t draws from the white hole engines against the ChaCha20 DRBG seeded from the same white hole,
+then a 256 MiB bulk fill.
+*/
+
+template<typename engine_type>
+inline std::size_t draw(engine_type& eng,std::size_t n)
+{
+	std::size_t sum{};
+	for(std::size_t i{};i!=n;++i)
+		sum+=eng();
+	return sum;
+}
+
+int main()
+{
+	constexpr std::size_t n{10000000};
+	std::size_t sum{};
+	{
+		fast_io::timer t(u8"native_white_hole_engine");
+		fast_io::native_white_hole_engine eng;
+		sum+=draw(eng,n);
+	}
+	{
+		fast_io::timer t(u8"ibuf_white_hole_engine");
+		fast_io::ibuf_white_hole_engine eng;
+		sum+=draw(eng,n);
+	}
+	{
+		fast_io::timer t(u8"chacha20_drbg_thread_local_engine");
+		sum+=draw(fast_io::chacha20_drbg_thread_local_engine<fast_io::native_white_hole>(),n);
+	}
+	std::vector<std::byte> buffer(static_cast<std::size_t>(256)<<20);
+	{
+		fast_io::timer t(u8"chacha20_drbg fill 256MiB");
+		fast_io::chacha20_drbg_thread_local_engine<fast_io::native_white_hole>().fill(buffer.data(),buffer.data()+buffer.size());
+	}
+	fast_io::io::println(sum,static_cast<unsigned>(buffer[12345]));
+}
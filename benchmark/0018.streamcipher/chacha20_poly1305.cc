@@ -0,0 +1,45 @@
+#include<fast_io.h>
+#include<fast_io_crypto.h>
+#include<fast_io_driver/timer.h>
+#include<vector>
+
+/*
+256 MiB through one block per chacha_runtime_routine call versus the multi-block chacha20_xor, then the whole AEAD.
+*/
+
+int main()
+{
+	std::vector<std::byte> data(static_cast<std::size_t>(256)<<20);
+	for(std::size_t i{};i!=data.size();++i)
+		data[i]=static_cast<std::byte>(i*7u);
+	std::vector<std::byte> out(data.size());
+	std::byte key[32]{};
+	std::byte nonce[12]{};
+	std::uint_least32_t state[16];
+	{
+		fast_io::details::chacha::chacha20_init_state(state,key,0,nonce);
+		fast_io::timer t(u8"chacha_runtime_routine");
+		std::byte keystream[64];
+		for(std::size_t i{};i!=data.size();i+=64)
+		{
+			fast_io::details::chacha::chacha_runtime_routine(keystream,state);
+			++state[12];
+			for(std::size_t j{};j!=64;++j)
+				out[i+j]=data[i+j]^keystream[j];
+		}
+	}
+	{
+		fast_io::details::chacha::chacha20_init_state(state,key,0,nonce);
+		fast_io::timer t(u8"chacha20_xor");
+		fast_io::details::chacha::chacha20_xor(state,data.data(),out.data(),data.size());
+	}
+	std::byte tag[16];
+	{
+		fast_io::timer t(u8"poly1305_mac");
+		fast_io::details::poly1305::poly1305_mac(key,data.data(),data.data()+data.size(),tag);
+	}
+	{
+		fast_io::timer t(u8"chacha20_poly1305_encrypt");
+		fast_io::chacha20_poly1305_encrypt(key,nonce,nullptr,nullptr,data.data(),data.data()+data.size(),out.data(),tag);
+	}
+}
@@ -0,0 +1,46 @@
+#include<fast_io.h>
+#include<fast_io_crypto.h>
+#include<fast_io_driver/timer.h>
+#include<vector>
+
+/*
+256 MiB through AES-256: one block at a time through fast_io::aes, the pipelined CTR kernels, then GCM and
+ChaCha20-Poly1305 for comparison.
+*/
+
+int main()
+{
+	std::vector<std::byte> data(static_cast<std::size_t>(256)<<20);
+	for(std::size_t i{};i!=data.size();++i)
+		data[i]=static_cast<std::byte>(i*7u);
+	std::vector<std::byte> out(data.size());
+	std::byte key[32]{};
+	std::byte nonce[12]{};
+	fast_io::aes_gcm<32> gcm(key);
+	{
+		fast_io::timer t(u8"aes single block ctr");
+		std::byte counter[16]{};
+		for(std::size_t i{};i!=data.size();i+=16)
+		{
+			std::byte ks[16];
+			gcm.cipher(counter,1,ks);
+			fast_io::details::aes::aes_ctr_increment<false>(counter);
+			for(std::size_t j{};j!=16;++j)
+				out[i+j]=data[i+j]^ks[j];
+		}
+	}
+	{
+		fast_io::timer t(u8"aes_ctr_xor");
+		std::byte counter[16]{};
+		fast_io::details::aes::aes_ctr_xor<fast_io::aes<32>::rounds,false>(gcm.cipher.key_schedule,counter,data.data(),out.data(),data.size());
+	}
+	std::byte tag[16];
+	{
+		fast_io::timer t(u8"aes_gcm<32>::encrypt");
+		gcm.encrypt(nonce,nullptr,nullptr,data.data(),data.data()+data.size(),out.data(),tag);
+	}
+	{
+		fast_io::timer t(u8"chacha20_poly1305_encrypt");
+		fast_io::chacha20_poly1305_encrypt(key,nonce,nullptr,nullptr,data.data(),data.data()+data.size(),out.data(),tag);
+	}
+}
@@ -0,0 +1,54 @@
+#include<fast_io.h>
+#include<fast_io_device.h>
+#include<fast_io_driver/zlib_driver.h>
+#include<fast_io_driver/timer.h>
+
+/*
+10 million log lines compressed with gzFile and with deflate_deco_t on one and on all cores, then read back through
+inflate_deco_t.
+*/
+
+inline constexpr std::size_t lines{10000000};
+
+template<typename output>
+inline void write_log(output& out)
+{
+	for(std::size_t i{};i!=lines;++i)
+		fast_io::io::println(out,"[info] request ",i%1000," served in ",i*7%100,"ms");
+}
+
+template<std::size_t bfs>
+inline void deco_log(std::u8string_view name,char const* filename,std::size_t threads)
+{
+	fast_io::timer t(name);
+	using decorators = fast_io::basic_decorators<char,fast_io::empty_decorator,fast_io::zlib::deflate_deco_t>;
+	fast_io::native_file file(fast_io::mnp::os_c_str(filename),fast_io::open_mode::out);
+	fast_io::basic_io_buffer<fast_io::native_io_observer,fast_io::buffer_mode::out|fast_io::buffer_mode::construct_decorator,decorators,bfs>
+		obf(decorators{{},fast_io::zlib::deflate_deco_t(fast_io::zlib::zstream_format::gzip,Z_DEFAULT_COMPRESSION,threads)},file);
+	write_log(obf);
+}
+
+int main()
+{
+	{
+		fast_io::timer t(u8"gzFile");
+		fast_io::basic_io_buffer<fast_io::zlib::gz_io_observer,fast_io::buffer_mode::out> obf(fast_io::zlib::gz_io_observer{gzopen("gzfile.log.gz","wb")});
+		write_log(obf);
+		flush(obf);
+		gzclose(obf.handle.gzfile);
+	}
+	deco_log<131072>(u8"deflate_deco_t 1 thread","deco1.log.gz",1);
+	deco_log<4194304>(u8"deflate_deco_t all cores","decon.log.gz",0);
+	{
+		fast_io::timer t(u8"inflate_deco_t");
+		using decorators = fast_io::basic_decorators<char,fast_io::zlib::inflate_deco_t>;
+		fast_io::native_file file("decon.log.gz",fast_io::open_mode::in);
+		fast_io::basic_io_buffer<fast_io::native_io_observer,fast_io::buffer_mode::in|fast_io::buffer_mode::construct_decorator,decorators>
+			ibf(decorators{fast_io::zlib::inflate_deco_t(),{}},file);
+		std::size_t total{};
+		char buffer[65536];
+		for(char* p;(p=read(ibf,buffer,buffer+sizeof(buffer)))!=buffer;)
+			total+=static_cast<std::size_t>(p-buffer);
+		fast_io::io::println("decompressed ",total," bytes");
+	}
+}
@@ -0,0 +1,85 @@
+#include<string>
+#include<thread>
+#include<fast_io.h>
+#include<fast_io_device.h>
+
+using namespace fast_io::io;
+
+/*
+Loopback keep-alive benchmark: a client thread sends pipelined GET requests over one TCP connection and the server
+parses them, either with scan() into an http_header_buffer (one copy per request) or with http_request_scanner
+(headers parsed in place in the socket's input buffer). Requests per second are reported against wall time and
+against the server thread's CPU time, the per-core figure.
+*/
+
+inline constexpr std::uint_least16_t port{18623};
+inline constexpr std::size_t batch{64};
+inline constexpr std::size_t rounds{30000};
+
+inline std::string make_batch()
+{
+	std::string s;
+	for(std::size_t i{};i!=batch;++i)
+		s.append("GET /api/v1/items/"+std::to_string(i)+"?fields=name,price HTTP/1.1\r\n"
+			"Host: localhost:18623\r\n"
+			"User-Agent: fast_io-bench/1.0\r\n"
+			"Accept: application/json\r\n"
+			"Accept-Encoding: gzip, deflate\r\n"
+			"Cookie: session=0123456789abcdef0123456789abcdef\r\n"
+			"Connection: keep-alive\r\n\r\n");
+	return s;
+}
+
+inline void client(std::string const& s)
+{
+	fast_io::native_socket_file socket(tcp_connect(fast_io::ipv4{{127,0,0,1},port}));
+	for(std::size_t i{};i!=rounds;++i)
+		write(socket,s.data(),s.data()+s.size());
+}
+
+inline double seconds(fast_io::unix_timestamp t)
+{
+	return static_cast<double>(t.seconds)+static_cast<double>(t.subseconds)/static_cast<double>(fast_io::uint_least64_subseconds_per_second);
+}
+
+template<typename F>
+inline void run(std::string_view name,fast_io::native_socket_file& listener,std::string const& s,F parse_all)
+{
+	std::thread th(client,std::cref(s));
+	fast_io::iobuf_socket_file conn(tcp_accept(listener));
+	auto const wall0{fast_io::posix_clock_gettime(fast_io::posix_clock_id::monotonic)};
+	auto const cpu0{fast_io::posix_clock_gettime(fast_io::posix_clock_id::thread_cputime_id)};
+	std::size_t const n{parse_all(conn)};
+	auto const cpu{seconds(fast_io::posix_clock_gettime(fast_io::posix_clock_id::thread_cputime_id)-cpu0)};
+	auto const wall{seconds(fast_io::posix_clock_gettime(fast_io::posix_clock_id::monotonic)-wall0)};
+	th.join();
+	println(fast_io::mnp::os_c_str(name.data(),name.size()),": ",n," requests, ",
+		static_cast<std::uint_least64_t>(static_cast<double>(n)/wall)," req/s, ",
+		static_cast<std::uint_least64_t>(static_cast<double>(n)/cpu)," req/s per server core");
+}
+
+int main()
+{
+	fast_io::net_service service;
+	fast_io::native_socket_file listener(fast_io::tcp_listen(port));
+	auto const s{make_batch()};
+	run("scan http_header_buffer",listener,s,[](fast_io::iobuf_socket_file& conn)
+	{
+		/*
+		scan() cannot tell a clean end of the connection from a truncated header, so read exactly what was sent.
+		*/
+		std::size_t n{};
+		for(;n!=batch*rounds;++n)
+		{
+			fast_io::http_header_buffer hb;
+			scan(conn,hb);
+		}
+		return n;
+	});
+	run("http_request_scanner",listener,s,[](fast_io::iobuf_socket_file& conn)
+	{
+		std::size_t n{};
+		for(fast_io::http_request_scanner scanner;scanner.next(conn);++n);
+		return n;
+	});
+}
@@ -0,0 +1,48 @@
+#include<thread>
+#include<vector>
+#include<fast_io.h>
+#include<fast_io_device.h>
+#include<fast_io_driver/timer.h>
+
+using namespace fast_io::io;
+
+/*
+64 threads print log-style lines to one file, through obuf_file_mutex (a pthread mutex around the shared buffer)
+and through basic_mpsc_log_sink over the raw file and over an obuf_file.
+*/
+
+inline constexpr std::size_t threads{64};
+inline constexpr std::size_t lines{200000};
+
+template<typename output>
+inline void run(output& out)
+{
+	std::vector<std::thread> workers;
+	for(std::size_t t{};t!=threads;++t)
+		workers.emplace_back([&out,t]
+		{
+			for(std::size_t i{};i!=lines;++i)
+				println(out,"thread ",t," request ",i," status ",200," bytes ",i*7);
+		});
+	for(auto& w : workers)
+		w.join();
+}
+
+int main()
+{
+	{
+		fast_io::timer timer(u8"obuf_file_mutex");
+		fast_io::obuf_file_mutex obf(u8"obuf_file_mutex.txt");
+		run(obf);
+	}
+	{
+		fast_io::timer timer(u8"mpsc_log_sink<native_file>");
+		fast_io::basic_mpsc_log_sink<fast_io::native_file> sink(u8"mpsc_log_sink_native_file.txt",fast_io::open_mode::out);
+		run(sink);
+	}
+	{
+		fast_io::timer timer(u8"mpsc_log_sink<obuf_file>");
+		fast_io::basic_mpsc_log_sink<fast_io::obuf_file> sink(u8"mpsc_log_sink_obuf_file.txt");
+		run(sink);
+	}
+}
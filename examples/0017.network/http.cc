@@ -1,6 +1,5 @@
 ﻿#include<fast_io.h>
 #include<fast_io_device.h>
-#include<string_view>
 
 using namespace fast_io::io;
 
@@ -25,15 +24,9 @@ int main(int argc, char const** argv)
 	"Connection:close\r\n\r\n");
 	fast_io::u8http_header_buffer buffer;
 	scan(socket,buffer);
-	using namespace std::string_view_literals;
-	for(auto [key,value]:line_generator(buffer))
+	if(buffer.has_content_length)
 	{
-		if(std::u8string_view(key)==u8"Content-Length"sv)
-		{
-			auto content_length{::fast_io::u8to<std::uint_least64_t>(value)};
-			fast_io::u8native_file nf(u8"index.html",fast_io::open_mode::out);
-			transmit64(nf,socket,content_length);
-			return 0;
-		}
+		fast_io::u8native_file nf(u8"index.html",fast_io::open_mode::out);
+		transmit64(nf,socket,buffer.content_length);
 	}
 }
@@ -91,6 +91,7 @@
 #include"fast_io_core_impl/black_hole.h"
 #include"fast_io_core_impl/buffer_view.h"
 #include"fast_io_core_impl/transmit/impl.h"
+#include"fast_io_core_impl/random_access_transmit.h"
 
 #ifdef __cpp_lib_source_location
 #include<source_location>
@@ -116,6 +117,7 @@
 #include"fast_io_core_impl/to.h"
 #include"fast_io_core_impl/concat/impl.h"
 #include"fast_io_core_impl/http_header.h"
+#include"fast_io_core_impl/http_request_scanner.h"
 
 #if defined(_MSC_VER) && !defined(__clang__)
 #pragma warning(pop)
@@ -0,0 +1,412 @@
+#pragma once
+
+#if defined(__linux__) && !defined(__KERNEL__) && __has_include(<sys/mman.h>) &&                                \
+	((__STDC_HOSTED__ == 1 && (!defined(_GLIBCXX_HOSTED) || _GLIBCXX_HOSTED == 1) && !defined(_LIBCPP_FREESTANDING)) || \
+	 defined(FAST_IO_ENABLE_HOSTED_FEATURES))
+#include <sys/mman.h>
+#endif
+
+namespace fast_io
+{
+
+namespace details
+{
+
+struct arena_chunk_header
+{
+	arena_chunk_header *prev;
+	::std::size_t size;
+};
+
+inline constexpr ::std::size_t arena_round_up_impl(::std::size_t n, ::std::size_t alignment) noexcept
+{
+	::std::size_t const mask{alignment - 1u};
+	if (::std::numeric_limits<::std::size_t>::max() - mask < n)
+	{
+		::fast_io::fast_terminate();
+	}
+	return (n + mask) & (0u - alignment);
+}
+
+} // namespace details
+
+/*
+Bump-pointer arena. Memory comes from upstream in chained chunks; allocation only moves a pointer, deallocation is a
+no-op unless it hands back the most recent allocation, and reset() drops everything at once while keeping the newest
+chunk around for the next round. With huge_page every chunk is a multiple of 2 MiB, 2 MiB aligned and, on Linux,
+advised MADV_HUGEPAGE.
+*/
+template <typename upstream>
+class basic_arena_resource
+{
+public:
+	using upstream_allocator_type = upstream;
+	using upstream_adapter_type = ::fast_io::generic_allocator_adapter<upstream_allocator_type>;
+	static inline constexpr ::std::size_t default_alignment{__STDCPP_DEFAULT_NEW_ALIGNMENT__};
+	static inline constexpr ::std::size_t default_chunk_size{static_cast<::std::size_t>(65536u)};
+	static inline constexpr ::std::size_t max_chunk_size{static_cast<::std::size_t>(16777216u)};
+	static inline constexpr ::std::size_t huge_page_size{static_cast<::std::size_t>(2097152u)};
+	::fast_io::details::arena_chunk_header *chunk{};
+	::std::byte *curr_ptr{};
+	::std::byte *end_ptr{};
+	::std::byte *last_ptr{};
+	::std::size_t next_chunk_size{default_chunk_size};
+	bool huge_page{};
+
+	explicit constexpr basic_arena_resource() noexcept = default;
+	explicit constexpr basic_arena_resource(::std::size_t initial_chunk_size, bool hp = false) noexcept
+		: next_chunk_size(initial_chunk_size), huge_page(hp)
+	{}
+	basic_arena_resource(basic_arena_resource const &) = delete;
+	basic_arena_resource &operator=(basic_arena_resource const &) = delete;
+	constexpr basic_arena_resource(basic_arena_resource &&other) noexcept
+		: chunk(other.chunk), curr_ptr(other.curr_ptr), end_ptr(other.end_ptr), last_ptr(other.last_ptr),
+		  next_chunk_size(other.next_chunk_size), huge_page(other.huge_page)
+	{
+		other.chunk = nullptr;
+		other.last_ptr = other.end_ptr = other.curr_ptr = nullptr;
+	}
+	basic_arena_resource &operator=(basic_arena_resource &&other) noexcept
+	{
+		if (__builtin_addressof(other) == this)
+		{
+			return *this;
+		}
+		this->release();
+		this->chunk = other.chunk;
+		this->curr_ptr = other.curr_ptr;
+		this->end_ptr = other.end_ptr;
+		this->last_ptr = other.last_ptr;
+		this->next_chunk_size = other.next_chunk_size;
+		this->huge_page = other.huge_page;
+		other.chunk = nullptr;
+		other.last_ptr = other.end_ptr = other.curr_ptr = nullptr;
+		return *this;
+	}
+	~basic_arena_resource()
+	{
+		this->release();
+	}
+
+	inline void *allocate_aligned(::std::size_t alignment, ::std::size_t n) noexcept
+	{
+		if (this->curr_ptr != nullptr) [[likely]]
+		{
+			::std::size_t const pad{(0u - reinterpret_cast<::std::size_t>(this->curr_ptr)) & (alignment - 1u)};
+			::std::size_t const remain{static_cast<::std::size_t>(this->end_ptr - this->curr_ptr)};
+			if (pad <= remain && n <= remain - pad) [[likely]]
+			{
+				auto p{this->curr_ptr + pad};
+				this->last_ptr = p;
+				this->curr_ptr = p + n;
+				return p;
+			}
+		}
+		return this->allocate_new_chunk(alignment, n);
+	}
+	inline void *allocate(::std::size_t n) noexcept
+	{
+		return this->allocate_aligned(default_alignment, n);
+	}
+	/*
+	Only the most recent allocation can be given back; anything else stays until reset() or release().
+	*/
+	inline void deallocate_n(void *p, ::std::size_t n) noexcept
+	{
+		auto bp{reinterpret_cast<::std::byte *>(p)};
+		if (bp != nullptr && bp == this->last_ptr && static_cast<::std::size_t>(this->curr_ptr - bp) == n)
+		{
+			this->curr_ptr = bp;
+			this->last_ptr = nullptr;
+		}
+	}
+	/*
+	The most recent allocation grows or shrinks in place while the chunk has room; otherwise this is allocate + copy.
+	*/
+	inline void *reallocate_aligned_n(void *p, ::std::size_t oldn, ::std::size_t alignment, ::std::size_t n) noexcept
+	{
+		auto bp{reinterpret_cast<::std::byte *>(p)};
+		if (bp != nullptr && bp == this->last_ptr && static_cast<::std::size_t>(this->curr_ptr - bp) == oldn &&
+			(reinterpret_cast<::std::size_t>(bp) & (alignment - 1u)) == 0u &&
+			n <= static_cast<::std::size_t>(this->end_ptr - bp))
+		{
+			this->curr_ptr = bp + n;
+			return p;
+		}
+		auto newp{this->allocate_aligned(alignment, n)};
+		if (bp != nullptr)
+		{
+			if (n < oldn)
+			{
+				oldn = n;
+			}
+			::fast_io::freestanding::nonoverlapped_bytes_copy_n(bp, oldn, reinterpret_cast<::std::byte *>(newp));
+		}
+		return newp;
+	}
+	inline void *reallocate_n(void *p, ::std::size_t oldn, ::std::size_t n) noexcept
+	{
+		return this->reallocate_aligned_n(p, oldn, default_alignment, n);
+	}
+	/*
+	Frees every chunk except the newest and rewinds it, so a steady-state workload stops touching upstream.
+	*/
+	inline void reset() noexcept
+	{
+		auto c{this->chunk};
+		if (c == nullptr)
+		{
+			return;
+		}
+		free_chunks(c->prev);
+		c->prev = nullptr;
+		this->curr_ptr = reinterpret_cast<::std::byte *>(c + 1);
+		this->last_ptr = nullptr;
+	}
+	inline void release() noexcept
+	{
+		free_chunks(this->chunk);
+		this->chunk = nullptr;
+		this->last_ptr = this->end_ptr = this->curr_ptr = nullptr;
+	}
+
+private:
+	inline constexpr ::std::size_t chunk_alignment() const noexcept
+	{
+		if (this->huge_page)
+		{
+			return huge_page_size;
+		}
+		return upstream_adapter_type::default_alignment;
+	}
+	inline void free_chunks(::fast_io::details::arena_chunk_header *c) noexcept
+	{
+		::std::size_t const calign{this->chunk_alignment()};
+		for (; c != nullptr;)
+		{
+			auto prev{c->prev};
+			upstream_adapter_type::deallocate_aligned_n(c, calign, c->size);
+			c = prev;
+		}
+	}
+#if __has_cpp_attribute(__gnu__::__cold__)
+	[[__gnu__::__cold__]]
+#endif
+	inline void *allocate_new_chunk(::std::size_t alignment, ::std::size_t n) noexcept
+	{
+		constexpr ::std::size_t header_size{sizeof(::fast_io::details::arena_chunk_header)};
+		constexpr ::std::size_t mxn{::std::numeric_limits<::std::size_t>::max()};
+		if (mxn - header_size - alignment < n)
+		{
+			::fast_io::fast_terminate();
+		}
+		::std::size_t const needed{n + header_size + alignment};
+		::std::size_t size{this->next_chunk_size};
+		if (size < needed)
+		{
+			size = needed;
+		}
+		::std::size_t const calign{this->chunk_alignment()};
+		if (this->huge_page)
+		{
+			size = ::fast_io::details::arena_round_up_impl(size, huge_page_size);
+		}
+		auto c{reinterpret_cast<::fast_io::details::arena_chunk_header *>(upstream_adapter_type::allocate_aligned(calign, size))};
+#if defined(__linux__) && defined(MADV_HUGEPAGE)
+		if (this->huge_page)
+		{
+			::madvise(c, size, MADV_HUGEPAGE);
+		}
+#endif
+		c->prev = this->chunk;
+		c->size = size;
+		this->chunk = c;
+		this->curr_ptr = reinterpret_cast<::std::byte *>(c + 1);
+		this->end_ptr = reinterpret_cast<::std::byte *>(c) + size;
+		if (this->next_chunk_size < max_chunk_size)
+		{
+			this->next_chunk_size <<= 1u;
+		}
+		return this->allocate_aligned(alignment, n);
+	}
+};
+
+/*
+Status allocator: the handle is the arena itself.
+*/
+template <typename upstream>
+class basic_arena_allocator
+{
+public:
+	using resource_type = ::fast_io::basic_arena_resource<upstream>;
+	using handle_type = resource_type *;
+	static inline constexpr ::std::size_t default_alignment{resource_type::default_alignment};
+	static inline void *handle_allocate(handle_type handle, ::std::size_t n) noexcept
+	{
+		return handle->allocate(n);
+	}
+	static inline void *handle_allocate_aligned(handle_type handle, ::std::size_t alignment, ::std::size_t n) noexcept
+	{
+		return handle->allocate_aligned(alignment, n);
+	}
+	static inline void *handle_reallocate_n(handle_type handle, void *p, ::std::size_t oldn, ::std::size_t n) noexcept
+	{
+		return handle->reallocate_n(p, oldn, n);
+	}
+	static inline void *handle_reallocate_aligned_n(handle_type handle, void *p, ::std::size_t oldn, ::std::size_t alignment, ::std::size_t n) noexcept
+	{
+		return handle->reallocate_aligned_n(p, oldn, alignment, n);
+	}
+	static inline void handle_deallocate_n(handle_type handle, void *p, ::std::size_t n) noexcept
+	{
+		handle->deallocate_n(p, n);
+	}
+	static inline void handle_deallocate_aligned_n(handle_type handle, void *p, ::std::size_t, ::std::size_t n) noexcept
+	{
+		handle->deallocate_n(p, n);
+	}
+};
+
+#if ((__STDC_HOSTED__ == 1 && (!defined(_GLIBCXX_HOSTED) || _GLIBCXX_HOSTED == 1) && \
+	  !defined(_LIBCPP_FREESTANDING)) ||                                             \
+	 defined(FAST_IO_ENABLE_HOSTED_FEATURES))
+
+/*
+Stateless face of the arena so it plugs into generic_allocator_adapter and therefore into containers::vector,
+containers::deque and the iobuf helpers: it allocates from whichever arena the innermost
+basic_arena_allocator_scope on this thread installed, and from upstream when no scope is active.
+Every block carries a header naming the arena it came from (nullptr for upstream), so reallocation and deallocation
+go back to the block's origin no matter which scope is active at the time. Memory handed out inside a scope must not
+outlive that scope's arena.
+*/
+template <typename upstream>
+class basic_thread_local_arena_allocator
+{
+public:
+	using resource_type = ::fast_io::basic_arena_resource<upstream>;
+	using upstream_adapter_type = ::fast_io::generic_allocator_adapter<upstream>;
+	static inline constexpr ::std::size_t default_alignment{resource_type::default_alignment};
+	static inline thread_local resource_type *current_arena{};
+
+private:
+	static inline constexpr ::std::size_t header_size(::std::size_t alignment) noexcept
+	{
+		if (alignment < default_alignment)
+		{
+			return default_alignment;
+		}
+		return alignment;
+	}
+	static inline constexpr ::std::size_t with_header(::std::size_t alignment, ::std::size_t n) noexcept
+	{
+		::std::size_t const h{header_size(alignment)};
+		if (::std::numeric_limits<::std::size_t>::max() - h < n)
+		{
+			::fast_io::fast_terminate();
+		}
+		return n + h;
+	}
+	static inline void *attach_header(void *base, ::std::size_t alignment, resource_type *origin) noexcept
+	{
+		auto p{reinterpret_cast<::std::byte *>(base) + header_size(alignment)};
+		reinterpret_cast<resource_type **>(p)[-1] = origin;
+		return p;
+	}
+	static inline resource_type *origin_of(void *p) noexcept
+	{
+		return reinterpret_cast<resource_type **>(p)[-1];
+	}
+	static inline void *base_of(void *p, ::std::size_t alignment) noexcept
+	{
+		return reinterpret_cast<::std::byte *>(p) - header_size(alignment);
+	}
+
+public:
+	static inline void *allocate_aligned(::std::size_t alignment, ::std::size_t n) noexcept
+	{
+		auto a{current_arena};
+		::std::size_t const total{with_header(alignment, n)};
+		void *base;
+		if (a == nullptr)
+		{
+			base = upstream_adapter_type::allocate_aligned(alignment, total);
+		}
+		else
+		{
+			base = a->allocate_aligned(alignment, total);
+		}
+		return attach_header(base, alignment, a);
+	}
+	static inline void *allocate(::std::size_t n) noexcept
+	{
+		return allocate_aligned(default_alignment, n);
+	}
+	static inline ::fast_io::allocation_least_result allocate_aligned_at_least(::std::size_t alignment, ::std::size_t n) noexcept
+	{
+		return {allocate_aligned(alignment, n), n};
+	}
+	static inline void *reallocate_aligned_n(void *p, ::std::size_t oldn, ::std::size_t alignment, ::std::size_t n) noexcept
+	{
+		if (p == nullptr)
+		{
+			return allocate_aligned(alignment, n);
+		}
+		auto a{origin_of(p)};
+		::std::size_t const h{header_size(alignment)};
+		void *base;
+		if (a == nullptr)
+		{
+			base = upstream_adapter_type::reallocate_aligned_n(base_of(p, alignment), oldn + h, alignment, with_header(alignment, n));
+		}
+		else
+		{
+			base = a->reallocate_aligned_n(base_of(p, alignment), oldn + h, alignment, with_header(alignment, n));
+		}
+		return attach_header(base, alignment, a);
+	}
+	static inline void *reallocate_n(void *p, ::std::size_t oldn, ::std::size_t n) noexcept
+	{
+		return reallocate_aligned_n(p, oldn, default_alignment, n);
+	}
+	static inline void deallocate_aligned_n(void *p, ::std::size_t alignment, ::std::size_t n) noexcept
+	{
+		if (p == nullptr)
+		{
+			return;
+		}
+		auto a{origin_of(p)};
+		if (a == nullptr)
+		{
+			upstream_adapter_type::deallocate_aligned_n(base_of(p, alignment), alignment, n + header_size(alignment));
+			return;
+		}
+		a->deallocate_n(base_of(p, alignment), n + header_size(alignment));
+	}
+	static inline void deallocate_n(void *p, ::std::size_t n) noexcept
+	{
+		deallocate_aligned_n(p, default_alignment, n);
+	}
+};
+
+template <typename upstream>
+class basic_arena_allocator_scope
+{
+public:
+	using resource_type = ::fast_io::basic_arena_resource<upstream>;
+	resource_type *previous;
+	explicit basic_arena_allocator_scope(resource_type &arena) noexcept
+		: previous(::fast_io::basic_thread_local_arena_allocator<upstream>::current_arena)
+	{
+		::fast_io::basic_thread_local_arena_allocator<upstream>::current_arena = __builtin_addressof(arena);
+	}
+	basic_arena_allocator_scope(basic_arena_allocator_scope const &) = delete;
+	basic_arena_allocator_scope &operator=(basic_arena_allocator_scope const &) = delete;
+	~basic_arena_allocator_scope()
+	{
+		::fast_io::basic_thread_local_arena_allocator<upstream>::current_arena = this->previous;
+	}
+};
+
+#endif
+
+} // namespace fast_io
@@ -27,6 +27,11 @@
 
 #include "custom.h"
 #include "adapters.h"
+#if ((__STDC_HOSTED__ == 1 && (!defined(_GLIBCXX_HOSTED) || _GLIBCXX_HOSTED == 1) && \
+	  !defined(_LIBCPP_FREESTANDING)) ||                                             \
+	 defined(FAST_IO_ENABLE_HOSTED_FEATURES))
+#include "thread_local_cache.h"
+#endif
 
 namespace fast_io
 {
@@ -65,6 +70,11 @@ using native_typed_global_allocator = typed_generic_allocator_adapter<native_glo
 using native_thread_local_allocator = generic_allocator_adapter<
 #if defined(FAST_IO_USE_CUSTOM_THREAD_LOCAL_ALLOCATOR)
 	custom_thread_local_allocator
+#elif (                                                                                                                \
+	(__STDC_HOSTED__ == 1 && (!defined(_GLIBCXX_HOSTED) || _GLIBCXX_HOSTED == 1) && !defined(_LIBCPP_FREESTANDING)) || \
+	defined(FAST_IO_ENABLE_HOSTED_FEATURES)) &&                                                                        \
+	defined(FAST_IO_USE_THREAD_LOCAL_CACHE_ALLOCATOR)
+	thread_local_cache_allocator<native_global_allocator>
 #else
 	native_global_allocator
 #endif
@@ -74,3 +84,80 @@ template <typename T>
 using native_typed_thread_local_allocator = typed_generic_allocator_adapter<native_thread_local_allocator, T>;
 
 } // namespace fast_io
+
+#include "arena.h"
+
+namespace fast_io
+{
+
+using arena_resource = basic_arena_resource<native_global_allocator>;
+using arena_allocator = generic_allocator_adapter<basic_arena_allocator<native_global_allocator>>;
+
+#if ((__STDC_HOSTED__ == 1 && (!defined(_GLIBCXX_HOSTED) || _GLIBCXX_HOSTED == 1) && \
+	  !defined(_LIBCPP_FREESTANDING)) ||                                             \
+	 defined(FAST_IO_ENABLE_HOSTED_FEATURES))
+using thread_local_arena_allocator = generic_allocator_adapter<basic_thread_local_arena_allocator<native_global_allocator>>;
+
+template <typename T>
+using typed_thread_local_arena_allocator = typed_generic_allocator_adapter<thread_local_arena_allocator, T>;
+
+using arena_allocator_scope = basic_arena_allocator_scope<native_global_allocator>;
+#endif
+
+} // namespace fast_io
+
+#if ((__STDC_HOSTED__ == 1 && (!defined(_GLIBCXX_HOSTED) || _GLIBCXX_HOSTED == 1) && \
+	  !defined(_LIBCPP_FREESTANDING)) ||                                             \
+	 defined(FAST_IO_ENABLE_HOSTED_FEATURES))
+#include "iobuf_pool.h"
+#endif
+#include "iobuf_aligned.h"
+
+namespace fast_io
+{
+
+#if ((__STDC_HOSTED__ == 1 && (!defined(_GLIBCXX_HOSTED) || _GLIBCXX_HOSTED == 1) && \
+	  !defined(_LIBCPP_FREESTANDING)) ||                                             \
+	 defined(FAST_IO_ENABLE_HOSTED_FEATURES))
+template <::std::size_t block_bytes>
+using iobuf_pool_allocator = generic_allocator_adapter<basic_iobuf_pool_allocator<block_bytes>>;
+#endif
+
+template <::std::size_t alignment>
+using iobuf_aligned_allocator = generic_allocator_adapter<basic_iobuf_aligned_allocator<alignment>>;
+
+namespace details
+{
+
+template <bool pooled, bool direct, ::std::size_t block_bytes>
+struct iobuf_allocator
+{
+	using type = ::fast_io::native_thread_local_allocator;
+};
+
+template <::std::size_t block_bytes>
+struct iobuf_allocator<false, true, block_bytes>
+{
+	using type = ::fast_io::iobuf_aligned_allocator<::fast_io::io_direct_alignment>;
+};
+
+#if ((__STDC_HOSTED__ == 1 && (!defined(_GLIBCXX_HOSTED) || _GLIBCXX_HOSTED == 1) && \
+	  !defined(_LIBCPP_FREESTANDING)) ||                                             \
+	 defined(FAST_IO_ENABLE_HOSTED_FEATURES))
+template <::std::size_t block_bytes>
+struct iobuf_allocator<true, false, block_bytes>
+{
+	using type = ::fast_io::iobuf_pool_allocator<block_bytes>;
+};
+
+template <::std::size_t block_bytes>
+struct iobuf_allocator<true, true, block_bytes>
+{
+	using type = ::fast_io::generic_allocator_adapter<::fast_io::basic_iobuf_pool_allocator<
+		block_bytes, ::fast_io::basic_iobuf_aligned_allocator<::fast_io::io_direct_alignment>>>;
+};
+#endif
+
+} // namespace details
+
+} // namespace fast_io
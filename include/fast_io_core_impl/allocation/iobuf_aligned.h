@@ -0,0 +1,35 @@
+#pragma once
+
+namespace fast_io
+{
+
+/*
+Alignment of buffer_mode::direct buffers and the granularity of their reads and writes. 4096 bytes satisfies devices
+with 512-byte and with 4K logical blocks.
+*/
+inline constexpr ::std::size_t io_direct_alignment{4096u};
+
+/*
+Hands out blocks aligned to alignment bytes, so O_DIRECT transfers can go straight from and into them.
+*/
+template <::std::size_t alignment, typename upstream = ::fast_io::native_global_allocator>
+class basic_iobuf_aligned_allocator
+{
+public:
+	using upstream_adapter_type = ::fast_io::generic_allocator_adapter<upstream>;
+	static inline constexpr ::std::size_t default_alignment{alignment};
+	static inline void *allocate(::std::size_t n) noexcept
+	{
+		return upstream_adapter_type::allocate_aligned(alignment, n);
+	}
+	static inline void deallocate_n(void *p, ::std::size_t n) noexcept
+	{
+		if (p == nullptr)
+		{
+			return;
+		}
+		upstream_adapter_type::deallocate_aligned_n(p, alignment, n);
+	}
+};
+
+} // namespace fast_io
@@ -0,0 +1,229 @@
+#pragma once
+
+#if defined(__linux__) && !defined(__KERNEL__) && __has_include(<sys/mman.h>)
+#include <sys/mman.h>
+#endif
+
+namespace fast_io
+{
+
+namespace details
+{
+
+inline constexpr ::std::size_t iobuf_pool_thread_cache_size{4u};
+inline constexpr ::std::size_t iobuf_pool_global_slots{64u};
+inline constexpr ::std::size_t iobuf_pool_huge_page_size{static_cast<::std::size_t>(2097152u)};
+
+template <::std::size_t block_bytes>
+struct iobuf_pool_thread_state
+{
+	void *blocks[iobuf_pool_thread_cache_size];
+	::std::size_t count;
+	bool registered;
+	bool destroyed;
+};
+
+inline void *iobuf_pool_global_pop(void **slots) noexcept
+{
+#if defined(__GNUC__) || defined(__clang__)
+	for (::std::size_t i{}; i != iobuf_pool_global_slots; ++i)
+	{
+		if (__atomic_load_n(slots + i, __ATOMIC_RELAXED) == nullptr)
+		{
+			continue;
+		}
+		void *p{__atomic_exchange_n(slots + i, nullptr, __ATOMIC_ACQUIRE)};
+		if (p != nullptr)
+		{
+			return p;
+		}
+	}
+#else
+	(void)slots;
+#endif
+	return nullptr;
+}
+
+inline bool iobuf_pool_global_push(void **slots, void *p) noexcept
+{
+#if defined(__GNUC__) || defined(__clang__)
+	for (::std::size_t i{}; i != iobuf_pool_global_slots; ++i)
+	{
+		if (__atomic_load_n(slots + i, __ATOMIC_RELAXED) != nullptr)
+		{
+			continue;
+		}
+		void *expected{};
+		if (__atomic_compare_exchange_n(slots + i, __builtin_addressof(expected), p, false, __ATOMIC_RELEASE, __ATOMIC_RELAXED))
+		{
+			return true;
+		}
+	}
+#else
+	(void)slots;
+	(void)p;
+#endif
+	return false;
+}
+
+} // namespace details
+
+/*
+Pool of recycled I/O buffers of exactly block_bytes bytes, used by basic_io_buffer with buffer_mode::pooled.
+A released buffer first goes into a small thread-local cache, then into a fixed table of global slots that other
+threads claim with a single atomic exchange, and only when both are full back to upstream, so opening and closing
+short-lived buffered files reuses warm buffers instead of going through malloc and fresh page faults.
+Blocks that are a multiple of 2 MiB are mapped directly, 2 MiB aligned and advised MADV_HUGEPAGE, on Linux.
+Requests of any other size pass straight through to upstream.
+*/
+template <::std::size_t block_bytes, typename upstream = ::fast_io::native_global_allocator>
+class basic_iobuf_pool_allocator
+{
+public:
+	using upstream_adapter_type = ::fast_io::generic_allocator_adapter<upstream>;
+	static inline constexpr ::std::size_t block_size{block_bytes};
+	static inline constexpr bool huge_page_backed{
+#if defined(__linux__) && defined(MADV_HUGEPAGE)
+		block_bytes != 0 && block_bytes % ::fast_io::details::iobuf_pool_huge_page_size == 0
+#else
+		false
+#endif
+	};
+
+private:
+	static inline thread_local constinit ::fast_io::details::iobuf_pool_thread_state<block_bytes> state{};
+	static inline constinit void *global_slots[::fast_io::details::iobuf_pool_global_slots]{};
+
+	static inline void *allocate_block() noexcept
+	{
+		if constexpr (huge_page_backed)
+		{
+#if defined(__linux__) && defined(MADV_HUGEPAGE)
+			constexpr ::std::size_t hps{::fast_io::details::iobuf_pool_huge_page_size};
+			constexpr ::std::size_t mapped{block_bytes + hps};
+			void *p{::mmap(nullptr, mapped, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0)};
+			if (p == MAP_FAILED) [[unlikely]]
+			{
+				::fast_io::fast_terminate();
+			}
+			auto const addr{reinterpret_cast<::std::size_t>(p)};
+			::std::size_t const head{((addr + (hps - 1u)) & (0u - hps)) - addr};
+			auto const bp{reinterpret_cast<char unsigned *>(p)};
+			if (head != 0u)
+			{
+				::munmap(bp, head);
+			}
+			if (head != hps)
+			{
+				::munmap(bp + head + block_bytes, hps - head);
+			}
+			::madvise(bp + head, block_bytes, MADV_HUGEPAGE);
+			return bp + head;
+#endif
+		}
+		else
+		{
+			return upstream_adapter_type::allocate(block_bytes);
+		}
+	}
+	static inline void deallocate_block(void *p) noexcept
+	{
+		if constexpr (huge_page_backed)
+		{
+#if defined(__linux__) && defined(MADV_HUGEPAGE)
+			::munmap(p, block_bytes);
+#endif
+		}
+		else
+		{
+			upstream_adapter_type::deallocate_n(p, block_bytes);
+		}
+	}
+
+	struct cleaner
+	{
+		~cleaner()
+		{
+			auto &st{state};
+			for (::std::size_t i{}; i != st.count; ++i)
+			{
+				if (!::fast_io::details::iobuf_pool_global_push(global_slots, st.blocks[i]))
+				{
+					deallocate_block(st.blocks[i]);
+				}
+			}
+			st.count = 0;
+			st.destroyed = true;
+		}
+	};
+
+#if __has_cpp_attribute(__gnu__::__cold__)
+	[[__gnu__::__cold__]]
+#endif
+	static inline void register_cleaner() noexcept
+	{
+		static thread_local cleaner c;
+		(void)c;
+		state.registered = true;
+	}
+
+public:
+	static inline void *allocate(::std::size_t n) noexcept
+	{
+		if (n != block_bytes) [[unlikely]]
+		{
+			return upstream_adapter_type::allocate(n);
+		}
+		auto &st{state};
+		if (st.count != 0)
+		{
+			return st.blocks[--st.count];
+		}
+		void *p{::fast_io::details::iobuf_pool_global_pop(global_slots)};
+		if (p != nullptr)
+		{
+			return p;
+		}
+		return allocate_block();
+	}
+	static inline void deallocate_n(void *p, ::std::size_t n) noexcept
+	{
+		if (p == nullptr)
+		{
+			return;
+		}
+		if (n != block_bytes) [[unlikely]]
+		{
+			upstream_adapter_type::deallocate_n(p, n);
+			return;
+		}
+		auto &st{state};
+		if (st.count != ::fast_io::details::iobuf_pool_thread_cache_size && !st.destroyed)
+		{
+			if (!st.registered) [[unlikely]]
+			{
+				register_cleaner();
+			}
+			st.blocks[st.count] = p;
+			++st.count;
+			return;
+		}
+		if (::fast_io::details::iobuf_pool_global_push(global_slots, p))
+		{
+			return;
+		}
+		deallocate_block(p);
+	}
+	/*
+	Returns every buffer parked in the global slots to upstream; thread caches are drained at thread exit.
+	*/
+	static inline void trim() noexcept
+	{
+		for (void *p; (p = ::fast_io::details::iobuf_pool_global_pop(global_slots)) != nullptr;)
+		{
+			deallocate_block(p);
+		}
+	}
+};
+
+} // namespace fast_io
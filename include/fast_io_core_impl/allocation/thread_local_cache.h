@@ -0,0 +1,202 @@
+#pragma once
+
+namespace fast_io
+{
+
+namespace details
+{
+
+struct thread_local_cache_free_node
+{
+	thread_local_cache_free_node *next;
+};
+
+inline constexpr ::std::size_t thread_local_cache_min_shift{4u};
+inline constexpr ::std::size_t thread_local_cache_classes{14u};
+inline constexpr ::std::size_t thread_local_cache_max_block_size{static_cast<::std::size_t>(1u)
+																  << (thread_local_cache_min_shift + thread_local_cache_classes - 1u)};
+
+/*
+At most 1 MiB (but never fewer than 8 blocks, never more than 256) is parked per size class; everything beyond that
+goes straight back to upstream.
+*/
+inline constexpr ::std::uint_least32_t thread_local_cache_class_limit(::std::size_t cls) noexcept
+{
+	::std::size_t blocks{static_cast<::std::size_t>(1048576u) >> (thread_local_cache_min_shift + cls)};
+	if (blocks < 8u)
+	{
+		blocks = 8u;
+	}
+	else if (256u < blocks)
+	{
+		blocks = 256u;
+	}
+	return static_cast<::std::uint_least32_t>(blocks);
+}
+
+inline constexpr ::std::size_t thread_local_cache_class_of(::std::size_t n) noexcept
+{
+	constexpr ::std::size_t mn{static_cast<::std::size_t>(1u) << thread_local_cache_min_shift};
+	if (n <= mn)
+	{
+		return 0;
+	}
+	return static_cast<::std::size_t>(::std::bit_width(n - 1u)) - thread_local_cache_min_shift;
+}
+
+struct thread_local_cache_state
+{
+	thread_local_cache_free_node *heads[thread_local_cache_classes];
+	::std::uint_least32_t counts[thread_local_cache_classes];
+	bool registered;
+	bool destroyed;
+};
+
+} // namespace details
+
+/*
+Per-thread size-class cache in front of upstream: power-of-two classes from 16 bytes to 128 KiB (the default iobuf
+size) are served from thread-local free lists without touching the global heap; larger requests go to upstream
+directly. Every cached block is an ordinary upstream block of its class size, so a block freed on another thread
+simply joins that thread's list (or goes back to upstream once the list is full) — cross-thread frees need no
+synchronisation. The lists are drained when the thread exits.
+native_thread_local_allocator puts it in front of native_global_allocator when FAST_IO_USE_THREAD_LOCAL_CACHE_ALLOCATOR
+is defined.
+*/
+template <typename upstream>
+class thread_local_cache_allocator
+{
+public:
+	using upstream_adapter_type = ::fast_io::generic_allocator_adapter<upstream>;
+	static inline constexpr ::std::size_t default_alignment{upstream_adapter_type::default_alignment};
+
+private:
+	static inline thread_local constinit ::fast_io::details::thread_local_cache_state state{};
+
+	struct cleaner
+	{
+		~cleaner()
+		{
+			auto &st{state};
+			for (::std::size_t i{}; i != ::fast_io::details::thread_local_cache_classes; ++i)
+			{
+				::std::size_t const blocksize{static_cast<::std::size_t>(1u) << (::fast_io::details::thread_local_cache_min_shift + i)};
+				for (auto p{st.heads[i]}; p != nullptr;)
+				{
+					auto next{p->next};
+					upstream_adapter_type::deallocate_n(p, blocksize);
+					p = next;
+				}
+				st.heads[i] = nullptr;
+				st.counts[i] = 0;
+			}
+			st.destroyed = true;
+		}
+	};
+
+#if __has_cpp_attribute(__gnu__::__cold__)
+	[[__gnu__::__cold__]]
+#endif
+	static inline void register_cleaner() noexcept
+	{
+		static thread_local cleaner c;
+		(void)c;
+		state.registered = true;
+	}
+
+public:
+	static inline ::fast_io::allocation_least_result allocate_at_least(::std::size_t n) noexcept
+	{
+		if (::fast_io::details::thread_local_cache_max_block_size < n) [[unlikely]]
+		{
+			return {upstream_adapter_type::allocate(n), n};
+		}
+		::std::size_t const cls{::fast_io::details::thread_local_cache_class_of(n)};
+		::std::size_t const blocksize{static_cast<::std::size_t>(1u) << (::fast_io::details::thread_local_cache_min_shift + cls)};
+		auto &st{state};
+		auto p{st.heads[cls]};
+		if (p != nullptr) [[likely]]
+		{
+			st.heads[cls] = p->next;
+			--st.counts[cls];
+			return {p, blocksize};
+		}
+		return {upstream_adapter_type::allocate(blocksize), blocksize};
+	}
+	static inline void *allocate(::std::size_t n) noexcept
+	{
+		return allocate_at_least(n).ptr;
+	}
+	static inline void deallocate_n(void *p, ::std::size_t n) noexcept
+	{
+		if (p == nullptr)
+		{
+			return;
+		}
+		if (::fast_io::details::thread_local_cache_max_block_size < n) [[unlikely]]
+		{
+			upstream_adapter_type::deallocate_n(p, n);
+			return;
+		}
+		::std::size_t const cls{::fast_io::details::thread_local_cache_class_of(n)};
+		auto &st{state};
+		if (st.counts[cls] < ::fast_io::details::thread_local_cache_class_limit(cls) && !st.destroyed) [[likely]]
+		{
+			if (!st.registered) [[unlikely]]
+			{
+				register_cleaner();
+			}
+			auto node{reinterpret_cast<::fast_io::details::thread_local_cache_free_node *>(p)};
+			node->next = st.heads[cls];
+			st.heads[cls] = node;
+			++st.counts[cls];
+			return;
+		}
+		upstream_adapter_type::deallocate_n(p, static_cast<::std::size_t>(1u) << (::fast_io::details::thread_local_cache_min_shift + cls));
+	}
+	/*
+	Stays in place while the new size falls into the same class.
+	*/
+	static inline void *reallocate_n(void *p, ::std::size_t oldn, ::std::size_t n) noexcept
+	{
+		constexpr ::std::size_t mx{::fast_io::details::thread_local_cache_max_block_size};
+		if (p != nullptr && oldn <= mx && n <= mx &&
+			::fast_io::details::thread_local_cache_class_of(oldn) == ::fast_io::details::thread_local_cache_class_of(n))
+		{
+			return p;
+		}
+		if (mx < oldn && mx < n)
+		{
+			return upstream_adapter_type::reallocate_n(p, oldn, n);
+		}
+		auto newp{allocate(n)};
+		if (p != nullptr)
+		{
+			::fast_io::freestanding::nonoverlapped_bytes_copy_n(reinterpret_cast<::std::byte const *>(p), oldn < n ? oldn : n,
+																reinterpret_cast<::std::byte *>(newp));
+			deallocate_n(p, oldn);
+		}
+		return newp;
+	}
+	/*
+	Over-aligned requests bypass the cache: upstream decides how it pads them, so only it can free them.
+	*/
+	static inline void *allocate_aligned(::std::size_t alignment, ::std::size_t n) noexcept
+	{
+		return upstream_adapter_type::allocate_aligned(alignment, n);
+	}
+	static inline void *allocate_aligned_zero(::std::size_t alignment, ::std::size_t n) noexcept
+	{
+		return upstream_adapter_type::allocate_aligned_zero(alignment, n);
+	}
+	static inline void *reallocate_aligned_n(void *p, ::std::size_t oldn, ::std::size_t alignment, ::std::size_t n) noexcept
+	{
+		return upstream_adapter_type::reallocate_aligned_n(p, oldn, alignment, n);
+	}
+	static inline void deallocate_aligned_n(void *p, ::std::size_t alignment, ::std::size_t n) noexcept
+	{
+		upstream_adapter_type::deallocate_aligned_n(p, alignment, n);
+	}
+};
+
+} // namespace fast_io
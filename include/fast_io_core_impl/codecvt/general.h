@@ -88,6 +88,18 @@ inline constexpr code_cvt_result<src_char_type,dest_char_type> general_code_cvt(
 	else if constexpr(sizeof(src_char_type)==4)
 	{
 		static_assert(src_encoding==encoding_scheme::utf_be||src_encoding==encoding_scheme::utf_le);
+#if __cpp_lib_is_constant_evaluated>=201811L
+		if constexpr(utf_simd_transcode_supported&&is_native_scheme(src_encoding)&&
+			encoding==encoding_scheme::utf&&sizeof(dest_char_type)==1)
+		{
+			if(!std::is_constant_evaluated())
+			{
+				auto [new_src,new_dst]=utf16_or_32_to_utf8_simd(src_first,src_last,dst);
+				src_first=new_src;
+				dst=new_dst;
+			}
+		}
+#endif
 		for(;src_first!=src_last;++src_first)
 			dst+=get_utf_code_units<encoding>(static_cast<char32_t>(*src_first),dst);
 		return {src_last,dst};
@@ -99,6 +111,18 @@ inline constexpr code_cvt_result<src_char_type,dest_char_type> general_code_cvt(
 Referenced from
 https://stackoverflow.com/questions/23919515/how-to-convert-from-utf-16-to-utf-32-on-linux-with-std-library
 */
+#if __cpp_lib_is_constant_evaluated>=201811L
+		if constexpr(utf_simd_transcode_supported&&is_native_scheme(src_encoding)&&
+			encoding==encoding_scheme::utf&&sizeof(dest_char_type)==1)
+		{
+			if(!std::is_constant_evaluated())
+			{
+				auto [new_src,new_dst]=utf16_or_32_to_utf8_simd(src_first,src_last,dst);
+				src_first=new_src;
+				dst=new_dst;
+			}
+		}
+#endif
 		for(;src_first!=src_last;++src_first)
 		{
 			char16_t code{static_cast<char16_t>(*src_first)};
@@ -158,6 +182,18 @@ https://stackoverflow.com/questions/23919515/how-to-convert-from-utf-16-to-utf-3
 	}
 	else
 	{
+#if __cpp_lib_is_constant_evaluated>=201811L
+		if constexpr(utf_simd_transcode_supported&&src_encoding==encoding_scheme::utf&&
+			encoding==encoding_scheme::utf&&sizeof(dest_char_type)!=1)
+		{
+			if(!std::is_constant_evaluated())
+			{
+				auto [new_src,new_dst]=utf8_to_utf16_or_32_simd(src_first,src_last,dst);
+				src_first=new_src;
+				dst=new_dst;
+			}
+		}
+#endif
 #if (defined(_MSC_VER)&&defined(_M_AMD64)&&!defined(__clang__)) || (defined(__SSE__) && defined(__x86_64__) && __cpp_lib_is_constant_evaluated>=201811L)
 		if constexpr(src_encoding!=encoding_scheme::utf_ebcdic&&encoding!=encoding_scheme::utf_ebcdic&&1==sizeof(src_char_type)
 		&&(1==sizeof(dest_char_type)||encoding_is_utf(encoding)))
@@ -443,7 +479,7 @@ inline constexpr dest_char_type* general_code_cvt_full(src_char_type const* src_
 				++new_dst;
 			}
 			else
-				new_dst+=get_general_invalid_code_units<encoding>(dst);
+				new_dst+=get_general_invalid_code_units<encoding>(new_dst);
 		}
 		return new_dst;
 	}
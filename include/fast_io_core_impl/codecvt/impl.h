@@ -4,6 +4,7 @@
 #include"utf_ebcdic.h"
 #include"utf_util_table.h"
 #include"utf.h"
+#include"utf_simd.h"
 #include"general.h"
 #include"code_cvt.h"
 
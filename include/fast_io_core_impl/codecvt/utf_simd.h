@@ -0,0 +1,806 @@
+#pragma once
+
+/*
+AVX2 / AVX-512BW UTF-8 validation and UTF-8 <-> UTF-16/UTF-32 transcoding for general_code_cvt.
+
+Validation is the lookup algorithm from John Keiser, Daniel Lemire, "Validating UTF-8 In Less Than One Instruction Per
+Byte" (2021): three 16-entry nibble tables classify every pair of adjacent bytes and a separate check covers the third
+and fourth byte of long sequences. Multi-byte decoding follows Daniel Lemire, Wojciech Mula, "Transcoding Billions of
+Unicode Characters per Second with SIMD Instructions" (2022): the end-of-code-point bits of a 12-byte window select a
+byte shuffle that spreads six, four or three code points into 16 or 32-bit lanes. The shuffle tables are generated at
+compile time.
+
+The kernels only convert well-formed input. A block that fails validation is decoded by the scalar DFA up to the next
+code point boundary past the block, so ill-formed input still produces exactly the U+FFFD replacements of the scalar
+code. The destination must have room for the worst case of the whole source (one unit per UTF-8 byte, three bytes per
+UTF-16 unit, four per UTF-32 unit), which every reserve size computed in this directory already guarantees; stores
+never reach beyond that bound.
+*/
+
+namespace fast_io::details::codecvt
+{
+
+inline constexpr bool utf_simd_transcode_supported
+{
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#if __has_builtin(__builtin_shufflevector) && __has_builtin(__builtin_convertvector)
+#if defined(__AVX2__)
+true
+#else
+::fast_io::details::cpu_flags::runtime_dispatch_supported
+#endif
+#endif
+#endif
+};
+
+struct utf8_simd_window_entry
+{
+	::std::uint_least8_t shuffle_index;
+	::std::uint_least8_t consumed;
+	::std::uint_least8_t count;
+};
+
+struct utf_simd_shuffle_entry
+{
+	::std::uint_least8_t bytes[16];
+	::std::uint_least8_t length;
+};
+
+/*
+Shuffle 0-63: six code points of 1-2 bytes into 16-bit lanes. 64-144: four of 1-3 bytes into 32-bit lanes.
+145-208: up to three of 1-4 bytes into 32-bit lanes. Each lane holds the bytes of one code point, last byte first.
+*/
+inline constexpr ::std::size_t utf8_simd_window_shuffles{209u};
+
+inline constexpr ::fast_io::freestanding::array<utf8_simd_window_entry,4096u> generate_utf8_simd_window_index_tb() noexcept
+{
+	::fast_io::freestanding::array<utf8_simd_window_entry,4096u> tb{};
+	for(::std::size_t mask{};mask!=4096u;++mask)
+	{
+		::std::size_t lens[12]{};
+		::std::size_t n{};
+		for(::std::size_t i{},start{};i!=12u;++i)
+		{
+			if(((mask>>i)&1u)==0u)
+				continue;
+			::std::size_t const len{i-start+1u};
+			if(4u<len)
+				break;
+			lens[n]=len;
+			++n;
+			start=i+1u;
+		}
+		bool six{6u<=n},four{4u<=n};
+		for(::std::size_t i{};i!=6u&&six;++i)
+			six=lens[i]<=2u;
+		for(::std::size_t i{};i!=4u&&four;++i)
+			four=lens[i]<=3u;
+		::std::size_t index{},consumed{},count{};
+		if(six)
+		{
+			count=6u;
+			for(::std::size_t i{};i!=count;++i)
+			{
+				index|=(lens[i]-1u)<<i;
+				consumed+=lens[i];
+			}
+		}
+		else if(four)
+		{
+			count=4u;
+			index=64u;
+			for(::std::size_t i{},pw{1u};i!=count;++i,pw*=3u)
+			{
+				index+=(lens[i]-1u)*pw;
+				consumed+=lens[i];
+			}
+		}
+		else
+		{
+			count=n<3u?n:3u;
+			index=145u;
+			for(::std::size_t i{},pw{1u};i!=count;++i,pw*=4u)
+			{
+				index+=(lens[i]-1u)*pw;
+				consumed+=lens[i];
+			}
+		}
+		tb[mask]={static_cast<::std::uint_least8_t>(index),static_cast<::std::uint_least8_t>(consumed),
+			static_cast<::std::uint_least8_t>(count)};
+	}
+	return tb;
+}
+
+inline constexpr ::fast_io::freestanding::array<utf_simd_shuffle_entry,utf8_simd_window_shuffles> generate_utf8_simd_window_shuffle_tb() noexcept
+{
+	::fast_io::freestanding::array<utf_simd_shuffle_entry,utf8_simd_window_shuffles> tb{};
+	for(::std::size_t index{};index!=utf8_simd_window_shuffles;++index)
+	{
+		::std::size_t lens[6]{};
+		::std::size_t lanes,lane_bytes;
+		if(index<64u)
+		{
+			lanes=6u;
+			lane_bytes=2u;
+			for(::std::size_t i{};i!=lanes;++i)
+				lens[i]=((index>>i)&1u)+1u;
+		}
+		else if(index<145u)
+		{
+			lanes=4u;
+			lane_bytes=4u;
+			for(::std::size_t i{},j{index-64u};i!=lanes;++i,j/=3u)
+				lens[i]=j%3u+1u;
+		}
+		else
+		{
+			lanes=3u;
+			lane_bytes=4u;
+			for(::std::size_t i{},j{index-145u};i!=lanes;++i,j/=4u)
+				lens[i]=j%4u+1u;
+		}
+		auto& e{tb[index]};
+		for(auto& b : e.bytes)
+			b=0x80u;
+		::std::size_t offset{};
+		for(::std::size_t i{};i!=lanes;++i)
+		{
+			for(::std::size_t k{};k!=lens[i];++k)
+				e.bytes[i*lane_bytes+k]=static_cast<::std::uint_least8_t>(offset+lens[i]-1u-k);
+			offset+=lens[i];
+		}
+		e.length=static_cast<::std::uint_least8_t>(offset);
+	}
+	return tb;
+}
+
+/*
+Index: bit i is set when lane i needs at least 2 bytes, bit i+4 when it needs 3. Packs the UTF-8 bytes of four 32-bit
+lanes together.
+*/
+inline constexpr ::fast_io::freestanding::array<utf_simd_shuffle_entry,256u> generate_utf_simd_utf8_pack_tb() noexcept
+{
+	::fast_io::freestanding::array<utf_simd_shuffle_entry,256u> tb{};
+	for(::std::size_t index{};index!=256u;++index)
+	{
+		auto& e{tb[index]};
+		for(auto& b : e.bytes)
+			b=0x80u;
+		::std::size_t pos{};
+		for(::std::size_t i{};i!=4u;++i)
+		{
+			::std::size_t const len{1u+((index>>i)&1u)+((index>>(i+4u))&1u)};
+			for(::std::size_t k{};k!=len;++k)
+			{
+				e.bytes[pos]=static_cast<::std::uint_least8_t>(i*4u+k);
+				++pos;
+			}
+		}
+		e.length=static_cast<::std::uint_least8_t>(pos);
+	}
+	return tb;
+}
+
+inline constexpr auto utf8_simd_window_index_tb{generate_utf8_simd_window_index_tb()};
+inline constexpr auto utf8_simd_window_shuffle_tb{generate_utf8_simd_window_shuffle_tb()};
+inline constexpr auto utf_simd_utf8_pack_tb{generate_utf_simd_utf8_pack_tb()};
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#if __has_builtin(__builtin_shufflevector) && __has_builtin(__builtin_convertvector)
+
+using utf_simd_u8x8 [[__gnu__::__vector_size__(8)]] = ::std::uint_least8_t;
+using utf_simd_u8x16 [[__gnu__::__vector_size__(16)]] = ::std::uint_least8_t;
+using utf_simd_i8x16 [[__gnu__::__vector_size__(16)]] = char;
+using utf_simd_u16x4 [[__gnu__::__vector_size__(8)]] = ::std::uint_least16_t;
+using utf_simd_u16x8 [[__gnu__::__vector_size__(16)]] = ::std::uint_least16_t;
+using utf_simd_u32x4 [[__gnu__::__vector_size__(16)]] = ::std::uint_least32_t;
+using utf_simd_u8x32 [[__gnu__::__vector_size__(32)]] = ::std::uint_least8_t;
+using utf_simd_i8x32 [[__gnu__::__vector_size__(32)]] = char;
+using utf_simd_s8x32 [[__gnu__::__vector_size__(32)]] = signed char;
+using utf_simd_u16x16 [[__gnu__::__vector_size__(32)]] = ::std::uint_least16_t;
+using utf_simd_u32x8 [[__gnu__::__vector_size__(32)]] = ::std::uint_least32_t;
+using utf_simd_i64x4 [[__gnu__::__vector_size__(32)]] = long long;
+using utf_simd_f32x8 [[__gnu__::__vector_size__(32)]] = float;
+using utf_simd_u8x64 [[__gnu__::__vector_size__(64)]] = ::std::uint_least8_t;
+using utf_simd_i8x64 [[__gnu__::__vector_size__(64)]] = char;
+using utf_simd_s8x64 [[__gnu__::__vector_size__(64)]] = signed char;
+using utf_simd_u16x32 [[__gnu__::__vector_size__(64)]] = ::std::uint_least16_t;
+using utf_simd_u32x16 [[__gnu__::__vector_size__(64)]] = ::std::uint_least32_t;
+
+inline constexpr ::std::uint_least8_t utf8_simd_too_short{1u};
+inline constexpr ::std::uint_least8_t utf8_simd_too_long{2u};
+inline constexpr ::std::uint_least8_t utf8_simd_overlong_3{4u};
+inline constexpr ::std::uint_least8_t utf8_simd_too_large{8u};
+inline constexpr ::std::uint_least8_t utf8_simd_surrogate{16u};
+inline constexpr ::std::uint_least8_t utf8_simd_overlong_2{32u};
+inline constexpr ::std::uint_least8_t utf8_simd_too_large_1000{64u};
+inline constexpr ::std::uint_least8_t utf8_simd_overlong_4{64u};
+inline constexpr ::std::uint_least8_t utf8_simd_two_conts{128u};
+inline constexpr ::std::uint_least8_t utf8_simd_carry{utf8_simd_too_short|utf8_simd_too_long|utf8_simd_two_conts};
+
+inline constexpr utf_simd_u8x16 utf8_simd_byte_1_high_tb{
+utf8_simd_too_long,utf8_simd_too_long,utf8_simd_too_long,utf8_simd_too_long,
+utf8_simd_too_long,utf8_simd_too_long,utf8_simd_too_long,utf8_simd_too_long,
+utf8_simd_two_conts,utf8_simd_two_conts,utf8_simd_two_conts,utf8_simd_two_conts,
+utf8_simd_too_short|utf8_simd_overlong_2,
+utf8_simd_too_short,
+utf8_simd_too_short|utf8_simd_overlong_3|utf8_simd_surrogate,
+utf8_simd_too_short|utf8_simd_too_large|utf8_simd_too_large_1000|utf8_simd_overlong_4};
+
+inline constexpr utf_simd_u8x16 utf8_simd_byte_1_low_tb{
+utf8_simd_carry|utf8_simd_overlong_3|utf8_simd_overlong_2|utf8_simd_overlong_4,
+utf8_simd_carry|utf8_simd_overlong_2,
+utf8_simd_carry,
+utf8_simd_carry,
+utf8_simd_carry|utf8_simd_too_large,
+utf8_simd_carry|utf8_simd_too_large|utf8_simd_too_large_1000,
+utf8_simd_carry|utf8_simd_too_large|utf8_simd_too_large_1000,
+utf8_simd_carry|utf8_simd_too_large|utf8_simd_too_large_1000,
+utf8_simd_carry|utf8_simd_too_large|utf8_simd_too_large_1000,
+utf8_simd_carry|utf8_simd_too_large|utf8_simd_too_large_1000,
+utf8_simd_carry|utf8_simd_too_large|utf8_simd_too_large_1000,
+utf8_simd_carry|utf8_simd_too_large|utf8_simd_too_large_1000,
+utf8_simd_carry|utf8_simd_too_large|utf8_simd_too_large_1000,
+utf8_simd_carry|utf8_simd_too_large|utf8_simd_too_large_1000|utf8_simd_surrogate,
+utf8_simd_carry|utf8_simd_too_large|utf8_simd_too_large_1000,
+utf8_simd_carry|utf8_simd_too_large|utf8_simd_too_large_1000};
+
+inline constexpr utf_simd_u8x16 utf8_simd_byte_2_high_tb{
+utf8_simd_too_short,utf8_simd_too_short,utf8_simd_too_short,utf8_simd_too_short,
+utf8_simd_too_short,utf8_simd_too_short,utf8_simd_too_short,utf8_simd_too_short,
+utf8_simd_too_long|utf8_simd_overlong_2|utf8_simd_two_conts|utf8_simd_overlong_3|utf8_simd_too_large_1000|utf8_simd_overlong_4,
+utf8_simd_too_long|utf8_simd_overlong_2|utf8_simd_two_conts|utf8_simd_overlong_3|utf8_simd_too_large,
+utf8_simd_too_long|utf8_simd_overlong_2|utf8_simd_two_conts|utf8_simd_surrogate|utf8_simd_too_large,
+utf8_simd_too_long|utf8_simd_overlong_2|utf8_simd_two_conts|utf8_simd_surrogate|utf8_simd_too_large,
+utf8_simd_too_short,utf8_simd_too_short,utf8_simd_too_short,utf8_simd_too_short};
+
+/*
+Nonzero bytes flag errors. Validation restarts at every block with all-ASCII context: blocks always begin on a code
+point boundary, and a sequence cut off by the end of the block is simply left for the next block.
+*/
+[[__gnu__::__target__("avx2")]]
+inline utf_simd_u8x32 utf8_simd_check_avx2(utf_simd_u8x32 input,utf_simd_u8x32 prev_input) noexcept
+{
+	utf_simd_u8x32 const prev1{__builtin_shufflevector(prev_input,input,
+		31,32,33,34,35,36,37,38,39,40,41,42,43,44,45,46,47,48,49,50,51,52,53,54,55,56,57,58,59,60,61,62)};
+	utf_simd_u8x32 const prev2{__builtin_shufflevector(prev_input,input,
+		30,31,32,33,34,35,36,37,38,39,40,41,42,43,44,45,46,47,48,49,50,51,52,53,54,55,56,57,58,59,60,61)};
+	utf_simd_u8x32 const prev3{__builtin_shufflevector(prev_input,input,
+		29,30,31,32,33,34,35,36,37,38,39,40,41,42,43,44,45,46,47,48,49,50,51,52,53,54,55,56,57,58,59,60)};
+	utf_simd_u8x32 const byte_1_high_tb{__builtin_shufflevector(utf8_simd_byte_1_high_tb,utf8_simd_byte_1_high_tb,
+		0,1,2,3,4,5,6,7,8,9,10,11,12,13,14,15,0,1,2,3,4,5,6,7,8,9,10,11,12,13,14,15)};
+	utf_simd_u8x32 const byte_1_low_tb{__builtin_shufflevector(utf8_simd_byte_1_low_tb,utf8_simd_byte_1_low_tb,
+		0,1,2,3,4,5,6,7,8,9,10,11,12,13,14,15,0,1,2,3,4,5,6,7,8,9,10,11,12,13,14,15)};
+	utf_simd_u8x32 const byte_2_high_tb{__builtin_shufflevector(utf8_simd_byte_2_high_tb,utf8_simd_byte_2_high_tb,
+		0,1,2,3,4,5,6,7,8,9,10,11,12,13,14,15,0,1,2,3,4,5,6,7,8,9,10,11,12,13,14,15)};
+	utf_simd_u8x32 const byte_1_high{(utf_simd_u8x32)__builtin_ia32_pshufb256((utf_simd_i8x32)byte_1_high_tb,(utf_simd_i8x32)(prev1>>4))};
+	utf_simd_u8x32 const byte_1_low{(utf_simd_u8x32)__builtin_ia32_pshufb256((utf_simd_i8x32)byte_1_low_tb,(utf_simd_i8x32)(prev1&0x0F))};
+	utf_simd_u8x32 const byte_2_high{(utf_simd_u8x32)__builtin_ia32_pshufb256((utf_simd_i8x32)byte_2_high_tb,(utf_simd_i8x32)(input>>4))};
+	utf_simd_u8x32 const must23{(utf_simd_u8x32)((prev2>=0xE0)|(prev3>=0xF0))&0x80};
+	return (byte_1_high&byte_1_low&byte_2_high)^must23;
+}
+
+[[__gnu__::__target__("avx512bw")]]
+inline utf_simd_u8x64 utf_simd_pshufb512(utf_simd_u8x64 tb,utf_simd_u8x64 index) noexcept
+{
+#if defined(__clang__)
+	return (utf_simd_u8x64)__builtin_ia32_pshufb512((utf_simd_i8x64)tb,(utf_simd_i8x64)index);
+#else
+	return (utf_simd_u8x64)__builtin_ia32_pshufb512_mask((utf_simd_i8x64)tb,(utf_simd_i8x64)index,utf_simd_i8x64{},
+		~static_cast<unsigned long long>(0u));
+#endif
+}
+
+[[__gnu__::__target__("avx512bw")]]
+inline utf_simd_u8x64 utf8_simd_check_avx512bw(utf_simd_u8x64 input) noexcept
+{
+	utf_simd_u8x64 const zero{};
+	utf_simd_u8x64 const prev1{__builtin_shufflevector(zero,input,
+		63,64,65,66,67,68,69,70,71,72,73,74,75,76,77,78,79,80,81,82,83,84,85,86,87,88,89,90,91,92,93,94,
+		95,96,97,98,99,100,101,102,103,104,105,106,107,108,109,110,111,112,113,114,115,116,117,118,119,120,121,122,123,124,125,126)};
+	utf_simd_u8x64 const prev2{__builtin_shufflevector(zero,input,
+		62,63,64,65,66,67,68,69,70,71,72,73,74,75,76,77,78,79,80,81,82,83,84,85,86,87,88,89,90,91,92,93,
+		94,95,96,97,98,99,100,101,102,103,104,105,106,107,108,109,110,111,112,113,114,115,116,117,118,119,120,121,122,123,124,125)};
+	utf_simd_u8x64 const prev3{__builtin_shufflevector(zero,input,
+		61,62,63,64,65,66,67,68,69,70,71,72,73,74,75,76,77,78,79,80,81,82,83,84,85,86,87,88,89,90,91,92,
+		93,94,95,96,97,98,99,100,101,102,103,104,105,106,107,108,109,110,111,112,113,114,115,116,117,118,119,120,121,122,123,124)};
+	utf_simd_u8x64 const byte_1_high_tb{__builtin_shufflevector(utf8_simd_byte_1_high_tb,utf8_simd_byte_1_high_tb,
+		0,1,2,3,4,5,6,7,8,9,10,11,12,13,14,15,0,1,2,3,4,5,6,7,8,9,10,11,12,13,14,15,
+		0,1,2,3,4,5,6,7,8,9,10,11,12,13,14,15,0,1,2,3,4,5,6,7,8,9,10,11,12,13,14,15)};
+	utf_simd_u8x64 const byte_1_low_tb{__builtin_shufflevector(utf8_simd_byte_1_low_tb,utf8_simd_byte_1_low_tb,
+		0,1,2,3,4,5,6,7,8,9,10,11,12,13,14,15,0,1,2,3,4,5,6,7,8,9,10,11,12,13,14,15,
+		0,1,2,3,4,5,6,7,8,9,10,11,12,13,14,15,0,1,2,3,4,5,6,7,8,9,10,11,12,13,14,15)};
+	utf_simd_u8x64 const byte_2_high_tb{__builtin_shufflevector(utf8_simd_byte_2_high_tb,utf8_simd_byte_2_high_tb,
+		0,1,2,3,4,5,6,7,8,9,10,11,12,13,14,15,0,1,2,3,4,5,6,7,8,9,10,11,12,13,14,15,
+		0,1,2,3,4,5,6,7,8,9,10,11,12,13,14,15,0,1,2,3,4,5,6,7,8,9,10,11,12,13,14,15)};
+	utf_simd_u8x64 const byte_1_high{utf_simd_pshufb512(byte_1_high_tb,prev1>>4)};
+	utf_simd_u8x64 const byte_1_low{utf_simd_pshufb512(byte_1_low_tb,prev1&0x0F)};
+	utf_simd_u8x64 const byte_2_high{utf_simd_pshufb512(byte_2_high_tb,input>>4)};
+	utf_simd_u8x64 const must23{(utf_simd_u8x64)((prev2>=0xE0)|(prev3>=0xF0))&0x80};
+	return (byte_1_high&byte_1_low&byte_2_high)^must23;
+}
+
+template<::std::integral U>
+[[__gnu__::__target__("avx2")]]
+inline U* utf8_simd_store_u16x8(utf_simd_u16x8 v,U* dst) noexcept
+{
+	if constexpr(sizeof(U)==2)
+		__builtin_memcpy(dst,__builtin_addressof(v),16u);
+	else
+	{
+		utf_simd_u32x8 const w{__builtin_convertvector(v,utf_simd_u32x8)};
+		__builtin_memcpy(dst,__builtin_addressof(w),32u);
+	}
+	return dst;
+}
+
+template<::std::integral U>
+[[__gnu__::__target__("avx2")]]
+inline U* utf8_simd_store_bmp_u32x4(utf_simd_u32x4 v,U* dst) noexcept
+{
+	if constexpr(sizeof(U)==2)
+	{
+		utf_simd_u16x4 const w{__builtin_convertvector(v,utf_simd_u16x4)};
+		__builtin_memcpy(dst,__builtin_addressof(w),8u);
+	}
+	else
+		__builtin_memcpy(dst,__builtin_addressof(v),16u);
+	return dst+4;
+}
+
+/*
+Decodes the complete code points at the start of the window; end_mask bit i is set when byte i ends a code point.
+At least one code point must end within the first four bytes.
+*/
+template<::std::integral T,::std::integral U>
+[[__gnu__::__target__("avx2")]]
+inline code_cvt_result<T,U> utf8_simd_convert_window_avx2(T const* src,::std::uint_least64_t end_mask,U* dst) noexcept
+{
+	utf_simd_u8x16 in;
+	__builtin_memcpy(__builtin_addressof(in),src,16u);
+	if((end_mask&0xFFFFu)==0xFFFFu)
+	{
+		if constexpr(sizeof(U)==2)
+		{
+			utf_simd_u16x16 const w{__builtin_convertvector(in,utf_simd_u16x16)};
+			__builtin_memcpy(dst,__builtin_addressof(w),32u);
+		}
+		else
+		{
+			utf_simd_u32x8 w{__builtin_convertvector(__builtin_shufflevector(in,in,0,1,2,3,4,5,6,7),utf_simd_u32x8)};
+			__builtin_memcpy(dst,__builtin_addressof(w),32u);
+			w=__builtin_convertvector(__builtin_shufflevector(in,in,8,9,10,11,12,13,14,15),utf_simd_u32x8);
+			__builtin_memcpy(dst+8,__builtin_addressof(w),32u);
+		}
+		return {src+16,dst+16};
+	}
+	if((end_mask&0xFFFFu)==0xAAAAu)
+	{
+		utf_simd_u16x8 const v{(utf_simd_u16x8)__builtin_shufflevector(in,in,1,0,3,2,5,4,7,6,9,8,11,10,13,12,15,14)};
+		utf8_simd_store_u16x8((v&0x7Fu)|((v&0x1F00u)>>2),dst);
+		return {src+16,dst+8};
+	}
+	if((end_mask&0xFFFu)==0x924u)
+	{
+		utf_simd_u8x16 const zero{};
+		utf_simd_u32x4 const v{(utf_simd_u32x4)__builtin_shufflevector(in,zero,2,1,0,16,5,4,3,16,8,7,6,16,11,10,9,16)};
+		return {src+12,utf8_simd_store_bmp_u32x4((v&0x7Fu)|((v&0x3F00u)>>2)|((v&0x0F0000u)>>4),dst)};
+	}
+	if((end_mask&0xFFFFu)==0x8888u)
+	{
+		utf_simd_u32x4 const v{(utf_simd_u32x4)__builtin_shufflevector(in,in,3,2,1,0,7,6,5,4,11,10,9,8,15,14,13,12)};
+		utf_simd_u32x4 const cp{(v&0x3Fu)|((v&0x3F00u)>>2)|((v&0x3F0000u)>>4)|((v&0x07000000u)>>6)};
+		if constexpr(sizeof(U)==2)
+		{
+			utf_simd_u32x4 const w{(0xD7C0u+(cp>>10))|((0xDC00u|(cp&0x3FFu))<<16)};
+			__builtin_memcpy(dst,__builtin_addressof(w),16u);
+			return {src+16,dst+8};
+		}
+		else
+		{
+			__builtin_memcpy(dst,__builtin_addressof(cp),16u);
+			return {src+16,dst+4};
+		}
+	}
+	auto const& e{utf8_simd_window_index_tb[static_cast<::std::size_t>(end_mask&0xFFFu)]};
+	utf_simd_u8x16 sh;
+	__builtin_memcpy(__builtin_addressof(sh),utf8_simd_window_shuffle_tb[e.shuffle_index].bytes,16u);
+	utf_simd_u8x16 const perm{(utf_simd_u8x16)__builtin_ia32_pshufb128((utf_simd_i8x16)in,(utf_simd_i8x16)sh)};
+	if(e.shuffle_index<64u)
+	{
+		utf_simd_u16x8 const v{(utf_simd_u16x8)perm};
+		utf8_simd_store_u16x8((v&0x7Fu)|((v&0x1F00u)>>2),dst);
+		dst+=6;
+	}
+	else if(e.shuffle_index<145u)
+	{
+		utf_simd_u32x4 const v{(utf_simd_u32x4)perm};
+		dst=utf8_simd_store_bmp_u32x4((v&0x7Fu)|((v&0x3F00u)>>2)|((v&0x0F0000u)>>4),dst);
+	}
+	else
+	{
+		utf_simd_u32x4 const v{(utf_simd_u32x4)perm};
+		utf_simd_u32x4 const middle_high{(v&0x3F0000u)^((v&0x400000u)>>1)};
+		utf_simd_u32x4 const cp{(v&0x7Fu)|((v&0x3F00u)>>2)|(middle_high>>4)|((v&0x07000000u)>>6)};
+		if constexpr(sizeof(U)==2)
+		{
+			for(::std::size_t i{};i!=e.count;++i)
+			{
+				::std::uint_least32_t const c{cp[i]};
+				if(c<0x10000u)
+				{
+					*dst=static_cast<U>(c);
+					++dst;
+				}
+				else
+				{
+					*dst=static_cast<U>(0xD7C0u+(c>>10));
+					dst[1]=static_cast<U>(0xDC00u|(c&0x3FFu));
+					dst+=2;
+				}
+			}
+		}
+		else
+		{
+			__builtin_memcpy(dst,__builtin_addressof(cp),16u);
+			dst+=e.count;
+		}
+	}
+	return {src+e.consumed,dst};
+}
+
+template<::std::integral T>
+inline constexpr bool utf8_simd_is_continuation(T ch) noexcept
+{
+	return (static_cast<char8_t>(ch)&0xC0u)==0x80u;
+}
+
+/*
+The scalar DFA handles a block the validator rejected. It never resumes the vector loop on a continuation byte, so the
+next block again starts at a code point boundary as the DFA sees it.
+*/
+template<::std::integral T,::std::integral U>
+inline code_cvt_result<T,U> utf8_simd_scalar_block(T const* first,T const* block_last,T const* last,U* dst) noexcept
+{
+	do
+	{
+		auto [src,code]=advance_with_big_table_unchecked(first);
+		first=src;
+		if constexpr(sizeof(U)==4)
+		{
+			*dst=code;
+			++dst;
+		}
+		else
+			dst+=get_utf_code_units<encoding_scheme::utf>(code,dst);
+	}
+	while(4u<=static_cast<::std::size_t>(last-first)&&(first<block_last||utf8_simd_is_continuation(*first)));
+	return {first,dst};
+}
+
+inline constexpr ::std::size_t utf8_simd_block_size{64u};
+inline constexpr ::std::size_t utf8_simd_window_last_start{utf8_simd_block_size-12u};
+inline constexpr ::std::size_t utf8_simd_min_input{96u};
+
+template<::std::integral T,::std::integral U>
+[[__gnu__::__target__("avx2")]]
+inline T const* utf8_simd_convert_block_avx2(T const* first,::std::uint_least64_t continuation,U*& dst) noexcept
+{
+	::std::uint_least64_t const end_mask{(~continuation)>>1u};
+	T const* const block_first{first};
+	for(::std::size_t pos{};pos<utf8_simd_window_last_start;pos=static_cast<::std::size_t>(first-block_first))
+	{
+		auto [src,new_dst]=utf8_simd_convert_window_avx2(first,end_mask>>pos,dst);
+		first=src;
+		dst=new_dst;
+	}
+	return first;
+}
+
+template<::std::integral T,::std::integral U>
+requires (sizeof(T)==1&&(sizeof(U)==2||sizeof(U)==4))
+[[__gnu__::__target__("avx2")]]
+inline code_cvt_result<T,U> utf8_to_utf16_or_32_avx2_impl(T const* first,T const* last,U* dst) noexcept
+{
+	while(utf8_simd_min_input<=static_cast<::std::size_t>(last-first))
+	{
+		utf_simd_u8x32 v0,v1;
+		__builtin_memcpy(__builtin_addressof(v0),first,32u);
+		__builtin_memcpy(__builtin_addressof(v1),first+32,32u);
+		if(__builtin_ia32_pmovmskb256((utf_simd_i8x32)(v0|v1))==0)
+		{
+			if constexpr(sizeof(U)==2)
+			{
+				utf_simd_u16x16 w{__builtin_convertvector(__builtin_shufflevector(v0,v0,
+					0,1,2,3,4,5,6,7,8,9,10,11,12,13,14,15),utf_simd_u16x16)};
+				__builtin_memcpy(dst,__builtin_addressof(w),32u);
+				w=__builtin_convertvector(__builtin_shufflevector(v0,v0,
+					16,17,18,19,20,21,22,23,24,25,26,27,28,29,30,31),utf_simd_u16x16);
+				__builtin_memcpy(dst+16,__builtin_addressof(w),32u);
+				w=__builtin_convertvector(__builtin_shufflevector(v1,v1,
+					0,1,2,3,4,5,6,7,8,9,10,11,12,13,14,15),utf_simd_u16x16);
+				__builtin_memcpy(dst+32,__builtin_addressof(w),32u);
+				w=__builtin_convertvector(__builtin_shufflevector(v1,v1,
+					16,17,18,19,20,21,22,23,24,25,26,27,28,29,30,31),utf_simd_u16x16);
+				__builtin_memcpy(dst+48,__builtin_addressof(w),32u);
+			}
+			else
+			{
+				for(::std::size_t i{};i!=utf8_simd_block_size;i+=8u)
+				{
+					utf_simd_u8x8 b;
+					__builtin_memcpy(__builtin_addressof(b),first+i,8u);
+					utf_simd_u32x8 const w{__builtin_convertvector(b,utf_simd_u32x8)};
+					__builtin_memcpy(dst+i,__builtin_addressof(w),32u);
+				}
+			}
+			first+=utf8_simd_block_size;
+			dst+=utf8_simd_block_size;
+			continue;
+		}
+		utf_simd_u8x32 const zero{};
+		utf_simd_u8x32 const err{utf8_simd_check_avx2(v0,zero)|utf8_simd_check_avx2(v1,v0)};
+		if(!__builtin_ia32_ptestz256((utf_simd_i64x4)err,(utf_simd_i64x4)err))
+		{
+			auto [src,new_dst]=utf8_simd_scalar_block(first,first+utf8_simd_block_size,last,dst);
+			first=src;
+			dst=new_dst;
+			continue;
+		}
+		::std::uint_least64_t const continuation{
+			static_cast<::std::uint_least64_t>(static_cast<::std::uint_least32_t>(
+				__builtin_ia32_pmovmskb256((utf_simd_i8x32)((utf_simd_s8x32)v0<-64))))|
+			(static_cast<::std::uint_least64_t>(static_cast<::std::uint_least32_t>(
+				__builtin_ia32_pmovmskb256((utf_simd_i8x32)((utf_simd_s8x32)v1<-64))))<<32u)};
+		first=utf8_simd_convert_block_avx2(first,continuation,dst);
+	}
+	return {first,dst};
+}
+
+template<::std::integral T,::std::integral U>
+requires (sizeof(T)==1&&(sizeof(U)==2||sizeof(U)==4))
+[[__gnu__::__target__("avx512bw")]]
+inline code_cvt_result<T,U> utf8_to_utf16_or_32_avx512bw_impl(T const* first,T const* last,U* dst) noexcept
+{
+	while(utf8_simd_min_input<=static_cast<::std::size_t>(last-first))
+	{
+		utf_simd_u8x64 v;
+		__builtin_memcpy(__builtin_addressof(v),first,64u);
+		if(__builtin_ia32_cvtb2mask512((utf_simd_i8x64)v)==0)
+		{
+			if constexpr(sizeof(U)==2)
+			{
+				utf_simd_u16x32 w{__builtin_convertvector(__builtin_shufflevector(v,v,
+					0,1,2,3,4,5,6,7,8,9,10,11,12,13,14,15,16,17,18,19,20,21,22,23,24,25,26,27,28,29,30,31),utf_simd_u16x32)};
+				__builtin_memcpy(dst,__builtin_addressof(w),64u);
+				w=__builtin_convertvector(__builtin_shufflevector(v,v,
+					32,33,34,35,36,37,38,39,40,41,42,43,44,45,46,47,48,49,50,51,52,53,54,55,56,57,58,59,60,61,62,63),utf_simd_u16x32);
+				__builtin_memcpy(dst+32,__builtin_addressof(w),64u);
+			}
+			else
+			{
+				for(::std::size_t i{};i!=utf8_simd_block_size;i+=16u)
+				{
+					utf_simd_u8x16 b;
+					__builtin_memcpy(__builtin_addressof(b),first+i,16u);
+					utf_simd_u32x16 const w{__builtin_convertvector(b,utf_simd_u32x16)};
+					__builtin_memcpy(dst+i,__builtin_addressof(w),64u);
+				}
+			}
+			first+=utf8_simd_block_size;
+			dst+=utf8_simd_block_size;
+			continue;
+		}
+		utf_simd_u8x64 const err{utf8_simd_check_avx512bw(v)};
+		if(__builtin_ia32_cvtb2mask512((utf_simd_i8x64)(err!=0))!=0)
+		{
+			auto [src,new_dst]=utf8_simd_scalar_block(first,first+utf8_simd_block_size,last,dst);
+			first=src;
+			dst=new_dst;
+			continue;
+		}
+		::std::uint_least64_t const continuation{static_cast<::std::uint_least64_t>(
+			__builtin_ia32_cvtb2mask512((utf_simd_i8x64)((utf_simd_s8x64)v<-64)))};
+		first=utf8_simd_convert_block_avx2(first,continuation,dst);
+	}
+	return {first,dst};
+}
+
+/*
+Encodes eight code points below 0x10000 (surrogate code points included, as the scalar encoder does) and packs the
+1-3 byte sequences of each half with one shuffle.
+*/
+template<::std::integral U>
+[[__gnu__::__target__("avx2")]]
+inline U* utf_simd_bmp_to_utf8_avx2(utf_simd_u32x8 c,U* dst) noexcept
+{
+	utf_simd_u32x8 const ge80{(utf_simd_u32x8)(0x7Fu<c)};
+	utf_simd_u32x8 const ge800{(utf_simd_u32x8)(0x7FFu<c)};
+	utf_simd_u32x8 const two{(0xC0u|(c>>6))|((0x80u|(c&0x3Fu))<<8)};
+	utf_simd_u32x8 const three{(0xE0u|(c>>12))|((0x80u|((c>>6)&0x3Fu))<<8)|((0x80u|(c&0x3Fu))<<16)};
+	utf_simd_u32x8 const word{(c&~ge80)|(two&ge80&~ge800)|(three&ge800)};
+	unsigned const m80{static_cast<unsigned>(__builtin_ia32_movmskps256((utf_simd_f32x8)ge80))};
+	unsigned const m800{static_cast<unsigned>(__builtin_ia32_movmskps256((utf_simd_f32x8)ge800))};
+	utf_simd_u8x32 const bytes{(utf_simd_u8x32)word};
+	auto const& lo{utf_simd_utf8_pack_tb[(m80&0xFu)|((m800&0xFu)<<4u)]};
+	auto const& hi{utf_simd_utf8_pack_tb[(m80>>4u)|(m800&0xF0u)]};
+	utf_simd_u8x16 sh;
+	__builtin_memcpy(__builtin_addressof(sh),lo.bytes,16u);
+	utf_simd_u8x16 packed{(utf_simd_u8x16)__builtin_ia32_pshufb128(
+		(utf_simd_i8x16)__builtin_shufflevector(bytes,bytes,0,1,2,3,4,5,6,7,8,9,10,11,12,13,14,15),(utf_simd_i8x16)sh)};
+	__builtin_memcpy(dst,__builtin_addressof(packed),16u);
+	dst+=lo.length;
+	__builtin_memcpy(__builtin_addressof(sh),hi.bytes,16u);
+	packed=(utf_simd_u8x16)__builtin_ia32_pshufb128(
+		(utf_simd_i8x16)__builtin_shufflevector(bytes,bytes,16,17,18,19,20,21,22,23,24,25,26,27,28,29,30,31),(utf_simd_i8x16)sh);
+	__builtin_memcpy(dst,__builtin_addressof(packed),16u);
+	return dst+hi.length;
+}
+
+template<::std::integral U>
+[[__gnu__::__target__("avx2")]]
+inline U* utf_simd_supplementary_to_utf8_avx2(utf_simd_u32x8 cp,U* dst) noexcept
+{
+	utf_simd_u32x8 const word{(0xF0u|(cp>>18))|((0x80u|((cp>>12)&0x3Fu))<<8)|
+		((0x80u|((cp>>6)&0x3Fu))<<16)|((0x80u|(cp&0x3Fu))<<24)};
+	__builtin_memcpy(dst,__builtin_addressof(word),32u);
+	return dst+32;
+}
+
+[[__gnu__::__target__("avx2")]]
+inline bool utf_simd_all_zero_avx2(utf_simd_u32x8 v) noexcept
+{
+	return __builtin_ia32_ptestz256((utf_simd_i64x4)v,(utf_simd_i64x4)v);
+}
+
+template<::std::integral T,::std::integral U>
+requires (sizeof(T)==2&&sizeof(U)==1)
+[[__gnu__::__target__("avx2")]]
+inline code_cvt_result<T,U> utf16_to_utf8_avx2_impl(T const* first,T const* last,U* dst) noexcept
+{
+	while(16u<=static_cast<::std::size_t>(last-first))
+	{
+		utf_simd_u16x16 v;
+		__builtin_memcpy(__builtin_addressof(v),first,32u);
+		if(utf_simd_all_zero_avx2((utf_simd_u32x8)(v&0xFF80u)))
+		{
+			utf_simd_u8x16 const b{__builtin_convertvector(v,utf_simd_u8x16)};
+			__builtin_memcpy(dst,__builtin_addressof(b),16u);
+			first+=16;
+			dst+=16;
+			continue;
+		}
+		utf_simd_u32x8 const pairs{(utf_simd_u32x8)v};
+		if(utf_simd_all_zero_avx2((utf_simd_u32x8)((pairs&0xFC00FC00u)!=0xDC00D800u)))
+		{
+			dst=utf_simd_supplementary_to_utf8_avx2(((pairs&0xFFFFu)<<10)+(pairs>>16)-0x35FDC00u,dst);
+			first+=16;
+			continue;
+		}
+		utf_simd_u16x8 const half{__builtin_shufflevector(v,v,0,1,2,3,4,5,6,7)};
+		utf_simd_u32x8 const c{__builtin_convertvector(half,utf_simd_u32x8)};
+		if(utf_simd_all_zero_avx2((utf_simd_u32x8)((c&0xF800u)==0xD800u)))
+		{
+			dst=utf_simd_bmp_to_utf8_avx2(c,dst);
+			first+=8;
+			continue;
+		}
+		for(T const* const chunk_last{first+8};first<chunk_last;)
+		{
+			char16_t const code{static_cast<char16_t>(*first)};
+			++first;
+			if(!is_utf16_surrogate(code))
+			{
+				dst+=get_utf_code_units<encoding_scheme::utf>(code,dst);
+				continue;
+			}
+			if(is_utf16_high_surrogate(code))
+			{
+				char16_t const code1{static_cast<char16_t>(*first)};
+				++first;
+				if(is_utf16_low_surrogate(code1))
+				{
+					dst+=get_utf_code_units<encoding_scheme::utf>(utf16_surrogate_to_utf32(code,code1),dst);
+					continue;
+				}
+			}
+			dst+=get_utf8_invalid_code_units(dst);
+		}
+	}
+	return {first,dst};
+}
+
+template<::std::integral T,::std::integral U>
+requires (sizeof(T)==4&&sizeof(U)==1)
+[[__gnu__::__target__("avx2")]]
+inline code_cvt_result<T,U> utf32_to_utf8_avx2_impl(T const* first,T const* last,U* dst) noexcept
+{
+	for(;8u<=static_cast<::std::size_t>(last-first);first+=8)
+	{
+		utf_simd_u32x8 c;
+		__builtin_memcpy(__builtin_addressof(c),first,32u);
+		if(utf_simd_all_zero_avx2(c&0xFFFFFF80u))
+		{
+			utf_simd_u8x8 const b{__builtin_convertvector(c,utf_simd_u8x8)};
+			__builtin_memcpy(dst,__builtin_addressof(b),8u);
+			dst+=8;
+		}
+		else if(utf_simd_all_zero_avx2(c&0xFFFF0000u))
+			dst=utf_simd_bmp_to_utf8_avx2(c,dst);
+		else if(utf_simd_all_zero_avx2((utf_simd_u32x8)(0xFFFFFu<(c-0x10000u))))
+			dst=utf_simd_supplementary_to_utf8_avx2(c,dst);
+		else
+		{
+			for(::std::size_t i{};i!=8u;++i)
+				dst+=get_utf_code_units<encoding_scheme::utf>(static_cast<char32_t>(first[i]),dst);
+		}
+	}
+	return {first,dst};
+}
+
+#endif
+#endif
+
+/*
+Each entry converts a prefix of [first,last) and returns where it stopped; the caller finishes the tail with the scalar
+code. The UTF-16/32 to UTF-8 directions only have AVX2 kernels, which AVX-512 machines use as well.
+*/
+template<::std::integral T,::std::integral U>
+inline code_cvt_result<T,U> utf8_to_utf16_or_32_simd(T const* first,T const* last,U* dst) noexcept
+{
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#if __has_builtin(__builtin_shufflevector) && __has_builtin(__builtin_convertvector)
+	if constexpr(::fast_io::details::cpu_flags::runtime_dispatch_supported)
+	{
+		switch(::fast_io::details::cpu_flags::get_runtime_simd_level())
+		{
+		case ::fast_io::details::cpu_flags::runtime_simd_level::avx512bw:
+			return utf8_to_utf16_or_32_avx512bw_impl(first,last,dst);
+		case ::fast_io::details::cpu_flags::runtime_simd_level::avx2:
+			return utf8_to_utf16_or_32_avx2_impl(first,last,dst);
+		default:
+			break;
+		}
+	}
+	else
+	{
+#if defined(__AVX512BW__)
+		return utf8_to_utf16_or_32_avx512bw_impl(first,last,dst);
+#elif defined(__AVX2__)
+		return utf8_to_utf16_or_32_avx2_impl(first,last,dst);
+#endif
+	}
+#endif
+#endif
+	return {first,dst};
+}
+
+template<::std::integral T,::std::integral U>
+inline code_cvt_result<T,U> utf16_or_32_to_utf8_simd(T const* first,T const* last,U* dst) noexcept
+{
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#if __has_builtin(__builtin_shufflevector) && __has_builtin(__builtin_convertvector)
+	bool has_avx2;
+	if constexpr(::fast_io::details::cpu_flags::runtime_dispatch_supported)
+		has_avx2=::fast_io::details::cpu_flags::get_runtime_simd_level()!=::fast_io::details::cpu_flags::runtime_simd_level::baseline;
+	else
+	{
+#if defined(__AVX2__)
+		has_avx2=true;
+#else
+		has_avx2=false;
+#endif
+	}
+	if(has_avx2)
+	{
+		if constexpr(sizeof(T)==2)
+			return utf16_to_utf8_avx2_impl(first,last,dst);
+		else
+			return utf32_to_utf8_avx2_impl(first,last,dst);
+	}
+#endif
+#endif
+	return {first,dst};
+}
+
+}
@@ -39,6 +39,38 @@ concept value_based_decorator = requires(T t)
 {
 	{deco_value_handle(t)};
 };
+
+/*
+A decorator that can still produce output from input it was given earlier (a decompressor whose output did not fit,
+for example). Input buffers ask it for more with an empty range before reading again.
+*/
+template<typename to_value_type,typename T>
+concept pending_decorator = requires(T& t)
+{
+	{deco_pending(io_reserve_type<to_value_type,T>,t)}->std::convertible_to<bool>;
+};
+
+/*
+A decorator that must see the end of its input (a record-framed cipher, for example). Input buffers call deco_eof once
+the source reports end of file; it throws when the stream stopped in the middle of a unit.
+*/
+template<typename to_value_type,typename T>
+concept eof_decorator = requires(T& t)
+{
+	deco_eof(io_reserve_type<to_value_type,T>,t);
+};
+
+/*
+An output decorator that appends a trailer when the stream ends (a final record, for example). Output buffers write
+deco_finish_size elements produced by deco_finish_define when they close, after the last flush. A decorator that has
+nothing left to write returns 0.
+*/
+template<typename to_value_type,typename T>
+concept finish_decorator = requires(T& t,to_value_type* p)
+{
+	{deco_finish_size(io_reserve_type<to_value_type,T>,t)}->std::convertible_to<std::size_t>;
+	{deco_finish_define(io_reserve_type<to_value_type,T>,t,p)}->std::convertible_to<to_value_type*>;
+};
 #if 0
 template<typename to_value_type,typename T>
 concept unshift_decorator = decorator<to_value_type,T>&&requires(T t,to_value_type const* from_iter,to_value_type const* to_iter)
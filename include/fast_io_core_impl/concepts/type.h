@@ -42,6 +42,16 @@ struct basic_message_hdr
 using message_hdr = basic_message_hdr<void>;
 //should be binary compatible with POSIX's msghdr
 
+/*
+Platforms specialize these to tell async_coro.h which scheduler drives a stream and
+which overlapped (completion callback) object an in-flight operation carries.
+*/
+template<typename T>
+struct io_async_scheduler_t;
+
+template<typename T>
+struct io_async_overlapped_t;
+
 template<typename T>
 struct io_type_t
 {
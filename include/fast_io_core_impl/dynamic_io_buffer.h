@@ -5,11 +5,12 @@
 namespace fast_io
 {
 
-template<std::integral ch_type>
+template<std::integral ch_type,typename alloc_type = ::fast_io::native_thread_local_allocator>
 class dynamic_io_buffer
 {
 public:
 	using char_type = ch_type;
+	using allocator_type = alloc_type;
 	using pointer = char_type*;
 	pointer buffer_begin=nullptr,buffer_curr=nullptr,buffer_end=nullptr;
 	constexpr dynamic_io_buffer()=default;
@@ -20,30 +21,30 @@ public:
 #endif
 	~dynamic_io_buffer()
 	{
-		details::deallocate_iobuf_space<false,char_type>(buffer_begin,buffer_end-buffer_begin);
+		details::deallocate_iobuf_space<false,char_type,allocator_type>(buffer_begin,buffer_end-buffer_begin);
 	}
 };
 
-template<std::integral char_type>
-[[nodiscard]] constexpr char_type* obuffer_begin(dynamic_io_buffer<char_type>& ob) noexcept
+template<std::integral char_type,typename allocator_type>
+[[nodiscard]] constexpr char_type* obuffer_begin(dynamic_io_buffer<char_type,allocator_type>& ob) noexcept
 {
 	return ob.buffer_begin;
 }
 
-template<std::integral char_type>
-[[nodiscard]] constexpr char_type* obuffer_curr(dynamic_io_buffer<char_type>& ob) noexcept
+template<std::integral char_type,typename allocator_type>
+[[nodiscard]] constexpr char_type* obuffer_curr(dynamic_io_buffer<char_type,allocator_type>& ob) noexcept
 {
 	return ob.buffer_curr;
 }
 
-template<std::integral char_type>
-[[nodiscard]] constexpr char_type* obuffer_end(dynamic_io_buffer<char_type>& ob) noexcept
+template<std::integral char_type,typename allocator_type>
+[[nodiscard]] constexpr char_type* obuffer_end(dynamic_io_buffer<char_type,allocator_type>& ob) noexcept
 {
 	return ob.buffer_end;
 }
 
-template<std::integral char_type>
-inline constexpr void obuffer_set_curr(dynamic_io_buffer<char_type>& ob,char_type* ptr) noexcept
+template<std::integral char_type,typename allocator_type>
+inline constexpr void obuffer_set_curr(dynamic_io_buffer<char_type,allocator_type>& ob,char_type* ptr) noexcept
 {
 	ob.buffer_curr=ptr;
 }
@@ -51,20 +52,20 @@ inline constexpr void obuffer_set_curr(dynamic_io_buffer<char_type>& ob,char_typ
 namespace details
 {
 
-template<std::integral char_type>
-inline constexpr void dynamic_io_buffer_oreallocate_impl(dynamic_io_buffer<char_type>& ob,std::size_t size) noexcept
+template<std::integral char_type,typename allocator_type>
+inline constexpr void dynamic_io_buffer_oreallocate_impl(dynamic_io_buffer<char_type,allocator_type>& ob,std::size_t size) noexcept
 {
-	auto new_space{allocate_iobuf_space<char_type>(size)};
+	auto new_space{allocate_iobuf_space<char_type,allocator_type>(size)};
 	std::size_t ptr_diff{static_cast<std::size_t>(ob.buffer_curr-ob.buffer_begin)};
 	non_overlapped_copy_n(ob.buffer_begin,ptr_diff,new_space);
-	deallocate_iobuf_space<false,char_type>(ob.buffer_begin,ob.buffer_end-ob.buffer_begin);
+	deallocate_iobuf_space<false,char_type,allocator_type>(ob.buffer_begin,ob.buffer_end-ob.buffer_begin);
 	ob.buffer_begin=new_space;
 	ob.buffer_curr=new_space+ptr_diff;
 	ob.buffer_end=new_space+size;
 }
 
-template<std::integral char_type>
-inline constexpr void dynamic_io_buffer_grow_with_new_size(dynamic_io_buffer<char_type>& ob,std::size_t new_size) noexcept
+template<std::integral char_type,typename allocator_type>
+inline constexpr void dynamic_io_buffer_grow_with_new_size(dynamic_io_buffer<char_type,allocator_type>& ob,std::size_t new_size) noexcept
 {
 	std::size_t new_capacity{static_cast<std::size_t>(ob.buffer_end-ob.buffer_begin)};
 	constexpr std::size_t cap_max{SIZE_MAX/2}; 
@@ -77,30 +78,24 @@ inline constexpr void dynamic_io_buffer_grow_with_new_size(dynamic_io_buffer<cha
 	dynamic_io_buffer_oreallocate_impl(ob,new_capacity);
 }
 
-template<std::integral char_type>
-inline constexpr void dynamic_io_buffer_overflow_impl(dynamic_io_buffer<char_type>& ob,char_type ch) noexcept
+template<std::integral char_type,typename allocator_type>
+inline constexpr void dynamic_io_buffer_overflow_impl(dynamic_io_buffer<char_type,allocator_type>& ob,char_type ch) noexcept
 {
-	std::size_t new_capacity{static_cast<std::size_t>(ob.buffer_end-ob.buffer_begin)};
-	constexpr std::size_t cap_max{SIZE_MAX/2}; 
-	if(new_capacity>cap_max)
-		new_capacity=SIZE_MAX;
-	else
-		new_capacity*=2;
-	dynamic_io_buffer_oreallocate_impl(ob,new_capacity);
+	dynamic_io_buffer_grow_with_new_size(ob,static_cast<std::size_t>(ob.buffer_end-ob.buffer_begin)+1u);
 	*ob.buffer_curr=ch;
 	++ob.buffer_curr;
 }
 
-template<std::integral char_type,::std::forward_iterator Iter>
-inline constexpr void dynamic_io_buffer_write_impl_unhappy_iter(dynamic_io_buffer<char_type>& ob,
+template<std::integral char_type,typename allocator_type,::std::forward_iterator Iter>
+inline constexpr void dynamic_io_buffer_write_impl_unhappy_iter(dynamic_io_buffer<char_type,allocator_type>& ob,
 	Iter first,std::size_t diff) noexcept
 {
 	dynamic_io_buffer_grow_with_new_size(ob,ob.buffer_end-ob.buffer_begin+diff);
 	ob.buffer_curr=non_overlapped_copy_n(first,diff,ob.buffer_curr);
 }
 
-template<::std::forward_iterator Iter>
-inline constexpr void dynamic_io_buffer_write_impl_unhappy(dynamic_io_buffer<::std::iter_value_t<Iter>>& ob,
+template<typename allocator_type,::std::forward_iterator Iter>
+inline constexpr void dynamic_io_buffer_write_impl_unhappy(dynamic_io_buffer<::std::iter_value_t<Iter>,allocator_type>& ob,
 	Iter first,std::size_t diff) noexcept
 {
 	if constexpr(::std::contiguous_iterator<Iter>)
@@ -113,32 +108,32 @@ inline constexpr void dynamic_io_buffer_write_impl_unhappy(dynamic_io_buffer<::s
 }
 
 }
-template<std::integral ch_type>
-inline constexpr void oreserve(dynamic_io_buffer<ch_type>& ob,std::size_t new_capacity)  noexcept
+template<std::integral ch_type,typename allocator_type>
+inline constexpr void oreserve(dynamic_io_buffer<ch_type,allocator_type>& ob,std::size_t new_capacity)  noexcept
 {
-	if(static_cast<std::size_t>(ob.buffer_end-ob.buffer_begin)<=new_capacity)
+	if(new_capacity<=static_cast<std::size_t>(ob.buffer_end-ob.buffer_begin))
 		return;
 	details::dynamic_io_buffer_oreallocate_impl(ob,new_capacity);
 }
 
-template<std::integral ch_type>
-inline constexpr void oshrink_to_fit(dynamic_io_buffer<ch_type>& ob)  noexcept
+template<std::integral ch_type,typename allocator_type>
+inline constexpr void oshrink_to_fit(dynamic_io_buffer<ch_type,allocator_type>& ob)  noexcept
 {
 	if(ob.buffer_curr==ob.buffer_end)
 		return;
 	details::dynamic_io_buffer_oreallocate_impl(ob,ob.buffer_curr-ob.buffer_begin);
 }
 
-template<std::integral ch_type>
-inline constexpr void obuffer_overflow(dynamic_io_buffer<ch_type>& ob,ch_type ch) noexcept
+template<std::integral ch_type,typename allocator_type>
+inline constexpr void obuffer_overflow(dynamic_io_buffer<ch_type,allocator_type>& ob,ch_type ch) noexcept
 {
 	details::dynamic_io_buffer_overflow_impl(ob,ch);
 }
 
-template<std::integral ch_type,::std::forward_iterator Iter>
+template<std::integral ch_type,typename allocator_type,::std::forward_iterator Iter>
 requires ((std::same_as<ch_type,char>&&::std::contiguous_iterator<Iter>)||
 	std::same_as<ch_type,::std::iter_value_t<Iter>>)
-inline constexpr void write(dynamic_io_buffer<ch_type>& ob,Iter first,Iter last) noexcept
+inline constexpr void write(dynamic_io_buffer<ch_type,allocator_type>& ob,Iter first,Iter last) noexcept
 {
 	if constexpr(!std::same_as<ch_type,::std::iter_value_t<Iter>>)
 	{
@@ -159,7 +154,7 @@ inline constexpr void write(dynamic_io_buffer<ch_type>& ob,Iter first,Iter last)
 			details::dynamic_io_buffer_write_impl_unhappy(ob,first,diff);
 			return;
 		}
-		ob.buffer_curr=details::non_overlapped_copy(first,last,ob.buffer_begin);
+		ob.buffer_curr=details::non_overlapped_copy(first,last,ob.buffer_curr);
 	}
 }
 
@@ -739,6 +739,7 @@ rotate(ForwardIt first, ForwardIt middle,
 }
 
 template <::std::bidirectional_iterator BidIt1, typename T>
+	requires(!::std::integral<T>)
 inline constexpr BidIt1 find_not(BidIt1 first, BidIt1 last, T const &val)
 {
 	for (; first != last && *first == val; ++first)
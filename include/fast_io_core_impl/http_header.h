@@ -3,17 +3,58 @@
 namespace fast_io
 {
 
+template<std::integral char_type>
+struct basic_http_line
+{
+	::fast_io::manipulators::basic_os_str_known_size_without_null_terminated<char_type> key,value;
+};
+
+/*
+Header fields beyond this many make the header invalid, the same limit picohttpparser users typically pick.
+*/
+inline constexpr std::size_t http_header_field_capacity{100u};
+
+/*
+Open-addressing table from the case-folded name hash to the field index plus one. Kept at most 40% full.
+*/
+inline constexpr std::size_t http_header_field_table_size{256u};
+
+template<std::unsigned_integral offset_type>
+struct http_header_field_location
+{
+	offset_type name_start;
+	offset_type name_end;
+	offset_type value_start;
+	offset_type value_end;
+};
+
 template<std::integral ch_type,std::size_t buffer_size=4096u>
 requires (buffer_size>=64u)
 struct basic_http_header_buffer
 {
 	using char_type = ch_type;
+	using field_offset_type = ::std::conditional_t<(buffer_size<=::std::numeric_limits<::std::uint_least16_t>::max()),::std::uint_least16_t,
+		::std::conditional_t<(buffer_size<=::std::numeric_limits<::std::uint_least32_t>::max()),::std::uint_least32_t,std::size_t>>;
+	static inline constexpr std::size_t npos{static_cast<std::size_t>(-1)};
 	std::size_t header_length{};
 	std::size_t http_request_end_location{};
 	std::size_t http_status_code_start_location{};
 	std::size_t http_status_code_end_location{};
 	std::size_t http_status_reason_start_location{};
 	std::size_t http_status_reason_end_location{};
+	/*
+	Filled in by the same scan that finds the end of the header. Values have surrounding whitespace removed.
+	*/
+	std::size_t field_count{};
+	std::uint_least64_t content_length{};
+	bool has_content_length{};
+	bool has_transfer_encoding{};
+	bool chunked{};
+	bool connection_close{};
+	bool connection_keep_alive{};
+	bool connection_upgrade{};
+	http_header_field_location<field_offset_type> fields[http_header_field_capacity];
+	::std::uint_least8_t field_table[http_header_field_table_size];
 	char_type buffer[buffer_size];
 	inline static constexpr std::size_t size() noexcept
 	{
@@ -31,6 +72,83 @@ struct basic_http_header_buffer
 	{
 		return ::fast_io::manipulators::os_str_known_size_without_null_terminated<char_type>(buffer+http_status_reason_start_location,buffer+http_status_reason_end_location);
 	}
+	inline constexpr std::size_t field_size() const noexcept
+	{
+		return field_count;
+	}
+	inline constexpr basic_http_line<char_type> field(std::size_t i) const noexcept
+	{
+		auto const& loc{fields[i]};
+		return {::fast_io::manipulators::os_str_known_size_without_null_terminated<char_type>(buffer+loc.name_start,buffer+loc.name_end),
+			::fast_io::manipulators::os_str_known_size_without_null_terminated<char_type>(buffer+loc.value_start,buffer+loc.value_end)};
+	}
+	/*
+	Index of the first field named name, compared case-insensitively, or npos.
+	*/
+	inline constexpr std::size_t find(char_type const* name,std::size_t n) const noexcept;
+	template<std::size_t n>
+	inline constexpr std::size_t find(char_type const (&name)[n]) const noexcept
+	{
+		return this->find(name,n-1);
+	}
+};
+
+/*
+A header block parsed in place by basic_http_request_scanner, with the same locations and field index as
+basic_http_header_buffer. buffer points into the scanner's input buffer or its spill buffer and stays valid until
+the scanner is asked for the next request.
+*/
+template<std::integral ch_type>
+struct basic_http_header_view
+{
+	using char_type = ch_type;
+	using field_offset_type = ::std::uint_least32_t;
+	static inline constexpr std::size_t npos{static_cast<std::size_t>(-1)};
+	std::size_t header_length{};
+	std::size_t http_request_end_location{};
+	std::size_t http_status_code_start_location{};
+	std::size_t http_status_code_end_location{};
+	std::size_t http_status_reason_start_location{};
+	std::size_t http_status_reason_end_location{};
+	std::size_t field_count{};
+	std::uint_least64_t content_length{};
+	bool has_content_length{};
+	bool has_transfer_encoding{};
+	bool chunked{};
+	bool connection_close{};
+	bool connection_keep_alive{};
+	bool connection_upgrade{};
+	http_header_field_location<field_offset_type> fields[http_header_field_capacity];
+	::std::uint_least8_t field_table[http_header_field_table_size];
+	char_type const* buffer{};
+	inline constexpr ::fast_io::manipulators::basic_os_str_known_size_without_null_terminated<char_type> request() const noexcept
+	{
+		return ::fast_io::manipulators::os_str_known_size_without_null_terminated<char_type>(buffer,buffer+http_request_end_location);
+	}
+	inline constexpr ::fast_io::manipulators::basic_os_str_known_size_without_null_terminated<char_type> code() const noexcept
+	{
+		return ::fast_io::manipulators::os_str_known_size_without_null_terminated<char_type>(buffer+http_status_code_start_location,buffer+http_status_code_end_location);
+	}
+	inline constexpr ::fast_io::manipulators::basic_os_str_known_size_without_null_terminated<char_type> reason() const noexcept
+	{
+		return ::fast_io::manipulators::os_str_known_size_without_null_terminated<char_type>(buffer+http_status_reason_start_location,buffer+http_status_reason_end_location);
+	}
+	inline constexpr std::size_t field_size() const noexcept
+	{
+		return field_count;
+	}
+	inline constexpr basic_http_line<char_type> field(std::size_t i) const noexcept
+	{
+		auto const& loc{fields[i]};
+		return {::fast_io::manipulators::os_str_known_size_without_null_terminated<char_type>(buffer+loc.name_start,buffer+loc.name_end),
+			::fast_io::manipulators::os_str_known_size_without_null_terminated<char_type>(buffer+loc.value_start,buffer+loc.value_end)};
+	}
+	inline constexpr std::size_t find(char_type const* name,std::size_t n) const noexcept;
+	template<std::size_t n>
+	inline constexpr std::size_t find(char_type const (&name)[n]) const noexcept
+	{
+		return this->find(name,n-1);
+	}
 };
 
 struct http_buffer_parse_context
@@ -50,6 +168,12 @@ inline constexpr basic_io_scatter_t<ch_type> print_alias_define(io_alias_t,basic
 	return {b.buffer,b.header_length};
 }
 
+template<std::integral ch_type>
+inline constexpr basic_io_scatter_t<ch_type> print_alias_define(io_alias_t,basic_http_header_view<ch_type> const& b) noexcept
+{
+	return {b.buffer,b.header_length};
+}
+
 namespace details
 {
 template<std::integral ch_type,std::size_t buffer_size,::std::integral char_type>
@@ -64,9 +188,253 @@ inline bool try_copy_into_buffer(basic_http_header_buffer<ch_type,buffer_size>&
 	return true;
 }
 
-template<std::integral ch_type,std::size_t buffer_size>
-inline constexpr parse_code determine_http_header_location(basic_http_header_buffer<ch_type,buffer_size>& b) noexcept
+template<::std::integral char_type>
+inline constexpr char_type http_header_name_fold(char_type ch) noexcept
+{
+	if(char_literal_v<u8'A',char_type><=ch&&ch<=char_literal_v<u8'Z',char_type>)
+		return static_cast<char_type>(ch-char_literal_v<u8'A',char_type>+char_literal_v<u8'a',char_type>);
+	return ch;
+}
+
+/*
+FNV-1a over the case-folded name.
+*/
+template<::std::integral char_type>
+inline constexpr std::size_t http_header_name_hash(char_type const* first,char_type const* last) noexcept
+{
+	using unsigned_char_type = ::std::make_unsigned_t<char_type>;
+	::std::uint_least32_t h{2166136261u};
+	for(;first!=last;++first)
+	{
+		h^=static_cast<::std::uint_least32_t>(static_cast<unsigned_char_type>(::fast_io::details::http_header_name_fold(*first)));
+		h*=16777619u;
+	}
+	return static_cast<std::size_t>(h);
+}
+
+template<::std::integral char_type>
+inline constexpr bool http_header_name_equal(char_type const* a,char_type const* b,std::size_t n) noexcept
 {
+	for(std::size_t i{};i!=n;++i)
+	{
+		if(::fast_io::details::http_header_name_fold(a[i])!=::fast_io::details::http_header_name_fold(b[i]))
+			return false;
+	}
+	return true;
+}
+
+/*
+Case-insensitive comparison against a lower-case ASCII token.
+*/
+template<::std::integral char_type,std::size_t n>
+inline constexpr bool http_header_token_is(char_type const* first,char_type const* last,char8_t const (&token)[n]) noexcept
+{
+	if(static_cast<std::size_t>(last-first)!=n-1)
+		return false;
+	for(std::size_t i{};i!=n-1;++i)
+	{
+		if(::fast_io::details::http_header_name_fold(first[i])!=::fast_io::char_literal<char_type>(token[i]))
+			return false;
+	}
+	return true;
+}
+
+template<::std::integral char_type>
+inline constexpr bool is_http_ows(char_type ch) noexcept
+{
+	return ch==char_literal_v<u8' ',char_type>||ch==char_literal_v<u8'\t',char_type>;
+}
+
+/*
+Calls func(first,last) for every comma-separated token of a list value, whitespace trimmed, empty tokens skipped.
+*/
+template<::std::integral char_type,typename Func>
+inline constexpr void http_header_for_each_token(char_type const* first,char_type const* last,Func func)
+{
+	while(first!=last)
+	{
+		auto token_end{::fast_io::details::find_ch_impl<u8',',false>(first,last)};
+		auto token_first{first};
+		auto token_last{token_end};
+		for(;token_first!=token_last&&::fast_io::details::is_http_ows(*token_first);++token_first);
+		for(;token_first!=token_last&&::fast_io::details::is_http_ows(token_last[-1]);--token_last);
+		if(token_first!=token_last)
+			func(token_first,token_last);
+		if(token_end==last)
+			break;
+		first=token_end+1;
+	}
+}
+
+template<::std::integral char_type>
+inline constexpr bool http_header_parse_content_length(char_type const* first,char_type const* last,::std::uint_least64_t& value) noexcept
+{
+	if(first==last)
+		return false;
+	::std::uint_least64_t v{};
+	for(;first!=last;++first)
+	{
+		char_type const ch{*first};
+		if(ch<char_literal_v<u8'0',char_type>||char_literal_v<u8'9',char_type><ch)
+			return false;
+		if(v>(::std::numeric_limits<::std::uint_least64_t>::max()-9u)/10u)
+			return false;
+		v=v*10u+static_cast<::std::uint_least64_t>(ch-char_literal_v<u8'0',char_type>);
+	}
+	value=v;
+	return true;
+}
+
+/*
+Content-Length (repeats must agree), Transfer-Encoding (chunked when it is the final coding across all its field
+lines) and Connection options are decoded while indexing so callers never have to look them up. The framing checks
+that need every field are done by index_http_header_fields.
+*/
+template<typename header_type>
+inline constexpr bool http_header_decode_known_field(header_type& b,typename header_type::char_type const* name,std::size_t name_size,
+	typename header_type::char_type const* vfirst,typename header_type::char_type const* vlast) noexcept
+{
+	using ch_type = typename header_type::char_type;
+	switch(name_size)
+	{
+	case 10:
+	{
+		if(::fast_io::details::http_header_token_is(name,name+name_size,u8"connection"))
+		{
+			::fast_io::details::http_header_for_each_token(vfirst,vlast,[&b](ch_type const* first,ch_type const* last) noexcept
+			{
+				if(::fast_io::details::http_header_token_is(first,last,u8"close"))
+					b.connection_close=true;
+				else if(::fast_io::details::http_header_token_is(first,last,u8"keep-alive"))
+					b.connection_keep_alive=true;
+				else if(::fast_io::details::http_header_token_is(first,last,u8"upgrade"))
+					b.connection_upgrade=true;
+			});
+		}
+		break;
+	}
+	case 14:
+	{
+		if(::fast_io::details::http_header_token_is(name,name+name_size,u8"content-length"))
+		{
+			::std::uint_least64_t v;
+			if(!::fast_io::details::http_header_parse_content_length(vfirst,vlast,v))
+				return false;
+			if(b.has_content_length&&b.content_length!=v)
+				return false;
+			b.content_length=v;
+			b.has_content_length=true;
+		}
+		break;
+	}
+	case 17:
+	{
+		if(::fast_io::details::http_header_token_is(name,name+name_size,u8"transfer-encoding"))
+		{
+			b.has_transfer_encoding=true;
+			::fast_io::details::http_header_for_each_token(vfirst,vlast,[&b](ch_type const* first,ch_type const* last) noexcept
+			{
+				b.chunked=::fast_io::details::http_header_token_is(first,last,u8"chunked");
+			});
+		}
+		break;
+	}
+	}
+	return true;
+}
+
+/*
+A status line starts with the protocol version, a request line with the method.
+*/
+template<typename header_type>
+inline constexpr bool http_header_is_response(header_type const& b) noexcept
+{
+	using ch_type = typename header_type::char_type;
+	auto const p{b.buffer};
+	return 5u<=b.http_request_end_location&&p[0]==char_literal_v<u8'H',ch_type>&&p[1]==char_literal_v<u8'T',ch_type>&&
+		p[2]==char_literal_v<u8'T',ch_type>&&p[3]==char_literal_v<u8'P',ch_type>&&p[4]==char_literal_v<u8'/',ch_type>;
+}
+
+/*
+Records name and value offsets of every field line after the start line. The scanner has already checked that
+every CR is followed by LF and that the block ends with an empty line.
+*/
+template<typename header_type>
+inline constexpr parse_code index_http_header_fields(header_type& b,typename header_type::char_type const* i) noexcept
+{
+	using ch_type = typename header_type::char_type;
+	using field_offset_type = typename header_type::field_offset_type;
+	b.field_count=0;
+	b.content_length=0;
+	b.has_content_length=b.has_transfer_encoding=b.chunked=b.connection_close=b.connection_keep_alive=b.connection_upgrade=false;
+	for(auto& e : b.field_table)
+		e=0;
+	constexpr std::size_t mask{http_header_field_table_size-1u};
+	ch_type const* const base{b.buffer};
+	ch_type const* const e{base+b.header_length};
+	for(;i!=e&&*i!=char_literal_v<u8'\r',ch_type>;)
+	{
+		auto const line_end{::fast_io::details::find_ch_impl<u8'\r',false>(i,e)};
+		if(e-line_end<2||line_end[1]!=char_literal_v<u8'\n',ch_type>)
+			return parse_code::invalid;
+		auto const name_end{::fast_io::details::find_ch_impl<u8':',false>(i,line_end)};
+		/*
+		RFC 9112 forbids whitespace before the colon and line folding; both are request smuggling vectors.
+		*/
+		if(name_end==line_end||name_end==i||::fast_io::details::is_http_ows(*i)||::fast_io::details::is_http_ows(name_end[-1]))
+			return parse_code::invalid;
+		auto vfirst{name_end+1};
+		auto vlast{line_end};
+		for(;vfirst!=vlast&&::fast_io::details::is_http_ows(*vfirst);++vfirst);
+		for(;vfirst!=vlast&&::fast_io::details::is_http_ows(vlast[-1]);--vlast);
+		std::size_t const index{b.field_count};
+		if(index==http_header_field_capacity)
+			return parse_code::invalid;
+		std::size_t const name_size{static_cast<std::size_t>(name_end-i)};
+		auto& loc{b.fields[index]};
+		loc.name_start=static_cast<field_offset_type>(i-base);
+		loc.name_end=static_cast<field_offset_type>(name_end-base);
+		loc.value_start=static_cast<field_offset_type>(vfirst-base);
+		loc.value_end=static_cast<field_offset_type>(vlast-base);
+		++b.field_count;
+		for(std::size_t slot{::fast_io::details::http_header_name_hash(i,name_end)&mask};;slot=(slot+1u)&mask)
+		{
+			std::size_t const occupant{b.field_table[slot]};
+			if(occupant==0)
+			{
+				b.field_table[slot]=static_cast<::std::uint_least8_t>(index+1u);
+				break;
+			}
+			auto const& other{b.fields[occupant-1u]};
+			if(static_cast<std::size_t>(other.name_end-other.name_start)==name_size&&
+				::fast_io::details::http_header_name_equal(base+other.name_start,i,name_size))
+			{
+				break;
+			}
+		}
+		if(!::fast_io::details::http_header_decode_known_field(b,i,name_size,vfirst,vlast))
+			return parse_code::invalid;
+		i=line_end+2;
+	}
+	/*
+	A message framed both ways is the classic request smuggling vector (RFC 9112 6.3): reject Content-Length next to
+	any Transfer-Encoding rather than guess which length a downstream peer will believe. A request body whose final
+	coding is not chunked has no length at all, so that is rejected too; a response like that runs until close.
+	*/
+	if(b.has_transfer_encoding)
+	{
+		if(b.has_content_length)
+			return parse_code::invalid;
+		if(!b.chunked&&!::fast_io::details::http_header_is_response(b))
+			return parse_code::invalid;
+	}
+	return parse_code::ok;
+}
+
+template<typename header_type>
+inline constexpr parse_code determine_http_header_location(header_type& b) noexcept
+{
+	using ch_type = typename header_type::char_type;
 	auto i{b.buffer},e{b.buffer+b.header_length};
 	if(i!=e&&*i==char_literal_v<u8' ',ch_type>)
 		return parse_code::invalid;
@@ -102,7 +470,9 @@ inline constexpr parse_code determine_http_header_location(basic_http_header_buf
 	if(i==e)
 		return parse_code::invalid;
 	b.http_status_reason_end_location=static_cast<std::size_t>(i-b.buffer);
-	return parse_code::ok;
+	if(e-i<2||i[1]!=char_literal_v<u8'\n',ch_type>)
+		return parse_code::invalid;
+	return ::fast_io::details::index_http_header_fields(b,i+2);
 }
 
 template<::std::integral char_type,std::size_t buffer_size>
@@ -213,14 +583,48 @@ inline constexpr parse_result<char_type const*> http_header_scan_context_define_
 
 }
 
+namespace details
+{
+
+template<typename header_type>
+inline constexpr std::size_t http_header_find_impl(header_type const& b,typename header_type::char_type const* name,std::size_t n) noexcept
+{
+	constexpr std::size_t mask{http_header_field_table_size-1u};
+	for(std::size_t slot{::fast_io::details::http_header_name_hash(name,name+n)&mask};;slot=(slot+1u)&mask)
+	{
+		std::size_t const occupant{b.field_table[slot]};
+		if(occupant==0)
+			return header_type::npos;
+		auto const& loc{b.fields[occupant-1u]};
+		if(static_cast<std::size_t>(loc.name_end-loc.name_start)==n&&
+			::fast_io::details::http_header_name_equal(b.buffer+loc.name_start,name,n))
+			return occupant-1u;
+	}
+}
+
+}
+
+template<std::integral ch_type,std::size_t buffer_size>
+requires (buffer_size>=64u)
+inline constexpr std::size_t basic_http_header_buffer<ch_type,buffer_size>::find(char_type const* name,std::size_t n) const noexcept
+{
+	return ::fast_io::details::http_header_find_impl(*this,name,n);
+}
+
+template<std::integral ch_type>
+inline constexpr std::size_t basic_http_header_view<ch_type>::find(char_type const* name,std::size_t n) const noexcept
+{
+	return ::fast_io::details::http_header_find_impl(*this,name,n);
+}
+
 template<::std::integral char_type,std::size_t buffer_size>
-inline constexpr parse_result<char_type const*> scan_context_define(io_reserve_type_t<char_type,::fast_io::parameter<basic_http_header_buffer<char_type,buffer_size>&>>,http_buffer_parse_context& statetp,char_type const* first1,char_type const* last,::fast_io::parameter<basic_http_header_buffer<char_type>&> t) noexcept
+inline constexpr parse_result<char_type const*> scan_context_define(io_reserve_type_t<char_type,::fast_io::parameter<basic_http_header_buffer<char_type,buffer_size>&>>,http_buffer_parse_context& statetp,char_type const* first1,char_type const* last,::fast_io::parameter<basic_http_header_buffer<char_type,buffer_size>&> t) noexcept
 {
 	return ::fast_io::details::http_header_scan_context_define_impl(statetp.state,first1,last,t.reference);
 }
 
 template<std::integral char_type,std::size_t buffer_size>
-inline constexpr parse_code scan_context_eof_define(io_reserve_type_t<char_type,::fast_io::parameter<basic_http_header_buffer<char_type>&>>,http_buffer_parse_context,::fast_io::parameter<basic_http_header_buffer<char_type,buffer_size>&>) noexcept
+inline constexpr parse_code scan_context_eof_define(io_reserve_type_t<char_type,::fast_io::parameter<basic_http_header_buffer<char_type,buffer_size>&>>,http_buffer_parse_context,::fast_io::parameter<basic_http_header_buffer<char_type,buffer_size>&>) noexcept
 {
 	return parse_code::invalid;
 }
@@ -231,6 +635,12 @@ using u16http_header_buffer = basic_http_header_buffer<char16_t>;
 using u32http_header_buffer = basic_http_header_buffer<char32_t>;
 using whttp_header_buffer = basic_http_header_buffer<wchar_t>;
 
+using http_header_view = basic_http_header_view<char>;
+using u8http_header_view = basic_http_header_view<char8_t>;
+using u16http_header_view = basic_http_header_view<char16_t>;
+using u32http_header_view = basic_http_header_view<char32_t>;
+using whttp_header_view = basic_http_header_view<wchar_t>;
+
 template<std::integral char_type>
 struct basic_http_line_generator
 {
@@ -241,12 +651,6 @@ struct basic_http_line_generator
 	char_type const* value_end{};
 };
 
-template<std::integral char_type>
-struct basic_http_line
-{
-	::fast_io::manipulators::basic_os_str_known_size_without_null_terminated<char_type> key,value;
-};
-
 template<std::integral char_type,std::size_t buffer_size>
 inline constexpr basic_http_line_generator<char_type> line_generator(basic_http_header_buffer<char_type,buffer_size>& b) noexcept
 {
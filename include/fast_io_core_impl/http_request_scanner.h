@@ -0,0 +1,193 @@
+#pragma once
+
+/*
+Pipelined HTTP/1.1 header scanning straight out of a buffered input stream. Each call to next() parses one header
+block into a basic_http_header_view and leaves the input positioned at the first byte after it, so the body and any
+further pipelined requests stay in the stream. When the whole block is already in the input buffer the view points
+into that buffer and nothing is copied; only a block that straddles a refill is gathered into a spill buffer that
+grows on demand up to max_header_size.
+*/
+
+namespace fast_io
+{
+
+inline constexpr std::size_t http_request_scanner_default_max_header_size{static_cast<std::size_t>(1)<<20u};
+
+namespace details
+{
+
+/*
+Position just past the first CRLFCRLF in [first,last), or nullptr.
+*/
+template<::std::integral char_type>
+inline constexpr char_type const* find_http_header_end(char_type const* first,char_type const* last) noexcept
+{
+	for(;;)
+	{
+		first=::fast_io::details::find_ch_impl<u8'\r',false>(first,last);
+		if(last-first<4)
+			return nullptr;
+		if(first[1]==char_literal_v<u8'\n',char_type>&&first[2]==char_literal_v<u8'\r',char_type>&&
+			first[3]==char_literal_v<u8'\n',char_type>)
+			return first+4;
+		++first;
+	}
+}
+
+/*
+A CRLFCRLF that starts in the last three characters already spilled and ends in [first,last). Returns how many
+characters of [first,last) complete it, or 0.
+*/
+template<::std::integral char_type>
+inline constexpr std::size_t http_header_end_straddle(char_type const* spill_first,char_type const* spill_last,char_type const* first,char_type const* last) noexcept
+{
+	char_type window[6];
+	std::size_t tail{static_cast<std::size_t>(spill_last-spill_first)};
+	if(3u<tail)
+		tail=3u;
+	std::size_t head{static_cast<std::size_t>(last-first)};
+	if(3u<head)
+		head=3u;
+	::fast_io::details::non_overlapped_copy_n(spill_last-tail,tail,window);
+	::fast_io::details::non_overlapped_copy_n(first,head,window+tail);
+	for(std::size_t i{};i!=tail;++i)
+	{
+		if(tail+head<i+4u)
+			break;
+		if(window[i]==char_literal_v<u8'\r',char_type>&&window[i+1]==char_literal_v<u8'\n',char_type>&&
+			window[i+2]==char_literal_v<u8'\r',char_type>&&window[i+3]==char_literal_v<u8'\n',char_type>)
+			return i+4u-tail;
+	}
+	return 0;
+}
+
+}
+
+template<std::integral ch_type>
+class basic_http_request_scanner
+{
+public:
+	using char_type = ch_type;
+	using allocator = ::fast_io::native_typed_global_allocator<char_type>;
+	basic_http_header_view<char_type> header;
+	char_type* spill_begin{};
+	char_type* spill_curr{};
+	char_type* spill_end{};
+	std::size_t max_header_size{http_request_scanner_default_max_header_size};
+
+	constexpr basic_http_request_scanner() noexcept=default;
+	explicit constexpr basic_http_request_scanner(std::size_t maxhdsz) noexcept:max_header_size(maxhdsz)
+	{}
+	basic_http_request_scanner(basic_http_request_scanner const&)=delete;
+	basic_http_request_scanner& operator=(basic_http_request_scanner const&)=delete;
+	~basic_http_request_scanner()
+	{
+		if(spill_begin)
+			allocator::deallocate_n(spill_begin,static_cast<std::size_t>(spill_end-spill_begin));
+	}
+
+	/*
+	Scans the next request header. Returns false when the input ends cleanly between requests; throws
+	parse_code::end_of_file for a truncated header, parse_code::overflow for one longer than max_header_size and
+	parse_code::invalid for a malformed one. Empty lines before a request line are skipped (RFC 9112 section 2.2).
+	*/
+	template<buffer_input_stream input>
+	inline bool next(input& in)
+	{
+		spill_curr=spill_begin;
+		auto curr{ibuffer_curr(in)};
+		auto end{ibuffer_end(in)};
+		for(;;)
+		{
+			for(;curr!=end&&(*curr==char_literal_v<u8'\r',char_type>||*curr==char_literal_v<u8'\n',char_type>);++curr);
+			if(curr!=end)
+				break;
+			ibuffer_set_curr(in,curr);
+			if(!ibuffer_underflow(in))
+				return false;
+			curr=ibuffer_curr(in);
+			end=ibuffer_end(in);
+		}
+		char_type const* hend{::fast_io::details::find_http_header_end<char_type>(curr,end)};
+		if(hend)[[likely]]
+		{
+			std::size_t const n{static_cast<std::size_t>(hend-curr)};
+			if(max_header_size<n)
+				throw_parse_code(parse_code::overflow);
+			ibuffer_set_curr(in,curr+n);
+			return this->parse(curr,n);
+		}
+		return this->next_straddled(in,curr,end);
+	}
+
+private:
+	template<buffer_input_stream input>
+#if __has_cpp_attribute(__gnu__::__cold__)
+	[[__gnu__::__cold__]]
+#endif
+	inline bool next_straddled(input& in,typename input::char_type* curr,typename input::char_type* end)
+	{
+		for(;;)
+		{
+			this->append(curr,end);
+			ibuffer_set_curr(in,end);
+			if(!ibuffer_underflow(in))
+				throw_parse_code(parse_code::end_of_file);
+			curr=ibuffer_curr(in);
+			end=ibuffer_end(in);
+			std::size_t n{::fast_io::details::http_header_end_straddle<char_type>(spill_begin,spill_curr,curr,end)};
+			if(!n)
+			{
+				char_type const* hend{::fast_io::details::find_http_header_end<char_type>(curr,end)};
+				if(hend)
+					n=static_cast<std::size_t>(hend-curr);
+			}
+			if(n)
+			{
+				this->append(curr,curr+n);
+				ibuffer_set_curr(in,curr+n);
+				return this->parse(spill_begin,static_cast<std::size_t>(spill_curr-spill_begin));
+			}
+		}
+	}
+	inline void append(char_type const* first,char_type const* last)
+	{
+		std::size_t const n{static_cast<std::size_t>(last-first)};
+		std::size_t const used{static_cast<std::size_t>(spill_curr-spill_begin)};
+		if(max_header_size-used<n)
+			throw_parse_code(parse_code::overflow);
+		std::size_t const capacity{static_cast<std::size_t>(spill_end-spill_begin)};
+		if(capacity-used<n)
+		{
+			std::size_t newcapacity{capacity?capacity:4096u};
+			for(;newcapacity-used<n;newcapacity<<=1u);
+			if(max_header_size<newcapacity)
+				newcapacity=max_header_size;
+			char_type* newbegin{allocator::allocate(newcapacity)};
+			::fast_io::details::non_overlapped_copy_n(spill_begin,used,newbegin);
+			if(spill_begin)
+				allocator::deallocate_n(spill_begin,capacity);
+			spill_begin=newbegin;
+			spill_curr=newbegin+used;
+			spill_end=newbegin+newcapacity;
+		}
+		spill_curr=::fast_io::details::non_overlapped_copy_n(first,n,spill_curr);
+	}
+	inline bool parse(char_type const* first,std::size_t n)
+	{
+		header.buffer=first;
+		header.header_length=n;
+		parse_code const code{::fast_io::details::determine_http_header_location(header)};
+		if(code!=parse_code::ok)
+			throw_parse_code(code);
+		return true;
+	}
+};
+
+using http_request_scanner = basic_http_request_scanner<char>;
+using u8http_request_scanner = basic_http_request_scanner<char8_t>;
+using u16http_request_scanner = basic_http_request_scanner<char16_t>;
+using u32http_request_scanner = basic_http_request_scanner<char32_t>;
+using whttp_request_scanner = basic_http_request_scanner<wchar_t>;
+
+}
@@ -54,6 +54,34 @@ constexpr toIter deco_reserve_define(io_reserve_type_t<::std::iter_value_t<toIte
 	return deco_reserve_define(io_reserve_type<::std::iter_value_t<toIter>,decot>,*deco.ptr,first,last,iter);
 }
 
+template<std::integral to_char_type,typename decot>
+requires pending_decorator<to_char_type,decot>
+constexpr bool deco_pending(io_reserve_type_t<to_char_type,deco_reference_wrapper<decot>>,deco_reference_wrapper<decot> deco)
+{
+	return deco_pending(io_reserve_type<to_char_type,decot>,*deco.ptr);
+}
+
+template<std::integral to_char_type,typename decot>
+requires eof_decorator<to_char_type,decot>
+constexpr void deco_eof(io_reserve_type_t<to_char_type,deco_reference_wrapper<decot>>,deco_reference_wrapper<decot> deco)
+{
+	deco_eof(io_reserve_type<to_char_type,decot>,*deco.ptr);
+}
+
+template<std::integral to_char_type,typename decot>
+requires finish_decorator<to_char_type,decot>
+constexpr std::size_t deco_finish_size(io_reserve_type_t<to_char_type,deco_reference_wrapper<decot>>,deco_reference_wrapper<decot> deco)
+{
+	return deco_finish_size(io_reserve_type<to_char_type,decot>,*deco.ptr);
+}
+
+template<::std::random_access_iterator toIter,typename decot>
+requires finish_decorator<::std::iter_value_t<toIter>,decot>
+constexpr toIter deco_finish_define(io_reserve_type_t<::std::iter_value_t<toIter>,deco_reference_wrapper<decot>>,deco_reference_wrapper<decot> deco,toIter iter)
+{
+	return deco_finish_define(io_reserve_type<::std::iter_value_t<toIter>,decot>,*deco.ptr,iter);
+}
+
 #if 0
 template<std::integral to_char_type,typename decot,::std::random_access_iterator fromIter>
 requires requires(decot& deco,fromIter from_it)
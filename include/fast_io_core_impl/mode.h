@@ -571,5 +571,55 @@ struct file_loader_extra_bytes
 	explicit constexpr file_loader_extra_bytes(::std::size_t nn) noexcept:n(nn) {}
 };
 
+enum class file_loader_mode:std::uint_least8_t
+{
+none=0,
+//	default mapping: PROT_READ|PROT_WRITE, MAP_PRIVATE|MAP_POPULATE. Fully populated copy-on-write pages.
+read_only=1,
+//	PROT_READ, MAP_SHARED. Pages come straight from the page cache, no COW page tables. Writing through the loader faults.
+lazy=1<<1,
+//	Do not MAP_POPULATE. Opening costs one mmap; pages fault in on first touch.
+sequential=1<<2,
+//	MADV_SEQUENTIAL: aggressive readahead, pages behind the cursor may be dropped early.
+random=1<<3,
+//	MADV_RANDOM
+willneed=1<<4,
+//	MADV_WILLNEED: start asynchronous readahead of the whole file.
+huge_page=1<<5,
+//	MADV_HUGEPAGE: ask for transparent huge pages to cut TLB pressure. Page cache backed THP requires kernel support.
+prefault=1<<6
+//	Implies lazy. A background thread populates the page tables chunk by chunk while the caller starts scanning; the loader joins it on close/destruction.
+};
+
+constexpr file_loader_mode operator&(file_loader_mode x, file_loader_mode y) noexcept
+{
+using utype = typename std::underlying_type<file_loader_mode>::type;
+return static_cast<file_loader_mode>(static_cast<utype>(x) & static_cast<utype>(y));
+}
+
+constexpr file_loader_mode operator|(file_loader_mode x, file_loader_mode y) noexcept
+{
+using utype = typename std::underlying_type<file_loader_mode>::type;
+return static_cast<file_loader_mode>(static_cast<utype>(x) | static_cast<utype>(y));
+}
+
+constexpr file_loader_mode operator^(file_loader_mode x, file_loader_mode y) noexcept
+{
+using utype = typename std::underlying_type<file_loader_mode>::type;
+return static_cast<file_loader_mode>(static_cast<utype>(x) ^ static_cast<utype>(y));
+}
+
+constexpr file_loader_mode operator~(file_loader_mode x) noexcept
+{
+using utype = typename std::underlying_type<file_loader_mode>::type;
+return static_cast<file_loader_mode>(~static_cast<utype>(x));
+}
+
+inline constexpr file_loader_mode& operator&=(file_loader_mode& x, file_loader_mode y) noexcept{return x=x&y;}
+
+inline constexpr file_loader_mode& operator|=(file_loader_mode& x, file_loader_mode y) noexcept{return x=x|y;}
+
+inline constexpr file_loader_mode& operator^=(file_loader_mode& x, file_loader_mode y) noexcept{return x=x^y;}
+
 }
 
@@ -2,114 +2,89 @@
 
 namespace fast_io
 {
-namespace details
-{
 
-#if defined(__linux__)||defined(__BSD_VISIBLE)
-template<output_stream output,input_stream input>
-inline constexpr std::uintmax_t zero_copy_random_access_transmit_impl(output& outp,input& inp,std::intmax_t offset)
+template<typename T,typename P>
+concept zero_copy_random_access_transmitable = zero_copy_output_stream<T>&&zero_copy_input_stream<P>&&requires(T t,P p)
 {
-	auto ret(zero_copy_transmit<true,true>(outp,inp,offset));
-	if(ret.second)
-	{
-		offset+=static_cast<std::intmax_t>(ret.first);
-		return ret.first+bufferred_transmit_impl(outp,inp);
-	}
-	return ret.first;
-}
+	zero_copy_random_access_transmit64_define(io_alias,zero_copy_out_handle(t),zero_copy_in_handle(p),
+		std::uint_least64_t{},std::uint_least64_t{});
+};
 
-template<output_stream output,input_stream input>
-inline constexpr std::uintmax_t zero_copy_random_access_transmit_impl(output& outp,input& inp,std::intmax_t offset,std::uintmax_t sz)
+namespace details
 {
-	auto ret(zero_copy_transmit<true,true>(outp,inp,offset,sz)); 
-	if(ret.second)
-	{
-		offset+=static_cast<std::intmax_t>(ret.first);
-		return ret.first+bufferred_transmit_impl(outp,inp,sz-ret.first);
-	}
-	return ret.first;
-}
-#endif
 
-template<output_stream output,input_stream input,typename... Args>
-inline constexpr auto random_access_transmit_impl(output& outp,input& inp,std::intmax_t offset,Args&& ...args)
+/*
+Transmits characters [offset,offset+characters) of ins. When the platform provides a positional zero-copy
+primitive the input position and buffer are left untouched, so several threads may serve disjoint ranges of one
+shared descriptor. Otherwise this falls back to seek + transmit64, which is not safe to share.
+*/
+template<output_stream output,input_stream input>
+requires (std::is_trivially_copyable_v<output>&&std::is_trivially_copyable_v<input>)
+inline constexpr std::uint_least64_t random_access_transmit64_decay(output outs,input ins,std::uint_least64_t offset,std::uint_least64_t characters)
 {
-	if constexpr(mutex_stream<input>)
+	if constexpr(mutex_stream<output>)
 	{
-		io_lock_guard lg{inp};
-		decltype(auto) uh{inp.unlocked_handle()};
-		return random_access_transmit_impl(outp,uh,::std::forward<Args>(args)...);
+		io_lock_guard lg{outs};
+		decltype(auto) uh{outs.unlocked_handle()};
+		return random_access_transmit64_decay(io_ref(uh),ins,offset,characters);
 	}
-	else
+	else if constexpr(zero_copy_random_access_transmitable<output,input>&&
+		(!buffer_output_stream<output>||flush_output_stream<output>))
 	{
-#ifdef __cpp_lib_is_constant_evaluated
-		if (std::is_constant_evaluated())
-		{
-			seek(inp,offset);
-			return bufferred_transmit_impl(outp,inp,::std::forward<Args>(args)...);
-		}
-		else
-		{
-#endif
-		if constexpr(zero_copy_output_stream<output>&&zero_copy_input_stream<input>)
-		{
-			if constexpr(buffer_input_stream<input>)
-			{
-				offset-=end(inp)-begin(inp);
-				iclear(inp);
-			}
-			if constexpr(buffer_output_stream<output>)
-				flush(outp);
-#if defined(__linux__)||defined(__BSD_VISIBLE)
-			return zero_copy_random_access_transmit_impl(outp,inp,offset,::std::forward<Args>(args)...);
+#ifdef __cpp_if_consteval
+		if consteval
 #else
-			return zero_copy_transmit<true>(outp,inp,offset,::std::forward<Args>(args)...);
+		if(__builtin_is_constant_evaluated())
 #endif
+		{
+			seek(ins,static_cast<std::intmax_t>(offset),seekdir::beg);
+			return transmit64_decay(outs,ins,characters);
 		}
 		else
 		{
-			seek(inp,offset);
-			return bufferred_transmit_impl(outp,inp,::std::forward<Args>(args)...);
-		}
-#ifdef __cpp_lib_is_constant_evaluated
+			if constexpr(buffer_output_stream<output>)
+				flush(outs);
+			return zero_copy_random_access_transmit64_define(io_alias,zero_copy_out_handle(outs),zero_copy_in_handle(ins),offset,characters);
 		}
-#endif
+	}
+	else if constexpr(mutex_stream<input>)
+	{
+		io_lock_guard lg{ins};
+		decltype(auto) uh{ins.unlocked_handle()};
+		return random_access_transmit64_decay(outs,io_ref(uh),offset,characters);
+	}
+	else
+	{
+		if constexpr(buffer_input_stream<input>)
+			ibuffer_set_curr(ins,ibuffer_end(ins));
+		seek(ins,static_cast<std::intmax_t>(offset),seekdir::beg);
+		return transmit64_decay(outs,ins,characters);
 	}
 }
 
-
-}
-
-template<output_stream output,input_stream input,std::integral sz_type,std::integral offset_type>
-requires fast_io::random_access_stream<input>
-inline constexpr void print_define(output& outp,manip::random_access_transmission<input,sz_type,offset_type> ref)
-{
-	ref.transmitted=static_cast<sz_type>(details::random_access_transmit_impl(outp,ref.reference,ref.offset));
 }
 
-template<output_stream output,input_stream input,std::integral sz_type,std::integral offset_type>
-requires fast_io::random_access_stream<input>
-inline constexpr void print_define(output& outp,manip::random_access_transmission_with_size<input,sz_type,offset_type> ref)
+template<typename output,typename input>
+#if __has_cpp_attribute(__gnu__::__always_inline__)
+[[__gnu__::__always_inline__]]
+#elif __has_cpp_attribute(msvc::forceinline)
+[[msvc::forceinline]]
+#endif
+inline constexpr std::uint_least64_t random_access_transmit64(output&& outs,input&& ins,std::uint_least64_t offset,std::uint_least64_t characters=UINT_LEAST64_MAX)
 {
-	ref.transmitted=static_cast<sz_type>(details::random_access_transmit_impl(outp,ref.reference,ref.offset,ref.bytes));
+	return details::random_access_transmit64_decay(fast_io::io_ref(outs),fast_io::io_ref(ins),offset,characters);
 }
 
-template<output_stream output,std::integral offset_type,input_stream input>
-requires fast_io::random_access_stream<input>
-inline constexpr std::uintmax_t random_access_transmit(output&& outp,offset_type offset,input&& in)
+template<typename output,std::integral offset_type,typename input>
+inline constexpr std::uintmax_t random_access_transmit(output&& outs,offset_type offset,input&& ins)
 {
-	std::uintmax_t transmitted{};
-	print_freestanding(::std::forward<output>(outp),manip::random_access_transmission<input,offset_type,std::uintmax_t>(transmitted,offset,in));
-	return transmitted;
+	return static_cast<std::uintmax_t>(random_access_transmit64(outs,ins,static_cast<std::uint_least64_t>(offset)));
 }
 
-template<output_stream output,std::integral offset_type,input_stream input,std::integral sz_type>
-requires fast_io::random_access_stream<input>
-inline constexpr sz_type random_access_transmit(output&& outp,offset_type offset,input&& in,sz_type bytes)
+template<typename output,std::integral offset_type,typename input,std::integral sz_type>
+inline constexpr sz_type random_access_transmit(output&& outs,offset_type offset,input&& ins,sz_type characters)
 {
-	sz_type transmitted{};
-	print_freestanding(::std::forward<output>(outp),manip::random_access_transmission_with_size<input,offset_type,std::uintmax_t>(transmitted,offset,in,bytes));
-	return transmitted;
+	return static_cast<sz_type>(random_access_transmit64(outs,ins,static_cast<std::uint_least64_t>(offset),static_cast<std::uint_least64_t>(characters)));
 }
 
 }
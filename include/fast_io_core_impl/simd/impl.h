@@ -12,3 +12,4 @@
 #include"prrsv.h"
 #include"is_all_zeros.h"
 #include"mask_countr.h"
+#include"runtime_dispatch.h"
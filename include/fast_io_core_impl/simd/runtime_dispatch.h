@@ -0,0 +1,138 @@
+#pragma once
+
+/*
+Runtime CPU dispatch for the hot scanning kernels. Binaries built for baseline x86-64 probe the CPU once
+(__builtin_cpu_supports, which also checks that the OS saves the wider registers) and route find_lf/find_space style
+scans through AVX2 or AVX-512BW kernels compiled with the target attribute. When the compiler already targets
+AVX-512BW the compile-time path is as good, so dispatch compiles away.
+*/
+
+namespace fast_io::details::cpu_flags
+{
+
+/*
+Whether __builtin_cpu_supports may be used at all. Kernels needing features outside the AVX2/AVX-512BW ladder below
+(sse4.2 crc32, pclmulqdq) probe through this directly.
+*/
+inline constexpr bool runtime_cpu_probe_supported
+{
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__)) && \
+	!defined(FAST_IO_DISABLE_RUNTIME_CPU_DISPATCH) && \
+	((__STDC_HOSTED__==1 && (!defined(_GLIBCXX_HOSTED) || _GLIBCXX_HOSTED==1) && !defined(_LIBCPP_FREESTANDING)) || \
+	defined(FAST_IO_ENABLE_HOSTED_FEATURES))
+true
+#endif
+};
+
+inline constexpr bool runtime_dispatch_supported
+{
+#if !defined(__AVX512BW__)
+runtime_cpu_probe_supported
+#endif
+};
+
+enum class runtime_simd_level : std::uint_least8_t
+{
+baseline,
+avx2,
+avx512bw
+};
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+inline runtime_simd_level detect_runtime_simd_level() noexcept
+{
+	__builtin_cpu_init();
+	if(__builtin_cpu_supports("avx512bw"))
+		return runtime_simd_level::avx512bw;
+	if(__builtin_cpu_supports("avx2"))
+		return runtime_simd_level::avx2;
+	return runtime_simd_level::baseline;
+}
+
+inline runtime_simd_level get_runtime_simd_level() noexcept
+{
+	static runtime_simd_level const level{detect_runtime_simd_level()};
+	return level;
+}
+#endif
+
+}
+
+namespace fast_io::details
+{
+
+template<typename char_type>
+inline constexpr bool runtime_simd_dispatch_char_type{::fast_io::details::cpu_flags::runtime_dispatch_supported&&
+	(sizeof(char_type)==1||sizeof(char_type)==2||sizeof(char_type)==4)&&
+	!::fast_io::details::is_ebcdic<char_type>&&
+	!(::std::same_as<char_type,wchar_t>&&::fast_io::details::wide_is_none_utf_endian)};
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+
+template<typename char_type>
+using runtime_simd_uint_type = ::std::conditional_t<sizeof(char_type)==1,::std::uint_least8_t,
+	::std::conditional_t<sizeof(char_type)==2,::std::uint_least16_t,::std::uint_least32_t>>;
+
+/*
+kind 0: the character ch, kind 1: C whitespace, kind 2: HTML whitespace.
+Each kernel returns the first match, or the start of the tail shorter than one vector.
+*/
+template<unsigned kind,bool findnot,typename char_type>
+[[__gnu__::__target__("avx2")]]
+inline char_type const* runtime_find_avx2_impl(char_type const* first,char_type const* last,char_type ch) noexcept
+{
+	using uint_type = runtime_simd_uint_type<char_type>;
+	using vec_type [[__gnu__::__vector_size__(32)]] = uint_type;
+	using x86_64_v32qi [[__gnu__::__vector_size__(32)]] = char;
+	constexpr std::size_t n{32u/sizeof(char_type)};
+	vec_type const chs{vec_type{}+static_cast<uint_type>(ch)};
+	for(;n<=static_cast<std::size_t>(last-first);first+=n)
+	{
+		vec_type v;
+		__builtin_memcpy(__builtin_addressof(v),first,32u);
+		std::uint_least32_t mask;
+		if constexpr(kind==0)
+			mask=static_cast<std::uint_least32_t>(__builtin_ia32_pmovmskb256((x86_64_v32qi)(v==chs)));
+		else if constexpr(kind==1)
+			mask=static_cast<std::uint_least32_t>(__builtin_ia32_pmovmskb256((x86_64_v32qi)((v==0x20)|((v-0x9)<0x5))));
+		else
+			mask=static_cast<std::uint_least32_t>(__builtin_ia32_pmovmskb256((x86_64_v32qi)((v==0x20)|(((v-0x9)<0x5)&(v!=0xb)))));
+		if constexpr(findnot)
+			mask=~mask;
+		if(mask)
+			return first+static_cast<std::size_t>(::std::countr_zero(mask))/sizeof(char_type);
+	}
+	return first;
+}
+
+template<unsigned kind,bool findnot,typename char_type>
+[[__gnu__::__target__("avx512bw")]]
+inline char_type const* runtime_find_avx512bw_impl(char_type const* first,char_type const* last,char_type ch) noexcept
+{
+	using uint_type = runtime_simd_uint_type<char_type>;
+	using vec_type [[__gnu__::__vector_size__(64)]] = uint_type;
+	using x86_64_v64qi [[__gnu__::__vector_size__(64)]] = char;
+	constexpr std::size_t n{64u/sizeof(char_type)};
+	vec_type const chs{vec_type{}+static_cast<uint_type>(ch)};
+	for(;n<=static_cast<std::size_t>(last-first);first+=n)
+	{
+		vec_type v;
+		__builtin_memcpy(__builtin_addressof(v),first,64u);
+		std::uint_least64_t mask;
+		if constexpr(kind==0)
+			mask=static_cast<std::uint_least64_t>(__builtin_ia32_cvtb2mask512((x86_64_v64qi)(v==chs)));
+		else if constexpr(kind==1)
+			mask=static_cast<std::uint_least64_t>(__builtin_ia32_cvtb2mask512((x86_64_v64qi)((v==0x20)|((v-0x9)<0x5))));
+		else
+			mask=static_cast<std::uint_least64_t>(__builtin_ia32_cvtb2mask512((x86_64_v64qi)((v==0x20)|(((v-0x9)<0x5)&(v!=0xb)))));
+		if constexpr(findnot)
+			mask=~mask;
+		if(mask)
+			return first+static_cast<std::size_t>(::std::countr_zero(mask))/sizeof(char_type);
+	}
+	return first;
+}
+
+#endif
+
+}
@@ -411,6 +411,30 @@ inline constexpr char unsigned const* find_characters_musl(char unsigned const*
 	return first;
 }
 
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+template<char8_t lfch,bool findnot,std::integral char_type>
+inline char_type const* find_simd_constant_runtime_dispatch_impl(char_type const* first,char_type const* last) noexcept
+{
+	constexpr char_type lfchct{char_literal_v<lfch,std::remove_cvref_t<char_type>>};
+	switch(::fast_io::details::cpu_flags::get_runtime_simd_level())
+	{
+	case ::fast_io::details::cpu_flags::runtime_simd_level::avx512bw:
+		return ::fast_io::details::runtime_find_avx512bw_impl<0,findnot>(first,last,lfchct);
+	case ::fast_io::details::cpu_flags::runtime_simd_level::avx2:
+		return ::fast_io::details::runtime_find_avx2_impl<0,findnot>(first,last,lfchct);
+	default:
+		if constexpr(::fast_io::details::optimal_simd_vector_run_with_cpu_instruction_size)
+		{
+			return find_simd_constant_simd_common_impl<lfch,findnot,::fast_io::details::optimal_simd_vector_run_with_cpu_instruction_size>(first,last);
+		}
+		else
+		{
+			return first;
+		}
+	}
+}
+#endif
+
 template<char8_t lfch,bool findnot,std::integral char_type>
 inline constexpr char_type const* find_simd_constant_common_cold_impl(char_type const* first,char_type const* last) noexcept
 {
@@ -457,6 +481,12 @@ inline constexpr char_type const* find_simd_constant_common_cold_impl(char_type
 		}
 		return reinterpret_cast<char_type const*>(ret);
 	}
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+	else if constexpr(::fast_io::details::runtime_simd_dispatch_char_type<char_type>)
+	{
+		first=find_simd_constant_runtime_dispatch_impl<lfch,findnot>(first,last);
+	}
+#endif
 	else if constexpr(::fast_io::details::optimal_simd_vector_run_with_cpu_instruction_size)
 	{
 		first=find_simd_constant_simd_common_impl<lfch,findnot,::fast_io::details::optimal_simd_vector_run_with_cpu_instruction_size>(first,last);
@@ -553,6 +583,30 @@ inline constexpr Iter find_space_common_iterator_generic_impl(Iter begin,Iter en
 	return begin;
 }
 
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+template<bool ishtml,bool findnot,std::integral char_type>
+inline char_type const* find_space_runtime_dispatch_impl(char_type const* first,char_type const* last) noexcept
+{
+	constexpr unsigned kind{ishtml?2u:1u};
+	switch(::fast_io::details::cpu_flags::get_runtime_simd_level())
+	{
+	case ::fast_io::details::cpu_flags::runtime_simd_level::avx512bw:
+		return ::fast_io::details::runtime_find_avx512bw_impl<kind,findnot>(first,last,char_type{});
+	case ::fast_io::details::cpu_flags::runtime_simd_level::avx2:
+		return ::fast_io::details::runtime_find_avx2_impl<kind,findnot>(first,last,char_type{});
+	default:
+		if constexpr(::fast_io::details::optimal_simd_vector_run_with_cpu_instruction_size)
+		{
+			return find_space_simd_common_impl<ishtml,findnot,::fast_io::details::optimal_simd_vector_run_with_cpu_instruction_size>(first,last);
+		}
+		else
+		{
+			return first;
+		}
+	}
+}
+#endif
+
 template<bool ishtml,bool findnot,std::integral char_type>
 inline constexpr char_type const* find_space_common_cold_impl(char_type const* first,char_type const* last) noexcept
 {
@@ -563,6 +617,13 @@ inline constexpr char_type const* find_space_common_cold_impl(char_type const* f
 	if(!std::is_constant_evaluated())
 #endif
 	{
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+		if constexpr(::fast_io::details::runtime_simd_dispatch_char_type<char_type>)
+		{
+			first=find_space_runtime_dispatch_impl<ishtml,findnot>(first,last);
+		}
+		else
+#endif
 		if constexpr(::fast_io::details::optimal_simd_vector_run_with_cpu_instruction_size)
 		{
 			first=find_space_simd_common_impl<ishtml,findnot,::fast_io::details::optimal_simd_vector_run_with_cpu_instruction_size>(first,last);
@@ -23,6 +23,9 @@
 //#include"fast_io_crypto/symmetric_crypto.h"
 //#include"fast_io_crypto/hash/intrin_include.h"
 #include"fast_io_crypto/hash/impl.h"
+#include"fast_io_crypto/aead/record.h"
+#include"fast_io_crypto/cipher/impl.h"
+#include"fast_io_crypto/streamcipher/chacha/impl.h"
 
 #if defined(_MSC_VER) && !defined(__clang__)
 #pragma warning(pop)
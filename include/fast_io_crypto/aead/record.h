@@ -0,0 +1,246 @@
+#pragma once
+
+/*
+Record framing shared by the AEAD stream decorators (ChaCha20-Poly1305, AES-GCM). basic_io_buffer hands the output
+decorator chunks it splits into records of at most aead_record_size plaintext bytes:
+	4-byte little-endian header | ciphertext | 16-byte tag
+The low 31 bits of the header hold the plaintext length and the top bit marks the final record. The header is the
+record's associated data and record i is sealed under nonce XOR big-endian i in its last 8 bytes (the TLS 1.3
+construction), so dropping, reordering or replaying records fails authentication.
+Closing the stream (close(), reopen(), assignment or the destructor of the buffer) seals an empty final record;
+flush() does not end the stream. The input decorator throws parse_code::invalid on a bad header or tag, or on data
+after the final record, and parse_code::end_of_file at end of file unless the final record was authenticated, so a cut
+at a record boundary is caught like a cut inside a record.
+*/
+
+namespace fast_io
+{
+
+inline constexpr std::size_t aead_record_size{16384};
+inline constexpr std::size_t aead_record_tag_size{16};
+inline constexpr std::size_t aead_record_overhead{4+aead_record_tag_size};
+
+}
+
+namespace fast_io::details::aead
+{
+
+inline constexpr ::std::uint_least32_t record_final_flag{static_cast<::std::uint_least32_t>(1)<<31};
+
+/*
+Sequence state of the sealing side. Moving it marks the source finished: a moved-from decorator sealing its own final
+record would reuse the sequence number, and so the nonce, of the one the destination seals.
+*/
+struct record_seal_state
+{
+	::std::uint_least64_t sequence{};
+	bool finished{};
+	constexpr record_seal_state() noexcept = default;
+	constexpr record_seal_state(record_seal_state&& other) noexcept:sequence(other.sequence),finished(other.finished)
+	{
+		other.finished=true;
+	}
+	constexpr record_seal_state& operator=(record_seal_state&& other) noexcept
+	{
+		if(__builtin_addressof(other)!=this)
+		{
+			sequence=other.sequence;
+			finished=other.finished;
+			other.finished=true;
+		}
+		return *this;
+	}
+};
+
+struct record_open_state
+{
+	::std::uint_least64_t sequence{};
+	std::size_t pending_size{};
+	bool finished{};
+	::std::byte pending[::fast_io::aead_record_overhead+::fast_io::aead_record_size];
+	~record_open_state()
+	{
+		::fast_io::secure_clear(pending,pending_size);
+	}
+};
+
+template<std::size_t n>
+inline void record_nonce(::std::byte const (&base)[n],::std::uint_least64_t sequence,::std::byte (&nonce)[n]) noexcept
+{
+	static_assert(8<=n);
+	::fast_io::details::non_overlapped_copy_n(base,n,nonce);
+	for(std::size_t i{};i!=8;++i)
+	{
+		nonce[n-1-i]^=static_cast<::std::byte>(sequence>>(i*8));
+	}
+}
+
+/*
+deco provides nonce, state (a record_seal_state) and
+	void seal(::std::byte const* nonce,::std::byte const* header,::std::byte const* first,std::size_t size,::std::byte* out) noexcept
+writing size bytes of ciphertext and then the tag to out.
+*/
+template<typename deco_type>
+inline ::std::byte* seal_record(deco_type& deco,::std::byte const* first,std::size_t size,bool final,::std::byte* out) noexcept
+{
+	::std::uint_least32_t header{static_cast<::std::uint_least32_t>(size)};
+	if(final)
+	{
+		header|=record_final_flag;
+	}
+	header=::fast_io::little_endian(header);
+	__builtin_memcpy(out,__builtin_addressof(header),sizeof(header));
+	decltype(deco.nonce) nonce;
+	record_nonce(deco.nonce,deco.state.sequence,nonce);
+	++deco.state.sequence;
+	deco.seal(nonce,out,first,size,out+sizeof(header));
+	return out+::fast_io::aead_record_overhead+size;
+}
+
+template<typename deco_type>
+inline ::std::byte* seal_records(deco_type& deco,::std::byte const* first,::std::byte const* last,::std::byte* out) noexcept
+{
+	while(first!=last)
+	{
+		std::size_t size{static_cast<std::size_t>(last-first)};
+		if(::fast_io::aead_record_size<size)
+		{
+			size=::fast_io::aead_record_size;
+		}
+		out=seal_record(deco,first,size,false,out);
+		first+=size;
+	}
+	return out;
+}
+
+template<typename deco_type>
+inline constexpr std::size_t seal_final_size(deco_type& deco) noexcept
+{
+	if(deco.state.finished)
+	{
+		return 0;
+	}
+	return ::fast_io::aead_record_overhead;
+}
+
+template<typename deco_type>
+inline ::std::byte* seal_final(deco_type& deco,::std::byte* out) noexcept
+{
+	if(deco.state.finished)
+	{
+		return out;
+	}
+	deco.state.finished=true;
+	return seal_record(deco,out,0,true,out);
+}
+
+/*
+Size of the record starting at p (the header must be available).
+*/
+inline std::size_t record_total(::std::byte const* p)
+{
+	::std::uint_least32_t header;
+	__builtin_memcpy(__builtin_addressof(header),p,sizeof(header));
+	header=::fast_io::little_endian(header);
+	std::size_t const size{static_cast<std::size_t>(header&~record_final_flag)};
+	if(::fast_io::aead_record_size<size||(size==0&&(header&record_final_flag)==0))
+	{
+		::fast_io::throw_parse_code(::fast_io::parse_code::invalid);
+	}
+	return ::fast_io::aead_record_overhead+size;
+}
+
+/*
+deco provides nonce, state (a record_open_state) and
+	bool open(::std::byte const* nonce,::std::byte const* header,::std::byte const* ciphertext,std::size_t size,::std::byte* out) noexcept
+reading the tag after the ciphertext and returning false, with out untouched, when it does not authenticate.
+*/
+template<typename deco_type>
+inline ::std::byte* open_record(deco_type& deco,::std::byte const* record,std::size_t total,::std::byte* out)
+{
+	std::size_t const size{total-::fast_io::aead_record_overhead};
+	decltype(deco.nonce) nonce;
+	record_nonce(deco.nonce,deco.state.sequence,nonce);
+	if(!deco.open(nonce,record,record+4,size,out))
+	{
+		::fast_io::throw_parse_code(::fast_io::parse_code::invalid);
+	}
+	++deco.state.sequence;
+	::std::uint_least32_t header;
+	__builtin_memcpy(__builtin_addressof(header),record,sizeof(header));
+	if((::fast_io::little_endian(header)&record_final_flag)!=0)
+	{
+		deco.state.finished=true;
+	}
+	return out+size;
+}
+
+template<typename deco_type>
+inline ::std::byte* open_records(deco_type& deco,::std::byte const* first,::std::byte const* last,::std::byte* out)
+{
+	auto& state{deco.state};
+	if(state.pending_size)
+	{
+		std::size_t need{4};
+		if(4<=state.pending_size)
+		{
+			need=record_total(state.pending);
+		}
+		for(;;)
+		{
+			std::size_t copy{need-state.pending_size};
+			std::size_t const avail{static_cast<std::size_t>(last-first)};
+			if(avail<copy)
+			{
+				copy=avail;
+			}
+			::fast_io::details::non_overlapped_copy_n(first,copy,state.pending+state.pending_size);
+			first+=copy;
+			state.pending_size+=copy;
+			if(state.pending_size!=need)
+			{
+				return out;
+			}
+			if(need!=4)
+			{
+				break;
+			}
+			need=record_total(state.pending);
+		}
+		out=open_record(deco,state.pending,need,out);
+		state.pending_size=0;
+	}
+	while(first!=last)
+	{
+		if(state.finished)
+		{
+			::fast_io::throw_parse_code(::fast_io::parse_code::invalid);
+		}
+		std::size_t const avail{static_cast<std::size_t>(last-first)};
+		if(4<=avail)
+		{
+			std::size_t const total{record_total(first)};
+			if(total<=avail)
+			{
+				out=open_record(deco,first,total,out);
+				first+=total;
+				continue;
+			}
+		}
+		::fast_io::details::non_overlapped_copy_n(first,avail,state.pending);
+		state.pending_size=avail;
+		break;
+	}
+	return out;
+}
+
+template<typename deco_type>
+inline constexpr void open_eof(deco_type& deco)
+{
+	if(deco.state.pending_size!=0||!deco.state.finished)
+	{
+		::fast_io::throw_parse_code(::fast_io::parse_code::end_of_file);
+	}
+}
+
+}
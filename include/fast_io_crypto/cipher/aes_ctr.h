@@ -0,0 +1,165 @@
+#pragma once
+
+namespace fast_io::details::aes
+{
+
+/*
+Big-endian increment of the whole counter block (SP 800-38A) or of its last 32 bits only (GCM's inc32).
+*/
+template<bool inc32>
+inline void aes_ctr_increment(::std::byte* counter) noexcept
+{
+	constexpr std::size_t last{inc32?12u:0u};
+	for(std::size_t i{16};i!=last;)
+	{
+		--i;
+		counter[i]=static_cast<::std::byte>(static_cast<::std::uint_least8_t>(counter[i])+1u);
+		if(counter[i]!=::std::byte{})
+		{
+			break;
+		}
+	}
+}
+
+/*
+XORs the keystream of counter,counter+1,... into blocks whole blocks of in and advances counter. in may equal out.
+*/
+template<std::size_t rounds,bool inc32>
+inline void aes_ctr_xor_blocks(::std::uint_least8_t const* rk,::std::byte* counter,::std::byte const* in,::std::byte* out,std::size_t blocks) noexcept
+{
+#ifdef FAST_IO_AES_HAS_X86
+	auto const level{::fast_io::details::aes::get_aes_x86_level()};
+	if(level!=::fast_io::details::aes::aes_x86_level::none)
+	{
+		std::size_t done{};
+		if(level==::fast_io::details::aes::aes_x86_level::vaes512)
+		{
+			done=::fast_io::details::aes::aes_x86_ctr_vaes512<rounds,inc32>(rk,counter,in,out,blocks);
+		}
+		else if(level==::fast_io::details::aes::aes_x86_level::vaes256)
+		{
+			done=::fast_io::details::aes::aes_x86_ctr_vaes256<rounds,inc32>(rk,counter,in,out,blocks);
+		}
+		::fast_io::details::aes::aes_x86_ctr_aesni<rounds,inc32>(rk,counter,in+done*16u,out+done*16u,blocks-done);
+		return;
+	}
+#endif
+	::std::byte keystream[16];
+	for(;blocks;--blocks)
+	{
+		::fast_io::details::aes::aes_portable_encrypt_block(rk,rounds,counter,keystream);
+		::fast_io::details::aes::aes_ctr_increment<inc32>(counter);
+		for(std::size_t i{};i!=16;++i)
+		{
+			out[i]=in[i]^keystream[i];
+		}
+		in+=16;
+		out+=16;
+	}
+	::fast_io::secure_clear(keystream,sizeof(keystream));
+}
+
+/*
+As aes_ctr_xor_blocks for any length; a trailing partial block uses up its counter.
+*/
+template<std::size_t rounds,bool inc32>
+inline void aes_ctr_xor(::std::uint_least8_t const* rk,::std::byte* counter,::std::byte const* in,::std::byte* out,std::size_t n) noexcept
+{
+	std::size_t const whole{n/16u*16u};
+	::fast_io::details::aes::aes_ctr_xor_blocks<rounds,inc32>(rk,counter,in,out,n/16u);
+	std::size_t const tail{n-whole};
+	if(tail)
+	{
+		::std::byte block[16]{};
+		::fast_io::details::non_overlapped_copy_n(in+whole,tail,block);
+		::fast_io::details::aes::aes_ctr_xor_blocks<rounds,inc32>(rk,counter,block,block,1);
+		::fast_io::details::non_overlapped_copy_n(block,tail,out+whole);
+		::fast_io::secure_clear(block,sizeof(block));
+	}
+}
+
+}
+
+namespace fast_io
+{
+
+/*
+AES-CTR (SP 800-38A, the counter block increments as one 128-bit big-endian integer) as a basic_io_buffer decorator.
+Encryption and decryption are the same operation, so it serves as either the input or the output decorator. It adds
+confidentiality only: pair it with a MAC, or use the GCM decorators, when the data must not be tampered with.
+*/
+template<std::size_t keysize>
+requires (keysize==16||keysize==24||keysize==32)
+struct aes_ctr_deco_t
+{
+	::fast_io::aes<keysize> cipher;
+	::std::byte counter[16];
+	::std::byte keystream[16];
+	std::size_t keystream_used{16};
+	aes_ctr_deco_t(std::span<std::byte const,keysize> key,std::span<std::byte const,16> iv) noexcept:cipher(key)
+	{
+		::fast_io::details::non_overlapped_copy_n(iv.data(),16u,counter);
+	}
+	~aes_ctr_deco_t()
+	{
+		::fast_io::secure_clear(keystream,sizeof(keystream));
+	}
+};
+
+namespace details::aes
+{
+
+template<std::size_t keysize>
+inline ::std::byte* aes_ctr_deco_xor(::fast_io::aes_ctr_deco_t<keysize>& deco,::std::byte const* first,::std::byte const* last,::std::byte* out) noexcept
+{
+	constexpr std::size_t rounds{::fast_io::aes<keysize>::rounds};
+	for(;first!=last&&deco.keystream_used!=16u;++first)
+	{
+		*out=*first^deco.keystream[deco.keystream_used];
+		++deco.keystream_used;
+		++out;
+	}
+	std::size_t const n{static_cast<std::size_t>(last-first)};
+	std::size_t const whole{n/16u*16u};
+	::fast_io::details::aes::aes_ctr_xor_blocks<rounds,false>(deco.cipher.key_schedule,deco.counter,first,out,n/16u);
+	first+=whole;
+	out+=whole;
+	if(first!=last)
+	{
+		for(auto& e : deco.keystream)
+		{
+			e=::std::byte{};
+		}
+		::fast_io::details::aes::aes_ctr_xor_blocks<rounds,false>(deco.cipher.key_schedule,deco.counter,deco.keystream,deco.keystream,1);
+		for(deco.keystream_used=0;first!=last;++first)
+		{
+			*out=*first^deco.keystream[deco.keystream_used];
+			++deco.keystream_used;
+			++out;
+		}
+	}
+	return out;
+}
+
+}
+
+template<::std::integral to_char_type,std::size_t keysize>
+requires (sizeof(to_char_type)==1)
+inline constexpr std::size_t deco_reserve_size(io_reserve_type_t<to_char_type,aes_ctr_deco_t<keysize>>,
+	aes_ctr_deco_t<keysize>&,std::size_t size) noexcept
+{
+	return size;
+}
+
+template<::std::contiguous_iterator fromIter,::std::contiguous_iterator toIter,std::size_t keysize>
+requires (sizeof(::std::iter_value_t<fromIter>)==1&&sizeof(::std::iter_value_t<toIter>)==1)
+inline toIter deco_reserve_define(io_reserve_type_t<::std::iter_value_t<toIter>,aes_ctr_deco_t<keysize>>,
+	aes_ctr_deco_t<keysize>& deco,fromIter first,fromIter last,toIter iter) noexcept
+{
+	::std::byte* const out{reinterpret_cast<::std::byte*>(::std::to_address(iter))};
+	return iter+(::fast_io::details::aes::aes_ctr_deco_xor(deco,
+		reinterpret_cast<::std::byte const*>(::std::to_address(first)),
+		reinterpret_cast<::std::byte const*>(::std::to_address(last)),out)-out);
+}
+
+}
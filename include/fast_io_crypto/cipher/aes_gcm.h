@@ -0,0 +1,373 @@
+#pragma once
+
+/*
+AES-GCM (SP 800-38D) with 96-bit nonces and 128-bit tags, and basic_io_buffer decorators built on it.
+*/
+
+namespace fast_io
+{
+
+inline constexpr std::size_t aes_gcm_nonce_size{12};
+inline constexpr std::size_t aes_gcm_tag_size{16};
+
+}
+
+namespace fast_io::details::aes
+{
+
+/*
+Byte-reflected powers H^32,H^31,...,H^1, the layout the x86 GHASH kernels load; the portable path reads H^1 back.
+*/
+inline constexpr std::size_t aes_gcm_table_powers{32};
+
+inline ::std::uint_least64_t aes_gcm_load_be64(::std::byte const* p) noexcept
+{
+	::std::uint_least64_t v;
+	__builtin_memcpy(__builtin_addressof(v),p,sizeof(v));
+	return ::fast_io::big_endian(v);
+}
+
+inline void aes_gcm_store_be64(::std::byte* p,::std::uint_least64_t v) noexcept
+{
+	v=::fast_io::big_endian(v);
+	__builtin_memcpy(p,__builtin_addressof(v),sizeof(v));
+}
+
+/*
+x*=y in GF(2^128), bit by bit (SP 800-38D algorithm 1) with masks instead of branches.
+*/
+inline void aes_gcm_gf_mul(::std::uint_least64_t* x,::std::uint_least64_t const* y) noexcept
+{
+	::std::uint_least64_t zh{},zl{},vh{y[0]},vl{y[1]};
+	for(std::size_t i{};i!=128;++i)
+	{
+		::std::uint_least64_t const bit{(i<64u?x[0]>>(63u-i):x[1]>>(127u-i))&1u};
+		::std::uint_least64_t const mask{0u-bit};
+		zh^=vh&mask;
+		zl^=vl&mask;
+		::std::uint_least64_t const lsb{vl&1u};
+		vl=(vl>>1u)|(vh<<63u);
+		vh=(vh>>1u)^(static_cast<::std::uint_least64_t>(0xE100000000000000u)&(0u-lsb));
+	}
+	x[0]=zh;
+	x[1]=zl;
+}
+
+inline void aes_gcm_reflect(::std::byte const* in,::std::byte* out) noexcept
+{
+	for(std::size_t i{};i!=16;++i)
+	{
+		out[i]=in[15-i];
+	}
+}
+
+template<std::size_t rounds>
+inline void aes_gcm_init_table(::std::uint_least8_t const* rk,::std::byte* table) noexcept
+{
+	::std::byte h[16]{};
+	::std::byte counter[16]{};
+	::fast_io::details::aes::aes_ctr_xor_blocks<rounds,false>(rk,counter,h,h,1);
+	::std::uint_least64_t const hv[2]{aes_gcm_load_be64(h),aes_gcm_load_be64(h+8)};
+	::std::uint_least64_t p[2]{hv[0],hv[1]};
+	for(std::size_t i{1};;++i)
+	{
+		::std::byte b[16];
+		aes_gcm_store_be64(b,p[0]);
+		aes_gcm_store_be64(b+8,p[1]);
+		::fast_io::details::aes::aes_gcm_reflect(b,table+(aes_gcm_table_powers-i)*16u);
+		if(i==aes_gcm_table_powers)
+		{
+			break;
+		}
+		::fast_io::details::aes::aes_gcm_gf_mul(p,hv);
+	}
+	::fast_io::secure_clear(h,sizeof(h));
+	::fast_io::secure_clear(p,sizeof(p));
+}
+
+/*
+GHASH update over whole blocks. y is the hash state in specification byte order.
+*/
+inline void aes_gcm_ghash_blocks(::std::byte const* table,::std::byte* y,::std::byte const* in,std::size_t blocks) noexcept
+{
+#ifdef FAST_IO_AES_HAS_X86
+	auto const level{::fast_io::details::aes::get_aes_x86_level()};
+	if(level!=::fast_io::details::aes::aes_x86_level::none)
+	{
+		std::size_t done{};
+		if(level==::fast_io::details::aes::aes_x86_level::vaes512)
+		{
+			done=::fast_io::details::aes::aes_x86_ghash_vaes512(table,y,in,blocks);
+		}
+		else if(level==::fast_io::details::aes::aes_x86_level::vaes256)
+		{
+			done=::fast_io::details::aes::aes_x86_ghash_vaes256(table,y,in,blocks);
+		}
+		::fast_io::details::aes::aes_x86_ghash_aesni(table,y,in+done*16u,blocks-done);
+		return;
+	}
+#endif
+	::std::byte hb[16];
+	::fast_io::details::aes::aes_gcm_reflect(table+(aes_gcm_table_powers-1u)*16u,hb);
+	::std::uint_least64_t const h[2]{aes_gcm_load_be64(hb),aes_gcm_load_be64(hb+8)};
+	::std::uint_least64_t s[2]{aes_gcm_load_be64(y),aes_gcm_load_be64(y+8)};
+	for(;blocks;--blocks)
+	{
+		s[0]^=aes_gcm_load_be64(in);
+		s[1]^=aes_gcm_load_be64(in+8);
+		::fast_io::details::aes::aes_gcm_gf_mul(s,h);
+		in+=16;
+	}
+	aes_gcm_store_be64(y,s[0]);
+	aes_gcm_store_be64(y+8,s[1]);
+	::fast_io::secure_clear(hb,sizeof(hb));
+}
+
+/*
+GHASH update with the final partial block zero padded.
+*/
+inline void aes_gcm_ghash(::std::byte const* table,::std::byte* y,::std::byte const* in,std::size_t n) noexcept
+{
+	::fast_io::details::aes::aes_gcm_ghash_blocks(table,y,in,n/16u);
+	std::size_t const tail{n%16u};
+	if(tail)
+	{
+		::std::byte block[16]{};
+		::fast_io::details::non_overlapped_copy_n(in+(n-tail),tail,block);
+		::fast_io::details::aes::aes_gcm_ghash_blocks(table,y,block,1);
+	}
+}
+
+/*
+Ciphertext is hashed in chunks right after it is produced, while it is still in L1.
+*/
+inline constexpr std::size_t aes_gcm_chunk_size{8192};
+
+inline void aes_gcm_j0(::std::byte const* nonce,::std::byte* j0) noexcept
+{
+	::fast_io::details::non_overlapped_copy_n(nonce,::fast_io::aes_gcm_nonce_size,j0);
+	j0[12]=::std::byte{};
+	j0[13]=::std::byte{};
+	j0[14]=::std::byte{};
+	j0[15]=::std::byte{1};
+}
+
+/*
+Finishes GHASH with the length block and encrypts it under J0 into tag.
+*/
+template<std::size_t rounds>
+inline void aes_gcm_finish(::std::uint_least8_t const* rk,::std::byte const* table,::std::byte* y,::std::byte const* nonce,
+	std::size_t aad_size,std::size_t size,::std::byte* tag) noexcept
+{
+	::std::byte lengths[16];
+	aes_gcm_store_be64(lengths,static_cast<::std::uint_least64_t>(aad_size)*8u);
+	aes_gcm_store_be64(lengths+8,static_cast<::std::uint_least64_t>(size)*8u);
+	::fast_io::details::aes::aes_gcm_ghash_blocks(table,y,lengths,1);
+	::std::byte j0[16];
+	::fast_io::details::aes::aes_gcm_j0(nonce,j0);
+	::fast_io::details::aes::aes_ctr_xor_blocks<rounds,true>(rk,j0,y,tag,1);
+}
+
+template<std::size_t rounds>
+inline void aes_gcm_seal(::std::uint_least8_t const* rk,::std::byte const* table,::std::byte const* nonce,
+	::std::byte const* aad,std::size_t aad_size,::std::byte const* in,std::size_t size,::std::byte* out,::std::byte* tag) noexcept
+{
+	::std::byte counter[16];
+	::fast_io::details::aes::aes_gcm_j0(nonce,counter);
+	counter[15]=::std::byte{2};
+	::std::byte y[16]{};
+	::fast_io::details::aes::aes_gcm_ghash(table,y,aad,aad_size);
+	for(std::size_t off{};off<size;off+=aes_gcm_chunk_size)
+	{
+		std::size_t n{size-off};
+		if(aes_gcm_chunk_size<n)
+		{
+			n=aes_gcm_chunk_size;
+		}
+		::fast_io::details::aes::aes_ctr_xor<rounds,true>(rk,counter,in+off,out+off,n);
+		::fast_io::details::aes::aes_gcm_ghash(table,y,out+off,n);
+	}
+	::fast_io::details::aes::aes_gcm_finish<rounds>(rk,table,y,nonce,aad_size,size,tag);
+}
+
+/*
+Verifies before decrypting, so nothing is written to out when the tag does not match.
+*/
+template<std::size_t rounds>
+inline bool aes_gcm_open(::std::uint_least8_t const* rk,::std::byte const* table,::std::byte const* nonce,
+	::std::byte const* aad,std::size_t aad_size,::std::byte const* in,std::size_t size,::std::byte const* tag,::std::byte* out) noexcept
+{
+	::std::byte y[16]{};
+	::fast_io::details::aes::aes_gcm_ghash(table,y,aad,aad_size);
+	::fast_io::details::aes::aes_gcm_ghash(table,y,in,size);
+	::std::byte expected[::fast_io::aes_gcm_tag_size];
+	::fast_io::details::aes::aes_gcm_finish<rounds>(rk,table,y,nonce,aad_size,size,expected);
+	unsigned char diff{};
+	for(std::size_t i{};i!=::fast_io::aes_gcm_tag_size;++i)
+	{
+		diff|=static_cast<unsigned char>(expected[i]^tag[i]);
+	}
+	bool const ok{diff==0};
+	if(ok)
+	{
+		::std::byte counter[16];
+		::fast_io::details::aes::aes_gcm_j0(nonce,counter);
+		counter[15]=::std::byte{2};
+		::fast_io::details::aes::aes_ctr_xor<rounds,true>(rk,counter,in,out,size);
+	}
+	return ok;
+}
+
+}
+
+namespace fast_io
+{
+
+/*
+An AES-GCM key: the expanded AES key plus the precomputed powers of the hash key, so sealing many messages under
+one key pays the setup once. nonce is aes_gcm_nonce_size bytes and must never repeat under a key.
+*/
+template<std::size_t keysize>
+requires (keysize==16||keysize==24||keysize==32)
+struct aes_gcm
+{
+	::fast_io::aes<keysize> cipher;
+	alignas(16) ::std::byte h_table[::fast_io::details::aes::aes_gcm_table_powers*16u];
+	explicit aes_gcm(std::span<std::byte const,keysize> key) noexcept:cipher(key)
+	{
+		::fast_io::details::aes::aes_gcm_init_table<::fast_io::aes<keysize>::rounds>(cipher.key_schedule,h_table);
+	}
+	aes_gcm(aes_gcm const&)=default;
+	aes_gcm& operator=(aes_gcm const&)=default;
+	~aes_gcm()
+	{
+		::fast_io::secure_clear(h_table,sizeof(h_table));
+	}
+	/*
+	Encrypts [first,last) to ciphertext (same length, may alias first) and writes the 16-byte tag.
+	*/
+	void encrypt(std::span<std::byte const,aes_gcm_nonce_size> nonce,::std::byte const* aad_first,::std::byte const* aad_last,
+		::std::byte const* first,::std::byte const* last,::std::byte* ciphertext,::std::byte* tag) const noexcept
+	{
+		::fast_io::details::aes::aes_gcm_seal<::fast_io::aes<keysize>::rounds>(cipher.key_schedule,h_table,nonce.data(),
+			aad_first,static_cast<std::size_t>(aad_last-aad_first),first,static_cast<std::size_t>(last-first),ciphertext,tag);
+	}
+	/*
+	Returns false, leaving plaintext untouched, when the tag does not authenticate aad and [first,last).
+	*/
+	bool decrypt(std::span<std::byte const,aes_gcm_nonce_size> nonce,::std::byte const* aad_first,::std::byte const* aad_last,
+		::std::byte const* first,::std::byte const* last,::std::byte const* tag,::std::byte* plaintext) const noexcept
+	{
+		return ::fast_io::details::aes::aes_gcm_open<::fast_io::aes<keysize>::rounds>(cipher.key_schedule,h_table,nonce.data(),
+			aad_first,static_cast<std::size_t>(aad_last-aad_first),first,static_cast<std::size_t>(last-first),tag,plaintext);
+	}
+};
+
+/*
+Stream decorators framed as described in fast_io_crypto/aead/record.h, exactly like the ChaCha20-Poly1305 ones.
+*/
+inline constexpr std::size_t aes_gcm_record_size{::fast_io::aead_record_size};
+inline constexpr std::size_t aes_gcm_record_overhead{::fast_io::aead_record_overhead};
+
+template<std::size_t keysize>
+requires (keysize==16||keysize==24||keysize==32)
+struct aes_gcm_encrypt_deco_t
+{
+	::fast_io::aes_gcm<keysize> gcm;
+	::std::byte nonce[aes_gcm_nonce_size];
+	::fast_io::details::aead::record_seal_state state;
+	aes_gcm_encrypt_deco_t(std::span<std::byte const,keysize> key,std::span<std::byte const,aes_gcm_nonce_size> n) noexcept:gcm(key)
+	{
+		::fast_io::details::non_overlapped_copy_n(n.data(),aes_gcm_nonce_size,nonce);
+	}
+	aes_gcm_encrypt_deco_t(aes_gcm_encrypt_deco_t&&) noexcept = default;
+	aes_gcm_encrypt_deco_t& operator=(aes_gcm_encrypt_deco_t&&) noexcept = default;
+	void seal(::std::byte const* record_nonce,::std::byte const* header,::std::byte const* first,std::size_t size,::std::byte* out) const noexcept
+	{
+		gcm.encrypt(std::span<std::byte const,aes_gcm_nonce_size>(record_nonce,aes_gcm_nonce_size),header,header+4,first,first+size,out,out+size);
+	}
+};
+
+template<std::size_t keysize>
+requires (keysize==16||keysize==24||keysize==32)
+struct aes_gcm_decrypt_deco_t
+{
+	::fast_io::aes_gcm<keysize> gcm;
+	::std::byte nonce[aes_gcm_nonce_size];
+	::fast_io::details::aead::record_open_state state;
+	aes_gcm_decrypt_deco_t(std::span<std::byte const,keysize> key,std::span<std::byte const,aes_gcm_nonce_size> n) noexcept:gcm(key)
+	{
+		::fast_io::details::non_overlapped_copy_n(n.data(),aes_gcm_nonce_size,nonce);
+	}
+	bool open(::std::byte const* record_nonce,::std::byte const* header,::std::byte const* ciphertext,std::size_t size,::std::byte* out) const noexcept
+	{
+		return gcm.decrypt(std::span<std::byte const,aes_gcm_nonce_size>(record_nonce,aes_gcm_nonce_size),header,header+4,
+			ciphertext,ciphertext+size,ciphertext+size,out);
+	}
+};
+
+template<::std::integral to_char_type,std::size_t keysize>
+requires (sizeof(to_char_type)==1)
+inline constexpr std::size_t deco_reserve_size(io_reserve_type_t<to_char_type,aes_gcm_encrypt_deco_t<keysize>>,
+	aes_gcm_encrypt_deco_t<keysize>&,std::size_t size) noexcept
+{
+	return ::fast_io::details::intrinsics::add_or_overflow_die(size,
+		::fast_io::details::intrinsics::mul_or_overflow_die(size/aes_gcm_record_size+1,aes_gcm_record_overhead));
+}
+
+template<::std::contiguous_iterator fromIter,::std::contiguous_iterator toIter,std::size_t keysize>
+requires (sizeof(::std::iter_value_t<fromIter>)==1&&sizeof(::std::iter_value_t<toIter>)==1)
+inline toIter deco_reserve_define(io_reserve_type_t<::std::iter_value_t<toIter>,aes_gcm_encrypt_deco_t<keysize>>,
+	aes_gcm_encrypt_deco_t<keysize>& deco,fromIter first,fromIter last,toIter iter) noexcept
+{
+	::std::byte* const out{reinterpret_cast<::std::byte*>(::std::to_address(iter))};
+	return iter+(::fast_io::details::aead::seal_records(deco,
+		reinterpret_cast<::std::byte const*>(::std::to_address(first)),
+		reinterpret_cast<::std::byte const*>(::std::to_address(last)),out)-out);
+}
+
+template<::std::integral to_char_type,std::size_t keysize>
+requires (sizeof(to_char_type)==1)
+inline constexpr std::size_t deco_finish_size(io_reserve_type_t<to_char_type,aes_gcm_encrypt_deco_t<keysize>>,
+	aes_gcm_encrypt_deco_t<keysize>& deco) noexcept
+{
+	return ::fast_io::details::aead::seal_final_size(deco);
+}
+
+template<::std::contiguous_iterator toIter,std::size_t keysize>
+requires (sizeof(::std::iter_value_t<toIter>)==1)
+inline toIter deco_finish_define(io_reserve_type_t<::std::iter_value_t<toIter>,aes_gcm_encrypt_deco_t<keysize>>,
+	aes_gcm_encrypt_deco_t<keysize>& deco,toIter iter) noexcept
+{
+	::std::byte* const out{reinterpret_cast<::std::byte*>(::std::to_address(iter))};
+	return iter+(::fast_io::details::aead::seal_final(deco,out)-out);
+}
+
+template<::std::integral to_char_type,std::size_t keysize>
+requires (sizeof(to_char_type)==1)
+inline constexpr std::size_t deco_reserve_size(io_reserve_type_t<to_char_type,aes_gcm_decrypt_deco_t<keysize>>,
+	aes_gcm_decrypt_deco_t<keysize>& deco,std::size_t size) noexcept
+{
+	return ::fast_io::details::intrinsics::add_or_overflow_die(size,deco.state.pending_size);
+}
+
+template<::std::integral to_char_type,std::size_t keysize>
+requires (sizeof(to_char_type)==1)
+inline constexpr void deco_eof(io_reserve_type_t<to_char_type,aes_gcm_decrypt_deco_t<keysize>>,
+	aes_gcm_decrypt_deco_t<keysize>& deco)
+{
+	::fast_io::details::aead::open_eof(deco);
+}
+
+template<::std::contiguous_iterator fromIter,::std::contiguous_iterator toIter,std::size_t keysize>
+requires (sizeof(::std::iter_value_t<fromIter>)==1&&sizeof(::std::iter_value_t<toIter>)==1)
+inline toIter deco_reserve_define(io_reserve_type_t<::std::iter_value_t<toIter>,aes_gcm_decrypt_deco_t<keysize>>,
+	aes_gcm_decrypt_deco_t<keysize>& deco,fromIter first,fromIter last,toIter iter)
+{
+	::std::byte* const out{reinterpret_cast<::std::byte*>(::std::to_address(iter))};
+	return iter+(::fast_io::details::aead::open_records(deco,
+		reinterpret_cast<::std::byte const*>(::std::to_address(first)),
+		reinterpret_cast<::std::byte const*>(::std::to_address(last)),out)-out);
+}
+
+}
@@ -0,0 +1,230 @@
+#pragma once
+
+/*
+Portable AES (FIPS-197), byte oriented. It backs every target without AES-NI and computes the key schedules that the
+x86 kernels use too, since AES-NI takes round keys in the same byte order. The S-box lookups are table driven and
+therefore not constant time; it is the fallback, not the fast path.
+*/
+
+namespace fast_io::details::aes
+{
+
+struct aes_sbox_tables
+{
+	::std::uint_least8_t sbox[256];
+	::std::uint_least8_t inv_sbox[256];
+};
+
+inline constexpr ::std::uint_least8_t aes_rotl8(::std::uint_least8_t x,unsigned r) noexcept
+{
+	return static_cast<::std::uint_least8_t>((x<<r)|(x>>(8u-r)));
+}
+
+/*
+Walks the multiplicative group with generator 3 and its inverse 0xf6 side by side, so q is always 1/p.
+*/
+inline constexpr aes_sbox_tables generate_aes_sbox_tables() noexcept
+{
+	aes_sbox_tables tb{};
+	::std::uint_least8_t p{1},q{1};
+	do
+	{
+		p=static_cast<::std::uint_least8_t>(p^(p<<1u)^((p&0x80u)?0x1Bu:0u));
+		q=static_cast<::std::uint_least8_t>(q^(q<<1u));
+		q=static_cast<::std::uint_least8_t>(q^(q<<2u));
+		q=static_cast<::std::uint_least8_t>(q^(q<<4u));
+		if(q&0x80u)
+		{
+			q^=0x09u;
+		}
+		::std::uint_least8_t const x{static_cast<::std::uint_least8_t>(q^aes_rotl8(q,1)^aes_rotl8(q,2)^aes_rotl8(q,3)^aes_rotl8(q,4)^0x63u)};
+		tb.sbox[p]=x;
+	}
+	while(p!=1);
+	tb.sbox[0]=0x63;
+	for(std::size_t i{};i!=256;++i)
+	{
+		tb.inv_sbox[tb.sbox[i]]=static_cast<::std::uint_least8_t>(i);
+	}
+	return tb;
+}
+
+inline constexpr aes_sbox_tables aes_sbox{generate_aes_sbox_tables()};
+
+inline constexpr ::std::uint_least8_t aes_xtime(::std::uint_least8_t x) noexcept
+{
+	return static_cast<::std::uint_least8_t>((x<<1u)^((x&0x80u)?0x1Bu:0u));
+}
+
+inline constexpr ::std::uint_least8_t aes_gmul(::std::uint_least8_t a,::std::uint_least8_t b) noexcept
+{
+	::std::uint_least8_t r{};
+	for(;b;b>>=1u)
+	{
+		if(b&1u)
+		{
+			r^=a;
+		}
+		a=aes_xtime(a);
+	}
+	return r;
+}
+
+inline constexpr void aes_inv_mix_column(::std::uint_least8_t* c) noexcept
+{
+	::std::uint_least8_t const a0{c[0]},a1{c[1]},a2{c[2]},a3{c[3]};
+	c[0]=static_cast<::std::uint_least8_t>(aes_gmul(a0,14)^aes_gmul(a1,11)^aes_gmul(a2,13)^aes_gmul(a3,9));
+	c[1]=static_cast<::std::uint_least8_t>(aes_gmul(a0,9)^aes_gmul(a1,14)^aes_gmul(a2,11)^aes_gmul(a3,13));
+	c[2]=static_cast<::std::uint_least8_t>(aes_gmul(a0,13)^aes_gmul(a1,9)^aes_gmul(a2,14)^aes_gmul(a3,11));
+	c[3]=static_cast<::std::uint_least8_t>(aes_gmul(a0,11)^aes_gmul(a1,13)^aes_gmul(a2,9)^aes_gmul(a3,14));
+}
+
+inline constexpr std::size_t aes_rounds(std::size_t keysize) noexcept
+{
+	return keysize/4u+6u;
+}
+
+/*
+Expands keysize bytes of key into (rounds+1)*16 bytes of round keys. With decrypt the schedule is the one of the
+equivalent inverse cipher (FIPS-197 5.3.5): reversed, InvMixColumns applied to the inner keys, which is also what
+aesdec expects.
+*/
+template<std::size_t keysize,bool decrypt>
+inline void aes_expand_key(::std::byte const* key,::std::uint_least8_t* rk) noexcept
+{
+	constexpr std::size_t nk{keysize/4u};
+	constexpr std::size_t rounds{aes_rounds(keysize)};
+	constexpr std::size_t words{4u*(rounds+1u)};
+	::std::uint_least8_t w[words*4u];
+	for(std::size_t i{};i!=keysize;++i)
+	{
+		w[i]=static_cast<::std::uint_least8_t>(key[i]);
+	}
+	::std::uint_least8_t rcon{1};
+	for(std::size_t i{nk};i!=words;++i)
+	{
+		::std::uint_least8_t t[4]{w[4*i-4],w[4*i-3],w[4*i-2],w[4*i-1]};
+		if(i%nk==0)
+		{
+			::std::uint_least8_t const t0{t[0]};
+			t[0]=static_cast<::std::uint_least8_t>(aes_sbox.sbox[t[1]]^rcon);
+			t[1]=aes_sbox.sbox[t[2]];
+			t[2]=aes_sbox.sbox[t[3]];
+			t[3]=aes_sbox.sbox[t0];
+			rcon=aes_xtime(rcon);
+		}
+		else if(6<nk&&i%nk==4)
+		{
+			for(auto& e : t)
+			{
+				e=aes_sbox.sbox[e];
+			}
+		}
+		for(std::size_t j{};j!=4;++j)
+		{
+			w[4*i+j]=static_cast<::std::uint_least8_t>(w[4*(i-nk)+j]^t[j]);
+		}
+	}
+	if constexpr(decrypt)
+	{
+		for(std::size_t r{};r!=rounds+1u;++r)
+		{
+			::fast_io::details::non_overlapped_copy_n(w+16u*(rounds-r),16u,rk+16u*r);
+			if(r!=0&&r!=rounds)
+			{
+				for(std::size_t c{};c!=4;++c)
+				{
+					aes_inv_mix_column(rk+16u*r+4u*c);
+				}
+			}
+		}
+	}
+	else
+	{
+		::fast_io::details::non_overlapped_copy_n(w,sizeof(w),rk);
+	}
+	::fast_io::secure_clear(w,sizeof(w));
+}
+
+inline void aes_portable_encrypt_block(::std::uint_least8_t const* rk,std::size_t rounds,::std::byte const* in,::std::byte* out) noexcept
+{
+	::std::uint_least8_t s[16];
+	for(std::size_t i{};i!=16;++i)
+	{
+		s[i]=static_cast<::std::uint_least8_t>(static_cast<::std::uint_least8_t>(in[i])^rk[i]);
+	}
+	for(std::size_t r{1};;++r)
+	{
+		::std::uint_least8_t t[16];
+		/*
+		SubBytes and ShiftRows: byte i of column c comes from column c+i.
+		*/
+		for(std::size_t c{};c!=4;++c)
+		{
+			for(std::size_t i{};i!=4;++i)
+			{
+				t[4*c+i]=aes_sbox.sbox[s[4*((c+i)&3u)+i]];
+			}
+		}
+		if(r==rounds)
+		{
+			for(std::size_t i{};i!=16;++i)
+			{
+				out[i]=static_cast<::std::byte>(t[i]^rk[16*r+i]);
+			}
+			break;
+		}
+		for(std::size_t c{};c!=4;++c)
+		{
+			::std::uint_least8_t const* a{t+4*c};
+			::std::uint_least8_t const all{static_cast<::std::uint_least8_t>(a[0]^a[1]^a[2]^a[3])};
+			for(std::size_t i{};i!=4;++i)
+			{
+				s[4*c+i]=static_cast<::std::uint_least8_t>(a[i]^all^aes_xtime(static_cast<::std::uint_least8_t>(a[i]^a[(i+1)&3u]))^rk[16*r+4*c+i]);
+			}
+		}
+	}
+	::fast_io::secure_clear(s,sizeof(s));
+}
+
+/*
+rk is a decrypt schedule from aes_expand_key<keysize,true>.
+*/
+inline void aes_portable_decrypt_block(::std::uint_least8_t const* rk,std::size_t rounds,::std::byte const* in,::std::byte* out) noexcept
+{
+	::std::uint_least8_t s[16];
+	for(std::size_t i{};i!=16;++i)
+	{
+		s[i]=static_cast<::std::uint_least8_t>(static_cast<::std::uint_least8_t>(in[i])^rk[i]);
+	}
+	for(std::size_t r{1};;++r)
+	{
+		::std::uint_least8_t t[16];
+		for(std::size_t c{};c!=4;++c)
+		{
+			for(std::size_t i{};i!=4;++i)
+			{
+				t[4*c+i]=aes_sbox.inv_sbox[s[4*((c+4-i)&3u)+i]];
+			}
+		}
+		if(r==rounds)
+		{
+			for(std::size_t i{};i!=16;++i)
+			{
+				out[i]=static_cast<::std::byte>(t[i]^rk[16*r+i]);
+			}
+			break;
+		}
+		for(std::size_t c{};c!=4;++c)
+		{
+			aes_inv_mix_column(t+4*c);
+		}
+		for(std::size_t i{};i!=16;++i)
+		{
+			s[i]=static_cast<::std::uint_least8_t>(t[i]^rk[16*r+i]);
+		}
+	}
+	::fast_io::secure_clear(s,sizeof(s));
+}
+
+}
@@ -0,0 +1,599 @@
+#pragma once
+
+/*
+x86-64 AES kernels. Every kernel keeps 8 independent vectors in flight so aesenc (4 cycles latency, 1-2 per cycle)
+never waits on itself; with VAES a vector holds 2 (ymm) or 4 (zmm) blocks, so one batch is 8, 16 or 32 blocks.
+GHASH multiplies the byte-reflected blocks with pclmulqdq, aggregating a whole batch against precomputed powers of H
+and reducing once per batch (Gueron and Kounavis, "Intel Carry-Less Multiplication Instruction and its Usage for
+Computing the GCM Mode"). The level is fixed at compile time when the target has the features, otherwise probed once.
+The instruction wrappers and generic kernels carry no target attribute: they are always inlined into the target
+specific entry points at the bottom, and GCC checks the builtins there. Clang checks them where they are written, so
+under Clang this header is only included when the translation unit targets AES-NI, and the level is whatever it is
+compiled for; the VAES entry points are left empty unless their features are compiled in too.
+*/
+
+#if !defined(__clang__) || (defined(__VAES__) && defined(__VPCLMULQDQ__) && defined(__AVX2__))
+#define FAST_IO_AES_X86_VAES256
+#endif
+#if !defined(__clang__) || (defined(__VAES__) && defined(__VPCLMULQDQ__) && defined(__AVX512F__) && defined(__AVX512BW__))
+#define FAST_IO_AES_X86_VAES512
+#endif
+
+namespace fast_io::details::aes
+{
+
+enum class aes_x86_level : ::std::uint_least8_t
+{
+none,
+aesni,
+vaes256,
+vaes512
+};
+
+inline aes_x86_level get_aes_x86_level() noexcept
+{
+#if defined(__AES__) && defined(__PCLMUL__) && defined(__VAES__) && defined(__VPCLMULQDQ__) && defined(__AVX512BW__)
+	return aes_x86_level::vaes512;
+#elif defined(__clang__)
+#if defined(FAST_IO_AES_X86_VAES512)
+	return aes_x86_level::vaes512;
+#elif defined(FAST_IO_AES_X86_VAES256)
+	return aes_x86_level::vaes256;
+#else
+	return aes_x86_level::aesni;
+#endif
+#else
+	if constexpr(::fast_io::details::cpu_flags::runtime_cpu_probe_supported)
+	{
+		static aes_x86_level const level{[]() noexcept
+		{
+			__builtin_cpu_init();
+			if(!__builtin_cpu_supports("aes")||!__builtin_cpu_supports("pclmul"))
+				return aes_x86_level::none;
+			if(__builtin_cpu_supports("vaes")&&__builtin_cpu_supports("vpclmulqdq"))
+			{
+				if(__builtin_cpu_supports("avx512bw"))
+					return aes_x86_level::vaes512;
+				if(__builtin_cpu_supports("avx2"))
+					return aes_x86_level::vaes256;
+			}
+			return aes_x86_level::aesni;
+		}()};
+		return level;
+	}
+	else
+	{
+#if defined(__AES__) && defined(__PCLMUL__) && defined(__VAES__) && defined(__VPCLMULQDQ__) && defined(__AVX2__)
+		return aes_x86_level::vaes256;
+#elif defined(__AES__) && defined(__PCLMUL__)
+		return aes_x86_level::aesni;
+#else
+		return aes_x86_level::none;
+#endif
+	}
+#endif
+}
+
+using aes_x86_v2du [[__gnu__::__vector_size__(16)]] = unsigned long long;
+using aes_x86_v4du [[__gnu__::__vector_size__(32)]] = unsigned long long;
+using aes_x86_v8du [[__gnu__::__vector_size__(64)]] = unsigned long long;
+using aes_x86_v2di [[__gnu__::__vector_size__(16)]] = long long;
+using aes_x86_v4di [[__gnu__::__vector_size__(32)]] = long long;
+using aes_x86_v8di [[__gnu__::__vector_size__(64)]] = long long;
+using aes_x86_v32qi [[__gnu__::__vector_size__(32)]] = char;
+using aes_x86_v64qi [[__gnu__::__vector_size__(64)]] = char;
+using aes_x86_v4su [[__gnu__::__vector_size__(16)]] = unsigned;
+
+/*
+lanes 16-byte blocks in one vector. Spelled through classes so the vector attribute survives in the helpers' signatures.
+*/
+template<std::size_t lanes>
+struct aes_x86_vector
+{
+	using type [[__gnu__::__vector_size__(lanes*16u)]] = unsigned long long;
+};
+
+template<std::size_t lanes>
+struct aes_x86_byte_vector
+{
+	using type [[__gnu__::__vector_size__(lanes*16u)]] = unsigned char;
+};
+
+template<std::size_t lanes>
+struct aes_x86_u32_vector
+{
+	using type [[__gnu__::__vector_size__(lanes*16u)]] = unsigned;
+};
+
+/*
+GCC only declares the VAES builtins once it has seen a function targeting VAES, so the wide entry points are declared
+ahead of the wrappers.
+*/
+template<std::size_t rounds,bool inc32>
+[[__gnu__::__target__("avx2,aes,pclmul,vaes,vpclmulqdq")]]
+inline std::size_t aes_x86_ctr_vaes256(::std::uint_least8_t const* rk,::std::byte* counter,::std::byte const* in,::std::byte* out,std::size_t blocks) noexcept;
+
+template<std::size_t rounds,bool inc32>
+[[__gnu__::__target__("avx512f,avx512bw,aes,pclmul,vaes,vpclmulqdq")]]
+inline std::size_t aes_x86_ctr_vaes512(::std::uint_least8_t const* rk,::std::byte* counter,::std::byte const* in,::std::byte* out,std::size_t blocks) noexcept;
+
+/*
+Instruction wrappers. They return wide vectors from functions without AVX, which -Wpsabi flags although they never
+exist outside the kernels they are inlined into.
+*/
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wpsabi"
+template<std::size_t lanes,bool last>
+#if __has_cpp_attribute(__gnu__::__always_inline__)
+[[__gnu__::__always_inline__]]
+#endif
+inline void aes_x86_enc(typename aes_x86_vector<lanes>::type& v,typename aes_x86_vector<lanes>::type const& k) noexcept
+{
+	using vec_type = typename aes_x86_vector<lanes>::type;
+	if constexpr(lanes==1)
+	{
+		if constexpr(last)
+			v=(vec_type)__builtin_ia32_aesenclast128((aes_x86_v2di)v,(aes_x86_v2di)k);
+		else
+			v=(vec_type)__builtin_ia32_aesenc128((aes_x86_v2di)v,(aes_x86_v2di)k);
+	}
+	else if constexpr(lanes==2)
+	{
+		if constexpr(last)
+			v=(vec_type)__builtin_ia32_vaesenclast_v32qi((aes_x86_v32qi)v,(aes_x86_v32qi)k);
+		else
+			v=(vec_type)__builtin_ia32_vaesenc_v32qi((aes_x86_v32qi)v,(aes_x86_v32qi)k);
+	}
+	else
+	{
+		if constexpr(last)
+			v=(vec_type)__builtin_ia32_vaesenclast_v64qi((aes_x86_v64qi)v,(aes_x86_v64qi)k);
+		else
+			v=(vec_type)__builtin_ia32_vaesenc_v64qi((aes_x86_v64qi)v,(aes_x86_v64qi)k);
+	}
+}
+
+template<std::size_t lanes,bool last>
+requires (lanes==1)
+#if __has_cpp_attribute(__gnu__::__always_inline__)
+[[__gnu__::__always_inline__]]
+#endif
+inline void aes_x86_dec(typename aes_x86_vector<lanes>::type& v,typename aes_x86_vector<lanes>::type const& k) noexcept
+{
+	if constexpr(last)
+		v=(aes_x86_v2du)__builtin_ia32_aesdeclast128((aes_x86_v2di)v,(aes_x86_v2di)k);
+	else
+		v=(aes_x86_v2du)__builtin_ia32_aesdec128((aes_x86_v2di)v,(aes_x86_v2di)k);
+}
+
+template<std::size_t lanes,int imm>
+#if __has_cpp_attribute(__gnu__::__always_inline__)
+[[__gnu__::__always_inline__]]
+#endif
+inline void aes_x86_clmul_xor(typename aes_x86_vector<lanes>::type& r,typename aes_x86_vector<lanes>::type const& a,typename aes_x86_vector<lanes>::type const& b) noexcept
+{
+	using vec_type = typename aes_x86_vector<lanes>::type;
+	if constexpr(lanes==1)
+		r^=(vec_type)__builtin_ia32_pclmulqdq128((aes_x86_v2di)a,(aes_x86_v2di)b,imm);
+	else if constexpr(lanes==2)
+		r^=(vec_type)__builtin_ia32_vpclmulqdq_v4di((aes_x86_v4di)a,(aes_x86_v4di)b,imm);
+	else
+		r^=(vec_type)__builtin_ia32_vpclmulqdq_v8di((aes_x86_v8di)a,(aes_x86_v8di)b,imm);
+}
+
+#pragma GCC diagnostic pop
+
+inline constexpr int aes_x86_bswap_index(std::size_t i) noexcept
+{
+	return static_cast<int>((i&~static_cast<std::size_t>(15u))|(15u-(i&15u)));
+}
+
+/*
+Byte order reversal inside every 16-byte lane: big-endian counters and GHASH blocks become little-endian integers.
+*/
+template<std::size_t lanes,std::size_t... i>
+#if __has_cpp_attribute(__gnu__::__always_inline__)
+[[__gnu__::__always_inline__]]
+#endif
+inline void aes_x86_bswap_lanes_impl(typename aes_x86_vector<lanes>::type& v,::std::index_sequence<i...>) noexcept
+{
+	using byte_vector = typename aes_x86_byte_vector<lanes>::type;
+	byte_vector const b{(byte_vector)v};
+	v=(typename aes_x86_vector<lanes>::type)__builtin_shufflevector(b,b,aes_x86_bswap_index(i)...);
+}
+
+template<std::size_t lanes>
+#if __has_cpp_attribute(__gnu__::__always_inline__)
+[[__gnu__::__always_inline__]]
+#endif
+inline void aes_x86_bswap_lanes(typename aes_x86_vector<lanes>::type& v) noexcept
+{
+	::fast_io::details::aes::aes_x86_bswap_lanes_impl<lanes>(v,::std::make_index_sequence<lanes*16u>{});
+}
+
+/*
+with_zero: only lane 0 gets v, the others are zero.
+*/
+template<std::size_t lanes,bool with_zero,std::size_t... i>
+#if __has_cpp_attribute(__gnu__::__always_inline__)
+[[__gnu__::__always_inline__]]
+#endif
+inline void aes_x86_broadcast_impl(typename aes_x86_vector<lanes>::type& r,aes_x86_v2du const& v,::std::index_sequence<i...>) noexcept
+{
+	if constexpr(lanes==1)
+	{
+		r=v;
+	}
+	else
+	{
+		r=__builtin_shufflevector(v,aes_x86_v2du{},static_cast<int>((with_zero&&1<i)?2u+(i&1u):(i&1u))...);
+	}
+}
+
+template<std::size_t lanes,bool with_zero=false>
+#if __has_cpp_attribute(__gnu__::__always_inline__)
+[[__gnu__::__always_inline__]]
+#endif
+inline void aes_x86_broadcast(typename aes_x86_vector<lanes>::type& r,aes_x86_v2du const& v) noexcept
+{
+	::fast_io::details::aes::aes_x86_broadcast_impl<lanes,with_zero>(r,v,::std::make_index_sequence<lanes*2u>{});
+}
+
+/*
+XOR of all lanes.
+*/
+template<std::size_t lanes,std::size_t... l>
+#if __has_cpp_attribute(__gnu__::__always_inline__)
+[[__gnu__::__always_inline__]]
+#endif
+inline aes_x86_v2du aes_x86_fold_lanes(typename aes_x86_vector<lanes>::type const& v,::std::index_sequence<l...>) noexcept
+{
+	if constexpr(lanes==1)
+	{
+		return v;
+	}
+	else
+	{
+		return (__builtin_shufflevector(v,v,static_cast<int>(2u*l),static_cast<int>(2u*l+1u))^...);
+	}
+}
+
+/*
+Adds the per-lane block offsets in off (as {n,0} pairs) to the counters in v. Counter mode carries across all 128 bits
+(SP 800-38A); GCM only increments the low 32 bits (inc32).
+*/
+template<std::size_t lanes,bool inc32,std::size_t... i>
+#if __has_cpp_attribute(__gnu__::__always_inline__)
+[[__gnu__::__always_inline__]]
+#endif
+inline void aes_x86_ctr_add_impl(typename aes_x86_vector<lanes>::type& v,typename aes_x86_vector<lanes>::type const& off,::std::index_sequence<i...>) noexcept
+{
+	using vec_type = typename aes_x86_vector<lanes>::type;
+	if constexpr(inc32)
+	{
+		using u32_vector = typename aes_x86_u32_vector<lanes>::type;
+		v=(vec_type)((u32_vector)v+(u32_vector)off);
+	}
+	else
+	{
+		vec_type const s{v+off};
+		vec_type const carry{(vec_type)(s<v)};
+		v=s-__builtin_shufflevector(carry,vec_type{},static_cast<int>((i&1u)?i-1u:lanes*2u+i)...);
+	}
+}
+
+template<std::size_t lanes,bool inc32>
+#if __has_cpp_attribute(__gnu__::__always_inline__)
+[[__gnu__::__always_inline__]]
+#endif
+inline void aes_x86_ctr_add(typename aes_x86_vector<lanes>::type& v,typename aes_x86_vector<lanes>::type const& off) noexcept
+{
+	::fast_io::details::aes::aes_x86_ctr_add_impl<lanes,inc32>(v,off,::std::make_index_sequence<lanes*2u>{});
+}
+
+template<std::size_t lanes,std::size_t... i>
+#if __has_cpp_attribute(__gnu__::__always_inline__)
+[[__gnu__::__always_inline__]]
+#endif
+inline void aes_x86_lane_offsets(typename aes_x86_vector<lanes>::type& v,std::size_t first,::std::index_sequence<i...>) noexcept
+{
+	v=typename aes_x86_vector<lanes>::type{((i&1u)?0ull:static_cast<unsigned long long>(first+i/2u))...};
+}
+
+template<std::size_t rounds,std::size_t lanes>
+#if __has_cpp_attribute(__gnu__::__always_inline__)
+[[__gnu__::__always_inline__]]
+#endif
+inline void aes_x86_load_round_keys(typename aes_x86_vector<lanes>::type* keys,::std::uint_least8_t const* rk) noexcept
+{
+	for(std::size_t r{};r!=rounds+1u;++r)
+	{
+		aes_x86_v2du k;
+		__builtin_memcpy(__builtin_addressof(k),rk+16u*r,16u);
+		::fast_io::details::aes::aes_x86_broadcast<lanes>(keys[r],k);
+	}
+}
+
+template<std::size_t rounds,std::size_t lanes,std::size_t vecs,bool decrypt>
+#if __has_cpp_attribute(__gnu__::__always_inline__)
+[[__gnu__::__always_inline__]]
+#endif
+inline void aes_x86_cipher(typename aes_x86_vector<lanes>::type* x,typename aes_x86_vector<lanes>::type const* keys) noexcept
+{
+	for(std::size_t i{};i!=vecs;++i)
+	{
+		x[i]^=keys[0];
+	}
+	for(std::size_t r{1};r!=rounds;++r)
+	{
+		for(std::size_t i{};i!=vecs;++i)
+		{
+			if constexpr(decrypt)
+			{
+				::fast_io::details::aes::aes_x86_dec<lanes,false>(x[i],keys[r]);
+			}
+			else
+			{
+				::fast_io::details::aes::aes_x86_enc<lanes,false>(x[i],keys[r]);
+			}
+		}
+	}
+	for(std::size_t i{};i!=vecs;++i)
+	{
+		if constexpr(decrypt)
+		{
+			::fast_io::details::aes::aes_x86_dec<lanes,true>(x[i],keys[rounds]);
+		}
+		else
+		{
+			::fast_io::details::aes::aes_x86_enc<lanes,true>(x[i],keys[rounds]);
+		}
+	}
+}
+
+/*
+ECB over every whole group of vecs blocks. Returns the number of blocks processed.
+*/
+template<std::size_t rounds,std::size_t vecs,bool decrypt>
+#if __has_cpp_attribute(__gnu__::__always_inline__)
+[[__gnu__::__always_inline__]]
+#endif
+inline std::size_t aes_x86_ecb_generic(::std::uint_least8_t const* rk,::std::byte const* in,::std::byte* out,std::size_t blocks) noexcept
+{
+	aes_x86_v2du keys[rounds+1u];
+	::fast_io::details::aes::aes_x86_load_round_keys<rounds,1>(keys,rk);
+	std::size_t const processed{blocks/vecs*vecs};
+	for(std::size_t k{};k!=processed;k+=vecs)
+	{
+		aes_x86_v2du x[vecs];
+		__builtin_memcpy(x,in,sizeof(x));
+		::fast_io::details::aes::aes_x86_cipher<rounds,1,vecs,decrypt>(x,keys);
+		__builtin_memcpy(out,x,sizeof(x));
+		in+=sizeof(x);
+		out+=sizeof(x);
+	}
+	return processed;
+}
+
+template<std::size_t rounds,bool decrypt>
+[[__gnu__::__target__("aes")]]
+inline void aes_x86_ecb(::std::uint_least8_t const* rk,::std::byte const* in,::std::byte* out,std::size_t blocks) noexcept
+{
+	std::size_t const done{::fast_io::details::aes::aes_x86_ecb_generic<rounds,8,decrypt>(rk,in,out,blocks)};
+	::fast_io::details::aes::aes_x86_ecb_generic<rounds,1,decrypt>(rk,in+done*16u,out+done*16u,blocks-done);
+}
+
+/*
+XORs the keystream of counter,counter+1,... into every whole group of lanes*vecs blocks and advances the big-endian
+counter block. in may equal out. Returns the number of blocks processed.
+*/
+template<std::size_t rounds,std::size_t lanes,std::size_t vecs,bool inc32>
+#if __has_cpp_attribute(__gnu__::__always_inline__)
+[[__gnu__::__always_inline__]]
+#endif
+inline std::size_t aes_x86_ctr_generic(::std::uint_least8_t const* rk,::std::byte* counter,::std::byte const* in,::std::byte* out,std::size_t blocks) noexcept
+{
+	using vec_type = typename aes_x86_vector<lanes>::type;
+	constexpr std::size_t batch{lanes*vecs};
+	std::size_t const processed{blocks/batch*batch};
+	if(processed==0)
+	{
+		return 0;
+	}
+	vec_type keys[rounds+1u];
+	::fast_io::details::aes::aes_x86_load_round_keys<rounds,lanes>(keys,rk);
+	aes_x86_v2du c;
+	__builtin_memcpy(__builtin_addressof(c),counter,16u);
+	::fast_io::details::aes::aes_x86_bswap_lanes<1>(c);
+	vec_type base;
+	::fast_io::details::aes::aes_x86_broadcast<lanes>(base,c);
+	vec_type offsets[vecs];
+	for(std::size_t i{};i!=vecs;++i)
+	{
+		::fast_io::details::aes::aes_x86_lane_offsets<lanes>(offsets[i],i*lanes,::std::make_index_sequence<lanes*2u>{});
+	}
+	vec_type step;
+	::fast_io::details::aes::aes_x86_broadcast<lanes>(step,aes_x86_v2du{batch,0u});
+	for(std::size_t k{};k!=processed;k+=batch)
+	{
+		vec_type x[vecs];
+		for(std::size_t i{};i!=vecs;++i)
+		{
+			x[i]=base;
+			::fast_io::details::aes::aes_x86_ctr_add<lanes,inc32>(x[i],offsets[i]);
+			::fast_io::details::aes::aes_x86_bswap_lanes<lanes>(x[i]);
+		}
+		::fast_io::details::aes::aes_x86_cipher<rounds,lanes,vecs,false>(x,keys);
+		for(std::size_t i{};i!=vecs;++i)
+		{
+			vec_type v;
+			__builtin_memcpy(__builtin_addressof(v),in+i*sizeof(vec_type),sizeof(vec_type));
+			v^=x[i];
+			__builtin_memcpy(out+i*sizeof(vec_type),__builtin_addressof(v),sizeof(vec_type));
+		}
+		::fast_io::details::aes::aes_x86_ctr_add<lanes,inc32>(base,step);
+		in+=batch*16u;
+		out+=batch*16u;
+	}
+	c=__builtin_shufflevector(base,base,0,1);
+	::fast_io::details::aes::aes_x86_bswap_lanes<1>(c);
+	__builtin_memcpy(counter,__builtin_addressof(c),16u);
+	return processed;
+}
+
+/*
+lo^mid*x^64^hi*x^128 is the 256-bit carry-less product of two byte-reflected blocks; shift it left by one to undo the
+bit reflection and reduce modulo x^128+x^7+x^2+x+1.
+*/
+#if __has_cpp_attribute(__gnu__::__always_inline__)
+[[__gnu__::__always_inline__]]
+#endif
+inline aes_x86_v2du aes_x86_ghash_reduce(aes_x86_v2du const& lo,aes_x86_v2du const& mid,aes_x86_v2du const& hi) noexcept
+{
+	aes_x86_v4su a{(aes_x86_v4su)(lo^__builtin_shufflevector(mid,aes_x86_v2du{},2,0))};
+	aes_x86_v4su b{(aes_x86_v4su)(hi^__builtin_shufflevector(mid,aes_x86_v2du{},1,2))};
+	aes_x86_v4su const z{};
+	aes_x86_v4su const ca{a>>31u};
+	aes_x86_v4su const cb{b>>31u};
+	a=(a<<1u)|__builtin_shufflevector(ca,z,4,0,1,2);
+	b=(b<<1u)|__builtin_shufflevector(cb,z,4,0,1,2)|__builtin_shufflevector(ca,z,3,4,4,4);
+	aes_x86_v4su const t{(a<<31u)^(a<<30u)^(a<<25u)};
+	a^=__builtin_shufflevector(t,z,4,4,4,0);
+	aes_x86_v4su const u{(a>>1u)^(a>>2u)^(a>>7u)^__builtin_shufflevector(t,z,1,2,3,4)};
+	return (aes_x86_v2du)(b^a^u);
+}
+
+/*
+GHASH over every whole group of lanes*vecs blocks. y is the byte-reflected hash state and table holds the
+byte-reflected powers H^32,H^31,...,H^1, so block j of a batch of n meets H^(n-j). Returns the number of blocks processed.
+*/
+template<std::size_t lanes,std::size_t vecs>
+#if __has_cpp_attribute(__gnu__::__always_inline__)
+[[__gnu__::__always_inline__]]
+#endif
+inline std::size_t aes_x86_ghash_generic(::std::byte const* table,aes_x86_v2du& y,::std::byte const* in,std::size_t blocks) noexcept
+{
+	using vec_type = typename aes_x86_vector<lanes>::type;
+	constexpr std::size_t batch{lanes*vecs};
+	static_assert(batch<=32);
+	std::size_t const processed{blocks/batch*batch};
+	if(processed==0)
+	{
+		return 0;
+	}
+	vec_type h[vecs];
+	__builtin_memcpy(h,table+(32u-batch)*16u,sizeof(h));
+	for(std::size_t k{};k!=processed;k+=batch)
+	{
+		vec_type lo{},mid{},hi{};
+		for(std::size_t i{};i!=vecs;++i)
+		{
+			vec_type d;
+			__builtin_memcpy(__builtin_addressof(d),in+i*sizeof(vec_type),sizeof(vec_type));
+			::fast_io::details::aes::aes_x86_bswap_lanes<lanes>(d);
+			if(i==0)
+			{
+				vec_type yv;
+				::fast_io::details::aes::aes_x86_broadcast<lanes,true>(yv,y);
+				d^=yv;
+			}
+			::fast_io::details::aes::aes_x86_clmul_xor<lanes,0x00>(lo,d,h[i]);
+			::fast_io::details::aes::aes_x86_clmul_xor<lanes,0x11>(hi,d,h[i]);
+			::fast_io::details::aes::aes_x86_clmul_xor<lanes,0x01>(mid,d,h[i]);
+			::fast_io::details::aes::aes_x86_clmul_xor<lanes,0x10>(mid,d,h[i]);
+		}
+		y=::fast_io::details::aes::aes_x86_ghash_reduce(
+			::fast_io::details::aes::aes_x86_fold_lanes<lanes>(lo,::std::make_index_sequence<lanes>{}),
+			::fast_io::details::aes::aes_x86_fold_lanes<lanes>(mid,::std::make_index_sequence<lanes>{}),
+			::fast_io::details::aes::aes_x86_fold_lanes<lanes>(hi,::std::make_index_sequence<lanes>{}));
+		in+=batch*16u;
+	}
+	return processed;
+}
+
+/*
+Kernels per level: the widest batches first, then the AES-NI 8- and 1-block batches take the rest. y is the
+big-endian GHASH state as in the specification.
+*/
+template<std::size_t rounds,bool inc32>
+[[__gnu__::__target__("aes,pclmul,ssse3")]]
+inline void aes_x86_ctr_aesni(::std::uint_least8_t const* rk,::std::byte* counter,::std::byte const* in,::std::byte* out,std::size_t blocks) noexcept
+{
+	std::size_t const done{::fast_io::details::aes::aes_x86_ctr_generic<rounds,1,8,inc32>(rk,counter,in,out,blocks)};
+	::fast_io::details::aes::aes_x86_ctr_generic<rounds,1,1,inc32>(rk,counter,in+done*16u,out+done*16u,blocks-done);
+}
+
+template<std::size_t rounds,bool inc32>
+[[__gnu__::__target__("avx2,aes,pclmul,vaes,vpclmulqdq")]]
+inline std::size_t aes_x86_ctr_vaes256(::std::uint_least8_t const* rk,::std::byte* counter,::std::byte const* in,::std::byte* out,std::size_t blocks) noexcept
+{
+#ifdef FAST_IO_AES_X86_VAES256
+	return ::fast_io::details::aes::aes_x86_ctr_generic<rounds,2,8,inc32>(rk,counter,in,out,blocks);
+#else
+	(void)rk;(void)counter;(void)in;(void)out;(void)blocks;
+	return 0;
+#endif
+}
+
+template<std::size_t rounds,bool inc32>
+[[__gnu__::__target__("avx512f,avx512bw,aes,pclmul,vaes,vpclmulqdq")]]
+inline std::size_t aes_x86_ctr_vaes512(::std::uint_least8_t const* rk,::std::byte* counter,::std::byte const* in,::std::byte* out,std::size_t blocks) noexcept
+{
+#ifdef FAST_IO_AES_X86_VAES512
+	return ::fast_io::details::aes::aes_x86_ctr_generic<rounds,4,8,inc32>(rk,counter,in,out,blocks);
+#else
+	(void)rk;(void)counter;(void)in;(void)out;(void)blocks;
+	return 0;
+#endif
+}
+
+[[__gnu__::__target__("aes,pclmul,ssse3")]]
+inline void aes_x86_ghash_aesni(::std::byte const* table,::std::byte* y,::std::byte const* in,std::size_t blocks) noexcept
+{
+	aes_x86_v2du s;
+	__builtin_memcpy(__builtin_addressof(s),y,16u);
+	::fast_io::details::aes::aes_x86_bswap_lanes<1>(s);
+	std::size_t const done{::fast_io::details::aes::aes_x86_ghash_generic<1,8>(table,s,in,blocks)};
+	::fast_io::details::aes::aes_x86_ghash_generic<1,1>(table,s,in+done*16u,blocks-done);
+	::fast_io::details::aes::aes_x86_bswap_lanes<1>(s);
+	__builtin_memcpy(y,__builtin_addressof(s),16u);
+}
+
+[[__gnu__::__target__("avx2,aes,pclmul,vaes,vpclmulqdq")]]
+inline std::size_t aes_x86_ghash_vaes256(::std::byte const* table,::std::byte* y,::std::byte const* in,std::size_t blocks) noexcept
+{
+#ifdef FAST_IO_AES_X86_VAES256
+	aes_x86_v2du s;
+	__builtin_memcpy(__builtin_addressof(s),y,16u);
+	::fast_io::details::aes::aes_x86_bswap_lanes<1>(s);
+	std::size_t const done{::fast_io::details::aes::aes_x86_ghash_generic<2,8>(table,s,in,blocks)};
+	::fast_io::details::aes::aes_x86_bswap_lanes<1>(s);
+	__builtin_memcpy(y,__builtin_addressof(s),16u);
+	return done;
+#else
+	(void)table;(void)y;(void)in;(void)blocks;
+	return 0;
+#endif
+}
+
+[[__gnu__::__target__("avx512f,avx512bw,aes,pclmul,vaes,vpclmulqdq")]]
+inline std::size_t aes_x86_ghash_vaes512(::std::byte const* table,::std::byte* y,::std::byte const* in,std::size_t blocks) noexcept
+{
+#ifdef FAST_IO_AES_X86_VAES512
+	aes_x86_v2du s;
+	__builtin_memcpy(__builtin_addressof(s),y,16u);
+	::fast_io::details::aes::aes_x86_bswap_lanes<1>(s);
+	std::size_t const done{::fast_io::details::aes::aes_x86_ghash_generic<4,8>(table,s,in,blocks)};
+	::fast_io::details::aes::aes_x86_bswap_lanes<1>(s);
+	__builtin_memcpy(y,__builtin_addressof(s),16u);
+	return done;
+#else
+	(void)table;(void)y;(void)in;(void)blocks;
+	return 0;
+#endif
+}
+
+}
+
+#undef FAST_IO_AES_X86_VAES512
+#undef FAST_IO_AES_X86_VAES256
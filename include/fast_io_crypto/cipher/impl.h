@@ -0,0 +1,7 @@
+#pragma once
+
+#include<span>
+#include"aes.h"
+#include"aes_ctr.h"
+#include"aes_gcm.h"
+#undef FAST_IO_AES_HAS_X86
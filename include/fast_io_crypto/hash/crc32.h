@@ -48,16 +48,151 @@ inline constexpr std::uint_least32_t crc32_tb[256]{0x0,0x77073096,0xee0e612c,0x9
 
 inline constexpr std::uint_least32_t crc32c_tb[256]{0x0,0xf26b8303,0xe13b70f7,0x1350f3f4,0xc79a971f,0x35f1141c,0x26a1e7e8,0xd4ca64eb,0x8ad958cf,0x78b2dbcc,0x6be22838,0x9989ab3b,0x4d43cfd0,0xbf284cd3,0xac78bf27,0x5e133c24,0x105ec76f,0xe235446c,0xf165b798,0x30e349b,0xd7c45070,0x25afd373,0x36ff2087,0xc494a384,0x9a879fa0,0x68ec1ca3,0x7bbcef57,0x89d76c54,0x5d1d08bf,0xaf768bbc,0xbc267848,0x4e4dfb4b,0x20bd8ede,0xd2d60ddd,0xc186fe29,0x33ed7d2a,0xe72719c1,0x154c9ac2,0x61c6936,0xf477ea35,0xaa64d611,0x580f5512,0x4b5fa6e6,0xb93425e5,0x6dfe410e,0x9f95c20d,0x8cc531f9,0x7eaeb2fa,0x30e349b1,0xc288cab2,0xd1d83946,0x23b3ba45,0xf779deae,0x5125dad,0x1642ae59,0xe4292d5a,0xba3a117e,0x4851927d,0x5b016189,0xa96ae28a,0x7da08661,0x8fcb0562,0x9c9bf696,0x6ef07595,0x417b1dbc,0xb3109ebf,0xa0406d4b,0x522bee48,0x86e18aa3,0x748a09a0,0x67dafa54,0x95b17957,0xcba24573,0x39c9c670,0x2a993584,0xd8f2b687,0xc38d26c,0xfe53516f,0xed03a29b,0x1f682198,0x5125dad3,0xa34e59d0,0xb01eaa24,0x42752927,0x96bf4dcc,0x64d4cecf,0x77843d3b,0x85efbe38,0xdbfc821c,0x2997011f,0x3ac7f2eb,0xc8ac71e8,0x1c661503,0xee0d9600,0xfd5d65f4,0xf36e6f7,0x61c69362,0x93ad1061,0x80fde395,0x72966096,0xa65c047d,0x5437877e,0x4767748a,0xb50cf789,0xeb1fcbad,0x197448ae,0xa24bb5a,0xf84f3859,0x2c855cb2,0xdeeedfb1,0xcdbe2c45,0x3fd5af46,0x7198540d,0x83f3d70e,0x90a324fa,0x62c8a7f9,0xb602c312,0x44694011,0x5739b3e5,0xa55230e6,0xfb410cc2,0x92a8fc1,0x1a7a7c35,0xe811ff36,0x3cdb9bdd,0xceb018de,0xdde0eb2a,0x2f8b6829,0x82f63b78,0x709db87b,0x63cd4b8f,0x91a6c88c,0x456cac67,0xb7072f64,0xa457dc90,0x563c5f93,0x82f63b7,0xfa44e0b4,0xe9141340,0x1b7f9043,0xcfb5f4a8,0x3dde77ab,0x2e8e845f,0xdce5075c,0x92a8fc17,0x60c37f14,0x73938ce0,0x81f80fe3,0x55326b08,0xa759e80b,0xb4091bff,0x466298fc,0x1871a4d8,0xea1a27db,0xf94ad42f,0xb21572c,0xdfeb33c7,0x2d80b0c4,0x3ed04330,0xccbbc033,0xa24bb5a6,0x502036a5,0x4370c551,0xb11b4652,0x65d122b9,0x97baa1ba,0x84ea524e,0x7681d14d,0x2892ed69,0xdaf96e6a,0xc9a99d9e,0x3bc21e9d,0xef087a76,0x1d63f975,0xe330a81,0xfc588982,0xb21572c9,0x407ef1ca,0x532e023e,0xa145813d,0x758fe5d6,0x87e466d5,0x94b49521,0x66df1622,0x38cc2a06,0xcaa7a905,0xd9f75af1,0x2b9cd9f2,0xff56bd19,0xd3d3e1a,0x1e6dcdee,0xec064eed,0xc38d26c4,0x31e6a5c7,0x22b65633,0xd0ddd530,0x417b1db,0xf67c32d8,0xe52cc12c,0x1747422f,0x49547e0b,0xbb3ffd08,0xa86f0efc,0x5a048dff,0x8ecee914,0x7ca56a17,0x6ff599e3,0x9d9e1ae0,0xd3d3e1ab,0x21b862a8,0x32e8915c,0xc083125f,0x144976b4,0xe622f5b7,0xf5720643,0x7198540,0x590ab964,0xab613a67,0xb831c993,0x4a5a4a90,0x9e902e7b,0x6cfbad78,0x7fab5e8c,0x8dc0dd8f,0xe330a81a,0x115b2b19,0x20bd8ed,0xf0605bee,0x24aa3f05,0xd6c1bc06,0xc5914ff2,0x37faccf1,0x69e9f0d5,0x9b8273d6,0x88d28022,0x7ab90321,0xae7367ca,0x5c18e4c9,0x4f48173d,0xbd23943e,0xf36e6f75,0x105ec76,0x12551f82,0xe03e9c81,0x34f4f86a,0xc69f7b69,0xd5cf889d,0x27a40b9e,0x79b737ba,0x8bdcb4b9,0x988c474d,0x6ae7c44e,0xbe2da0a5,0x4c4623a6,0x5f16d052,0xad7d5351};
 
+
+/*
+Slice-by-16: table k maps a byte to its contribution after k further zero bytes, so sixteen independent lookups
+replace sixteen dependent ones. Portable tier and tail handler for the hardware kernels.
+*/
+using crc32_slice_table = ::fast_io::freestanding::array<::fast_io::freestanding::array<std::uint_least32_t,256>,16>;
+
+inline constexpr crc32_slice_table generate_crc32_slice_table(std::uint_least32_t const* tb) noexcept
+{
+	crc32_slice_table t{};
+	for(std::size_t n{};n!=256;++n)
+	{
+		t[0][n]=tb[n];
+	}
+	for(std::size_t k{1};k!=16;++k)
+	{
+		for(std::size_t n{};n!=256;++n)
+		{
+			std::uint_least32_t const v{t[k-1][n]};
+			t[k][n]=(v>>8)^tb[v&0xff];
+		}
+	}
+	return t;
+}
+
+inline constexpr crc32_slice_table crc32_slice_tb{generate_crc32_slice_table(crc32_tb)};
+inline constexpr crc32_slice_table crc32c_slice_tb{generate_crc32_slice_table(crc32c_tb)};
+
+inline constexpr std::uint_least32_t crc32_load_le32(std::byte const* p) noexcept
+{
+	return static_cast<std::uint_least32_t>(p[0])|(static_cast<std::uint_least32_t>(p[1])<<8)|
+		(static_cast<std::uint_least32_t>(p[2])<<16)|(static_cast<std::uint_least32_t>(p[3])<<24);
+}
+
+inline constexpr std::uint_least32_t calculate_crc32_slice16(std::uint_least32_t crc,std::byte const* i,std::byte const* ed,crc32_slice_table const& t) noexcept
+{
+	for(;16<=static_cast<std::size_t>(ed-i);i+=16)
+	{
+		crc^=crc32_load_le32(i);
+		std::uint_least32_t const w1{crc32_load_le32(i+4)},w2{crc32_load_le32(i+8)},w3{crc32_load_le32(i+12)};
+		crc=t[15][crc&0xff]^t[14][(crc>>8)&0xff]^t[13][(crc>>16)&0xff]^t[12][crc>>24]^
+			t[11][w1&0xff]^t[10][(w1>>8)&0xff]^t[9][(w1>>16)&0xff]^t[8][w1>>24]^
+			t[7][w2&0xff]^t[6][(w2>>8)&0xff]^t[5][(w2>>16)&0xff]^t[4][w2>>24]^
+			t[3][w3&0xff]^t[2][(w3>>8)&0xff]^t[1][(w3>>16)&0xff]^t[0][w3>>24];
+	}
+	return calculate_crc32_common(crc,i,ed,t[0].data());
+}
+
+/*
+Arithmetic modulo the (bit-reflected) generator, as in zlib's crc32_combine: appending n zero bytes to a message
+multiplies its crc register by x^(8n). This is what lets independently computed streams be stitched together.
+*/
+inline constexpr std::uint_least32_t crc32_multmodp(std::uint_least32_t a,std::uint_least32_t b,std::uint_least32_t poly) noexcept
+{
+	std::uint_least32_t p{};
+	for(std::uint_least32_t m{static_cast<std::uint_least32_t>(1)<<31};m;m>>=1)
+	{
+		if(a&m)
+		{
+			p^=b;
+		}
+		b=(b&1u)?((b>>1)^poly):(b>>1);
+	}
+	return p;
+}
+
+inline constexpr std::uint_least32_t crc32_x8nmodp(std::size_t n,std::uint_least32_t poly) noexcept
+{
+	std::uint_least32_t p{static_cast<std::uint_least32_t>(1)<<31};
+	std::uint_least32_t sq{static_cast<std::uint_least32_t>(1)<<23};
+	for(;n;n>>=1)
+	{
+		if(n&1u)
+		{
+			p=crc32_multmodp(sq,p,poly);
+		}
+		sq=crc32_multmodp(sq,sq,poly);
+	}
+	return p;
+}
+
+using crc32_shift_table = ::fast_io::freestanding::array<::fast_io::freestanding::array<std::uint_least32_t,256>,4>;
+
+inline constexpr crc32_shift_table generate_crc32_shift_table(std::size_t n,std::uint_least32_t poly) noexcept
+{
+	std::uint_least32_t const op{crc32_x8nmodp(n,poly)};
+	crc32_shift_table t{};
+	for(std::size_t k{};k!=4;++k)
+	{
+		for(std::uint_least32_t b{};b!=256;++b)
+		{
+			t[k][b]=crc32_multmodp(op,b<<(8*k),poly);
+		}
+	}
+	return t;
+}
+
+inline constexpr std::uint_least32_t crc32_shift(crc32_shift_table const& t,std::uint_least32_t crc) noexcept
+{
+	return t[0][crc&0xff]^t[1][(crc>>8)&0xff]^t[2][(crc>>16)&0xff]^t[3][crc>>24];
+}
+
+}
+
+}
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#include"crc32_x86.h"
+#endif
+
+namespace fast_io
+{
+
+namespace details
+{
+
 template<crc32_option opt>
 inline constexpr std::uint_least32_t calculate_crc32(std::uint_least32_t crc,std::byte const* i,std::byte const* ed) noexcept
 {
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__)) && __cpp_lib_is_constant_evaluated >= 201811L
+	if(!std::is_constant_evaluated())
+	{
+		if constexpr(opt==crc32_option::crc32c)
+		{
+			if(::fast_io::details::crc32_x86_has_sse42())
+			{
+				return ::fast_io::details::crc32c_x86_sse42_impl(crc,i,ed);
+			}
+		}
+		else
+		{
+			if(crc32_x86_pclmul_min_size<=static_cast<std::size_t>(ed-i)&&::fast_io::details::crc32_x86_has_pclmul())
+			{
+				return ::fast_io::details::crc32_x86_pclmul_impl(crc,i,ed);
+			}
+		}
+	}
+#endif
 	if constexpr(opt==crc32_option::crc32)
 	{
-		return calculate_crc32_common(crc,i,ed,crc32_tb);
+		return calculate_crc32_slice16(crc,i,ed,crc32_slice_tb);
 	}
 	else
 	{
-		return calculate_crc32_common(crc,i,ed,crc32c_tb);
+		return calculate_crc32_slice16(crc,i,ed,crc32c_slice_tb);
 	}
 }
 
@@ -0,0 +1,179 @@
+#pragma once
+
+/*
+x86-64 CRC kernels.
+CRC32C: the SSE4.2 crc32 instruction has 3 cycles latency and 1 cycle throughput, so three independent streams keep it
+busy; the streams are stitched together with zero-shift tables (Mark Adler's crc32c.c scheme).
+CRC32: the crc32 instruction hardwires the Castagnoli polynomial, so the IEEE polynomial folds 64 bytes per iteration
+with carry-less multiplication and finishes with a Barrett reduction (Intel, "Fast CRC Computation for Generic
+Polynomials Using PCLMULQDQ Instruction"; constants as in the Linux kernel's crc32-pclmul_asm.S).
+Both are picked at compile time when the target already has the feature, otherwise probed once at runtime.
+*/
+
+namespace fast_io::details
+{
+
+inline constexpr std::uint_least32_t crc32c_poly{0x82F63B78};
+inline constexpr std::size_t crc32c_x86_long_size{8192};
+inline constexpr std::size_t crc32c_x86_short_size{256};
+inline constexpr crc32_shift_table crc32c_long_shift_tb{generate_crc32_shift_table(crc32c_x86_long_size,crc32c_poly)};
+inline constexpr crc32_shift_table crc32c_short_shift_tb{generate_crc32_shift_table(crc32c_x86_short_size,crc32c_poly)};
+
+inline constexpr std::size_t crc32_x86_pclmul_min_size{64};
+
+inline bool crc32_x86_has_sse42() noexcept
+{
+#if defined(__SSE4_2__)
+	return true;
+#else
+	if constexpr(::fast_io::details::cpu_flags::runtime_cpu_probe_supported)
+	{
+		static bool const supported{(__builtin_cpu_init(),__builtin_cpu_supports("sse4.2")!=0)};
+		return supported;
+	}
+	else
+	{
+		return false;
+	}
+#endif
+}
+
+inline bool crc32_x86_has_pclmul() noexcept
+{
+#if defined(__PCLMUL__)
+	return true;
+#else
+	if constexpr(::fast_io::details::cpu_flags::runtime_cpu_probe_supported)
+	{
+		static bool const supported{(__builtin_cpu_init(),__builtin_cpu_supports("pclmul")!=0)};
+		return supported;
+	}
+	else
+	{
+		return false;
+	}
+#endif
+}
+
+#if __has_cpp_attribute(__gnu__::__always_inline__)
+[[__gnu__::__always_inline__]]
+#endif
+inline std::uint_least64_t crc32_x86_load64(std::byte const* p) noexcept
+{
+	std::uint_least64_t v;
+	__builtin_memcpy(__builtin_addressof(v),p,sizeof(v));
+	return v;
+}
+
+template<std::size_t len>
+[[__gnu__::__target__("sse4.2")]]
+inline std::byte const* crc32c_x86_sse42_three_way(std::uint_least32_t& crc,std::byte const* first,std::byte const* last,crc32_shift_table const& shift_tb) noexcept
+{
+	std::uint_least64_t c0{crc};
+	for(;len*3<=static_cast<std::size_t>(last-first);first+=len*2)
+	{
+		std::uint_least64_t c1{},c2{};
+		for(std::byte const* const block_last{first+len};first!=block_last;first+=8)
+		{
+			c0=__builtin_ia32_crc32di(c0,crc32_x86_load64(first));
+			c1=__builtin_ia32_crc32di(c1,crc32_x86_load64(first+len));
+			c2=__builtin_ia32_crc32di(c2,crc32_x86_load64(first+len*2));
+		}
+		c0=crc32_shift(shift_tb,static_cast<std::uint_least32_t>(c0))^c1;
+		c0=crc32_shift(shift_tb,static_cast<std::uint_least32_t>(c0))^c2;
+	}
+	crc=static_cast<std::uint_least32_t>(c0);
+	return first;
+}
+
+[[__gnu__::__target__("sse4.2")]]
+inline std::uint_least32_t crc32c_x86_sse42_impl(std::uint_least32_t crc,std::byte const* first,std::byte const* last) noexcept
+{
+	for(;first!=last&&(reinterpret_cast<std::uintptr_t>(first)&7u);++first)
+	{
+		crc=__builtin_ia32_crc32qi(crc,static_cast<unsigned char>(*first));
+	}
+	first=crc32c_x86_sse42_three_way<crc32c_x86_long_size>(crc,first,last,crc32c_long_shift_tb);
+	first=crc32c_x86_sse42_three_way<crc32c_x86_short_size>(crc,first,last,crc32c_short_shift_tb);
+	std::uint_least64_t c0{crc};
+	for(;8<=static_cast<std::size_t>(last-first);first+=8)
+	{
+		c0=__builtin_ia32_crc32di(c0,crc32_x86_load64(first));
+	}
+	crc=static_cast<std::uint_least32_t>(c0);
+	for(;first!=last;++first)
+	{
+		crc=__builtin_ia32_crc32qi(crc,static_cast<unsigned char>(*first));
+	}
+	return crc;
+}
+
+using crc32_x86_v2du [[__gnu__::__vector_size__(16)]] = unsigned long long;
+using crc32_x86_v2di [[__gnu__::__vector_size__(16)]] = long long;
+using crc32_x86_v4su [[__gnu__::__vector_size__(16)]] = unsigned;
+
+template<int imm>
+[[__gnu__::__target__("pclmul")]]
+#if __has_cpp_attribute(__gnu__::__always_inline__)
+[[__gnu__::__always_inline__]]
+#endif
+inline crc32_x86_v2du crc32_x86_clmul(crc32_x86_v2du a,crc32_x86_v2du b) noexcept
+{
+	return (crc32_x86_v2du)__builtin_ia32_pclmulqdq128((crc32_x86_v2di)a,(crc32_x86_v2di)b,imm);
+}
+
+[[__gnu__::__target__("pclmul")]]
+#if __has_cpp_attribute(__gnu__::__always_inline__)
+[[__gnu__::__always_inline__]]
+#endif
+inline crc32_x86_v2du crc32_x86_fold(crc32_x86_v2du x,crc32_x86_v2du k,std::byte const* p) noexcept
+{
+	crc32_x86_v2du v;
+	__builtin_memcpy(__builtin_addressof(v),p,sizeof(v));
+	return crc32_x86_clmul<0x00>(x,k)^crc32_x86_clmul<0x11>(x,k)^v;
+}
+
+/*
+Requires at least crc32_x86_pclmul_min_size bytes.
+*/
+[[__gnu__::__target__("pclmul")]]
+inline std::uint_least32_t crc32_x86_pclmul_impl(std::uint_least32_t crc,std::byte const* first,std::byte const* last) noexcept
+{
+	constexpr crc32_x86_v2du k1k2{0x154442bd4,0x1c6e41596};
+	constexpr crc32_x86_v2du k3k4{0x1751997d0,0x0ccaa009e};
+	constexpr crc32_x86_v2du k5{0x163cd6124,0};
+	constexpr crc32_x86_v2du poly_mu{0x1db710641,0x1f7011641};
+	constexpr crc32_x86_v2du mask32{0xffffffff,0};
+	crc32_x86_v2du x1,x2,x3,x4;
+	__builtin_memcpy(__builtin_addressof(x1),first,16);
+	__builtin_memcpy(__builtin_addressof(x2),first+16,16);
+	__builtin_memcpy(__builtin_addressof(x3),first+32,16);
+	__builtin_memcpy(__builtin_addressof(x4),first+48,16);
+	x1^=crc32_x86_v2du{crc,0};
+	for(first+=64;64<=static_cast<std::size_t>(last-first);first+=64)
+	{
+		x1=crc32_x86_fold(x1,k1k2,first);
+		x2=crc32_x86_fold(x2,k1k2,first+16);
+		x3=crc32_x86_fold(x3,k1k2,first+32);
+		x4=crc32_x86_fold(x4,k1k2,first+48);
+	}
+	x1=crc32_x86_clmul<0x00>(x1,k3k4)^crc32_x86_clmul<0x11>(x1,k3k4)^x2;
+	x1=crc32_x86_clmul<0x00>(x1,k3k4)^crc32_x86_clmul<0x11>(x1,k3k4)^x3;
+	x1=crc32_x86_clmul<0x00>(x1,k3k4)^crc32_x86_clmul<0x11>(x1,k3k4)^x4;
+	for(;16<=static_cast<std::size_t>(last-first);first+=16)
+	{
+		x1=crc32_x86_fold(x1,k3k4,first);
+	}
+	/*
+	128 -> 64 bits (appending 32 zero bits), 64 -> 32 bits, then Barrett reduction.
+	*/
+	x1=crc32_x86_clmul<0x10>(x1,k3k4)^crc32_x86_v2du{x1[1],0};
+	x1=crc32_x86_clmul<0x00>(x1&mask32,k5)^((x1>>32)|crc32_x86_v2du{x1[1]<<32,0});
+	crc32_x86_v2du t{crc32_x86_clmul<0x10>(x1&mask32,poly_mu)};
+	t=crc32_x86_clmul<0x00>(t&mask32,poly_mu);
+	x1^=t;
+	crc=((crc32_x86_v4su)x1)[1];
+	return calculate_crc32_slice16(crc,first,last,crc32_slice_tb);
+}
+
+}
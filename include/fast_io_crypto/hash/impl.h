@@ -4,4 +4,6 @@
 #include"sha1.h"
 #include"sha256.h"
 #include"sha512.h"
+#include"sha_multi_buffer.h"
+#include"tree_hash.h"
 #include"crc32.h"
\ No newline at end of file
@@ -0,0 +1,613 @@
+#pragma once
+
+/*
+Multi-buffer SHA-2: many independent messages are hashed at once, one message per SIMD lane
+(Gueron & Krasnov, "Parallelizing message schemes to accelerate the processing of hash functions").
+SHA-256 runs 8 lanes on AVX2 and 16 lanes on AVX-512; SHA-512 runs 4 and 8. Each step compresses one block
+of every lane; lanes that finish their message pick up the next one, so messages of different lengths share
+the vectors. Without AVX-512 but with SHA-NI, SHA-256 interleaves two independent streams to hide the
+sha256rnds2 latency, which beats the 8-lane AVX2 kernel. Without any of these the messages are hashed one after
+another.
+*/
+
+namespace fast_io
+{
+
+struct hash_batch_entry
+{
+	std::byte const* first;
+	std::byte const* last;
+	std::byte* digest;
+};
+
+}
+
+namespace fast_io::details
+{
+
+template<typename T>
+struct sha2_multi_buffer_traits;
+
+template<>
+struct sha2_multi_buffer_traits<::fast_io::details::sha256::sha256>
+{
+	using value_type = std::uint_least32_t;
+	static inline constexpr std::size_t rounds{64};
+	static inline constexpr std::size_t length_bytes{8};
+	static inline constexpr std::uint_least32_t const* k{::fast_io::details::sha256::K256};
+	static inline constexpr unsigned big_sigma0[3]{2,13,22};
+	static inline constexpr unsigned big_sigma1[3]{6,11,25};
+	static inline constexpr unsigned small_sigma0[3]{7,18,3};
+	static inline constexpr unsigned small_sigma1[3]{17,19,10};
+};
+
+template<>
+struct sha2_multi_buffer_traits<::fast_io::details::sha512::sha512>
+{
+	using value_type = std::uint_least64_t;
+	static inline constexpr std::size_t rounds{80};
+	static inline constexpr std::size_t length_bytes{16};
+	static inline constexpr std::uint_least64_t const* k{::fast_io::details::sha512::K512};
+	static inline constexpr unsigned big_sigma0[3]{28,34,39};
+	static inline constexpr unsigned big_sigma1[3]{14,18,41};
+	static inline constexpr unsigned small_sigma0[3]{1,8,7};
+	static inline constexpr unsigned small_sigma1[3]{19,61,6};
+};
+
+template<typename T>
+concept sha2_multi_buffer_hasher = requires()
+{
+	sha2_multi_buffer_traits<T>::rounds;
+};
+
+template<typename context>
+struct sha2_multi_buffer_context_traits
+{
+	static inline constexpr bool supported{};
+};
+
+template<typename T,typename initializer,std::size_t counterbits>
+requires sha2_multi_buffer_hasher<T>
+struct sha2_multi_buffer_context_traits<::fast_io::details::basic_md5_sha_context_impl<T,initializer,counterbits>>
+{
+	static inline constexpr bool supported{true};
+	using hasher_type = T;
+	using initializer_type = initializer;
+};
+
+/*
+An idle lane keeps compressing this block; its state is thrown away when a message is assigned to it.
+*/
+inline constexpr std::byte sha2_multi_buffer_idle_block[128]{};
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__)) && __has_builtin(__builtin_shufflevector)
+
+template<std::size_t n,std::size_t d,bool high>
+inline constexpr int sha2_multi_buffer_transpose_index(std::size_t c) noexcept
+{
+	if constexpr(high)
+	{
+		return static_cast<int>((c&d)?n+c:c+d);
+	}
+	else
+	{
+		return static_cast<int>((c&d)?n+c-d:c);
+	}
+}
+
+/*
+The helpers below take vectors by reference: they are instantiated outside any target attribute and only ever
+inlined into the kernels, so passing wide vectors by value would only produce ABI warnings.
+*/
+template<std::size_t n,std::size_t d,typename vec_type,std::size_t... c>
+#if __has_cpp_attribute(__gnu__::__always_inline__)
+[[__gnu__::__always_inline__]]
+#endif
+inline void sha2_multi_buffer_transpose_step(vec_type& a,vec_type& b,::std::index_sequence<c...>) noexcept
+{
+	vec_type const lo{__builtin_shufflevector(a,b,sha2_multi_buffer_transpose_index<n,d,false>(c)...)};
+	b=__builtin_shufflevector(a,b,sha2_multi_buffer_transpose_index<n,d,true>(c)...);
+	a=lo;
+}
+
+/*
+n x n transpose: step d swaps the off-diagonal d x d sub-blocks of every 2d x 2d block.
+Row j is lane j's slice of the block, column c becomes message word c.
+*/
+template<std::size_t n,std::size_t d,typename vec_type>
+#if __has_cpp_attribute(__gnu__::__always_inline__)
+[[__gnu__::__always_inline__]]
+#endif
+inline void sha2_multi_buffer_transpose(vec_type* rows) noexcept
+{
+	if constexpr(d!=0)
+	{
+		for(std::size_t i{};i!=n;++i)
+		{
+			if(!(i&d))
+			{
+				sha2_multi_buffer_transpose_step<n,d>(rows[i],rows[i+d],::std::make_index_sequence<n>{});
+			}
+		}
+		sha2_multi_buffer_transpose<n,d/2u>(rows);
+	}
+}
+
+template<std::size_t sz,typename vec_type,std::size_t... i>
+#if __has_cpp_attribute(__gnu__::__always_inline__)
+[[__gnu__::__always_inline__]]
+#endif
+inline void sha2_multi_buffer_byte_swap(vec_type& v,::std::index_sequence<i...>) noexcept
+{
+	using byte_vec_type [[__gnu__::__vector_size__(sizeof...(i))]] = char;
+	byte_vec_type const b{(byte_vec_type)v};
+	v=(vec_type)__builtin_shufflevector(b,b,static_cast<int>((i/sz)*sz+(sz-1-i%sz))...);
+}
+
+/*
+x>>>r0 ^ x>>>r1 ^ (x>>>r2 or, for the message schedule, x>>r2)
+*/
+template<unsigned r0,unsigned r1,unsigned r2,bool shift_last,typename vec_type>
+#if __has_cpp_attribute(__gnu__::__always_inline__)
+[[__gnu__::__always_inline__]]
+#endif
+inline void sha2_multi_buffer_sigma(vec_type const& x,vec_type& out) noexcept
+{
+	constexpr unsigned bits{sizeof(x[0])*8u};
+	out=((x>>r0)|(x<<(bits-r0)))^((x>>r1)|(x<<(bits-r1)));
+	if constexpr(shift_last)
+	{
+		out^=x>>r2;
+	}
+	else
+	{
+		out^=(x>>r2)|(x<<(bits-r2));
+	}
+}
+
+/*
+Compresses one block of each of the n lanes. state is structure-of-arrays: state[i*n+j] is word i of lane j.
+Only ever inlined into the target-specific kernels below.
+*/
+template<typename T,std::size_t n>
+#if __has_cpp_attribute(__gnu__::__always_inline__)
+[[__gnu__::__always_inline__]]
+#endif
+inline void sha2_multi_buffer_compress_generic(typename sha2_multi_buffer_traits<T>::value_type* __restrict state,std::byte const* const* __restrict blocks) noexcept
+{
+	using traits = sha2_multi_buffer_traits<T>;
+	using value_type = typename traits::value_type;
+	using vec_type [[__gnu__::__vector_size__(n*sizeof(value_type))]] = value_type;
+	constexpr std::size_t words{16};
+	static_assert(words%n==0);
+	vec_type w[words];
+	for(std::size_t k{};k!=words/n;++k)
+	{
+		vec_type rows[n];
+		for(std::size_t j{};j!=n;++j)
+		{
+			__builtin_memcpy(rows+j,blocks[j]+k*sizeof(vec_type),sizeof(vec_type));
+		}
+		sha2_multi_buffer_transpose<n,n/2u>(rows);
+		for(std::size_t c{};c!=n;++c)
+		{
+			sha2_multi_buffer_byte_swap<sizeof(value_type)>(rows[c],::std::make_index_sequence<n*sizeof(value_type)>{});
+			w[k*n+c]=rows[c];
+		}
+	}
+	vec_type s[8];
+	__builtin_memcpy(s,state,sizeof(s));
+	vec_type a{s[0]},b{s[1]},c{s[2]},d{s[3]},e{s[4]},f{s[5]},g{s[6]},h{s[7]};
+	for(std::size_t t{};t!=traits::rounds;++t)
+	{
+		vec_type s0,s1;
+		if(words<=t)
+		{
+			sha2_multi_buffer_sigma<traits::small_sigma0[0],traits::small_sigma0[1],traits::small_sigma0[2],true>(w[(t-15)%words],s0);
+			sha2_multi_buffer_sigma<traits::small_sigma1[0],traits::small_sigma1[1],traits::small_sigma1[2],true>(w[(t-2)%words],s1);
+			w[t%words]+=s0+s1+w[(t-7)%words];
+		}
+		sha2_multi_buffer_sigma<traits::big_sigma1[0],traits::big_sigma1[1],traits::big_sigma1[2],false>(e,s1);
+		sha2_multi_buffer_sigma<traits::big_sigma0[0],traits::big_sigma0[1],traits::big_sigma0[2],false>(a,s0);
+		vec_type const t1{h+s1+(((f^g)&e)^g)+traits::k[t]+w[t%words]};
+		vec_type const t2{s0+((a&b)|((a|b)&c))};
+		h=g;
+		g=f;
+		f=e;
+		e=d+t1;
+		d=c;
+		c=b;
+		b=a;
+		a=t1+t2;
+	}
+	s[0]+=a;
+	s[1]+=b;
+	s[2]+=c;
+	s[3]+=d;
+	s[4]+=e;
+	s[5]+=f;
+	s[6]+=g;
+	s[7]+=h;
+	__builtin_memcpy(state,s,sizeof(s));
+}
+
+template<typename T>
+[[__gnu__::__target__("avx2")]]
+inline void sha2_multi_buffer_avx2_kernel(typename sha2_multi_buffer_traits<T>::value_type* __restrict state,std::byte const* const* __restrict blocks) noexcept
+{
+	sha2_multi_buffer_compress_generic<T,32u/sizeof(typename sha2_multi_buffer_traits<T>::value_type)>(state,blocks);
+}
+
+template<typename T>
+[[__gnu__::__target__("avx512bw")]]
+inline void sha2_multi_buffer_avx512bw_kernel(typename sha2_multi_buffer_traits<T>::value_type* __restrict state,std::byte const* const* __restrict blocks) noexcept
+{
+	sha2_multi_buffer_compress_generic<T,64u/sizeof(typename sha2_multi_buffer_traits<T>::value_type)>(state,blocks);
+}
+
+using sha2_multi_buffer_v4si [[__gnu__::__vector_size__(16)]] = int;
+using sha2_multi_buffer_v4su [[__gnu__::__vector_size__(16)]] = unsigned;
+using sha2_multi_buffer_v16qi [[__gnu__::__vector_size__(16)]] = char;
+
+/*
+SHA-NI on two streams at once. The round structure is the one of sha256_x86_sha_extensions.h, written as
+16 groups of 4 rounds over a ring of four message vectors.
+*/
+template<std::size_t group>
+[[__gnu__::__target__("sha,sse4.1")]]
+#if __has_cpp_attribute(__gnu__::__always_inline__)
+[[__gnu__::__always_inline__]]
+#endif
+inline void sha256_multi_buffer_shani_group(sha2_multi_buffer_v4si& state0,sha2_multi_buffer_v4si& state1,sha2_multi_buffer_v4si* msg,std::byte const* block) noexcept
+{
+	constexpr std::size_t cur{group%4},prev{(group+3)%4},next{(group+1)%4};
+	if constexpr(group<4)
+	{
+		sha2_multi_buffer_v16qi v;
+		__builtin_memcpy(__builtin_addressof(v),block+group*16,16);
+		msg[cur]=(sha2_multi_buffer_v4si)__builtin_shufflevector(v,v,3,2,1,0,7,6,5,4,11,10,9,8,15,14,13,12);
+	}
+	sha2_multi_buffer_v4su k;
+	__builtin_memcpy(__builtin_addressof(k),::fast_io::details::sha256::K256+group*4,16);
+	sha2_multi_buffer_v4si m{(sha2_multi_buffer_v4si)((sha2_multi_buffer_v4su)msg[cur]+k)};
+	state1=__builtin_ia32_sha256rnds2(state1,state0,m);
+	if constexpr(3<=group&&group<15)
+	{
+		msg[next]=__builtin_ia32_sha256msg2((sha2_multi_buffer_v4si)((sha2_multi_buffer_v4su)msg[next]+
+			(sha2_multi_buffer_v4su)__builtin_shufflevector(msg[prev],msg[cur],1,2,3,4)),msg[cur]);
+	}
+	m=__builtin_shufflevector(m,m,2,3,0,0);
+	state0=__builtin_ia32_sha256rnds2(state0,state1,m);
+	if constexpr(1<=group&&group<13)
+	{
+		msg[prev]=__builtin_ia32_sha256msg1(msg[prev],msg[cur]);
+	}
+}
+
+template<std::size_t... group>
+[[__gnu__::__target__("sha,sse4.1")]]
+#if __has_cpp_attribute(__gnu__::__always_inline__)
+[[__gnu__::__always_inline__]]
+#endif
+inline void sha256_multi_buffer_shani_rounds(sha2_multi_buffer_v4si* state0,sha2_multi_buffer_v4si* state1,sha2_multi_buffer_v4si (*msg)[4],std::byte const* const* blocks,::std::index_sequence<group...>) noexcept
+{
+	((sha256_multi_buffer_shani_group<group>(state0[0],state1[0],msg[0],blocks[0]),
+	sha256_multi_buffer_shani_group<group>(state0[1],state1[1],msg[1],blocks[1])),...);
+}
+
+[[__gnu__::__target__("sha,sse4.1")]]
+inline void sha256_multi_buffer_shani_kernel(std::uint_least32_t* __restrict state,std::byte const* const* __restrict blocks) noexcept
+{
+	constexpr std::size_t n{2};
+	sha2_multi_buffer_v4si state0[n],state1[n],save0[n],save1[n],msg[n][4];
+	for(std::size_t j{};j!=n;++j)
+	{
+		auto s{[&](std::size_t i){return static_cast<int>(state[i*n+j]);}};
+		save0[j]=state0[j]=sha2_multi_buffer_v4si{s(5),s(4),s(1),s(0)};
+		save1[j]=state1[j]=sha2_multi_buffer_v4si{s(7),s(6),s(3),s(2)};
+	}
+	sha256_multi_buffer_shani_rounds(state0,state1,msg,blocks,::std::make_index_sequence<16>{});
+	for(std::size_t j{};j!=n;++j)
+	{
+		sha2_multi_buffer_v4su const s0{(sha2_multi_buffer_v4su)state0[j]+(sha2_multi_buffer_v4su)save0[j]};
+		sha2_multi_buffer_v4su const s1{(sha2_multi_buffer_v4su)state1[j]+(sha2_multi_buffer_v4su)save1[j]};
+		state[0*n+j]=s0[3];
+		state[1*n+j]=s0[2];
+		state[2*n+j]=s1[3];
+		state[3*n+j]=s1[2];
+		state[4*n+j]=s0[1];
+		state[5*n+j]=s0[0];
+		state[6*n+j]=s1[1];
+		state[7*n+j]=s1[0];
+	}
+}
+
+inline bool sha256_multi_buffer_has_shani() noexcept
+{
+#if defined(__SHA__) && defined(__SSE4_1__)
+	return true;
+#else
+	if constexpr(::fast_io::details::cpu_flags::runtime_cpu_probe_supported)
+	{
+		static bool const supported{(__builtin_cpu_init(),__builtin_cpu_supports("sha")&&__builtin_cpu_supports("sse4.1"))};
+		return supported;
+	}
+	else
+	{
+		return false;
+	}
+#endif
+}
+
+#endif
+
+/*
+Every message of a batch may be hashed as prefix||message with one shared prefix shorter than a block
+(tree hashing uses it for node domain separation).
+*/
+template<typename T,typename initializer>
+inline void sha2_multi_buffer_sequential(::fast_io::hash_batch_entry const* first,::fast_io::hash_batch_entry const* last,
+	std::byte const* prefix,std::size_t prefix_size) noexcept
+{
+	for(;first!=last;++first)
+	{
+		::fast_io::details::basic_md5_sha_context_impl<T,initializer,sha2_multi_buffer_traits<T>::length_bytes*8u> ctx;
+		ctx.update(prefix,prefix+prefix_size);
+		ctx.update(first->first,first->last);
+		ctx.do_final();
+		ctx.digest_to_byte_ptr(first->digest);
+	}
+}
+
+/*
+A lane walks through up to three segments: a staged head block holding the prefix, the full blocks read straight
+from the message, and one or two staged tail blocks with the padding.
+*/
+template<typename T>
+struct sha2_multi_buffer_lane
+{
+	::fast_io::hash_batch_entry const* job;
+	std::byte const* block;
+	std::byte const* direct;
+	bool head_pending;
+	std::size_t full_blocks;
+	std::size_t remaining_blocks;
+	std::byte head[T::block_size];
+	std::byte tail[T::block_size*2];
+};
+
+template<typename T>
+inline void sha2_multi_buffer_lane_assign(sha2_multi_buffer_lane<T>& lane,::fast_io::hash_batch_entry const* job,
+	std::byte const* prefix,std::size_t prefix_size) noexcept
+{
+	using traits = sha2_multi_buffer_traits<T>;
+	constexpr std::size_t block_size{T::block_size};
+	std::size_t const len{static_cast<std::size_t>(job->last-job->first)};
+	std::size_t const total{prefix_size+len};
+	std::byte const* direct{job->first};
+	std::size_t tail_used{};
+	lane.head_pending=false;
+	if(prefix_size)
+	{
+		if(block_size<=total)
+		{
+			std::size_t const head_message{block_size-prefix_size};
+			::fast_io::details::non_overlapped_copy_n(prefix,prefix_size,lane.head);
+			::fast_io::details::non_overlapped_copy_n(direct,head_message,lane.head+prefix_size);
+			direct+=head_message;
+			lane.head_pending=true;
+		}
+		else
+		{
+			::fast_io::details::non_overlapped_copy_n(prefix,prefix_size,lane.tail);
+			tail_used=prefix_size;
+		}
+	}
+	std::size_t const direct_size{static_cast<std::size_t>(job->last-direct)};
+	std::size_t const full{direct_size/block_size};
+	std::size_t const rem{direct_size%block_size};
+	::fast_io::details::non_overlapped_copy_n(direct+full*block_size,rem,lane.tail+tail_used);
+	tail_used+=rem;
+	std::size_t const tail_blocks{tail_used+1u+traits::length_bytes<=block_size?1u:2u};
+	std::size_t const tail_size{tail_blocks*block_size};
+	lane.tail[tail_used]=std::byte{0x80};
+	::fast_io::none_secure_clear(lane.tail+tail_used+1,tail_size-tail_used-1);
+	std::uint_least64_t const bits{static_cast<std::uint_least64_t>(total)<<3};
+	for(std::size_t i{};i!=8;++i)
+	{
+		lane.tail[tail_size-1-i]=static_cast<std::byte>(bits>>(i*8));
+	}
+	if constexpr(traits::length_bytes==16)
+	{
+		lane.tail[tail_size-9]=static_cast<std::byte>(static_cast<std::uint_least64_t>(total)>>61);
+	}
+	lane.job=job;
+	lane.direct=direct;
+	lane.full_blocks=full;
+	lane.remaining_blocks=static_cast<std::size_t>(lane.head_pending)+full+tail_blocks;
+	lane.block=lane.head_pending?lane.head:(full?direct:lane.tail);
+}
+
+template<typename T,typename initializer,std::size_t n,typename Kernel>
+inline void sha2_multi_buffer_impl(::fast_io::hash_batch_entry const* first,::fast_io::hash_batch_entry const* last,Kernel kernel,
+	std::byte const* prefix=nullptr,std::size_t prefix_size=0) noexcept
+{
+	using value_type = typename sha2_multi_buffer_traits<T>::value_type;
+	constexpr std::size_t block_size{T::block_size};
+	constexpr std::size_t state_size{8};
+	value_type state[state_size*n];
+	std::byte const* blocks[n];
+	sha2_multi_buffer_lane<T> lanes[n];
+	std::size_t active{};
+	auto assign{[&](std::size_t j) noexcept
+	{
+		if(first==last)
+		{
+			lanes[j].job=nullptr;
+			blocks[j]=sha2_multi_buffer_idle_block;
+			return;
+		}
+		sha2_multi_buffer_lane_assign(lanes[j],first,prefix,prefix_size);
+		++first;
+		++active;
+		for(std::size_t i{};i!=state_size;++i)
+		{
+			state[i*n+j]=initializer::initialize_value.state[i];
+		}
+		blocks[j]=lanes[j].block;
+	}};
+	for(std::size_t j{};j!=n;++j)
+	{
+		assign(j);
+	}
+	while(active)
+	{
+		/*
+		With the queue drained and most lanes idle, single-stream hashing of the stragglers is cheaper.
+		*/
+		if(n>2u&&first==last&&active*4u<=n)
+		{
+			for(std::size_t j{};j!=n;++j)
+			{
+				auto& lane{lanes[j]};
+				if(lane.job==nullptr)
+				{
+					continue;
+				}
+				T hasher;
+				for(std::size_t i{};i!=state_size;++i)
+				{
+					hasher.state[i]=state[i*n+j];
+				}
+				if(lane.head_pending)
+				{
+					hasher.update_blocks(lane.head,lane.head+block_size);
+					--lane.remaining_blocks;
+					lane.block=lane.full_blocks?lane.direct:lane.tail;
+				}
+				if(lane.full_blocks)
+				{
+					hasher.update_blocks(lane.block,lane.block+lane.full_blocks*block_size);
+					lane.remaining_blocks-=lane.full_blocks;
+					lane.block=lane.tail;
+				}
+				hasher.update_blocks(lane.block,lane.block+lane.remaining_blocks*block_size);
+				initializer::digest_to_byte_ptr(hasher.state,lane.job->digest);
+			}
+			return;
+		}
+		kernel(state,blocks);
+		for(std::size_t j{};j!=n;++j)
+		{
+			auto& lane{lanes[j]};
+			if(lane.job==nullptr)
+			{
+				continue;
+			}
+			if(lane.head_pending)
+			{
+				lane.head_pending=false;
+				lane.block=lane.full_blocks?lane.direct:lane.tail;
+			}
+			else if(lane.full_blocks)
+			{
+				--lane.full_blocks;
+				lane.block=lane.full_blocks?lane.block+block_size:lane.tail;
+			}
+			else
+			{
+				lane.block+=block_size;
+			}
+			if(--lane.remaining_blocks)
+			{
+				blocks[j]=lane.block;
+				continue;
+			}
+			value_type digest[state_size];
+			for(std::size_t i{};i!=state_size;++i)
+			{
+				digest[i]=state[i*n+j];
+			}
+			initializer::digest_to_byte_ptr(digest,lane.job->digest);
+			--active;
+			assign(j);
+		}
+	}
+}
+
+template<typename T,typename initializer>
+inline void sha2_multi_buffer(::fast_io::hash_batch_entry const* first,::fast_io::hash_batch_entry const* last,
+	std::byte const* prefix=nullptr,std::size_t prefix_size=0) noexcept
+{
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__)) && __has_builtin(__builtin_shufflevector)
+	using value_type = typename sha2_multi_buffer_traits<T>::value_type;
+	constexpr bool runtime_dispatch{::fast_io::details::cpu_flags::runtime_dispatch_supported};
+	bool avx512bw{
+#if defined(__AVX512BW__)
+		true
+#endif
+	};
+	bool avx2{
+#if defined(__AVX2__)
+		true
+#endif
+	};
+	if constexpr(runtime_dispatch)
+	{
+		auto const level{::fast_io::details::cpu_flags::get_runtime_simd_level()};
+		avx512bw=level==::fast_io::details::cpu_flags::runtime_simd_level::avx512bw;
+		avx2=level!=::fast_io::details::cpu_flags::runtime_simd_level::baseline;
+	}
+	if(avx512bw)
+	{
+		::fast_io::details::sha2_multi_buffer_impl<T,initializer,64u/sizeof(value_type)>(first,last,sha2_multi_buffer_avx512bw_kernel<T>,prefix,prefix_size);
+		return;
+	}
+	if constexpr(::std::same_as<T,::fast_io::details::sha256::sha256>)
+	{
+		if(::fast_io::details::sha256_multi_buffer_has_shani())
+		{
+			::fast_io::details::sha2_multi_buffer_impl<T,initializer,2>(first,last,sha256_multi_buffer_shani_kernel,prefix,prefix_size);
+			return;
+		}
+	}
+	if(avx2)
+	{
+		::fast_io::details::sha2_multi_buffer_impl<T,initializer,32u/sizeof(value_type)>(first,last,sha2_multi_buffer_avx2_kernel<T>,prefix,prefix_size);
+		return;
+	}
+#endif
+	::fast_io::details::sha2_multi_buffer_sequential<T,initializer>(first,last,prefix,prefix_size);
+}
+
+}
+
+namespace fast_io
+{
+
+/*
+Hashes every message [e.first,e.last) and writes its digest to e.digest (context::digest_size bytes).
+SHA-224/256/384/512 and the SHA-512/t variants go through the multi-buffer kernels; any other context hashes
+the messages one at a time.
+*/
+template<typename context>
+inline void hash_batch(hash_batch_entry const* first,hash_batch_entry const* last) noexcept
+{
+	using traits = ::fast_io::details::sha2_multi_buffer_context_traits<context>;
+	if constexpr(traits::supported)
+	{
+		::fast_io::details::sha2_multi_buffer<typename traits::hasher_type,typename traits::initializer_type>(first,last);
+	}
+	else
+	{
+		for(;first!=last;++first)
+		{
+			context ctx;
+			ctx.update(first->first,first->last);
+			ctx.do_final();
+			ctx.digest_to_byte_ptr(first->digest);
+		}
+	}
+}
+
+}
@@ -0,0 +1,344 @@
+#pragma once
+
+/*
+Parallel tree hashing for large inputs. The input is cut into fixed-size chunks and hashed as the Merkle Tree Hash
+of RFC 6962 (Certificate Transparency): leaf = H(0x00||chunk), node = H(0x01||left||right), an odd node at the end
+of a level moves up unchanged, and empty input hashes to H(""). The digest depends only on the data, the hash
+function and the chunk size, never on the number of threads.
+Leaves are handed out to worker threads in groups; each group goes through hash_batch's multi-buffer kernels,
+so cores and SIMD lanes both contribute. The upper levels are tiny and are reduced on the calling thread.
+*/
+
+#if ((__STDC_HOSTED__==1 && (!defined(_GLIBCXX_HOSTED) || _GLIBCXX_HOSTED==1) && !defined(_LIBCPP_FREESTANDING)) || defined(FAST_IO_ENABLE_HOSTED_FEATURES)) && __has_include(<pthread.h>) && __has_include(<unistd.h>)
+#include<pthread.h>
+#include<unistd.h>
+#define FAST_IO_TREE_HASH_HAS_THREADS
+#endif
+
+#if ((__STDC_HOSTED__==1 && (!defined(_GLIBCXX_HOSTED) || _GLIBCXX_HOSTED==1) && !defined(_LIBCPP_FREESTANDING)) || defined(FAST_IO_ENABLE_HOSTED_FEATURES)) && defined(__cpp_exceptions)
+#include<exception>
+#define FAST_IO_TREE_HASH_HAS_EXCEPTIONS
+#endif
+
+namespace fast_io
+{
+
+inline constexpr std::size_t tree_hash_default_chunk_size{static_cast<std::size_t>(1)<<20u};
+
+}
+
+namespace fast_io::details
+{
+
+inline constexpr std::size_t tree_hash_group_leaves{16};
+
+template<typename context>
+inline void tree_hash_nodes(::fast_io::hash_batch_entry const* first,::fast_io::hash_batch_entry const* last,std::byte prefix) noexcept
+{
+	using traits = ::fast_io::details::sha2_multi_buffer_context_traits<context>;
+	if constexpr(traits::supported)
+	{
+		::fast_io::details::sha2_multi_buffer<typename traits::hasher_type,typename traits::initializer_type>(first,last,__builtin_addressof(prefix),1);
+	}
+	else
+	{
+		for(;first!=last;++first)
+		{
+			context ctx;
+			ctx.update(__builtin_addressof(prefix),__builtin_addressof(prefix)+1);
+			ctx.update(first->first,first->last);
+			ctx.do_final();
+			ctx.digest_to_byte_ptr(first->digest);
+		}
+	}
+}
+
+struct tree_hash_memory_source
+{
+	static inline constexpr bool needs_buffer{};
+	static inline constexpr bool may_throw{};
+	std::byte const* data;
+	std::byte const* load(std::uintmax_t offset,std::size_t,std::byte*) const noexcept
+	{
+		return data+offset;
+	}
+};
+
+template<typename Reader>
+struct tree_hash_reader_source
+{
+	static inline constexpr bool needs_buffer{true};
+	static inline constexpr bool may_throw{!noexcept((*static_cast<Reader*>(nullptr))(static_cast<std::byte*>(nullptr),
+		std::size_t{},std::uintmax_t{}))};
+	Reader* reader;
+	std::byte const* load(std::uintmax_t offset,std::size_t n,std::byte* buffer) const noexcept(!may_throw)
+	{
+		(*reader)(buffer,n,offset);
+		return buffer;
+	}
+};
+
+template<typename context,typename Source>
+struct tree_hash_job
+{
+	Source source;
+	std::uintmax_t size;
+	std::size_t chunk_size;
+	std::size_t leaves;
+	std::size_t groups;
+	std::byte* leaf_digests;
+	std::size_t next_group;
+#if defined(FAST_IO_TREE_HASH_HAS_EXCEPTIONS)
+	bool failed{};
+	::std::exception_ptr error{};
+#endif
+};
+
+struct tree_hash_buffer_guard
+{
+	using byte_allocator = ::fast_io::native_typed_global_allocator<std::byte>;
+	std::byte* ptr;
+	std::size_t size;
+	explicit tree_hash_buffer_guard(std::size_t n) noexcept:ptr(n==0?nullptr:byte_allocator::allocate(n)),size(n)
+	{}
+	tree_hash_buffer_guard(tree_hash_buffer_guard const&)=delete;
+	tree_hash_buffer_guard& operator=(tree_hash_buffer_guard const&)=delete;
+	~tree_hash_buffer_guard()
+	{
+		if(ptr)
+		{
+			byte_allocator::deallocate_n(ptr,size);
+		}
+	}
+};
+
+template<typename context,typename Source>
+inline void tree_hash_worker(tree_hash_job<context,Source>& job) noexcept(!Source::may_throw)
+{
+	constexpr std::size_t digest_size{context::digest_size};
+	tree_hash_buffer_guard const guard{Source::needs_buffer?tree_hash_group_leaves*job.chunk_size:0u};
+	std::byte* const buffer{guard.ptr};
+	::fast_io::hash_batch_entry entries[tree_hash_group_leaves];
+	for(;;)
+	{
+		std::size_t const group{__atomic_fetch_add(__builtin_addressof(job.next_group),1u,__ATOMIC_RELAXED)};
+		if(job.groups<=group)
+		{
+			break;
+		}
+		std::size_t const first_leaf{group*tree_hash_group_leaves};
+		std::size_t count{job.leaves-first_leaf};
+		if(tree_hash_group_leaves<count)
+		{
+			count=tree_hash_group_leaves;
+		}
+		std::uintmax_t const offset{static_cast<std::uintmax_t>(first_leaf)*job.chunk_size};
+		std::uintmax_t bytes{job.size-offset};
+		if(static_cast<std::uintmax_t>(count*job.chunk_size)<bytes)
+		{
+			bytes=count*job.chunk_size;
+		}
+		std::byte const* p{job.source.load(offset,static_cast<std::size_t>(bytes),buffer)};
+		std::byte const* const p_last{p+bytes};
+		for(std::size_t i{};i!=count;++i)
+		{
+			std::byte const* const leaf{p+i*job.chunk_size};
+			std::byte const* leaf_last{p_last};
+			if(job.chunk_size<static_cast<std::size_t>(p_last-leaf))
+			{
+				leaf_last=leaf+job.chunk_size;
+			}
+			entries[i]={leaf,leaf_last,job.leaf_digests+(first_leaf+i)*digest_size};
+		}
+		::fast_io::details::tree_hash_nodes<context>(entries,entries+count,std::byte{0});
+	}
+}
+
+/*
+A reader that throws stops every worker: the remaining groups are skipped, the first exception is kept and
+rethrown on the calling thread once all workers have been joined.
+*/
+template<typename job_type>
+inline void tree_hash_guarded_worker(job_type& job) noexcept
+{
+#if defined(FAST_IO_TREE_HASH_HAS_EXCEPTIONS)
+	try
+	{
+		::fast_io::details::tree_hash_worker(job);
+	}
+	catch(...)
+	{
+		__atomic_store_n(__builtin_addressof(job.next_group),job.groups,__ATOMIC_RELAXED);
+		if(!__atomic_exchange_n(__builtin_addressof(job.failed),true,__ATOMIC_ACQ_REL))
+		{
+			job.error=::std::current_exception();
+		}
+	}
+#else
+	::fast_io::details::tree_hash_worker(job);
+#endif
+}
+
+#if defined(FAST_IO_TREE_HASH_HAS_THREADS)
+template<typename job_type>
+inline void* tree_hash_thread_routine(void* arg) noexcept
+{
+	::fast_io::details::tree_hash_guarded_worker(*static_cast<job_type*>(arg));
+	return nullptr;
+}
+#endif
+
+/*
+The calling thread is one of the workers. A thread that cannot be created simply leaves its share to the others.
+*/
+template<typename job_type>
+inline void tree_hash_run_workers(job_type& job,std::size_t threads)
+{
+#if defined(FAST_IO_TREE_HASH_HAS_THREADS)
+	if(threads==0)
+	{
+		long const online{noexcept_call(::sysconf,_SC_NPROCESSORS_ONLN)};
+		threads=online<1?1u:static_cast<std::size_t>(online);
+	}
+	if(job.groups<threads)
+	{
+		threads=job.groups;
+	}
+	if(1u<threads)
+	{
+		using tid_allocator = ::fast_io::native_typed_global_allocator<::pthread_t>;
+		std::size_t const spawn{threads-1u};
+		::pthread_t* tids{tid_allocator::allocate(spawn)};
+		std::size_t created{};
+		for(;created!=spawn;++created)
+		{
+			if(noexcept_call(::pthread_create,tids+created,nullptr,tree_hash_thread_routine<job_type>,__builtin_addressof(job))!=0)
+			{
+				break;
+			}
+		}
+		::fast_io::details::tree_hash_guarded_worker(job);
+		for(std::size_t i{};i!=created;++i)
+		{
+			noexcept_call(::pthread_join,tids[i],nullptr);
+		}
+		tid_allocator::deallocate_n(tids,spawn);
+	}
+	else
+#else
+	(void)threads;
+#endif
+	{
+		::fast_io::details::tree_hash_guarded_worker(job);
+	}
+#if defined(FAST_IO_TREE_HASH_HAS_EXCEPTIONS)
+	if(job.error)
+	{
+		::std::rethrow_exception(job.error);
+	}
+#endif
+}
+
+/*
+Empty input hashes to H(""). GCC cannot see that finalising a fresh context never reads its unfilled block buffer.
+*/
+template<typename context>
+inline void tree_hash_empty_digest(std::byte* digest) noexcept
+{
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+#endif
+	context ctx;
+	ctx.do_final();
+	ctx.digest_to_byte_ptr(digest);
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic pop
+#endif
+}
+
+template<typename context,typename Source>
+inline void tree_hash_impl(Source source,std::uintmax_t size,std::byte* digest,std::size_t threads,std::size_t chunk_size) noexcept(!Source::may_throw)
+{
+	constexpr std::size_t digest_size{context::digest_size};
+	if(size==0)
+	{
+		::fast_io::details::tree_hash_empty_digest<context>(digest);
+		return;
+	}
+	if(chunk_size==0)
+	{
+		chunk_size=::fast_io::tree_hash_default_chunk_size;
+	}
+	std::size_t const leaves{static_cast<std::size_t>((size-1u)/chunk_size+1u)};
+	std::size_t const level_size{leaves*digest_size};
+	std::size_t const scratch_size{(leaves/2u+1u)*digest_size};
+	tree_hash_buffer_guard const level_guard{level_size};
+	tree_hash_buffer_guard const scratch_guard{scratch_size};
+	std::byte* const level{level_guard.ptr};
+	std::byte* const scratch{scratch_guard.ptr};
+	tree_hash_job<context,Source> job{source,size,chunk_size,leaves,(leaves-1u)/tree_hash_group_leaves+1u,level,0};
+	::fast_io::details::tree_hash_run_workers(job,threads);
+	std::byte* cur{level};
+	std::byte* next{scratch};
+	::fast_io::hash_batch_entry entries[tree_hash_group_leaves];
+	for(std::size_t n{leaves};n!=1u;n=(n+1u)/2u)
+	{
+		std::size_t const pairs{n/2u};
+		for(std::size_t i{};i!=pairs;)
+		{
+			std::size_t count{};
+			for(;count!=tree_hash_group_leaves&&i!=pairs;++count,++i)
+			{
+				std::byte const* const left{cur+2u*i*digest_size};
+				entries[count]={left,left+2u*digest_size,next+i*digest_size};
+			}
+			::fast_io::details::tree_hash_nodes<context>(entries,entries+count,std::byte{1});
+		}
+		if(n&1u)
+		{
+			::fast_io::details::non_overlapped_copy_n(cur+(n-1u)*digest_size,digest_size,next+pairs*digest_size);
+		}
+		std::byte* const t{cur};
+		cur=next;
+		next=t;
+	}
+	::fast_io::details::non_overlapped_copy_n(cur,digest_size,digest);
+}
+
+}
+
+namespace fast_io
+{
+
+/*
+Tree digest (context::digest_size bytes) of [first,last), e.g. the span of a native_file_loader.
+threads==0 uses every online CPU.
+*/
+template<typename context>
+inline void tree_hash(std::byte const* first,std::byte const* last,std::byte* digest,std::size_t threads=0,
+	std::size_t chunk_size=::fast_io::tree_hash_default_chunk_size) noexcept
+{
+	::fast_io::details::tree_hash_impl<context>(::fast_io::details::tree_hash_memory_source{first},
+		static_cast<std::uintmax_t>(last-first),digest,threads,chunk_size);
+}
+
+/*
+Same digest as tree_hash over a source of size bytes that is read in ranges, e.g. with pread.
+reader(std::byte* buffer,std::size_t n,std::uintmax_t offset) must fill buffer with n bytes from offset; it is
+called concurrently from the worker threads, with ranges of up to 16 chunks. If it throws, the other workers stop,
+all of them are joined and the first exception is rethrown.
+*/
+template<typename context,typename Reader>
+inline void tree_hash_ranged(Reader&& reader,std::uintmax_t size,std::byte* digest,std::size_t threads=0,
+	std::size_t chunk_size=::fast_io::tree_hash_default_chunk_size)
+{
+	using reader_type = ::std::remove_reference_t<Reader>;
+	::fast_io::details::tree_hash_impl<context>(::fast_io::details::tree_hash_reader_source<reader_type>{__builtin_addressof(reader)},
+		size,digest,threads,chunk_size);
+}
+
+}
+
+#undef FAST_IO_TREE_HASH_HAS_EXCEPTIONS
+#undef FAST_IO_TREE_HASH_HAS_THREADS
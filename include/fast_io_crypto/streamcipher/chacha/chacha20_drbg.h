@@ -0,0 +1,268 @@
+#pragma once
+
+/*
+Userspace ChaCha20 DRBG with fast key erasure (Bernstein, "Fast-key-erasure random-number generators", 2017).
+Every refill runs the multi-block keystream over a 4 KiB buffer, immediately replaces the key with the first 32
+bytes of it and hands out the rest, zeroing each value as it leaves, so a later state compromise reveals nothing
+already returned. The entropy source (a white hole) is consulted once at construction and then once per
+chacha20_drbg_reseed_refills refills, with the fresh seed XORed into the key.
+An engine is not thread safe; chacha20_drbg_thread_local_engine gives each thread its own. A child created by
+fork() throws the copied buffer away and reseeds before its next draw: a pthread_atfork handler bumps a generation
+counter that every draw compares against. That reseed comes straight from getentropy, never from the handle, since a
+buffered handle hands every child the same read-ahead bytes. fork through raw system calls bypasses the handler.
+*/
+
+#if ((__STDC_HOSTED__==1 && (!defined(_GLIBCXX_HOSTED) || _GLIBCXX_HOSTED==1) && !defined(_LIBCPP_FREESTANDING)) || defined(FAST_IO_ENABLE_HOSTED_FEATURES)) && __has_include(<pthread.h>) && !defined(_WIN32)
+#include<pthread.h>
+#include<unistd.h>
+#if __has_include(<sys/random.h>)
+#include<sys/random.h>
+#endif
+#define FAST_IO_CHACHA20_DRBG_HAS_FORK_HANDLER
+#endif
+
+namespace fast_io::details::chacha
+{
+
+inline constexpr std::size_t chacha20_drbg_key_size{32};
+inline constexpr std::size_t chacha20_drbg_buffer_size{4096};
+inline constexpr std::size_t chacha20_drbg_reseed_refills{256};
+/*
+Large fills skip the buffer and are keyed afresh at least this often, keeping the 32-bit block counter far from
+wrapping.
+*/
+inline constexpr std::size_t chacha20_drbg_bulk_chunk{static_cast<std::size_t>(1)<<20u};
+
+#if defined(FAST_IO_CHACHA20_DRBG_HAS_FORK_HANDLER)
+/*
+Only ever written in a freshly forked child, which has a single thread at that point.
+*/
+inline std::size_t chacha20_drbg_fork_generation_value{};
+
+inline void chacha20_drbg_fork_child() noexcept
+{
+	++chacha20_drbg_fork_generation_value;
+}
+
+inline void chacha20_drbg_register_fork_handler() noexcept
+{
+	[[maybe_unused]] static int const registered{noexcept_call(::pthread_atfork,nullptr,nullptr,chacha20_drbg_fork_child)};
+}
+
+inline void chacha20_drbg_fork_seed(::std::byte* seed) noexcept
+{
+	if(noexcept_call(::getentropy,seed,chacha20_drbg_key_size)!=0)
+	{
+		::fast_io::fast_terminate();
+	}
+}
+#endif
+
+inline std::size_t chacha20_drbg_fork_generation() noexcept
+{
+#if defined(FAST_IO_CHACHA20_DRBG_HAS_FORK_HANDLER)
+	return chacha20_drbg_fork_generation_value;
+#else
+	return 0;
+#endif
+}
+
+inline void chacha20_drbg_set_key(::std::uint_least32_t* state,::std::byte const* key) noexcept
+{
+	for(std::size_t i{};i!=8;++i)
+	{
+		::std::uint_least32_t v;
+		__builtin_memcpy(__builtin_addressof(v),key+i*sizeof(v),sizeof(v));
+		state[4+i]=::fast_io::little_endian(v);
+	}
+	state[12]=0;
+}
+
+inline void chacha20_drbg_mix_key(::std::uint_least32_t* state,::std::byte const* seed) noexcept
+{
+	for(std::size_t i{};i!=8;++i)
+	{
+		::std::uint_least32_t v;
+		__builtin_memcpy(__builtin_addressof(v),seed+i*sizeof(v),sizeof(v));
+		state[4+i]^=::fast_io::little_endian(v);
+	}
+	state[12]=0;
+}
+
+/*
+Writes n bytes of keystream to out (zeroed first, since chacha20_xor only XORs) and continues the block counter.
+*/
+inline void chacha20_drbg_keystream(::std::uint_least32_t* state,::std::byte* out,std::size_t n) noexcept
+{
+	__builtin_memset(out,0,n);
+	::fast_io::details::chacha::chacha20_xor(state,out,out,n);
+}
+
+}
+
+namespace fast_io
+{
+
+template<input_stream handletype>
+requires std::same_as<std::remove_cvref_t<typename handletype::char_type>,char>
+struct basic_chacha20_drbg_engine
+{
+	using handle_type = handletype;
+	using result_type = std::size_t;
+	handle_type handle;
+	::std::uint_least32_t state[16];
+	std::size_t position;
+	std::size_t refills_until_reseed;
+	std::size_t fork_generation;
+	::std::byte buffer[::fast_io::details::chacha::chacha20_drbg_buffer_size];
+
+	explicit basic_chacha20_drbg_engine() requires std::default_initializable<handle_type>:handle()
+	{
+		this->seed();
+	}
+	explicit basic_chacha20_drbg_engine(handle_type h):handle(::std::move(h))
+	{
+		this->seed();
+	}
+	basic_chacha20_drbg_engine(basic_chacha20_drbg_engine const&)=delete;
+	basic_chacha20_drbg_engine& operator=(basic_chacha20_drbg_engine const&)=delete;
+	~basic_chacha20_drbg_engine()
+	{
+		::fast_io::secure_clear(state,sizeof(state));
+		::fast_io::secure_clear(buffer,sizeof(buffer));
+	}
+
+	static inline constexpr result_type min() noexcept
+	{
+		return 0;
+	}
+	static inline constexpr result_type max() noexcept
+	{
+		return SIZE_MAX;
+	}
+
+	/*
+	Mixes 32 fresh bytes from the white hole into the key and drops everything buffered.
+	*/
+	inline void reseed()
+	{
+		::std::byte seed_bytes[::fast_io::details::chacha::chacha20_drbg_key_size];
+		::fast_io::read_all(handle,reinterpret_cast<char*>(seed_bytes),reinterpret_cast<char*>(seed_bytes)+sizeof(seed_bytes));
+		this->mix_seed(seed_bytes);
+	}
+
+	inline result_type operator()()
+	{
+		this->check_fork();
+		if(sizeof(buffer)-position<sizeof(result_type))[[unlikely]]
+		{
+			this->refill();
+		}
+		result_type v;
+		__builtin_memcpy(__builtin_addressof(v),buffer+position,sizeof(v));
+		__builtin_memset(buffer+position,0,sizeof(v));
+		position+=sizeof(v);
+		return v;
+	}
+
+	/*
+	Fills [first,last) with random bytes. Fills of a buffer or more are generated straight into the destination.
+	*/
+	template<::std::contiguous_iterator Iter>
+	requires std::is_trivially_copyable_v<::std::iter_value_t<Iter>>
+	inline void fill(Iter first,Iter last)
+	{
+		this->check_fork();
+		::std::byte* out{reinterpret_cast<::std::byte*>(::std::to_address(first))};
+		std::size_t n{static_cast<std::size_t>(last-first)*sizeof(::std::iter_value_t<Iter>)};
+		for(;;)
+		{
+			std::size_t const available{sizeof(buffer)-position};
+			std::size_t const taken{n<available?n:available};
+			::fast_io::details::non_overlapped_copy_n(buffer+position,taken,out);
+			__builtin_memset(buffer+position,0,taken);
+			position+=taken;
+			out+=taken;
+			n-=taken;
+			if(!n)
+			{
+				break;
+			}
+			if(sizeof(buffer)<=n)
+			{
+				if(!refills_until_reseed)
+				{
+					this->reseed();
+				}
+				std::size_t const chunk{n<::fast_io::details::chacha::chacha20_drbg_bulk_chunk?n:(::fast_io::details::chacha::chacha20_drbg_bulk_chunk)};
+				::fast_io::details::chacha::chacha20_drbg_keystream(state,out,chunk);
+				out+=chunk;
+				n-=chunk;
+			}
+			/*
+			After a bulk chunk this also retires its key: the refill continues the counter, so the new key is
+			keystream that never reached the caller.
+			*/
+			this->refill();
+		}
+	}
+
+private:
+	inline void mix_seed(::std::byte* seed_bytes) noexcept
+	{
+		::fast_io::details::chacha::chacha20_drbg_mix_key(state,seed_bytes);
+		::fast_io::secure_clear(seed_bytes,::fast_io::details::chacha::chacha20_drbg_key_size);
+		::fast_io::secure_clear(buffer,sizeof(buffer));
+		position=sizeof(buffer);
+		refills_until_reseed=::fast_io::details::chacha::chacha20_drbg_reseed_refills;
+		fork_generation=::fast_io::details::chacha::chacha20_drbg_fork_generation();
+	}
+	inline void seed()
+	{
+#if defined(FAST_IO_CHACHA20_DRBG_HAS_FORK_HANDLER)
+		::fast_io::details::chacha::chacha20_drbg_register_fork_handler();
+#endif
+		::std::byte const zero_nonce[12]{};
+		::std::byte const zero_key[::fast_io::details::chacha::chacha20_drbg_key_size]{};
+		::fast_io::details::chacha::chacha20_init_state(state,zero_key,0,zero_nonce);
+		this->reseed();
+	}
+	inline void check_fork()
+	{
+		if(fork_generation!=::fast_io::details::chacha::chacha20_drbg_fork_generation())[[unlikely]]
+		{
+#if defined(FAST_IO_CHACHA20_DRBG_HAS_FORK_HANDLER)
+			::std::byte seed_bytes[::fast_io::details::chacha::chacha20_drbg_key_size];
+			::fast_io::details::chacha::chacha20_drbg_fork_seed(seed_bytes);
+			this->mix_seed(seed_bytes);
+#else
+			this->reseed();
+#endif
+		}
+	}
+	inline void refill()
+	{
+		if(!refills_until_reseed)
+		{
+			this->reseed();
+		}
+		--refills_until_reseed;
+		::fast_io::details::chacha::chacha20_drbg_keystream(state,buffer,sizeof(buffer));
+		::fast_io::details::chacha::chacha20_drbg_set_key(state,buffer);
+		__builtin_memset(buffer,0,::fast_io::details::chacha::chacha20_drbg_key_size);
+		position=::fast_io::details::chacha::chacha20_drbg_key_size;
+	}
+};
+
+/*
+The calling thread's engine, seeded from a default-constructed handletype on first use.
+*/
+template<input_stream handletype>
+requires std::same_as<std::remove_cvref_t<typename handletype::char_type>,char>
+inline basic_chacha20_drbg_engine<handletype>& chacha20_drbg_thread_local_engine()
+{
+	thread_local basic_chacha20_drbg_engine<handletype> engine;
+	return engine;
+}
+
+}
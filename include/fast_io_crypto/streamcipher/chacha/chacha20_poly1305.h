@@ -0,0 +1,222 @@
+#pragma once
+
+/*
+ChaCha20-Poly1305 AEAD (RFC 8439 section 2.8) and basic_io_buffer decorators built on it.
+*/
+
+namespace fast_io
+{
+
+inline constexpr std::size_t chacha20_poly1305_key_size{32};
+inline constexpr std::size_t chacha20_poly1305_nonce_size{12};
+inline constexpr std::size_t chacha20_poly1305_tag_size{16};
+
+}
+
+namespace fast_io::details::chacha
+{
+
+inline void chacha20_poly1305_tag(::std::byte const* otk,::std::byte const* aad,std::size_t aad_size,
+	::std::byte const* ciphertext,std::size_t size,::std::byte* tag) noexcept
+{
+	::fast_io::details::poly1305::poly1305_state st;
+	::fast_io::details::poly1305::poly1305_init(st,otk);
+	::fast_io::details::poly1305::poly1305_update<true>(st,aad,aad_size);
+	::fast_io::details::poly1305::poly1305_update<true>(st,ciphertext,size);
+	::std::uint_least64_t lengths[2]{::fast_io::little_endian(static_cast<::std::uint_least64_t>(aad_size)),
+		::fast_io::little_endian(static_cast<::std::uint_least64_t>(size))};
+	::std::byte block[::fast_io::details::poly1305::block_size];
+	__builtin_memcpy(block,lengths,sizeof(block));
+	::fast_io::details::poly1305::poly1305_blocks_scalar(st,block,1,static_cast<::std::uint_least32_t>(1)<<24);
+	::fast_io::details::poly1305::poly1305_finish(st,tag);
+}
+
+/*
+Block 0 of the keystream becomes the one-time Poly1305 key; the payload uses blocks 1,2,...
+*/
+inline void chacha20_poly1305_setup(::std::uint_least32_t* state,::std::byte* otk,::std::byte const* key,::std::byte const* nonce) noexcept
+{
+	::fast_io::details::chacha::chacha20_init_state(state,key,0,nonce);
+	::fast_io::details::chacha::chacha_runtime_routine(otk,state);
+	state[12]=1;
+}
+
+inline void chacha20_poly1305_seal(::std::byte const* key,::std::byte const* nonce,::std::byte const* aad,std::size_t aad_size,
+	::std::byte const* in,std::size_t size,::std::byte* out,::std::byte* tag) noexcept
+{
+	::std::uint_least32_t state[16];
+	::std::byte otk[64];
+	::fast_io::details::chacha::chacha20_poly1305_setup(state,otk,key,nonce);
+	::fast_io::details::chacha::chacha20_xor(state,in,out,size);
+	::fast_io::details::chacha::chacha20_poly1305_tag(otk,aad,aad_size,out,size,tag);
+	::fast_io::secure_clear(state,sizeof(state));
+	::fast_io::secure_clear(otk,sizeof(otk));
+}
+
+/*
+Verifies before decrypting, so nothing is written to out when the tag does not match.
+*/
+inline bool chacha20_poly1305_open(::std::byte const* key,::std::byte const* nonce,::std::byte const* aad,std::size_t aad_size,
+	::std::byte const* in,std::size_t size,::std::byte const* tag,::std::byte* out) noexcept
+{
+	::std::uint_least32_t state[16];
+	::std::byte otk[64];
+	::fast_io::details::chacha::chacha20_poly1305_setup(state,otk,key,nonce);
+	::std::byte expected[::fast_io::chacha20_poly1305_tag_size];
+	::fast_io::details::chacha::chacha20_poly1305_tag(otk,aad,aad_size,in,size,expected);
+	unsigned char diff{};
+	for(std::size_t i{};i!=::fast_io::chacha20_poly1305_tag_size;++i)
+	{
+		diff|=static_cast<unsigned char>(expected[i]^tag[i]);
+	}
+	bool const ok{diff==0};
+	if(ok)
+	{
+		::fast_io::details::chacha::chacha20_xor(state,in,out,size);
+	}
+	::fast_io::secure_clear(state,sizeof(state));
+	::fast_io::secure_clear(otk,sizeof(otk));
+	return ok;
+}
+
+}
+
+namespace fast_io
+{
+
+/*
+Encrypts [first,last) to ciphertext (same length, may alias first) and writes the 16-byte tag.
+key is chacha20_poly1305_key_size bytes, nonce chacha20_poly1305_nonce_size bytes and must never repeat under a key.
+*/
+inline void chacha20_poly1305_encrypt(::std::byte const* key,::std::byte const* nonce,
+	::std::byte const* aad_first,::std::byte const* aad_last,
+	::std::byte const* first,::std::byte const* last,::std::byte* ciphertext,::std::byte* tag) noexcept
+{
+	::fast_io::details::chacha::chacha20_poly1305_seal(key,nonce,aad_first,static_cast<std::size_t>(aad_last-aad_first),
+		first,static_cast<std::size_t>(last-first),ciphertext,tag);
+}
+
+/*
+Returns false, leaving plaintext untouched, when the tag does not authenticate aad and [first,last).
+*/
+inline bool chacha20_poly1305_decrypt(::std::byte const* key,::std::byte const* nonce,
+	::std::byte const* aad_first,::std::byte const* aad_last,
+	::std::byte const* first,::std::byte const* last,::std::byte const* tag,::std::byte* plaintext) noexcept
+{
+	return ::fast_io::details::chacha::chacha20_poly1305_open(key,nonce,aad_first,static_cast<std::size_t>(aad_last-aad_first),
+		first,static_cast<std::size_t>(last-first),tag,plaintext);
+}
+
+/*
+Stream decorators framed as described in fast_io_crypto/aead/record.h.
+*/
+inline constexpr std::size_t chacha20_poly1305_record_size{::fast_io::aead_record_size};
+inline constexpr std::size_t chacha20_poly1305_record_overhead{::fast_io::aead_record_overhead};
+
+struct chacha20_poly1305_encrypt_deco_t
+{
+	::std::byte key[chacha20_poly1305_key_size];
+	::std::byte nonce[chacha20_poly1305_nonce_size];
+	::fast_io::details::aead::record_seal_state state;
+	chacha20_poly1305_encrypt_deco_t(::std::byte const* k,::std::byte const* n) noexcept
+	{
+		::fast_io::details::non_overlapped_copy_n(k,chacha20_poly1305_key_size,key);
+		::fast_io::details::non_overlapped_copy_n(n,chacha20_poly1305_nonce_size,nonce);
+	}
+	chacha20_poly1305_encrypt_deco_t(chacha20_poly1305_encrypt_deco_t&&) noexcept = default;
+	chacha20_poly1305_encrypt_deco_t& operator=(chacha20_poly1305_encrypt_deco_t&&) noexcept = default;
+	void seal(::std::byte const* record_nonce,::std::byte const* header,::std::byte const* first,std::size_t size,::std::byte* out) const noexcept
+	{
+		::fast_io::details::chacha::chacha20_poly1305_seal(key,record_nonce,header,4,first,size,out,out+size);
+	}
+	~chacha20_poly1305_encrypt_deco_t()
+	{
+		::fast_io::secure_clear(key,sizeof(key));
+	}
+};
+
+struct chacha20_poly1305_decrypt_deco_t
+{
+	::std::byte key[chacha20_poly1305_key_size];
+	::std::byte nonce[chacha20_poly1305_nonce_size];
+	::fast_io::details::aead::record_open_state state;
+	chacha20_poly1305_decrypt_deco_t(::std::byte const* k,::std::byte const* n) noexcept
+	{
+		::fast_io::details::non_overlapped_copy_n(k,chacha20_poly1305_key_size,key);
+		::fast_io::details::non_overlapped_copy_n(n,chacha20_poly1305_nonce_size,nonce);
+	}
+	bool open(::std::byte const* record_nonce,::std::byte const* header,::std::byte const* ciphertext,std::size_t size,::std::byte* out) const noexcept
+	{
+		return ::fast_io::details::chacha::chacha20_poly1305_open(key,record_nonce,header,4,ciphertext,size,ciphertext+size,out);
+	}
+	~chacha20_poly1305_decrypt_deco_t()
+	{
+		::fast_io::secure_clear(key,sizeof(key));
+	}
+};
+
+template<::std::integral to_char_type>
+requires (sizeof(to_char_type)==1)
+inline constexpr std::size_t deco_reserve_size(io_reserve_type_t<to_char_type,chacha20_poly1305_encrypt_deco_t>,
+	chacha20_poly1305_encrypt_deco_t&,std::size_t size) noexcept
+{
+	return ::fast_io::details::intrinsics::add_or_overflow_die(size,
+		::fast_io::details::intrinsics::mul_or_overflow_die(size/chacha20_poly1305_record_size+1,chacha20_poly1305_record_overhead));
+}
+
+template<::std::contiguous_iterator fromIter,::std::contiguous_iterator toIter>
+requires (sizeof(::std::iter_value_t<fromIter>)==1&&sizeof(::std::iter_value_t<toIter>)==1)
+inline toIter deco_reserve_define(io_reserve_type_t<::std::iter_value_t<toIter>,chacha20_poly1305_encrypt_deco_t>,
+	chacha20_poly1305_encrypt_deco_t& deco,fromIter first,fromIter last,toIter iter) noexcept
+{
+	::std::byte* const out{reinterpret_cast<::std::byte*>(::std::to_address(iter))};
+	return iter+(::fast_io::details::aead::seal_records(deco,
+		reinterpret_cast<::std::byte const*>(::std::to_address(first)),
+		reinterpret_cast<::std::byte const*>(::std::to_address(last)),out)-out);
+}
+
+template<::std::integral to_char_type>
+requires (sizeof(to_char_type)==1)
+inline constexpr std::size_t deco_finish_size(io_reserve_type_t<to_char_type,chacha20_poly1305_encrypt_deco_t>,
+	chacha20_poly1305_encrypt_deco_t& deco) noexcept
+{
+	return ::fast_io::details::aead::seal_final_size(deco);
+}
+
+template<::std::contiguous_iterator toIter>
+requires (sizeof(::std::iter_value_t<toIter>)==1)
+inline toIter deco_finish_define(io_reserve_type_t<::std::iter_value_t<toIter>,chacha20_poly1305_encrypt_deco_t>,
+	chacha20_poly1305_encrypt_deco_t& deco,toIter iter) noexcept
+{
+	::std::byte* const out{reinterpret_cast<::std::byte*>(::std::to_address(iter))};
+	return iter+(::fast_io::details::aead::seal_final(deco,out)-out);
+}
+
+template<::std::integral to_char_type>
+requires (sizeof(to_char_type)==1)
+inline constexpr std::size_t deco_reserve_size(io_reserve_type_t<to_char_type,chacha20_poly1305_decrypt_deco_t>,
+	chacha20_poly1305_decrypt_deco_t& deco,std::size_t size) noexcept
+{
+	return ::fast_io::details::intrinsics::add_or_overflow_die(size,deco.state.pending_size);
+}
+
+template<::std::integral to_char_type>
+requires (sizeof(to_char_type)==1)
+inline constexpr void deco_eof(io_reserve_type_t<to_char_type,chacha20_poly1305_decrypt_deco_t>,
+	chacha20_poly1305_decrypt_deco_t& deco)
+{
+	::fast_io::details::aead::open_eof(deco);
+}
+
+template<::std::contiguous_iterator fromIter,::std::contiguous_iterator toIter>
+requires (sizeof(::std::iter_value_t<fromIter>)==1&&sizeof(::std::iter_value_t<toIter>)==1)
+inline toIter deco_reserve_define(io_reserve_type_t<::std::iter_value_t<toIter>,chacha20_poly1305_decrypt_deco_t>,
+	chacha20_poly1305_decrypt_deco_t& deco,fromIter first,fromIter last,toIter iter)
+{
+	::std::byte* const out{reinterpret_cast<::std::byte*>(::std::to_address(iter))};
+	return iter+(::fast_io::details::aead::open_records(deco,
+		reinterpret_cast<::std::byte const*>(::std::to_address(first)),
+		reinterpret_cast<::std::byte const*>(::std::to_address(last)),out)-out);
+}
+
+}
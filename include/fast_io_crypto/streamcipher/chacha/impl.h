@@ -10,6 +10,10 @@
 #else
 #include"runtime.h"
 #endif
+#include"multi_block.h"
+#include"poly1305.h"
+#include"chacha20_poly1305.h"
+#include"chacha20_drbg.h"
 
 
 namespace fast_io
@@ -0,0 +1,300 @@
+#pragma once
+
+/*
+Multi-block ChaCha20 (RFC 8439 block layout: constants, key, 32-bit counter in word 12, 96-bit nonce).
+n blocks run side by side, one per vector lane: word j of all n blocks lives in one vector, so a quarter round is
+plain vertical arithmetic and the lane counters are just counter+lane. The keystream comes out word-major and is
+transposed back to block order on the way out. Baseline 128-bit vectors run 4 blocks, AVX2 8 and AVX-512 16; CPUs
+are probed once through runtime_dispatch.h when the target does not already have them.
+*/
+
+namespace fast_io::details::chacha
+{
+
+#if (defined(__GNUC__) || defined(__clang__)) && __has_builtin(__builtin_shufflevector)
+
+inline constexpr bool chacha_multi_block_supported{::std::endian::native==::std::endian::little};
+
+/*
+Word j of n blocks. Spelled through a class so the vector attribute survives in the helpers' signatures.
+*/
+template<std::size_t n>
+struct chacha_multi_block_vector
+{
+	using type [[__gnu__::__vector_size__(n*sizeof(::std::uint_least32_t))]] = ::std::uint_least32_t;
+};
+
+template<std::size_t n,std::size_t d,bool high>
+inline constexpr int chacha_multi_block_transpose_index(std::size_t c) noexcept
+{
+	if constexpr(high)
+	{
+		return static_cast<int>((c&d)?n+c:c+d);
+	}
+	else
+	{
+		return static_cast<int>((c&d)?n+c-d:c);
+	}
+}
+
+/*
+As in the multi-buffer hashes, vectors are passed by reference: these helpers are only ever inlined into the
+target-specific kernels.
+*/
+template<std::size_t n,std::size_t d,std::size_t... c>
+#if __has_cpp_attribute(__gnu__::__always_inline__)
+[[__gnu__::__always_inline__]]
+#endif
+inline void chacha_multi_block_transpose_step(typename chacha_multi_block_vector<n>::type& a,typename chacha_multi_block_vector<n>::type& b,::std::index_sequence<c...>) noexcept
+{
+	typename chacha_multi_block_vector<n>::type const lo{__builtin_shufflevector(a,b,chacha_multi_block_transpose_index<n,d,false>(c)...)};
+	b=__builtin_shufflevector(a,b,chacha_multi_block_transpose_index<n,d,true>(c)...);
+	a=lo;
+}
+
+template<std::size_t n,std::size_t d>
+#if __has_cpp_attribute(__gnu__::__always_inline__)
+[[__gnu__::__always_inline__]]
+#endif
+inline void chacha_multi_block_transpose(typename chacha_multi_block_vector<n>::type* rows) noexcept
+{
+	if constexpr(d!=0)
+	{
+		for(std::size_t i{};i!=n;++i)
+		{
+			if(!(i&d))
+			{
+				chacha_multi_block_transpose_step<n,d>(rows[i],rows[i+d],::std::make_index_sequence<n>{});
+			}
+		}
+		chacha_multi_block_transpose<n,d/2u>(rows);
+	}
+}
+
+template<std::size_t n,unsigned r>
+#if __has_cpp_attribute(__gnu__::__always_inline__)
+[[__gnu__::__always_inline__]]
+#endif
+inline void chacha_multi_block_rotl(typename chacha_multi_block_vector<n>::type& v) noexcept
+{
+	v=(v<<r)|(v>>(32u-r));
+}
+
+template<std::size_t n>
+#if __has_cpp_attribute(__gnu__::__always_inline__)
+[[__gnu__::__always_inline__]]
+#endif
+inline void chacha_multi_block_qr(typename chacha_multi_block_vector<n>::type& a,typename chacha_multi_block_vector<n>::type& b,
+	typename chacha_multi_block_vector<n>::type& c,typename chacha_multi_block_vector<n>::type& d) noexcept
+{
+	a+=b;
+	d^=a;
+	chacha_multi_block_rotl<n,16>(d);
+	c+=d;
+	b^=c;
+	chacha_multi_block_rotl<n,12>(b);
+	a+=b;
+	d^=a;
+	chacha_multi_block_rotl<n,8>(d);
+	c+=d;
+	b^=c;
+	chacha_multi_block_rotl<n,7>(b);
+}
+
+template<std::size_t n,std::size_t... i>
+#if __has_cpp_attribute(__gnu__::__always_inline__)
+[[__gnu__::__always_inline__]]
+#endif
+inline void chacha_multi_block_lane_index(typename chacha_multi_block_vector<n>::type& v,::std::index_sequence<i...>) noexcept
+{
+	v=typename chacha_multi_block_vector<n>::type{static_cast<::std::uint_least32_t>(i)...};
+}
+
+/*
+XORs the keystream of blocks state[12],state[12]+1,... into every whole group of n blocks of [in,in+blocks*64) and
+advances the counter. in may equal out. Returns the number of blocks processed.
+*/
+template<std::size_t n>
+#if __has_cpp_attribute(__gnu__::__always_inline__)
+[[__gnu__::__always_inline__]]
+#endif
+inline std::size_t chacha20_xor_multi_block_generic(::std::uint_least32_t* __restrict state,::std::byte const* in,::std::byte* out,std::size_t blocks) noexcept
+{
+	using vec_type = typename chacha_multi_block_vector<n>::type;
+	constexpr std::size_t words{16};
+	constexpr std::size_t block_size{64};
+	vec_type lanes;
+	chacha_multi_block_lane_index<n>(lanes,::std::make_index_sequence<n>{});
+	std::size_t const processed{blocks/n*n};
+	for(std::size_t k{};k!=processed;k+=n)
+	{
+		vec_type init[words];
+		for(std::size_t i{};i!=words;++i)
+		{
+			init[i]=vec_type{}+state[i];
+		}
+		init[12]+=lanes;
+		vec_type x[words];
+		for(std::size_t i{};i!=words;++i)
+		{
+			x[i]=init[i];
+		}
+		for(std::size_t i{};i!=10;++i)
+		{
+			chacha_multi_block_qr<n>(x[0],x[4],x[8],x[12]);
+			chacha_multi_block_qr<n>(x[1],x[5],x[9],x[13]);
+			chacha_multi_block_qr<n>(x[2],x[6],x[10],x[14]);
+			chacha_multi_block_qr<n>(x[3],x[7],x[11],x[15]);
+			chacha_multi_block_qr<n>(x[0],x[5],x[10],x[15]);
+			chacha_multi_block_qr<n>(x[1],x[6],x[11],x[12]);
+			chacha_multi_block_qr<n>(x[2],x[7],x[8],x[13]);
+			chacha_multi_block_qr<n>(x[3],x[4],x[9],x[14]);
+		}
+		for(std::size_t i{};i!=words;++i)
+		{
+			x[i]+=init[i];
+		}
+		/*
+		Each n x n slice of words turns into n consecutive words of each of the n blocks.
+		*/
+		for(std::size_t g{};g!=words;g+=n)
+		{
+			vec_type* const rows{x+g};
+			chacha_multi_block_transpose<n,n/2u>(rows);
+			for(std::size_t j{};j!=n;++j)
+			{
+				std::size_t const offset{j*block_size+g*sizeof(::std::uint_least32_t)};
+				vec_type v;
+				__builtin_memcpy(__builtin_addressof(v),in+offset,sizeof(v));
+				v^=rows[j];
+				__builtin_memcpy(out+offset,__builtin_addressof(v),sizeof(v));
+			}
+		}
+		state[12]+=static_cast<::std::uint_least32_t>(n);
+		in+=n*block_size;
+		out+=n*block_size;
+	}
+	return processed;
+}
+
+inline std::size_t chacha20_xor_blocks_baseline(::std::uint_least32_t* __restrict state,::std::byte const* in,::std::byte* out,std::size_t blocks) noexcept
+{
+	return ::fast_io::details::chacha::chacha20_xor_multi_block_generic<4>(state,in,out,blocks);
+}
+
+#if defined(__x86_64__)
+[[__gnu__::__target__("avx2")]]
+inline std::size_t chacha20_xor_blocks_avx2(::std::uint_least32_t* __restrict state,::std::byte const* in,::std::byte* out,std::size_t blocks) noexcept
+{
+	return ::fast_io::details::chacha::chacha20_xor_multi_block_generic<8>(state,in,out,blocks);
+}
+
+[[__gnu__::__target__("avx512bw")]]
+inline std::size_t chacha20_xor_blocks_avx512bw(::std::uint_least32_t* __restrict state,::std::byte const* in,::std::byte* out,std::size_t blocks) noexcept
+{
+	return ::fast_io::details::chacha::chacha20_xor_multi_block_generic<16>(state,in,out,blocks);
+}
+#endif
+
+#else
+inline constexpr bool chacha_multi_block_supported{};
+#endif
+
+/*
+Encrypts or decrypts [in,in+n) into out (in may equal out) with the keystream starting at block state[12] and
+leaves state[12] at the next unused block; a trailing partial block uses up its counter.
+*/
+inline void chacha20_xor(::std::uint_least32_t* __restrict state,::std::byte const* in,::std::byte* out,std::size_t n) noexcept
+{
+	constexpr std::size_t block_size{64};
+	std::size_t blocks{n/block_size};
+	if constexpr(chacha_multi_block_supported)
+	{
+#if (defined(__GNUC__) || defined(__clang__)) && __has_builtin(__builtin_shufflevector)
+#if defined(__x86_64__)
+		bool avx512bw{
+#if defined(__AVX512BW__)
+			true
+#endif
+		};
+		bool avx2{
+#if defined(__AVX2__)
+			true
+#endif
+		};
+		if constexpr(::fast_io::details::cpu_flags::runtime_dispatch_supported)
+		{
+			auto const level{::fast_io::details::cpu_flags::get_runtime_simd_level()};
+			avx512bw=level==::fast_io::details::cpu_flags::runtime_simd_level::avx512bw;
+			avx2=level!=::fast_io::details::cpu_flags::runtime_simd_level::baseline;
+		}
+		if(avx512bw)
+		{
+			std::size_t const done{::fast_io::details::chacha::chacha20_xor_blocks_avx512bw(state,in,out,blocks)};
+			in+=done*block_size;
+			out+=done*block_size;
+			blocks-=done;
+		}
+		if(avx2)
+		{
+			std::size_t const done{::fast_io::details::chacha::chacha20_xor_blocks_avx2(state,in,out,blocks)};
+			in+=done*block_size;
+			out+=done*block_size;
+			blocks-=done;
+		}
+#endif
+		std::size_t const done{::fast_io::details::chacha::chacha20_xor_blocks_baseline(state,in,out,blocks)};
+		in+=done*block_size;
+		out+=done*block_size;
+		blocks-=done;
+#endif
+	}
+	::std::byte keystream[block_size];
+	for(;blocks;--blocks)
+	{
+		::fast_io::details::chacha::chacha_runtime_routine(keystream,state);
+		++state[12];
+		for(std::size_t i{};i!=block_size;++i)
+		{
+			out[i]=in[i]^keystream[i];
+		}
+		in+=block_size;
+		out+=block_size;
+	}
+	std::size_t const tail{n%block_size};
+	if(tail)
+	{
+		::fast_io::details::chacha::chacha_runtime_routine(keystream,state);
+		++state[12];
+		for(std::size_t i{};i!=tail;++i)
+		{
+			out[i]=in[i]^keystream[i];
+		}
+	}
+}
+
+/*
+Sets up an RFC 8439 state: 32-byte key, 32-bit initial block counter, 12-byte nonce.
+*/
+inline void chacha20_init_state(::std::uint_least32_t* state,::std::byte const* key,::std::uint_least32_t counter,::std::byte const* nonce) noexcept
+{
+	state[0]=0x61707865;
+	state[1]=0x3320646e;
+	state[2]=0x79622d32;
+	state[3]=0x6b206574;
+	for(std::size_t i{};i!=8;++i)
+	{
+		::std::uint_least32_t v;
+		__builtin_memcpy(__builtin_addressof(v),key+i*sizeof(v),sizeof(v));
+		state[4+i]=::fast_io::little_endian(v);
+	}
+	state[12]=counter;
+	for(std::size_t i{};i!=3;++i)
+	{
+		::std::uint_least32_t v;
+		__builtin_memcpy(__builtin_addressof(v),nonce+i*sizeof(v),sizeof(v));
+		state[13+i]=::fast_io::little_endian(v);
+	}
+}
+
+}
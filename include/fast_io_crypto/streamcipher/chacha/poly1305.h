@@ -0,0 +1,349 @@
+#pragma once
+
+/*
+Poly1305 (RFC 8439 section 2.5) in radix 2^26: five 26-bit limbs, 32x32->64 products (poly1305-donna-32).
+Long messages go through a 4-way AVX2 kernel: lane j accumulates blocks j,j+4,j+8,... multiplied by r^4 each step,
+and the lanes are folded with r^4,r^3,r^2,r at the end, which gives exactly the serial Horner result. Because the
+vector kernel uses the same limb layout, switching between it and the scalar code needs no conversion.
+*/
+
+namespace fast_io::details::poly1305
+{
+
+inline constexpr std::size_t block_size{16};
+inline constexpr ::std::uint_least32_t limb_mask{0x3ffffff};
+
+struct poly1305_state
+{
+	::std::uint_least32_t r[5];
+	::std::uint_least32_t h[5];
+	::std::uint_least32_t pad[4];
+};
+
+inline ::std::uint_least32_t poly1305_load32(::std::byte const* p) noexcept
+{
+	::std::uint_least32_t v;
+	__builtin_memcpy(__builtin_addressof(v),p,sizeof(v));
+	return ::fast_io::little_endian(v);
+}
+
+inline void poly1305_init(poly1305_state& st,::std::byte const* key) noexcept
+{
+	st.r[0]=poly1305_load32(key)&0x3ffffff;
+	st.r[1]=(poly1305_load32(key+3)>>2)&0x3ffff03;
+	st.r[2]=(poly1305_load32(key+6)>>4)&0x3ffc0ff;
+	st.r[3]=(poly1305_load32(key+9)>>6)&0x3f03fff;
+	st.r[4]=(poly1305_load32(key+12)>>8)&0x00fffff;
+	for(std::size_t i{};i!=5;++i)
+	{
+		st.h[i]=0;
+	}
+	for(std::size_t i{};i!=4;++i)
+	{
+		st.pad[i]=poly1305_load32(key+16+i*4);
+	}
+}
+
+/*
+h=h*r mod 2^130-5, with h only partially reduced (every limb below 2^26 except h[1], which may carry one more bit).
+*/
+inline void poly1305_mul(::std::uint_least32_t* __restrict h,::std::uint_least32_t const* __restrict r) noexcept
+{
+	using u64 = ::std::uint_least64_t;
+	u64 const r0{r[0]},r1{r[1]},r2{r[2]},r3{r[3]},r4{r[4]};
+	u64 const s1{r1*5},s2{r2*5},s3{r3*5},s4{r4*5};
+	u64 const h0{h[0]},h1{h[1]},h2{h[2]},h3{h[3]},h4{h[4]};
+	u64 const d0{h0*r0+h1*s4+h2*s3+h3*s2+h4*s1};
+	u64 d1{h0*r1+h1*r0+h2*s4+h3*s3+h4*s2};
+	u64 d2{h0*r2+h1*r1+h2*r0+h3*s4+h4*s3};
+	u64 d3{h0*r3+h1*r2+h2*r1+h3*r0+h4*s4};
+	u64 d4{h0*r4+h1*r3+h2*r2+h3*r1+h4*r0};
+	d1+=d0>>26;
+	d2+=d1>>26;
+	d3+=d2>>26;
+	d4+=d3>>26;
+	u64 t0{(d0&limb_mask)+(d4>>26)*5};
+	h[1]=static_cast<::std::uint_least32_t>((d1&limb_mask)+(t0>>26));
+	h[0]=static_cast<::std::uint_least32_t>(t0&limb_mask);
+	h[2]=static_cast<::std::uint_least32_t>(d2&limb_mask);
+	h[3]=static_cast<::std::uint_least32_t>(d3&limb_mask);
+	h[4]=static_cast<::std::uint_least32_t>(d4&limb_mask);
+}
+
+/*
+hibit is 1<<24 for whole message blocks and 0 for a final block that already carries its 0x01 terminator.
+*/
+inline void poly1305_blocks_scalar(poly1305_state& st,::std::byte const* p,std::size_t blocks,::std::uint_least32_t hibit) noexcept
+{
+	for(;blocks;--blocks)
+	{
+		st.h[0]+=poly1305_load32(p)&limb_mask;
+		st.h[1]+=(poly1305_load32(p+3)>>2)&limb_mask;
+		st.h[2]+=(poly1305_load32(p+6)>>4)&limb_mask;
+		st.h[3]+=(poly1305_load32(p+9)>>6)&limb_mask;
+		st.h[4]+=(poly1305_load32(p+12)>>8)|hibit;
+		poly1305_mul(st.h,st.r);
+		p+=block_size;
+	}
+}
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__)) && __has_builtin(__builtin_shufflevector)
+
+inline constexpr std::size_t poly1305_avx2_min_blocks{16};
+
+using poly1305_v4du [[__gnu__::__vector_size__(32)]] = unsigned long long;
+using poly1305_v8si [[__gnu__::__vector_size__(32)]] = int;
+
+/*
+Low 32 bits of each lane times low 32 bits of each lane (vpmuludq).
+*/
+[[__gnu__::__target__("avx2")]]
+#if __has_cpp_attribute(__gnu__::__always_inline__)
+[[__gnu__::__always_inline__]]
+#endif
+inline poly1305_v4du poly1305_avx2_mul32(poly1305_v4du a,poly1305_v4du b) noexcept
+{
+	return (poly1305_v4du)__builtin_ia32_pmuludq256((poly1305_v8si)a,(poly1305_v8si)b);
+}
+
+/*
+h[i]=h[i]*r[i] lane by lane; s holds 5*r.
+*/
+[[__gnu__::__target__("avx2")]]
+#if __has_cpp_attribute(__gnu__::__always_inline__)
+[[__gnu__::__always_inline__]]
+#endif
+inline void poly1305_avx2_mul(poly1305_v4du* __restrict h,poly1305_v4du const* __restrict r,poly1305_v4du const* __restrict s) noexcept
+{
+	poly1305_v4du const d0{poly1305_avx2_mul32(h[0],r[0])+poly1305_avx2_mul32(h[1],s[4])+poly1305_avx2_mul32(h[2],s[3])+poly1305_avx2_mul32(h[3],s[2])+poly1305_avx2_mul32(h[4],s[1])};
+	poly1305_v4du d1{poly1305_avx2_mul32(h[0],r[1])+poly1305_avx2_mul32(h[1],r[0])+poly1305_avx2_mul32(h[2],s[4])+poly1305_avx2_mul32(h[3],s[3])+poly1305_avx2_mul32(h[4],s[2])};
+	poly1305_v4du d2{poly1305_avx2_mul32(h[0],r[2])+poly1305_avx2_mul32(h[1],r[1])+poly1305_avx2_mul32(h[2],r[0])+poly1305_avx2_mul32(h[3],s[4])+poly1305_avx2_mul32(h[4],s[3])};
+	poly1305_v4du d3{poly1305_avx2_mul32(h[0],r[3])+poly1305_avx2_mul32(h[1],r[2])+poly1305_avx2_mul32(h[2],r[1])+poly1305_avx2_mul32(h[3],r[0])+poly1305_avx2_mul32(h[4],s[4])};
+	poly1305_v4du d4{poly1305_avx2_mul32(h[0],r[4])+poly1305_avx2_mul32(h[1],r[3])+poly1305_avx2_mul32(h[2],r[2])+poly1305_avx2_mul32(h[3],r[1])+poly1305_avx2_mul32(h[4],r[0])};
+	d1+=d0>>26;
+	d2+=d1>>26;
+	d3+=d2>>26;
+	d4+=d3>>26;
+	poly1305_v4du const c{d4>>26};
+	poly1305_v4du const t0{(d0&limb_mask)+c+(c<<2)};
+	h[0]=t0&limb_mask;
+	h[1]=(d1&limb_mask)+(t0>>26);
+	h[2]=d2&limb_mask;
+	h[3]=d3&limb_mask;
+	h[4]=d4&limb_mask;
+}
+
+/*
+Adds the 16-byte blocks p, p+16, p+32, p+48 (one per lane) to h.
+*/
+[[__gnu__::__target__("avx2")]]
+#if __has_cpp_attribute(__gnu__::__always_inline__)
+[[__gnu__::__always_inline__]]
+#endif
+inline void poly1305_avx2_add_blocks(poly1305_v4du* h,::std::byte const* p) noexcept
+{
+	poly1305_v4du a,b;
+	__builtin_memcpy(__builtin_addressof(a),p,sizeof(a));
+	__builtin_memcpy(__builtin_addressof(b),p+sizeof(a),sizeof(b));
+	poly1305_v4du const lo{__builtin_shufflevector(a,b,0,2,4,6)};
+	poly1305_v4du const hi{__builtin_shufflevector(a,b,1,3,5,7)};
+	h[0]+=lo&limb_mask;
+	h[1]+=(lo>>26)&limb_mask;
+	h[2]+=((lo>>52)|(hi<<12))&limb_mask;
+	h[3]+=(hi>>14)&limb_mask;
+	h[4]+=(hi>>40)|(static_cast<::std::uint_least64_t>(1)<<24);
+}
+
+/*
+Absorbs the whole groups of 4 blocks (all with the 2^128 bit) and returns the number of blocks consumed.
+*/
+[[__gnu__::__target__("avx2")]]
+inline std::size_t poly1305_blocks_avx2(poly1305_state& st,::std::byte const* p,std::size_t blocks) noexcept
+{
+	std::size_t const processed{blocks/4u*4u};
+	if(processed==0)
+	{
+		return 0;
+	}
+	::std::uint_least32_t pw[4][5];
+	for(std::size_t i{};i!=5;++i)
+	{
+		pw[0][i]=st.r[i];
+	}
+	for(std::size_t k{1};k!=4;++k)
+	{
+		for(std::size_t i{};i!=5;++i)
+		{
+			pw[k][i]=pw[k-1][i];
+		}
+		poly1305_mul(pw[k],st.r);
+	}
+	/*
+	The loop multiplies every lane by r^4; the final fold multiplies lane j by r^(4-j).
+	*/
+	poly1305_v4du r4[5],s4[5],rf[5],sf[5];
+	for(std::size_t i{};i!=5;++i)
+	{
+		r4[i]=poly1305_v4du{}+pw[3][i];
+		s4[i]=r4[i]*5;
+		rf[i]=poly1305_v4du{pw[3][i],pw[2][i],pw[1][i],pw[0][i]};
+		sf[i]=rf[i]*5;
+	}
+	poly1305_v4du h[5]{};
+	for(std::size_t i{};i!=5;++i)
+	{
+		h[i][0]=st.h[i];
+	}
+	poly1305_avx2_add_blocks(h,p);
+	::std::byte const* const last{p+processed*block_size};
+	for(p+=4u*block_size;p!=last;p+=4u*block_size)
+	{
+		poly1305_avx2_mul(h,r4,s4);
+		poly1305_avx2_add_blocks(h,p);
+	}
+	poly1305_avx2_mul(h,rf,sf);
+	::std::uint_least64_t d[5];
+	for(std::size_t i{};i!=5;++i)
+	{
+		d[i]=h[i][0]+h[i][1]+h[i][2]+h[i][3];
+	}
+	d[1]+=d[0]>>26;
+	d[2]+=d[1]>>26;
+	d[3]+=d[2]>>26;
+	d[4]+=d[3]>>26;
+	::std::uint_least64_t const t0{(d[0]&limb_mask)+(d[4]>>26)*5};
+	st.h[0]=static_cast<::std::uint_least32_t>(t0&limb_mask);
+	st.h[1]=static_cast<::std::uint_least32_t>((d[1]&limb_mask)+(t0>>26));
+	st.h[2]=static_cast<::std::uint_least32_t>(d[2]&limb_mask);
+	st.h[3]=static_cast<::std::uint_least32_t>(d[3]&limb_mask);
+	st.h[4]=static_cast<::std::uint_least32_t>(d[4]&limb_mask);
+	return processed;
+}
+
+inline bool poly1305_has_avx2() noexcept
+{
+#if defined(__AVX2__)
+	return true;
+#else
+	if constexpr(::fast_io::details::cpu_flags::runtime_cpu_probe_supported)
+	{
+		return ::fast_io::details::cpu_flags::get_runtime_simd_level()!=::fast_io::details::cpu_flags::runtime_simd_level::baseline;
+	}
+	else
+	{
+		return false;
+	}
+#endif
+}
+
+#endif
+
+/*
+Absorbs whole 16-byte message blocks.
+*/
+inline void poly1305_blocks(poly1305_state& st,::std::byte const* p,std::size_t blocks) noexcept
+{
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__)) && __has_builtin(__builtin_shufflevector)
+	if constexpr(::std::endian::native==::std::endian::little)
+	{
+		if(poly1305_avx2_min_blocks<=blocks&&poly1305_has_avx2())
+		{
+			std::size_t const done{poly1305_blocks_avx2(st,p,blocks)};
+			p+=done*block_size;
+			blocks-=done;
+		}
+	}
+#endif
+	poly1305_blocks_scalar(st,p,blocks,static_cast<::std::uint_least32_t>(1)<<24);
+}
+
+/*
+Absorbs [p,p+n). A trailing partial block is either zero-padded to a whole block (the AEAD construction) or
+terminated with 0x01 as the final block of a plain Poly1305 message.
+*/
+template<bool zero_pad>
+inline void poly1305_update(poly1305_state& st,::std::byte const* p,std::size_t n) noexcept
+{
+	std::size_t const blocks{n/block_size};
+	poly1305_blocks(st,p,blocks);
+	std::size_t const tail{n%block_size};
+	if(tail)
+	{
+		::std::byte last[block_size]{};
+		::fast_io::details::non_overlapped_copy_n(p+blocks*block_size,tail,last);
+		if constexpr(zero_pad)
+		{
+			poly1305_blocks_scalar(st,last,1,static_cast<::std::uint_least32_t>(1)<<24);
+		}
+		else
+		{
+			last[tail]=::std::byte{1};
+			poly1305_blocks_scalar(st,last,1,0);
+		}
+	}
+}
+
+inline void poly1305_finish(poly1305_state& st,::std::byte* tag) noexcept
+{
+	::std::uint_least32_t h0{st.h[0]},h1{st.h[1]},h2{st.h[2]},h3{st.h[3]},h4{st.h[4]};
+	::std::uint_least32_t c{h1>>26};
+	h1&=limb_mask;
+	h2+=c;
+	c=h2>>26;
+	h2&=limb_mask;
+	h3+=c;
+	c=h3>>26;
+	h3&=limb_mask;
+	h4+=c;
+	c=h4>>26;
+	h4&=limb_mask;
+	h0+=c*5;
+	c=h0>>26;
+	h0&=limb_mask;
+	h1+=c;
+	/*
+	Constant-time select of h or h-p.
+	*/
+	::std::uint_least32_t g0{h0+5};
+	c=g0>>26;
+	g0&=limb_mask;
+	::std::uint_least32_t g1{h1+c};
+	c=g1>>26;
+	g1&=limb_mask;
+	::std::uint_least32_t g2{h2+c};
+	c=g2>>26;
+	g2&=limb_mask;
+	::std::uint_least32_t g3{h3+c};
+	c=g3>>26;
+	g3&=limb_mask;
+	::std::uint_least32_t g4{h4+c-(static_cast<::std::uint_least32_t>(1)<<26)};
+	::std::uint_least32_t mask{(g4>>31)-1u};
+	h0=(h0&~mask)|(g0&mask);
+	h1=(h1&~mask)|(g1&mask);
+	h2=(h2&~mask)|(g2&mask);
+	h3=(h3&~mask)|(g3&mask);
+	h4=(h4&~mask)|(g4&mask);
+	::std::uint_least32_t w[4]{h0|(h1<<26),(h1>>6)|(h2<<20),(h2>>12)|(h3<<14),(h3>>18)|(h4<<8)};
+	::std::uint_least64_t f{};
+	for(std::size_t i{};i!=4;++i)
+	{
+		f+=static_cast<::std::uint_least64_t>(w[i])+st.pad[i];
+		::std::uint_least32_t const v{::fast_io::little_endian(static_cast<::std::uint_least32_t>(f))};
+		__builtin_memcpy(tag+i*sizeof(v),__builtin_addressof(v),sizeof(v));
+		f>>=32;
+	}
+	::fast_io::secure_clear(__builtin_addressof(st),sizeof(st));
+}
+
+/*
+One-shot Poly1305 of [first,last) under a 32-byte one-time key; writes the 16-byte tag.
+*/
+inline void poly1305_mac(::std::byte const* key,::std::byte const* first,::std::byte const* last,::std::byte* tag) noexcept
+{
+	poly1305_state st;
+	poly1305_init(st,key);
+	poly1305_update<false>(st,first,static_cast<std::size_t>(last-first));
+	poly1305_finish(st,tag);
+}
+
+}
@@ -21,13 +21,13 @@ inline void chacha_simd16_qr4_round_impl(
 {
 	if constexpr(evenround)
 	{
-		b.value=__builtin_shufflevector(b.value,b.value,3,0,1,2);
-		c.value=__builtin_shufflevector(c.value,c.value,2,3,0,1);
-		d.value=__builtin_shufflevector(d.value,d.value,1,2,3,0);
-		chacha_simd16_qr4_round_impl<0>(a,b,c,d);
 		b.value=__builtin_shufflevector(b.value,b.value,1,2,3,0);
 		c.value=__builtin_shufflevector(c.value,c.value,2,3,0,1);
 		d.value=__builtin_shufflevector(d.value,d.value,3,0,1,2);
+		chacha_simd16_qr4_round_impl<0>(a,b,c,d);
+		b.value=__builtin_shufflevector(b.value,b.value,3,0,1,2);
+		c.value=__builtin_shufflevector(c.value,c.value,2,3,0,1);
+		d.value=__builtin_shufflevector(d.value,d.value,1,2,3,0);
 	}
 	else
 	{
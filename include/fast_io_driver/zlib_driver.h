@@ -1,6 +1,7 @@
 ﻿#pragma once
 #include<zlib.h>
 #include"zlib_driver/gzfile.h"
+#include"zlib_driver/zstream_deco.h"
 
 namespace fast_io
 {
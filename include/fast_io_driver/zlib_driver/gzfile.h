@@ -122,15 +122,14 @@ public:
 
 
 	basic_gz_file(native_interface_t,int fd,char const* mode):
-		basic_gz_io_observer<char_type>(gzdopen(pfd,mode.data()))
+		basic_gz_io_observer<char_type>{noexcept_call(gzdopen,fd,mode)}
 	{
 		if(this->native_handle()==nullptr)
 			throw_posix_error();
-		posix_handle.release();
 	}
 
 	basic_gz_file(basic_posix_file<char_type>&& posix_handle,open_mode om):
-		basic_gz_file(native_interface,posix_handle.fd,to_native_c_mode(om))
+		basic_gz_file(native_interface,posix_handle.fd,to_c_mode(om))
 	{
 		posix_handle.release();
 	}
@@ -139,12 +138,12 @@ public:
 //windows specific. open posix file from win32 io handle
 	template<win32_family family>
 	basic_gz_file(basic_win32_family_file<family,char_type>&& win32_handle,open_mode om):
-		basic_gz_file(basic_posix_file<char_type>(::std::move(win32_handle),om),to_native_c_mode(om))
+		basic_gz_file(basic_posix_file<char_type>(::std::move(win32_handle),om),to_c_mode(om))
 	{
 	}
 	template<nt_family family>
 	basic_gz_file(basic_nt_family_file<family,char_type>&& nt_handle,open_mode om):
-		basic_gz_file(basic_posix_file<char_type>(::std::move(nt_handle),om),to_native_c_mode(om))
+		basic_gz_file(basic_posix_file<char_type>(::std::move(nt_handle),om),to_c_mode(om))
 	{
 	}
 #endif
@@ -156,10 +155,12 @@ public:
 		this->native_handle()=hd;
 	}
 
-	basic_gz_file(cstring_view file,open_mode om,perms pm=static_cast<perms>(436)):
+	template<::fast_io::constructible_to_os_c_str T>
+	basic_gz_file(T const& file,open_mode om,perms pm=static_cast<perms>(436)):
 		basic_gz_file(basic_posix_file<char_type>(file,om,pm),om)
 	{}
-	basic_gz_file(native_at_entry nate,cstring_view file,open_mode om,perms pm=static_cast<perms>(436)):
+	template<::fast_io::constructible_to_os_c_str T>
+	basic_gz_file(native_at_entry nate,T const& file,open_mode om,perms pm=static_cast<perms>(436)):
 		basic_gz_file(basic_posix_file<char_type>(nate,file,om,pm),om)
 	{}
 };
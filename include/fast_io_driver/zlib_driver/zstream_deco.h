@@ -0,0 +1,480 @@
+#pragma once
+
+/*
+z_stream decorators for basic_io_buffer: deflate_deco_t compresses what the buffer flushes (external decorator of an
+output buffer) and inflate_deco_t decompresses what it reads (internal decorator of an input buffer). They work over
+any fast_io stream and compress straight between basic_io_buffer's two buffers, without gzFile's extra buffer.
+
+Every flushed chunk is cut into blocks of block_size bytes and each block becomes one complete member of the chosen
+format, header and trailer included. No dictionary carries over, so every flush() ends a member and the data after it
+compresses from scratch: flush rarely, or raise block_size, when the ratio matters. Concatenated gzip members are a valid gzip file (RFC 1952 2.2), so the output is readable by gunzip after
+every flush; that independence also lets blocks compress on several threads at once, in the manner of pigz, when
+threads is not 1 and the buffer holds several blocks. zlib and raw deflate members are not standard when
+concatenated and are only meant for inflate_deco_t, which reads member after member of any format.
+inflate_deco_t throws parse_code::end_of_file when the input ends inside a member; a stream cut between two members
+looks like a shorter stream.
+*/
+
+#if ((__STDC_HOSTED__==1 && (!defined(_GLIBCXX_HOSTED) || _GLIBCXX_HOSTED==1) && !defined(_LIBCPP_FREESTANDING)) || defined(FAST_IO_ENABLE_HOSTED_FEATURES)) && __has_include(<pthread.h>) && __has_include(<unistd.h>)
+#include<pthread.h>
+#include<unistd.h>
+#define FAST_IO_ZLIB_DECO_HAS_THREADS
+#endif
+
+namespace fast_io::zlib
+{
+
+enum class zstream_format
+{
+deflate,
+zlib,
+gzip
+};
+
+inline constexpr std::size_t deflate_default_block_size{static_cast<std::size_t>(1)<<17u};
+
+namespace details
+{
+
+inline constexpr int zstream_window_bits(zstream_format format) noexcept
+{
+	switch(format)
+	{
+	case zstream_format::deflate:
+		return -MAX_WBITS;
+	case zstream_format::zlib:
+		return MAX_WBITS;
+	default:
+		return MAX_WBITS+16;
+	}
+}
+
+[[noreturn]] inline void throw_zstream_error(int ret)
+{
+	switch(ret)
+	{
+	case Z_DATA_ERROR:
+	case Z_NEED_DICT:
+		::fast_io::throw_parse_code(::fast_io::parse_code::invalid);
+	case Z_MEM_ERROR:
+		throw_posix_error(ENOMEM);
+	default:
+		throw_posix_error(EINVAL);
+	}
+}
+
+inline z_stream* allocate_zstreams(std::size_t n)
+{
+	using allocator = ::fast_io::native_typed_global_allocator<z_stream>;
+	z_stream* streams{allocator::allocate(n)};
+	::fast_io::freestanding::bytes_clear_n(reinterpret_cast<std::byte*>(streams),n*sizeof(z_stream));
+	return streams;
+}
+
+inline void deallocate_zstreams(z_stream* streams,std::size_t n,bool inflate) noexcept
+{
+	for(std::size_t i{};i!=n;++i)
+	{
+		if(streams[i].state)
+		{
+			if(inflate)
+				inflateEnd(streams+i);
+			else
+				deflateEnd(streams+i);
+		}
+	}
+	::fast_io::native_typed_global_allocator<z_stream>::deallocate_n(streams,n);
+}
+
+/*
+compressBound is for the 6-byte zlib wrapper; a gzip member has 18.
+*/
+inline constexpr std::size_t deflate_member_bound(std::size_t size) noexcept
+{
+	return size+(size>>12u)+(size>>14u)+(size>>25u)+31u;
+}
+
+}
+
+/*
+level is zlib's (Z_DEFAULT_COMPRESSION or 0..9). threads==0 uses every online CPU. block_size is capped so that a
+block always fits z_stream's 32-bit counters.
+*/
+struct deflate_deco_t
+{
+	zstream_format format{zstream_format::gzip};
+	int level{Z_DEFAULT_COMPRESSION};
+	std::size_t threads{1};
+	std::size_t block_size{deflate_default_block_size};
+	z_stream* streams{};
+	std::size_t stream_count{};
+	explicit constexpr deflate_deco_t(zstream_format fmt=zstream_format::gzip,int lvl=Z_DEFAULT_COMPRESSION,
+		std::size_t thds=1,std::size_t blksize=deflate_default_block_size) noexcept:
+		format(fmt),level(lvl),threads(thds),block_size(blksize)
+	{
+		constexpr std::size_t mx{static_cast<std::size_t>(1)<<30u};
+		if(block_size==0||mx<block_size)
+			block_size=mx;
+	}
+	deflate_deco_t(deflate_deco_t const&)=delete;
+	deflate_deco_t& operator=(deflate_deco_t const&)=delete;
+	constexpr deflate_deco_t(deflate_deco_t&& other) noexcept:format(other.format),level(other.level),threads(other.threads),
+		block_size(other.block_size),streams(other.streams),stream_count(other.stream_count)
+	{
+		other.streams=nullptr;
+		other.stream_count=0;
+	}
+	deflate_deco_t& operator=(deflate_deco_t&& other) noexcept
+	{
+		if(__builtin_addressof(other)==this)
+			return *this;
+		if(streams)
+			::fast_io::zlib::details::deallocate_zstreams(streams,stream_count,false);
+		format=other.format;
+		level=other.level;
+		threads=other.threads;
+		block_size=other.block_size;
+		streams=other.streams;
+		stream_count=other.stream_count;
+		other.streams=nullptr;
+		other.stream_count=0;
+		return *this;
+	}
+	~deflate_deco_t()
+	{
+		if(streams)
+			::fast_io::zlib::details::deallocate_zstreams(streams,stream_count,false);
+	}
+};
+
+/*
+z_stream keeps a pointer back to itself, so it lives on the heap and the decorator stays movable.
+*/
+struct inflate_deco_t
+{
+	zstream_format format{zstream_format::gzip};
+	z_stream* stream{};
+	bool output_pending{};
+	bool member_end{};
+	explicit constexpr inflate_deco_t(zstream_format fmt=zstream_format::gzip) noexcept:format(fmt){}
+	inflate_deco_t(inflate_deco_t const&)=delete;
+	inflate_deco_t& operator=(inflate_deco_t const&)=delete;
+	constexpr inflate_deco_t(inflate_deco_t&& other) noexcept:format(other.format),stream(other.stream),
+		output_pending(other.output_pending),member_end(other.member_end)
+	{
+		other.stream=nullptr;
+	}
+	inflate_deco_t& operator=(inflate_deco_t&& other) noexcept
+	{
+		if(__builtin_addressof(other)==this)
+			return *this;
+		if(stream)
+			::fast_io::zlib::details::deallocate_zstreams(stream,1,true);
+		format=other.format;
+		stream=other.stream;
+		output_pending=other.output_pending;
+		member_end=other.member_end;
+		other.stream=nullptr;
+		return *this;
+	}
+	~inflate_deco_t()
+	{
+		if(stream)
+			::fast_io::zlib::details::deallocate_zstreams(stream,1,true);
+	}
+};
+
+namespace details
+{
+
+inline std::size_t deflate_deco_bound(deflate_deco_t const& deco,std::size_t size) noexcept
+{
+	std::size_t const full{size/deco.block_size};
+	std::size_t const tail{size%deco.block_size};
+	std::size_t bound{::fast_io::details::intrinsics::mul_or_overflow_die(full,deflate_member_bound(deco.block_size))};
+	if(tail)
+		bound=::fast_io::details::intrinsics::add_or_overflow_die(bound,deflate_member_bound(tail));
+	return bound;
+}
+
+inline std::size_t deflate_worker_count(deflate_deco_t const& deco,std::size_t blocks) noexcept
+{
+	std::size_t threads{deco.threads};
+#if defined(FAST_IO_ZLIB_DECO_HAS_THREADS)
+	if(threads==0)
+	{
+		long const online{noexcept_call(::sysconf,_SC_NPROCESSORS_ONLN)};
+		threads=online<1?1u:static_cast<std::size_t>(online);
+	}
+#else
+	threads=1;
+#endif
+	if(blocks<threads)
+		threads=blocks;
+	return threads==0?1u:threads;
+}
+
+inline void deflate_prepare_streams(deflate_deco_t& deco,std::size_t workers)
+{
+	if(deco.stream_count<workers)
+	{
+		if(deco.streams)
+			deallocate_zstreams(deco.streams,deco.stream_count,false);
+		deco.streams=nullptr;
+		deco.stream_count=0;
+		deco.streams=allocate_zstreams(workers);
+		deco.stream_count=workers;
+	}
+	for(std::size_t i{};i!=workers;++i)
+	{
+		if(deco.streams[i].state==nullptr)
+		{
+			int const ret{deflateInit2(deco.streams+i,deco.level,Z_DEFLATED,zstream_window_bits(deco.format),8,Z_DEFAULT_STRATEGY)};
+			if(ret!=Z_OK)
+				throw_zstream_error(ret);
+		}
+	}
+}
+
+/*
+Compresses one block into one member; out has deflate_member_bound(size) bytes, which deflate never exceeds.
+*/
+inline std::size_t deflate_member(z_stream* strm,::std::byte const* in,std::size_t size,::std::byte* out) noexcept
+{
+	deflateReset(strm);
+	strm->next_in=const_cast<Bytef*>(reinterpret_cast<Bytef const*>(in));
+	strm->avail_in=static_cast<uInt>(size);
+	strm->next_out=reinterpret_cast<Bytef*>(out);
+	strm->avail_out=static_cast<uInt>(deflate_member_bound(size));
+	if(deflate(strm,Z_FINISH)!=Z_STREAM_END)
+		return static_cast<std::size_t>(-1);
+	return static_cast<std::size_t>(reinterpret_cast<::std::byte*>(strm->next_out)-out);
+}
+
+struct deflate_parallel_job
+{
+	deflate_deco_t* deco;
+	::std::byte const* in;
+	std::size_t size;
+	::std::byte* out;
+	std::size_t slot;
+	std::size_t blocks;
+	std::size_t* sizes;
+	std::size_t next_block;
+	std::size_t next_worker;
+};
+
+inline void deflate_parallel_worker(deflate_parallel_job& job) noexcept
+{
+	z_stream* strm{job.deco->streams+__atomic_fetch_add(__builtin_addressof(job.next_worker),1u,__ATOMIC_RELAXED)};
+	std::size_t const block_size{job.deco->block_size};
+	for(;;)
+	{
+		std::size_t const block{__atomic_fetch_add(__builtin_addressof(job.next_block),1u,__ATOMIC_RELAXED)};
+		if(job.blocks<=block)
+			break;
+		std::size_t const offset{block*block_size};
+		std::size_t size{job.size-offset};
+		if(block_size<size)
+			size=block_size;
+		job.sizes[block]=deflate_member(strm,job.in+offset,size,job.out+block*job.slot);
+	}
+}
+
+#if defined(FAST_IO_ZLIB_DECO_HAS_THREADS)
+inline void* deflate_parallel_thread_routine(void* arg) noexcept
+{
+	deflate_parallel_worker(*static_cast<deflate_parallel_job*>(arg));
+	return nullptr;
+}
+#endif
+
+/*
+Blocks are compressed into fixed slots of the output buffer, one bound apart, and then slid down in order; a member
+never outgrows its slot, so the slide only ever moves data towards the front.
+*/
+inline ::std::byte* deflate_parallel(deflate_deco_t& deco,::std::byte const* in,std::size_t size,::std::byte* out,
+	std::size_t blocks,std::size_t workers)
+{
+	using size_allocator = ::fast_io::native_typed_global_allocator<std::size_t>;
+	std::size_t* sizes{size_allocator::allocate(blocks)};
+	deflate_parallel_job job{__builtin_addressof(deco),in,size,out,deflate_member_bound(deco.block_size),blocks,sizes,0,0};
+	std::size_t created{};
+#if defined(FAST_IO_ZLIB_DECO_HAS_THREADS)
+	using tid_allocator = ::fast_io::native_typed_global_allocator<::pthread_t>;
+	std::size_t const spawn{workers-1u};
+	::pthread_t* tids{tid_allocator::allocate(spawn)};
+	for(;created!=spawn;++created)
+	{
+		if(noexcept_call(::pthread_create,tids+created,nullptr,deflate_parallel_thread_routine,__builtin_addressof(job))!=0)
+			break;
+	}
+#endif
+	deflate_parallel_worker(job);
+#if defined(FAST_IO_ZLIB_DECO_HAS_THREADS)
+	for(std::size_t i{};i!=created;++i)
+		noexcept_call(::pthread_join,tids[i],nullptr);
+	tid_allocator::deallocate_n(tids,spawn);
+#endif
+	bool failed{};
+	::std::byte* curr{out};
+	for(std::size_t i{};i!=blocks;++i)
+	{
+		if(sizes[i]==static_cast<std::size_t>(-1))
+		{
+			failed=true;
+			break;
+		}
+		::std::byte const* slot{out+i*job.slot};
+		if(curr!=slot)
+			::fast_io::freestanding::my_memmove(curr,slot,sizes[i]);
+		curr+=sizes[i];
+	}
+	size_allocator::deallocate_n(sizes,blocks);
+	if(failed)
+		throw_zstream_error(Z_STREAM_ERROR);
+	return curr;
+}
+
+inline ::std::byte* deflate_deco_define(deflate_deco_t& deco,::std::byte const* in,std::size_t size,::std::byte* out)
+{
+	if(size==0)
+		return out;
+	std::size_t const blocks{(size-1)/deco.block_size+1};
+	std::size_t const workers{deflate_worker_count(deco,blocks)};
+	deflate_prepare_streams(deco,workers);
+	if(1u<workers)
+		return deflate_parallel(deco,in,size,out,blocks,workers);
+	for(std::size_t offset{};offset!=size;)
+	{
+		std::size_t n{size-offset};
+		if(deco.block_size<n)
+			n=deco.block_size;
+		std::size_t const written{deflate_member(deco.streams,in+offset,n,out)};
+		if(written==static_cast<std::size_t>(-1))
+			throw_zstream_error(Z_STREAM_ERROR);
+		out+=written;
+		offset+=n;
+	}
+	return out;
+}
+
+inline constexpr std::size_t inflate_deco_min_output{static_cast<std::size_t>(1)<<16u};
+
+inline std::size_t inflate_deco_capacity(std::size_t size) noexcept
+{
+	std::size_t const cap{::fast_io::details::intrinsics::mul_or_overflow_die(size,static_cast<std::size_t>(4))};
+	return cap<inflate_deco_min_output?inflate_deco_min_output:cap;
+}
+
+/*
+The input is not copied: the stream keeps pointing into the caller's buffer, which basic_io_buffer leaves alone for
+as long as deco_pending reports output still to come. An empty range continues from there.
+*/
+inline ::std::byte* inflate_deco_define(inflate_deco_t& deco,::std::byte const* first,::std::byte const* last,::std::byte* out)
+{
+	if(deco.stream==nullptr)
+	{
+		z_stream* strm{allocate_zstreams(1)};
+		int const ret{inflateInit2(strm,zstream_window_bits(deco.format))};
+		if(ret!=Z_OK)
+		{
+			::fast_io::native_typed_global_allocator<z_stream>::deallocate_n(strm,1);
+			throw_zstream_error(ret);
+		}
+		deco.stream=strm;
+	}
+	z_stream* strm{deco.stream};
+	if(first!=last)
+	{
+		if(deco.member_end)
+		{
+			inflateReset(strm);
+			deco.member_end=false;
+		}
+		strm->next_in=const_cast<Bytef*>(reinterpret_cast<Bytef const*>(first));
+		strm->avail_in=static_cast<uInt>(last-first);
+	}
+	std::size_t const cap{inflate_deco_capacity(static_cast<std::size_t>(last-first))};
+	strm->next_out=reinterpret_cast<Bytef*>(out);
+	strm->avail_out=static_cast<uInt>(cap);
+	deco.output_pending=false;
+	for(;;)
+	{
+		int const ret{inflate(strm,Z_NO_FLUSH)};
+		if(ret==Z_STREAM_END)
+		{
+			if(strm->avail_in==0)
+			{
+				deco.member_end=true;
+				break;
+			}
+			inflateReset(strm);
+			continue;
+		}
+		if(ret!=Z_OK&&ret!=Z_BUF_ERROR)
+			throw_zstream_error(ret);
+		if(strm->avail_out==0)
+			deco.output_pending=true;
+		break;
+	}
+	return reinterpret_cast<::std::byte*>(strm->next_out);
+}
+
+}
+
+template<::std::integral to_char_type>
+requires (sizeof(to_char_type)==1)
+inline std::size_t deco_reserve_size(io_reserve_type_t<to_char_type,deflate_deco_t>,deflate_deco_t& deco,std::size_t size) noexcept
+{
+	return ::fast_io::zlib::details::deflate_deco_bound(deco,size);
+}
+
+template<::std::contiguous_iterator fromIter,::std::contiguous_iterator toIter>
+requires (sizeof(::std::iter_value_t<fromIter>)==1&&sizeof(::std::iter_value_t<toIter>)==1)
+inline toIter deco_reserve_define(io_reserve_type_t<::std::iter_value_t<toIter>,deflate_deco_t>,
+	deflate_deco_t& deco,fromIter first,fromIter last,toIter iter)
+{
+	::std::byte* const out{reinterpret_cast<::std::byte*>(::std::to_address(iter))};
+	return iter+(::fast_io::zlib::details::deflate_deco_define(deco,
+		reinterpret_cast<::std::byte const*>(::std::to_address(first)),
+		static_cast<std::size_t>(last-first),out)-out);
+}
+
+template<::std::integral to_char_type>
+requires (sizeof(to_char_type)==1)
+inline std::size_t deco_reserve_size(io_reserve_type_t<to_char_type,inflate_deco_t>,inflate_deco_t&,std::size_t size) noexcept
+{
+	return ::fast_io::zlib::details::inflate_deco_capacity(size);
+}
+
+template<::std::integral to_char_type>
+requires (sizeof(to_char_type)==1)
+inline bool deco_pending(io_reserve_type_t<to_char_type,inflate_deco_t>,inflate_deco_t& deco) noexcept
+{
+	return deco.stream&&(deco.output_pending||deco.stream->avail_in!=0);
+}
+
+/*
+Bytes consumed since the last member ended mean the member was cut short.
+*/
+template<::std::integral to_char_type>
+requires (sizeof(to_char_type)==1)
+inline void deco_eof(io_reserve_type_t<to_char_type,inflate_deco_t>,inflate_deco_t& deco)
+{
+	if(deco.stream&&!deco.member_end&&deco.stream->total_in!=0)
+		::fast_io::throw_parse_code(::fast_io::parse_code::end_of_file);
+}
+
+template<::std::contiguous_iterator fromIter,::std::contiguous_iterator toIter>
+requires (sizeof(::std::iter_value_t<fromIter>)==1&&sizeof(::std::iter_value_t<toIter>)==1)
+inline toIter deco_reserve_define(io_reserve_type_t<::std::iter_value_t<toIter>,inflate_deco_t>,
+	inflate_deco_t& deco,fromIter first,fromIter last,toIter iter)
+{
+	::std::byte* const out{reinterpret_cast<::std::byte*>(::std::to_address(iter))};
+	return iter+(::fast_io::zlib::details::inflate_deco_define(deco,
+		reinterpret_cast<::std::byte const*>(::std::to_address(first)),
+		reinterpret_cast<::std::byte const*>(::std::to_address(last)),out)-out);
+}
+
+}
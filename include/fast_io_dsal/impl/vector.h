@@ -234,7 +234,7 @@ private:
 	constexpr void destroy() noexcept
 	{
 		clear();
-		if constexpr (!typed_allocator_type::has_deallocate)
+		if constexpr (typed_allocator_type::has_deallocate)
 		{
 			typed_allocator_type::deallocate(imp.begin_ptr);
 		}
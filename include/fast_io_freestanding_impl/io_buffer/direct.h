@@ -0,0 +1,141 @@
+#pragma once
+#include"output_normal.h"
+#include"input_normal.h"
+
+/*
+buffer_mode::direct keeps every transfer on io_direct_alignment boundaries so a handle opened with open_mode::direct
+(O_DIRECT) accepts it: buffers come from an aligned allocator, the output side only ever writes whole blocks and
+keeps the partial last block at the front of the buffer, and the input side always refills the whole buffer instead
+of reading large requests straight into the caller's memory.
+*/
+
+namespace fast_io::details
+{
+
+template<std::integral char_type>
+inline constexpr std::size_t iobuf_direct_block_size{io_direct_alignment/sizeof(char_type)};
+
+/*
+Writes the whole blocks of [buffer_begin,buffer_curr) and moves the partial block left over to buffer_begin.
+*/
+template<typename T,std::integral char_type>
+inline constexpr void iobuf_direct_write_blocks_impl(T handle,basic_io_buffer_pointers<char_type>& pointers)
+{
+	constexpr std::size_t block{iobuf_direct_block_size<char_type>};
+	std::size_t const used{static_cast<std::size_t>(pointers.buffer_curr-pointers.buffer_begin)};
+	std::size_t const tail{used%block};
+	std::size_t const whole{used-tail};
+	if(whole==0)
+		return;
+	write(handle,pointers.buffer_begin,pointers.buffer_begin+whole);
+	pointers.buffer_curr=non_overlapped_copy_n(pointers.buffer_begin+whole,tail,pointers.buffer_begin);
+}
+
+/*
+Puts everything buffered into the file. A partial last block is written zero padded and the file is truncated back
+to its real length; the handle is then moved back to the start of that block and the partial block stays buffered,
+so the next write or flush rewrites it in place. The file therefore always ends where the stream does.
+*/
+template<typename handle_type,std::integral char_type>
+#if __has_cpp_attribute(__gnu__::__cold__)
+[[__gnu__::__cold__]]
+#endif
+inline constexpr void iobuf_direct_flush_impl(handle_type& handle,basic_io_buffer_pointers<char_type>& pointers)
+{
+	if(pointers.buffer_curr==pointers.buffer_begin)
+		return;
+	iobuf_direct_write_blocks_impl(io_ref(handle),pointers);
+	std::size_t const tail{static_cast<std::size_t>(pointers.buffer_curr-pointers.buffer_begin)};
+	if(tail==0)
+		return;
+	constexpr std::size_t block{iobuf_direct_block_size<char_type>};
+	::fast_io::details::my_memset(pointers.buffer_curr,0,(block-tail)*sizeof(char_type));
+	write(io_ref(handle),pointers.buffer_begin,pointers.buffer_begin+block);
+	std::uintmax_t const block_position{seek(handle,-static_cast<std::intmax_t>(io_direct_alignment),seekdir::cur)};
+	truncate(handle,block_position+tail*sizeof(char_type));
+}
+
+template<typename allocator_type,typename T,std::integral char_type>
+inline constexpr void iobuf_direct_constant_flush_prepare_impl(T handle,
+	basic_io_buffer_pointers<char_type>& pointers,std::size_t buffer_size)
+{
+	if(pointers.buffer_begin==nullptr)
+		iobuf_write_allocate_buffer_impl<allocator_type>(pointers,buffer_size);
+	else
+		iobuf_direct_write_blocks_impl(handle,pointers);
+}
+
+template<typename allocator_type,typename T,std::integral char_type>
+inline constexpr void iobuf_direct_overflow_impl(T handle,
+	basic_io_buffer_pointers<char_type>& pointers,char_type ch,std::size_t buffer_size)
+{
+	iobuf_direct_constant_flush_prepare_impl<allocator_type>(handle,pointers,buffer_size);
+	*pointers.buffer_curr=ch;
+	++pointers.buffer_curr;
+}
+
+template<std::size_t buffer_size,typename allocator_type,typename T,std::integral char_type,::std::random_access_iterator Iter>
+#if __has_cpp_attribute(__gnu__::__cold__)
+[[__gnu__::__cold__]]
+#endif
+inline constexpr void iobuf_direct_write_unhappy_impl(T handle,basic_io_buffer_pointers<char_type>& pointers,Iter first,Iter last)
+{
+	if(pointers.buffer_begin==nullptr)
+		iobuf_write_allocate_buffer_impl<allocator_type>(pointers,buffer_size);
+	for(;;)
+	{
+		std::size_t const remain_space{static_cast<std::size_t>(pointers.buffer_end-pointers.buffer_curr)};
+		std::size_t const diff{static_cast<std::size_t>(last-first)};
+		if(diff<remain_space)
+		{
+			pointers.buffer_curr=non_overlapped_copy_n(first,diff,pointers.buffer_curr);
+			return;
+		}
+		non_overlapped_copy_n(first,remain_space,pointers.buffer_curr);
+		first+=remain_space;
+		write(handle,pointers.buffer_begin,pointers.buffer_end);
+		pointers.buffer_curr=pointers.buffer_begin;
+	}
+}
+
+template<typename allocator_type,typename T,std::integral char_type,::std::random_access_iterator Iter>
+#if __has_cpp_attribute(__gnu__::__cold__)
+[[__gnu__::__cold__]]
+#endif
+inline constexpr Iter iobuf_direct_read_unhappy_impl(T handle,basic_io_buffer_pointers<char_type>& ibuffer,Iter first,Iter last,std::size_t buffer_size)
+{
+	for(;first!=last;)
+	{
+		if(!ibuffer_underflow_rl_impl<allocator_type>(handle,ibuffer,buffer_size))
+			break;
+		std::size_t const available{static_cast<std::size_t>(ibuffer.buffer_end-ibuffer.buffer_curr)};
+		std::size_t n{static_cast<std::size_t>(last-first)};
+		if(available<n)
+			n=available;
+		first=non_overlapped_copy_n(ibuffer.buffer_curr,n,first);
+		ibuffer.buffer_curr+=n;
+	}
+	return first;
+}
+
+/*
+Repositions a direct input buffer at an arbitrary offset: the handle goes to the start of the block holding it and
+the buffer is refilled from there.
+*/
+template<typename allocator_type,typename handle_type,std::integral char_type>
+inline constexpr void iobuf_direct_input_align_impl(handle_type& handle,basic_io_buffer_pointers<char_type>& ibuffer,
+	std::uintmax_t position,std::size_t buffer_size)
+{
+	std::size_t const skip{static_cast<std::size_t>(position%io_direct_alignment)};
+	if(skip==0)
+		return;
+	seek(handle,static_cast<std::intmax_t>(position-skip),seekdir::beg);
+	ibuffer_underflow_rl_impl<allocator_type>(io_ref(handle),ibuffer,buffer_size);
+	std::size_t const available{static_cast<std::size_t>(ibuffer.buffer_end-ibuffer.buffer_begin)};
+	std::size_t n{skip/sizeof(char_type)};
+	if(available<n)
+		n=available;
+	ibuffer.buffer_curr=ibuffer.buffer_begin+n;
+}
+
+}
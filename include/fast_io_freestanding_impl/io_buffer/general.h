@@ -8,8 +8,15 @@ inline constexpr void flush(basic_io_buffer<handletype,mde,decorators_type,bfs>&
 {
 	if constexpr((mde&buffer_mode::out)==buffer_mode::out)
 	{
-		if constexpr(details::has_external_decorator_impl<decorators_type>)
-			details::iobuf_output_flush_impl_deco<basic_io_buffer<handletype,mde,decorators_type,bfs>::need_secure_clear>(io_ref(bios.handle),external_decorator(bios.decorators),bios.obuffer,bfs);
+		if constexpr(basic_io_buffer<handletype,mde,decorators_type,bfs>::write_behind)
+		{
+			if(bios.obuffer.context)
+				iobuf_write_behind_flush(bios.handle,bios.obuffer);
+		}
+		else if constexpr(basic_io_buffer<handletype,mde,decorators_type,bfs>::direct)
+			details::iobuf_direct_flush_impl(bios.handle,bios.obuffer);
+		else if constexpr(details::has_external_decorator_impl<decorators_type>)
+			details::iobuf_output_flush_impl_deco(io_ref(bios.handle),external_decorator(bios.decorators),bios.obuffer,bios.obuffer_external,bfs);
 		else
 			details::iobuf_output_flush_impl(io_ref(bios.handle),bios.obuffer);
 	}
@@ -24,7 +31,10 @@ inline constexpr void require_secure_clear(basic_io_buffer<handletype,mde,decora
 template<stream handletype,buffer_mode mde,typename decorators_type,std::size_t bfs>
 inline constexpr std::size_t obuffer_constant_size(fast_io::io_reserve_type_t<typename basic_io_buffer<handletype,mde,decorators_type,bfs>::char_type,basic_io_buffer<handletype,mde,decorators_type,bfs>>) noexcept
 {
-	return bfs;
+	if constexpr(basic_io_buffer<handletype,mde,decorators_type,bfs>::direct)
+		return bfs-details::iobuf_direct_block_size<typename basic_io_buffer<handletype,mde,decorators_type,bfs>::char_type>;
+	else
+		return bfs;
 }
 
 template<stream handletype,buffer_mode mde,typename decorators_type,std::size_t bfs>
@@ -35,10 +45,15 @@ inline constexpr void obuffer_constant_flush_prepare(basic_io_buffer<handletype,
 {
 	if constexpr((mde&buffer_mode::out)==buffer_mode::out)
 	{
-		if constexpr(details::has_external_decorator_impl<decorators_type>)
-			details::iobuf_output_constant_flush_prepare_impl_deco<basic_io_buffer<handletype,mde,decorators_type,bfs>::need_secure_clear>(io_ref(bios.handle),external_decorator(bios.decorators),bios.obuffer,bfs);
+		using io_buffer_type = basic_io_buffer<handletype,mde,decorators_type,bfs>;
+		if constexpr(io_buffer_type::write_behind)
+			iobuf_write_behind_constant_flush_prepare<typename io_buffer_type::allocator_type,io_buffer_type::need_secure_clear,bfs>(bios.handle,bios.obuffer);
+		else if constexpr(io_buffer_type::direct)
+			details::iobuf_direct_constant_flush_prepare_impl<typename io_buffer_type::allocator_type>(io_ref(bios.handle),bios.obuffer,bfs);
+		else if constexpr(details::has_external_decorator_impl<decorators_type>)
+			details::iobuf_output_constant_flush_prepare_impl_deco<typename basic_io_buffer<handletype,mde,decorators_type,bfs>::allocator_type>(io_ref(bios.handle),external_decorator(bios.decorators),bios.obuffer,bios.obuffer_external,bfs);
 		else
-			details::iobuf_output_constant_flush_prepare_impl(io_ref(bios.handle),bios.obuffer,bfs);
+			details::iobuf_output_constant_flush_prepare_impl<typename basic_io_buffer<handletype,mde,decorators_type,bfs>::allocator_type>(io_ref(bios.handle),bios.obuffer,bfs);
 	}
 	if constexpr((mde&buffer_mode::in)==buffer_mode::in)
 		bios.ibuffer.buffer_end=bios.ibuffer.buffer_curr=bios.ibuffer.buffer_begin;
@@ -1,6 +1,7 @@
 ﻿#pragma once
 
 #include"mode.h"
+#include"direct.h"
 #include"main.h"
 #include"output.h"
 #include"input.h"
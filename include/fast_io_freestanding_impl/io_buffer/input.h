@@ -67,14 +67,14 @@ inline constexpr bool ibuffer_underflow(basic_io_buffer<handletype,mde,decorator
 	((mde&buffer_mode::tie)==buffer_mode::tie))
 	{
 		if constexpr(details::has_external_decorator_impl<decoratorstype>)
-			details::iobuf_output_flush_impl_deco<basic_io_buffer<handletype,mde,decoratorstype,bfs>::need_secure_clear>(io_ref(bios.handle),external_decorator(bios.decorators),bios.obuffer,bfs);
+			details::iobuf_output_flush_impl_deco(io_ref(bios.handle),external_decorator(bios.decorators),bios.obuffer,bios.obuffer_external,bfs);
 		else
 			details::iobuf_output_flush_impl(io_ref(bios.handle),bios.obuffer);
 	}
 	if constexpr(details::has_internal_decorator_impl<decoratorstype>)
 		return details::ibuffer_underflow_impl_deco<basic_io_buffer<handletype,mde,decoratorstype,bfs>::need_secure_clear,bfs>(io_ref(bios.handle),internal_decorator(bios.decorators),bios.ibuffer,bios.ibuffer_external);
 	else
-		return details::ibuffer_underflow_impl<bfs>(io_ref(bios.handle),bios.ibuffer);
+		return details::ibuffer_underflow_impl<bfs,typename basic_io_buffer<handletype,mde,decoratorstype,bfs>::allocator_type>(io_ref(bios.handle),bios.ibuffer);
 }
 
 namespace details
@@ -87,7 +87,7 @@ inline constexpr Iter iobuf_read_unhappy_impl(T& bios,Iter first,Iter last)
 	if constexpr(((T::mode&buffer_mode::out)==buffer_mode::out)&&((T::mode&buffer_mode::tie)==buffer_mode::tie))
 	{
 		if constexpr(details::has_external_decorator_impl<typename T::decorators_type>)
-			iobuf_output_flush_impl_deco<T::need_secure_clear>(io_ref(bios.handle),
+			iobuf_output_flush_impl_deco(io_ref(bios.handle),
 				external_decorator(bios.decorators),
 				bios.obuffer,
 				bios.obuffer_external,
@@ -102,8 +102,10 @@ inline constexpr Iter iobuf_read_unhappy_impl(T& bios,Iter first,Iter last)
 			internal_decorator(bios.decorators),
 			bios.ibuffer,bios.ibuffer_external,
 			first,last,T::buffer_size);
+	else if constexpr(T::direct)
+		return iobuf_direct_read_unhappy_impl<typename T::allocator_type>(io_ref(bios.handle),bios.ibuffer,first,last,T::buffer_size);
 	else
-		return iobuf_read_unhappy_decay_impl(io_ref(bios.handle),bios.ibuffer,first,last,T::buffer_size);
+		return iobuf_read_unhappy_decay_impl<typename T::allocator_type>(io_ref(bios.handle),bios.ibuffer,first,last,T::buffer_size);
 }
 
 }
@@ -153,10 +155,18 @@ std::size_t bfs>
 requires ((mde&buffer_mode::in)!=buffer_mode::in||!details::has_internal_decorator_impl<decoratorstype>)
 inline constexpr std::uintmax_t seek(basic_io_buffer<handletype,mde,decoratorstype,bfs>& bios,std::intmax_t pos=0,seekdir sdir=seekdir::cur)
 {
+	using io_buffer_type = basic_io_buffer<handletype,mde,decoratorstype,bfs>;
 	if constexpr((mde&buffer_mode::out)==buffer_mode::out)
 	{
-		if constexpr(details::has_external_decorator_impl<decoratorstype>)
-			details::iobuf_output_flush_impl_deco<basic_io_buffer<handletype,mde,decoratorstype,bfs>::need_secure_clear>(io_ref(bios.handle),external_decorator(bios.decorators),bios.obuffer,bfs);
+		if constexpr(io_buffer_type::direct)
+		{
+			details::iobuf_direct_flush_impl(bios.handle,bios.obuffer);
+			if(sdir==seekdir::cur)
+				pos+=static_cast<std::intmax_t>(static_cast<std::size_t>(bios.obuffer.buffer_curr-bios.obuffer.buffer_begin)*sizeof(typename io_buffer_type::char_type));
+			bios.obuffer.buffer_curr=bios.obuffer.buffer_begin;
+		}
+		else if constexpr(details::has_external_decorator_impl<decoratorstype>)
+			details::iobuf_output_flush_impl_deco(io_ref(bios.handle),external_decorator(bios.decorators),bios.obuffer,bios.obuffer_external,bfs);
 		else
 			details::iobuf_output_flush_impl(io_ref(bios.handle),bios.obuffer);
 	}
@@ -200,6 +210,8 @@ inline constexpr std::uintmax_t seek(basic_io_buffer<handletype,mde,decoratorsty
 	if constexpr((mde&buffer_mode::in)==buffer_mode::in)
 	{
 		bios.ibuffer.buffer_end=bios.ibuffer.buffer_curr=bios.ibuffer.buffer_begin;
+		if constexpr(io_buffer_type::direct)
+			details::iobuf_direct_input_align_impl<typename io_buffer_type::allocator_type>(bios.handle,bios.ibuffer,new_position,bfs);
 	}
 	return new_position;
 }
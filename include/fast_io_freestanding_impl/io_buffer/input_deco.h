@@ -3,6 +3,24 @@
 namespace fast_io::details
 {
 
+template<std::integral char_type,typename decot>
+inline constexpr bool deco_has_pending_output(decot deco)
+{
+	using decot_nocvref_t = std::remove_cvref_t<decot>;
+	if constexpr(::fast_io::pending_decorator<char_type,decot_nocvref_t>)
+		return deco_pending(io_reserve_type<char_type,decot_nocvref_t>,deco);
+	else
+		return false;
+}
+
+template<std::integral char_type,typename decot>
+inline constexpr void deco_check_eof(decot deco)
+{
+	using decot_nocvref_t = std::remove_cvref_t<decot>;
+	if constexpr(::fast_io::eof_decorator<char_type,decot_nocvref_t>)
+		deco_eof(io_reserve_type<char_type,decot_nocvref_t>,deco);
+}
+
 template<bool nsecure,stream T,typename decot,std::integral char_type>
 inline constexpr bool ibuffer_underflow_rl_impl_deco(T t,decot deco,
 	basic_io_buffer_pointers_with_cap<char_type>& ibuffer,
@@ -14,36 +32,49 @@ inline constexpr bool ibuffer_underflow_rl_impl_deco(T t,decot deco,
 		ibuffer_external.buffer_begin=allocate_iobuf_space<external_char_type>(bfsz);
 	auto buffer_begin{ibuffer_external.buffer_begin};
 	auto buffer_end{buffer_begin+bfsz};
-	auto readed=buffer_begin;
-	for(;readed!=buffer_end;)
+	using decot_nocvref_t = std::remove_cvref_t<decot>;
+	/*
+	A stateful decorator (a record-framed cipher, for example) may hold back everything it was given so far;
+	only a read that returns nothing means end of file. One with pending output (a decompressor) is drained with an
+	empty range first, so the input it still refers to is not overwritten.
+	*/
+	for(;;)
 	{
-		auto readed_after_this_round=read(t,readed,buffer_end);
-		if(readed_after_this_round==readed)
+		auto readed=buffer_begin;
+		if(!deco_has_pending_output<char_type>(deco))
+		{
+			for(;readed!=buffer_end;)
+			{
+				auto readed_after_this_round=read(t,readed,buffer_end);
+				if(readed_after_this_round==readed)
+				{
+					if(readed==buffer_begin)
+					{
+						deco_check_eof<char_type>(deco);
+						return false;
+					}
+					break;
+				}
+				readed=readed_after_this_round;
+			}
+		}
+		std::size_t readed_size{static_cast<std::size_t>(readed-buffer_begin)};
+		std::size_t new_size{deco_reserve_size(io_reserve_type<char_type,decot_nocvref_t>,deco,readed_size)};
+		std::size_t cap{static_cast<std::size_t>(ibuffer.buffer_cap-ibuffer.buffer_begin)};
+		if(cap<new_size)
 		{
-			if(readed==buffer_begin)
-				return false;
-			break;
+			if(ibuffer.buffer_begin)
+				deallocate_iobuf_space<nsecure,char_type>(ibuffer.buffer_begin,cap);
+			ibuffer.buffer_cap=ibuffer.buffer_end=ibuffer.buffer_curr=ibuffer.buffer_begin=nullptr;
+			ibuffer.buffer_cap=(ibuffer.buffer_end=ibuffer.buffer_curr=ibuffer.buffer_begin=
+			allocate_iobuf_space<char_type>(new_size))+new_size;
 		}
-		readed=readed_after_this_round;
-	}
-	using decot_nocvref_t = std::remove_cvref_t<decot>;
-	std::size_t readed_size{static_cast<std::size_t>(readed-buffer_begin)};
-	std::size_t new_size{deco_reserve_size(io_reserve_type<char_type,decot_nocvref_t>,deco,readed_size)};
-	std::size_t cap{static_cast<std::size_t>(ibuffer.buffer_cap-ibuffer.buffer_begin)};
-	if(cap<new_size)
-	{
-		deallocate_iobuf_space<nsecure,char_type>(ibuffer.buffer_begin,cap);
-		ibuffer.buffer_cap=ibuffer.buffer_end=ibuffer.buffer_curr=ibuffer.buffer_begin=nullptr;
-		ibuffer.buffer_cap=(ibuffer.buffer_end=ibuffer.buffer_curr=ibuffer.buffer_begin=
-		allocate_iobuf_space<char_type>(new_size))+new_size;
+		else
+			ibuffer.buffer_end=ibuffer.buffer_curr=ibuffer.buffer_begin;
+		ibuffer.buffer_end=deco_reserve_define(io_reserve_type<char_type,decot_nocvref_t>,deco,buffer_begin,readed,ibuffer.buffer_begin);
+		if(ibuffer.buffer_begin!=ibuffer.buffer_end)
+			return true;
 	}
-	else
-		ibuffer.buffer_end=ibuffer.buffer_curr=ibuffer.buffer_begin;
-	using decot_nocvref_t = std::remove_cvref_t<decot>;
-	ibuffer.buffer_end=deco_reserve_define(io_reserve_type<char_type,decot_nocvref_t>,deco,buffer_begin,readed,ibuffer.buffer_begin);
-	if(ibuffer.buffer_begin==ibuffer.buffer_end)
-		return false;
-	return true;
 }
 
 template<bool nsecure,std::size_t bfsz,stream T,typename decot,std::integral char_type>
@@ -80,16 +111,22 @@ inline constexpr Iter iobuf_read_unhappy_decay_impl_deco(T t,decot deco,
 	for(;first!=last;)
 	{
 		auto read_this_round{buffer_begin};
-		for(;read_this_round!=buffer_end;)
+		if(!deco_has_pending_output<internal_char_type>(deco))
 		{
-			auto readed_after_this_round=read(t,read_this_round,buffer_end);
-			if(readed_after_this_round==read_this_round)
+			for(;read_this_round!=buffer_end;)
 			{
-				if(read_this_round==buffer_begin)
-					return first;
-				break;
+				auto readed_after_this_round=read(t,read_this_round,buffer_end);
+				if(readed_after_this_round==read_this_round)
+				{
+					if(read_this_round==buffer_begin)
+					{
+						deco_check_eof<internal_char_type>(deco);
+						return first;
+					}
+					break;
+				}
+				read_this_round=readed_after_this_round;
 			}
-			read_this_round=readed_after_this_round;
 		}
 		std::size_t readed_size{static_cast<std::size_t>(read_this_round-buffer_begin)};
 		using decot_nocvref_t = std::remove_cvref_t<decot>;
@@ -104,7 +141,8 @@ inline constexpr Iter iobuf_read_unhappy_decay_impl_deco(T t,decot deco,
 			std::size_t cap{static_cast<std::size_t>(ibuffer.buffer_cap-ibuffer.buffer_begin)};
 			if(cap<new_size)
 			{
-				deallocate_iobuf_space<nsecure,char_type>(ibuffer.buffer_begin,cap);
+				if(ibuffer.buffer_begin)
+					deallocate_iobuf_space<nsecure,char_type>(ibuffer.buffer_begin,cap);
 				ibuffer.buffer_cap=ibuffer.buffer_end=ibuffer.buffer_curr=ibuffer.buffer_begin=nullptr;
 				ibuffer.buffer_cap=(ibuffer.buffer_end=ibuffer.buffer_curr=ibuffer.buffer_begin=
 				allocate_iobuf_space<char_type>(new_size))+new_size;
@@ -115,7 +153,7 @@ inline constexpr Iter iobuf_read_unhappy_decay_impl_deco(T t,decot deco,
 				buffer_begin,read_this_round,ibuffer.buffer_begin);
 			std::size_t need_to_copy{static_cast<std::size_t>(ibuffer.buffer_end-ibuffer.buffer_begin)};
 			if(need_to_copy==0)
-				return first;
+				continue;
 			if(diff<need_to_copy)
 				need_to_copy=diff;
 			non_overlapped_copy_n(ibuffer.buffer_begin,need_to_copy,first);
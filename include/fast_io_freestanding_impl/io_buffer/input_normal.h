@@ -3,26 +3,26 @@
 namespace fast_io::details
 {
 
-template<stream T,std::integral char_type>
+template<typename allocator_type,stream T,std::integral char_type>
 inline constexpr bool ibuffer_underflow_rl_impl(T t,basic_io_buffer_pointers<char_type>& ibuffer,std::size_t bfsz)
 {
 	if(ibuffer.buffer_begin==nullptr)
-		ibuffer.buffer_end=ibuffer.buffer_curr=ibuffer.buffer_begin=allocate_iobuf_space<char_type>(bfsz);
+		ibuffer.buffer_end=ibuffer.buffer_curr=ibuffer.buffer_begin=allocate_iobuf_space<char_type,allocator_type>(bfsz);
 	ibuffer.buffer_end=read(t,ibuffer.buffer_begin,ibuffer.buffer_begin+bfsz);
 	ibuffer.buffer_curr=ibuffer.buffer_begin;
 	return ibuffer.buffer_begin!=ibuffer.buffer_end;
 }
 
-template<std::size_t bfsz,stream T,std::integral char_type>
+template<std::size_t bfsz,typename allocator_type,stream T,std::integral char_type>
 #if __has_cpp_attribute(__gnu__::__cold__)
 [[__gnu__::__cold__]]
 #endif
 inline constexpr bool ibuffer_underflow_impl(T t,basic_io_buffer_pointers<char_type>& ibuffer)
 {
-	return ibuffer_underflow_rl_impl(t,ibuffer,bfsz);
+	return ibuffer_underflow_rl_impl<allocator_type>(t,ibuffer,bfsz);
 }
 
-template<typename T,std::integral char_type,::std::random_access_iterator Iter>
+template<typename allocator_type,typename T,std::integral char_type,::std::random_access_iterator Iter>
 #if __has_cpp_attribute(__gnu__::__cold__)
 [[__gnu__::__cold__]]
 #endif
@@ -34,7 +34,7 @@ inline constexpr Iter iobuf_read_unhappy_decay_impl(T t,basic_io_buffer_pointers
 	if(ibuffer.buffer_begin==nullptr)
 	{
 		ibuffer.buffer_end=ibuffer.buffer_begin=
-		allocate_iobuf_space<char_type>(buffer_size);
+		allocate_iobuf_space<char_type,allocator_type>(buffer_size);
 	}
 	ibuffer.buffer_end=read(t,ibuffer.buffer_begin,ibuffer.buffer_begin+buffer_size);
 	ibuffer.buffer_curr=ibuffer.buffer_begin;
@@ -103,6 +103,37 @@ inline constexpr void write_with_deco(T t,decot deco,Iter first,Iter last,
 	}
 }
 
+/*
+Writes the trailer of a finish_decorator when the stream closes, growing the external buffer if it is too small.
+*/
+template<bool need_secure_clear,typename T,typename decot>
+inline constexpr void write_deco_finish(T t,decot deco,
+	basic_io_buffer_pointers_no_curr<typename T::char_type>& external_buffer,
+	std::size_t buffer_size)
+{
+	using external_char_type = typename T::char_type;
+	using decot_no_cvref_t = std::remove_cvref_t<decot>;
+	if constexpr(::fast_io::finish_decorator<external_char_type,decot_no_cvref_t>)
+	{
+		std::size_t const size{deco_finish_size(io_reserve_type<external_char_type,decot_no_cvref_t>,deco)};
+		if(size==0)
+			return;
+		std::size_t const current_size{static_cast<std::size_t>(external_buffer.buffer_end-external_buffer.buffer_begin)};
+		if(current_size<size)
+		{
+			std::size_t new_size{deco_reserve_size(io_reserve_type<external_char_type,decot_no_cvref_t>,deco,buffer_size)};
+			if(new_size<size)
+				new_size=size;
+			auto new_ptr{allocate_iobuf_space<external_char_type>(new_size)};
+			if(external_buffer.buffer_begin)
+				deallocate_iobuf_space<need_secure_clear,external_char_type>(external_buffer.buffer_begin,current_size);
+			external_buffer.buffer_begin=new_ptr;
+			external_buffer.buffer_end=new_ptr+new_size;
+		}
+		write(t,external_buffer.buffer_begin,deco_finish_define(io_reserve_type<external_char_type,decot_no_cvref_t>,deco,external_buffer.buffer_begin));
+	}
+}
+
 template<typename decorators_type>
 concept has_internal_decorator_impl = requires(decorators_type&& decos)
 {
@@ -141,11 +172,19 @@ public:
 	using const_pointer = char_type const*;
 	inline static constexpr buffer_mode mode = mde;
 	inline static constexpr std::size_t buffer_size = bfs;
+	using allocator_type = typename details::iobuf_allocator<(mode&buffer_mode::pooled)==buffer_mode::pooled,
+		(mode&buffer_mode::direct)==buffer_mode::direct,buffer_size*sizeof(char_type)>::type;
 	inline static constexpr bool need_secure_clear = (mode&buffer_mode::secure_clear)==buffer_mode::secure_clear;
 	inline static constexpr bool has_ibuffer=(mode&buffer_mode::in)==buffer_mode::in;
 	inline static constexpr bool has_obuffer=(mode&buffer_mode::out)==buffer_mode::out;
 	inline static constexpr bool has_internal_decorator = details::has_internal_decorator_impl<decorators_type>;
 	inline static constexpr bool has_external_decorator = details::has_external_decorator_impl<decorators_type>;
+	inline static constexpr bool write_behind = (mode&buffer_mode::write_behind)==buffer_mode::write_behind;
+	static_assert(!write_behind||!has_external_decorator,"buffer_mode::write_behind does not support output decorators");
+	inline static constexpr bool direct = (mode&buffer_mode::direct)==buffer_mode::direct;
+	static_assert(!direct||(!has_internal_decorator&&!has_external_decorator),"buffer_mode::direct does not support decorators");
+	static_assert(!direct||(buffer_size!=0&&(buffer_size*sizeof(char_type))%io_direct_alignment==0),
+		"buffer_mode::direct needs a buffer of whole io_direct_alignment blocks");
 
 	using ibuffer_type = std::conditional_t<has_ibuffer,
 	std::conditional_t<has_internal_decorator,
@@ -154,7 +193,8 @@ public:
 
 	using obuffer_type =std::conditional_t<has_obuffer&&
 		(mode&buffer_mode::deco_out_no_internal)!=buffer_mode::deco_out_no_internal,
-		basic_io_buffer_pointers<char_type>,empty_buffer_pointers>;
+		std::conditional_t<write_behind,details::iobuf_write_behind_pointers<char_type>,basic_io_buffer_pointers<char_type>>,
+		empty_buffer_pointers>;
 
 	using ibuffer_external_type = std::conditional_t<has_ibuffer&&details::has_internal_decorator_impl<decorators_type>,
 	basic_io_buffer_pointers_only_begin<external_char_type>,
@@ -219,7 +259,16 @@ public:
 private:
 	constexpr void close_throw_impl()
 	{
-		if constexpr((mode&buffer_mode::out)==buffer_mode::out&&
+		if constexpr(write_behind)
+		{
+			if(obuffer.context)
+				iobuf_write_behind_flush(handle,obuffer);
+		}
+		else if constexpr(direct&&(mode&buffer_mode::out)==buffer_mode::out)
+		{
+			details::iobuf_direct_flush_impl(handle,obuffer);
+		}
+		else if constexpr((mode&buffer_mode::out)==buffer_mode::out&&
 			(mode&buffer_mode::deco_out_no_internal)!=buffer_mode::deco_out_no_internal)
 		{
 		if(obuffer.buffer_begin!=obuffer.buffer_curr)
@@ -236,6 +285,12 @@ private:
 				write(io_ref(handle),obuffer.buffer_begin,obuffer.buffer_curr);
 			}
 		}
+		if constexpr(details::has_external_decorator_impl<decorators_type>)
+		{
+			details::write_deco_finish<need_secure_clear>(io_ref(handle),
+			external_decorator(decorators),
+			obuffer_external,bfs);
+		}
 		}
 	}
 	constexpr void close_impl() noexcept
@@ -263,10 +318,15 @@ private:
 	{
 		if constexpr((mode&buffer_mode::out)==buffer_mode::out)
 		{
-			if constexpr((mode&buffer_mode::deco_out_no_internal)!=buffer_mode::deco_out_no_internal)
+			if constexpr(write_behind)
+			{
+			if(obuffer.context)
+				iobuf_write_behind_destroy(obuffer);
+			}
+			else if constexpr((mode&buffer_mode::deco_out_no_internal)!=buffer_mode::deco_out_no_internal)
 			{
 			if(obuffer.buffer_begin)
-				details::deallocate_iobuf_space<need_secure_clear,char_type>(obuffer.buffer_begin,buffer_size);
+				details::deallocate_iobuf_space<need_secure_clear,char_type,allocator_type>(obuffer.buffer_begin,buffer_size);
 			}
 			if constexpr(details::has_external_decorator_impl<decorators_type>)
 			{
@@ -287,7 +347,7 @@ private:
 				}
 				else
 				{
-					details::deallocate_iobuf_space<need_secure_clear,char_type>(ibuffer.buffer_begin,buffer_size);
+					details::deallocate_iobuf_space<need_secure_clear,char_type,allocator_type>(ibuffer.buffer_begin,buffer_size);
 				}
 			}
 			if constexpr(details::has_internal_decorator_impl<decorators_type>)
@@ -299,6 +359,17 @@ private:
 			}
 		}
 	}
+	/*
+	The flusher thread writes through the address of handle, so it must be idle before handle moves.
+	*/
+	constexpr void write_behind_wait() noexcept
+	{
+		if constexpr(write_behind)
+		{
+			if(obuffer.context)
+				iobuf_write_behind_wait(obuffer);
+		}
+	}
 public:
 
 	constexpr basic_io_buffer()=default;
@@ -357,7 +428,7 @@ public:
 	constexpr basic_io_buffer(basic_io_buffer&& other) noexcept requires(std::movable<handle_type>):
 		ibuffer(other.ibuffer),obuffer(other.obuffer),
 		ibuffer_external(other.ibuffer_external),obuffer_external(other.obuffer_external),
-		handle(::std::move(other.handle)),decorators(::std::move(other.decorators))
+		handle((other.write_behind_wait(),::std::move(other.handle))),decorators(::std::move(other.decorators))
 	{
 		other.ibuffer={};
 		other.obuffer={};
@@ -373,6 +444,7 @@ public:
 		if constexpr((mode&buffer_mode::out)==buffer_mode::out)
 			close_impl();
 		cleanup_impl();
+		other.write_behind_wait();
 		ibuffer=other.ibuffer;
 		other.ibuffer={};
 		obuffer=other.obuffer;
@@ -388,6 +460,8 @@ public:
 	constexpr basic_io_buffer& operator=(basic_io_buffer&& __restrict)=delete;
 	constexpr void swap(basic_io_buffer&& other) noexcept requires std::swappable<handle_type>
 	{
+		write_behind_wait();
+		other.write_behind_wait();
 		std::ranges::swap(ibuffer,other.ibuffer);
 		std::ranges::swap(obuffer,other.obuffer);
 		std::ranges::swap(ibuffer_external,other.ibuffer_external);
@@ -11,7 +11,10 @@ tie=1<<2,
 io=in|out|tie,
 secure_clear=1<<3,
 construct_decorator=1<<4,
-deco_out_no_internal=(1<<5)|(out)
+deco_out_no_internal=(1<<5)|(out),
+pooled=1<<6,
+write_behind=1<<7,
+direct=1<<8
 };
 
 inline constexpr buffer_mode operator&(buffer_mode x, buffer_mode y) noexcept
@@ -59,6 +62,26 @@ struct basic_io_buffer_pointers
 	pointer buffer_begin{},buffer_curr{},buffer_end{};
 };
 
+namespace details
+{
+
+/*
+Output pointers of a buffer_mode::write_behind buffer. The buffers themselves and the flusher thread belong to the
+context, which fast_io_hosted/iobuf_write_behind.h defines; these pointers only track the buffer being filled.
+*/
+struct iobuf_write_behind_context;
+
+template<typename T>
+struct iobuf_write_behind_pointers
+{
+	using value_type = T;
+	using pointer = T*;
+	pointer buffer_begin{},buffer_curr{},buffer_end{};
+	iobuf_write_behind_context* context{};
+};
+
+}
+
 template<typename T>
 struct basic_io_buffer_pointers_with_cap
 {
@@ -85,6 +108,16 @@ struct basic_io_buffer_pointers_no_curr
 
 namespace details
 {
+/*
+buffer_mode::direct settles a partial last block by writing it padded and cutting the file back to size.
+*/
+template<typename handle_type>
+concept iobuf_direct_output_handle_impl = requires(handle_type& h)
+{
+	truncate(h,static_cast<std::uintmax_t>(0));
+	seek(h,0,seekdir::cur);
+};
+
 template<stream handle_type>
 inline 
 #if __cpp_consteval >= 201811L
@@ -98,6 +131,21 @@ bool constraint_buffer_mode(buffer_mode mode) noexcept
 		return false;
 	if(((mode&buffer_mode::out)==buffer_mode::out)&&(!output_stream<handle_type>))
 		return false;
+	if((mode&buffer_mode::write_behind)==buffer_mode::write_behind&&
+		(((mode&buffer_mode::in)==buffer_mode::in)||((mode&buffer_mode::out)!=buffer_mode::out)||
+		((mode&buffer_mode::deco_out_no_internal)==buffer_mode::deco_out_no_internal)))
+		return false;
+	if((mode&buffer_mode::direct)==buffer_mode::direct)
+	{
+		bool const in{(mode&buffer_mode::in)==buffer_mode::in};
+		bool const out{(mode&buffer_mode::out)==buffer_mode::out};
+		if(in==out||(mode&buffer_mode::tie)==buffer_mode::tie||
+			(mode&buffer_mode::write_behind)==buffer_mode::write_behind||
+			(mode&buffer_mode::deco_out_no_internal)==buffer_mode::deco_out_no_internal)
+			return false;
+		if(out&&!iobuf_direct_output_handle_impl<handle_type>)
+			return false;
+	}
 	if constexpr(secure_clear_requirement_stream<handle_type>)
 		if((mode&buffer_mode::secure_clear)!=buffer_mode::secure_clear)
 			return false;
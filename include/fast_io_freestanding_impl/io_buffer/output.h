@@ -14,14 +14,18 @@ template<typename T,::std::random_access_iterator Iter>
 #endif
 inline constexpr void iobuf_write_unhappy_impl(T& t,Iter first,Iter last)
 {
-	if constexpr(has_external_decorator_impl<typename T::decorators_type>)
-		iobuf_write_unhappy_decay_impl_deco<T::buffer_size>(io_ref(t.handle),
+	if constexpr(T::write_behind)
+		iobuf_write_behind_write<typename T::allocator_type,T::need_secure_clear,T::buffer_size>(t.handle,t.obuffer,first,last);
+	else if constexpr(T::direct)
+		iobuf_direct_write_unhappy_impl<T::buffer_size,typename T::allocator_type>(io_ref(t.handle),t.obuffer,first,last);
+	else if constexpr(has_external_decorator_impl<typename T::decorators_type>)
+		iobuf_write_unhappy_decay_impl_deco<T::buffer_size,typename T::allocator_type>(io_ref(t.handle),
 		external_decorator(t.decorators),
 		t.obuffer,
 		t.obuffer_external,
 		first,last);
 	else
-		iobuf_write_unhappy_decay_impl<T::buffer_size>(io_ref(t.handle),t.obuffer,first,last);
+		iobuf_write_unhappy_decay_impl<T::buffer_size,typename T::allocator_type>(io_ref(t.handle),t.obuffer,first,last);
 }
 
 }
@@ -123,10 +127,15 @@ requires ((mde&buffer_mode::out)==buffer_mode::out&&
 inline constexpr void obuffer_overflow(basic_io_buffer<handletype,mde,decorators,bfs>& bios,
 	typename basic_io_buffer<handletype,mde,decorators,bfs>::char_type ch)
 {
-	if constexpr(details::has_external_decorator_impl<decorators>)
-		details::iobuf_overflow_impl_deco(io_ref(bios.handle),external_decorator(bios.decorators),bios.obuffer,bios.obuffer_external,ch,bfs);
+	using io_buffer_type = basic_io_buffer<handletype,mde,decorators,bfs>;
+	if constexpr(io_buffer_type::write_behind)
+		iobuf_write_behind_overflow<typename io_buffer_type::allocator_type,io_buffer_type::need_secure_clear,bfs>(bios.handle,bios.obuffer,ch);
+	else if constexpr(io_buffer_type::direct)
+		details::iobuf_direct_overflow_impl<typename io_buffer_type::allocator_type>(io_ref(bios.handle),bios.obuffer,ch,bfs);
+	else if constexpr(details::has_external_decorator_impl<decorators>)
+		details::iobuf_overflow_impl_deco<typename basic_io_buffer<handletype,mde,decorators,bfs>::allocator_type>(io_ref(bios.handle),external_decorator(bios.decorators),bios.obuffer,bios.obuffer_external,ch,bfs);
 	else
-		details::iobuf_overflow_impl(io_ref(bios.handle),bios.obuffer,ch,bfs);
+		details::iobuf_overflow_impl<typename basic_io_buffer<handletype,mde,decorators,bfs>::allocator_type>(io_ref(bios.handle),bios.obuffer,ch,bfs);
 }
 
 template<zero_copy_output_stream handletype,
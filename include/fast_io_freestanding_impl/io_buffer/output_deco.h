@@ -22,7 +22,7 @@ inline constexpr void iobuf_write_unhappy_decay_no_alloc_impl_deco(T t,decot dec
 		pointers.buffer_curr=non_overlapped_copy_n(first,new_remain_space,pointers.buffer_begin);
 
 }
-template<std::size_t buffer_size,typename T,typename decot,std::integral char_type,::std::random_access_iterator Iter>
+template<std::size_t buffer_size,typename allocator_type,typename T,typename decot,std::integral char_type,::std::random_access_iterator Iter>
 inline constexpr void iobuf_write_unhappy_decay_impl_deco(
 	T t,decot deco,
 	basic_io_buffer_pointers<char_type>& pointers,
@@ -33,7 +33,7 @@ inline constexpr void iobuf_write_unhappy_decay_impl_deco(
 	if(pointers.buffer_begin==nullptr)
 	{
 		if(diff<buffer_size)
-			iobuf_write_unhappy_nullptr_case_impl(pointers,first,last,buffer_size);
+			iobuf_write_unhappy_nullptr_case_impl<allocator_type>(pointers,first,last,buffer_size);
 		else
 			write_with_deco(t,deco,first,last,external_buffer,buffer_size);
 		return;
@@ -58,7 +58,7 @@ inline constexpr void iobuf_output_flush_impl_deco(T handle,decot deco,
 	pointers.buffer_curr=pointers.buffer_begin;
 }
 
-template<typename T,typename decot,std::integral char_type>
+template<typename allocator_type,typename T,typename decot,std::integral char_type>
 inline constexpr void iobuf_output_constant_flush_prepare_impl_deco(T handle,decot deco,
 	basic_io_buffer_pointers<char_type>& pointers,
 	basic_io_buffer_pointers_no_curr<typename T::char_type>& external_buffer,
@@ -66,7 +66,7 @@ inline constexpr void iobuf_output_constant_flush_prepare_impl_deco(T handle,dec
 {
 	if(pointers.buffer_begin==nullptr)
 	{
-		iobuf_write_allocate_buffer_impl(pointers,bfsz);
+		iobuf_write_allocate_buffer_impl<allocator_type>(pointers,bfsz);
 	}
 	else
 	{
@@ -74,13 +74,13 @@ inline constexpr void iobuf_output_constant_flush_prepare_impl_deco(T handle,dec
 	}
 }
 
-template<typename T,typename decot,std::integral char_type>
+template<typename allocator_type,typename T,typename decot,std::integral char_type>
 inline constexpr void iobuf_overflow_impl_deco(T handle,decot deco,
 	basic_io_buffer_pointers<char_type>& pointers,
 	basic_io_buffer_pointers_no_curr<typename T::char_type>& external_buffer,
 	char_type ch,std::size_t bfsz)
 {
-	iobuf_output_constant_flush_prepare_impl_deco(handle,deco,pointers,external_buffer,bfsz);
+	iobuf_output_constant_flush_prepare_impl_deco<allocator_type>(handle,deco,pointers,external_buffer,bfsz);
 	*pointers.buffer_curr=ch;
 	++pointers.buffer_curr;
 }
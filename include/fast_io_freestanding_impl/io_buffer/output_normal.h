@@ -10,23 +10,23 @@ concept allow_iobuf_punning = ::std::contiguous_iterator<Iter>&&
 (std::same_as<char_type,::std::iter_value_t<Iter>>||
 (std::same_as<char_type,char>&&::std::contiguous_iterator<Iter>));
 
-template<std::integral char_type>
+template<typename allocator_type,std::integral char_type>
 #if __has_cpp_attribute(__gnu__::__cold__)
 [[__gnu__::__cold__]]
 #endif
 inline constexpr void iobuf_write_allocate_buffer_impl(basic_io_buffer_pointers<char_type>& obuffer,std::size_t buffer_size)
 {
 	obuffer.buffer_end=(obuffer.buffer_curr=obuffer.buffer_begin=
-	allocate_iobuf_space<char_type>(buffer_size))+buffer_size;
+	allocate_iobuf_space<char_type,allocator_type>(buffer_size))+buffer_size;
 }
 
-template<std::integral char_type,::std::random_access_iterator Iter>
+template<typename allocator_type,std::integral char_type,::std::random_access_iterator Iter>
 #if __has_cpp_attribute(__gnu__::__cold__)
 [[__gnu__::__cold__]]
 #endif
 inline constexpr void iobuf_write_unhappy_nullptr_case_impl(basic_io_buffer_pointers<char_type>& obuffer,Iter first,Iter last,std::size_t buffer_size)
 {
-	iobuf_write_allocate_buffer_impl(obuffer,buffer_size);
+	iobuf_write_allocate_buffer_impl<allocator_type>(obuffer,buffer_size);
 	obuffer.buffer_curr=non_overlapped_copy(first,last,obuffer.buffer_curr);
 }
 
@@ -70,14 +70,14 @@ inline constexpr void iobuf_write_unhappy_decay_no_alloc_impl(T t,basic_io_buffe
 	}
 }
 
-template<std::size_t buffer_size,typename T,std::integral char_type,::std::random_access_iterator Iter>
+template<std::size_t buffer_size,typename allocator_type,typename T,std::integral char_type,::std::random_access_iterator Iter>
 inline constexpr void iobuf_write_unhappy_decay_impl(T t,basic_io_buffer_pointers<char_type>& pointers,Iter first,Iter last)
 {
 	std::size_t const diff{static_cast<std::size_t>(last-first)};
 	if(pointers.buffer_begin==nullptr)
 	{
 		if(diff<buffer_size)
-			iobuf_write_unhappy_nullptr_case_impl(pointers,first,last,buffer_size);
+			iobuf_write_unhappy_nullptr_case_impl<allocator_type>(pointers,first,last,buffer_size);
 		else
 			write(t,first,last);
 		return;
@@ -98,13 +98,13 @@ inline constexpr void iobuf_output_flush_impl(T handle,
 	pointers.buffer_curr=pointers.buffer_begin;
 }
 
-template<typename T,std::integral char_type>
+template<typename allocator_type,typename T,std::integral char_type>
 inline constexpr void iobuf_output_constant_flush_prepare_impl(T handle,
 	basic_io_buffer_pointers<char_type>& pointers,std::size_t buffer_size)
 {
 	if(pointers.buffer_begin==nullptr)
 	{
-		iobuf_write_allocate_buffer_impl(pointers,buffer_size);
+		iobuf_write_allocate_buffer_impl<allocator_type>(pointers,buffer_size);
 	}
 	else
 	{
@@ -112,11 +112,11 @@ inline constexpr void iobuf_output_constant_flush_prepare_impl(T handle,
 	}
 }
 
-template<typename T,std::integral char_type>
+template<typename allocator_type,typename T,std::integral char_type>
 inline constexpr void iobuf_overflow_impl(T handle,
 	basic_io_buffer_pointers<char_type>& pointers,char_type ch,std::size_t bfsz)
 {
-	iobuf_output_constant_flush_prepare_impl(handle,pointers,bfsz);
+	iobuf_output_constant_flush_prepare_impl<allocator_type>(handle,pointers,bfsz);
 	*pointers.buffer_curr=ch;
 	++pointers.buffer_curr;
 }
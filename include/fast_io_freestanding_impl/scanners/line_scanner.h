@@ -185,6 +185,8 @@ inline constexpr parse_result<char_type const*> scan_iterative_contiguous_line_d
 		{
 			return {it,parse_code::end_of_file};
 		}
+		buf.view_begin_ptr=first;
+		buf.view_end_ptr=it;
 		return {it,parse_code::ok};
 	}
 	buf.view_begin_ptr=first;
@@ -78,6 +78,8 @@ For hosted implementations the set of standard library headers required by the C
 
 #include"fast_io_hosted/threads/mutex/impl.h"
 #include"fast_io_hosted/iomutex.h"
+#include"fast_io_hosted/mpsc_log_sink.h"
+#include"fast_io_hosted/iobuf_write_behind.h"
 
 #include "fast_io_dsal/impl/common.h"
 #include "fast_io_dsal/impl/vector.h"
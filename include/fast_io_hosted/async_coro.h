@@ -1,29 +1,67 @@
 ﻿#pragma once
 
+#include<coroutine>
+#include<span>
+
 namespace fast_io
 {
+
+template<typename stm>
+concept async_stream = requires()
+{
+	typename io_async_scheduler_t<stm>::type;
+	typename io_async_overlapped_t<stm>::type;
+};
+
+template<typename stm,typename scheduler_type=typename io_async_scheduler_t<stm>::type>
+concept async_input_stream = async_stream<stm>&&requires(scheduler_type& scheduler,stm& sm,
+	typename stm::char_type* ptr,typename io_async_overlapped_t<stm>::type& overlapped,std::ptrdiff_t offset)
+{
+	async_read_callback(scheduler,sm,ptr,ptr,overlapped,offset);
+};
+
+template<typename stm,typename scheduler_type=typename io_async_scheduler_t<stm>::type>
+concept async_output_stream = async_stream<stm>&&requires(scheduler_type& scheduler,stm& sm,
+	typename stm::char_type const* ptr,typename io_async_overlapped_t<stm>::type& overlapped,std::ptrdiff_t offset)
+{
+	async_write_callback(scheduler,sm,ptr,ptr,overlapped,offset);
+};
+
+template<typename stm,typename scheduler_type=typename io_async_scheduler_t<stm>::type>
+concept async_scatter_input_stream = async_stream<stm>&&requires(scheduler_type& scheduler,stm& sm,
+	io_scatters_t scatters,typename io_async_overlapped_t<stm>::type& overlapped,std::ptrdiff_t offset)
+{
+	async_scatter_read_callback(scheduler,sm,scatters,overlapped,offset);
+};
+
+template<typename stm,typename scheduler_type=typename io_async_scheduler_t<stm>::type>
+concept async_scatter_output_stream = async_stream<stm>&&requires(scheduler_type& scheduler,stm& sm,
+	io_scatters_t scatters,typename io_async_overlapped_t<stm>::type& overlapped,std::ptrdiff_t offset)
+{
+	async_scatter_write_callback(scheduler,sm,scatters,overlapped,offset);
+};
 //This is DAMN bullshit
 struct task
 {
 struct promise_type
 {
-constexpr auto get_return_object() { return task{}; }
-constexpr auto initial_suspend() { return std::suspend_never{}; }
-constexpr auto final_suspend() { return std::suspend_never{}; }
-void unhandled_exception() { std::terminate(); }
-constexpr void return_void() {}
+constexpr auto get_return_object() noexcept { return task{}; }
+constexpr auto initial_suspend() noexcept { return std::suspend_never{}; }
+constexpr auto final_suspend() noexcept { return std::suspend_never{}; }
+void unhandled_exception() noexcept { ::fast_io::fast_terminate(); }
+constexpr void return_void() noexcept {}
 };
 };
 
 namespace details
 {
 
-template<typename stm,::std::input_iterator Iter,bool write>
-requires ((write&&async_output_stream<stm>)||(!write&&async_input_stream<stm>))
+template<typename scheduler_type,typename stm,::std::input_iterator Iter,bool write>
+requires ((write&&async_output_stream<stm,scheduler_type>)||(!write&&async_input_stream<stm,scheduler_type>))
 class async_io_coroutine
 {
 public:
-	typename io_async_scheduler_t<stm>::type& scheduler;
+	scheduler_type& scheduler;
 	stm& stream;
 	Iter first,last;
 	std::ptrdiff_t offset{write?-1:0};
@@ -46,9 +84,9 @@ public:
 			handle.resume();
 		});
 		if constexpr(write)
-			async_read_callback(scheduler,stream,first,last,overlapped,offset);
-		else
 			async_write_callback(scheduler,stream,first,last,overlapped,offset);
+		else
+			async_read_callback(scheduler,stream,first,last,overlapped,offset);
 	}
 };
 
@@ -56,12 +94,12 @@ public:
 
 
 
-template<typename stm,bool write>
-requires ((write&&async_scatter_output_stream<stm>)||(!write&&async_scatter_input_stream<stm>))
+template<typename scheduler_type,typename stm,bool write>
+requires ((write&&async_scatter_output_stream<stm,scheduler_type>)||(!write&&async_scatter_input_stream<stm,scheduler_type>))
 class async_scatter_io_coroutine
 {
 public:
-	typename io_async_scheduler_t<stm>::type& scheduler;
+	scheduler_type& scheduler;
 	stm& stream;
 	std::span<io_scatter_t> scatters;
 	std::ptrdiff_t offset{write?-1:0};
@@ -84,18 +122,19 @@ public:
 			handle.resume();
 		});
 		if constexpr(write)
-			async_scatter_read_callback(scheduler,stream,scatters,overlapped,offset);
+			async_scatter_write_callback(scheduler,stream,io_scatters_t{scatters.data(),scatters.size()},overlapped,offset);
 		else
-			async_scatter_write_callback(scheduler,stream,scatters,overlapped,offset);
+			async_scatter_read_callback(scheduler,stream,io_scatters_t{scatters.data(),scatters.size()},overlapped,offset);
 	}
 };
 
 
-template<async_output_stream stm,bool line>
+template<typename scheduler_type,typename stm,bool line>
+requires async_output_stream<stm,scheduler_type>
 class async_print_coroutine
 {
 public:
-	typename io_async_scheduler_t<stm>::type& scheduler;
+	scheduler_type& scheduler;
 	stm& stream;
 	std::ptrdiff_t offset{};
 	typename io_async_overlapped_t<stm>::type overlapped;
@@ -103,7 +142,7 @@ public:
 	int err{};
 	dynamic_io_buffer<typename stm::char_type> buffer;
 	template<typename ...Args>
-	async_print_coroutine(typename io_async_scheduler_t<stm>::type& sh,std::ptrdiff_t off,stm& s,Args&& ...args):scheduler(sh),stream(s)
+	async_print_coroutine(scheduler_type& sh,std::ptrdiff_t off,stm& s,Args&& ...args):scheduler(sh),stream(s),offset(off)
 	{
 		if constexpr(line)
 			println_freestanding(buffer,std::forward<Args>(args)...);
@@ -125,56 +164,64 @@ public:
 			this->err=errn;
 			handle.resume();
 		});
-		async_write_callback(scheduler,stream,buffer.beg_ptr,buffer.end_ptr,overlapped,offset);
+		async_write_callback(scheduler,stream,buffer.buffer_begin,buffer.buffer_curr,overlapped,offset);
 	}
 };
 }
 
-template<async_input_stream stm,::std::input_iterator Iter>
-constexpr inline details::async_io_coroutine<stm,Iter,false> async_read(typename io_async_scheduler_t<stm>::type& scheduler,stm& sm,Iter begin,Iter end,std::ptrdiff_t offset=0)
+template<typename scheduler_type,typename stm,::std::input_iterator Iter>
+requires async_input_stream<stm,scheduler_type>
+constexpr inline details::async_io_coroutine<scheduler_type,stm,Iter,false> async_read(scheduler_type& scheduler,stm& sm,Iter begin,Iter end,std::ptrdiff_t offset=0)
 {
-	return {scheduler,sm,begin,end,offset};
+	return {scheduler,sm,begin,end,offset,0,0,{}};
 }
 
-template<async_output_stream stm,::std::input_iterator Iter>
-constexpr inline details::async_io_coroutine<stm,Iter,true> async_write(typename io_async_scheduler_t<stm>::type& scheduler,stm& sm,Iter begin,Iter end,std::ptrdiff_t offset=-1)
+template<typename scheduler_type,typename stm,::std::input_iterator Iter>
+requires async_output_stream<stm,scheduler_type>
+constexpr inline details::async_io_coroutine<scheduler_type,stm,Iter,true> async_write(scheduler_type& scheduler,stm& sm,Iter begin,Iter end,std::ptrdiff_t offset=-1)
 {
-	return {scheduler,sm,begin,end,offset};
+	return {scheduler,sm,begin,end,offset,0,0,{}};
 }
 
-template<async_scatter_input_stream stm>
-constexpr inline details::async_scatter_io_coroutine<stm,false> async_scatter_read(typename io_async_scheduler_t<stm>::type& scheduler,stm& sm,std::span<io_scatter_t> sc,std::ptrdiff_t offset=0)
+template<typename scheduler_type,typename stm>
+requires async_scatter_input_stream<stm,scheduler_type>
+constexpr inline details::async_scatter_io_coroutine<scheduler_type,stm,false> async_scatter_read(scheduler_type& scheduler,stm& sm,std::span<io_scatter_t> sc,std::ptrdiff_t offset=0)
 {
-	return {scheduler,sm,sc,offset};
+	return {scheduler,sm,sc,offset,{}};
 }
 
-template<async_scatter_output_stream stm>
-constexpr inline details::async_scatter_io_coroutine<stm,true> async_scatter_write(typename io_async_scheduler_t<stm>::type& scheduler,stm& sm,std::span<io_scatter_t> sc,std::ptrdiff_t offset=-1)
+template<typename scheduler_type,typename stm>
+requires async_scatter_output_stream<stm,scheduler_type>
+constexpr inline details::async_scatter_io_coroutine<scheduler_type,stm,true> async_scatter_write(scheduler_type& scheduler,stm& sm,std::span<io_scatter_t> sc,std::ptrdiff_t offset=-1)
 {
-	return {scheduler,sm,sc,offset};
+	return {scheduler,sm,sc,offset,{}};
 }
 
 
-template<async_output_stream stm,typename... Args>
-constexpr inline details::async_print_coroutine<stm,false> async_print(typename io_async_scheduler_t<stm>::type& scheduler,stm& sm,Args&& ...args)
+template<typename scheduler_type,typename stm,typename... Args>
+requires async_output_stream<stm,scheduler_type>
+constexpr inline details::async_print_coroutine<scheduler_type,stm,false> async_print(scheduler_type& scheduler,stm& sm,Args&& ...args)
 {
-	return details::async_print_coroutine<stm,false>(scheduler,-1,sm,std::forward<Args>(args)...);
+	return details::async_print_coroutine<scheduler_type,stm,false>(scheduler,-1,sm,std::forward<Args>(args)...);
 }
-template<async_output_stream stm,typename... Args>
-constexpr inline details::async_print_coroutine<stm,true> async_println(typename io_async_scheduler_t<stm>::type& scheduler,stm& sm,Args&& ...args)
+template<typename scheduler_type,typename stm,typename... Args>
+requires async_output_stream<stm,scheduler_type>
+constexpr inline details::async_print_coroutine<scheduler_type,stm,true> async_println(scheduler_type& scheduler,stm& sm,Args&& ...args)
 {
-	return details::async_print_coroutine<stm,true>(scheduler,-1,sm,std::forward<Args>(args)...);
+	return details::async_print_coroutine<scheduler_type,stm,true>(scheduler,-1,sm,std::forward<Args>(args)...);
 }
 
-template<async_output_stream stm,typename... Args>
-constexpr inline details::async_print_coroutine<stm,false> async_print(typename io_async_scheduler_t<stm>::type& scheduler,std::ptrdiff_t offset,stm& sm,Args&& ...args)
+template<typename scheduler_type,typename stm,typename... Args>
+requires async_output_stream<stm,scheduler_type>
+constexpr inline details::async_print_coroutine<scheduler_type,stm,false> async_print(scheduler_type& scheduler,std::ptrdiff_t offset,stm& sm,Args&& ...args)
 {
-	return details::async_print_coroutine<stm,false>(scheduler,offset,sm,std::forward<Args>(args)...);
+	return details::async_print_coroutine<scheduler_type,stm,false>(scheduler,offset,sm,std::forward<Args>(args)...);
 }
-template<async_output_stream stm,typename... Args>
-constexpr inline details::async_print_coroutine<stm,true> async_println(typename io_async_scheduler_t<stm>::type& scheduler,std::ptrdiff_t offset,stm& sm,Args&& ...args)
+template<typename scheduler_type,typename stm,typename... Args>
+requires async_output_stream<stm,scheduler_type>
+constexpr inline details::async_print_coroutine<scheduler_type,stm,true> async_println(scheduler_type& scheduler,std::ptrdiff_t offset,stm& sm,Args&& ...args)
 {
-	return details::async_print_coroutine<stm,true>(scheduler,offset,sm,std::forward<Args>(args)...);
+	return details::async_print_coroutine<scheduler_type,stm,true>(scheduler,offset,sm,std::forward<Args>(args)...);
 }
 
 
@@ -2,6 +2,9 @@
 #if !(defined(_WIN32)&&defined(__BIONIC__))
 #include"posix_file_loader.h"
 #endif
+#if (!defined(_WIN32) || defined(__WINE__)) && (!defined(__NEWLIB__)||defined(__CYGWIN__)) && !defined(__MSDOS__) && !defined(__wasm__) && !defined(_PICOLIBC__)
+#include"posix_file_window_loader.h"
+#endif
 #if defined(_WIN32) || defined(__CYGWIN__)
 #include"win32_file_loader.h"
 #endif
@@ -18,5 +21,9 @@ using native_file_loader = posix_file_loader;
 using native_file_loader = allocation_file_loader;
 #endif
 
+#if (!defined(_WIN32) || defined(__WINE__)) && (!defined(__NEWLIB__)||defined(__CYGWIN__)) && !defined(__MSDOS__) && !defined(__wasm__) && !defined(_PICOLIBC__)
+using native_file_window_loader = posix_file_window_loader;
+#endif
+
 
 }
@@ -7,6 +7,9 @@
 #elif !defined(_MSC_VER)
 #include<cstdlib>
 #endif
+#if defined(__linux__) && __has_include(<pthread.h>)
+#include<pthread.h>
+#endif
 
 namespace fast_io
 {
@@ -40,6 +43,11 @@ inline std::size_t win32_load_file_get_file_size(void* handle)
 namespace details
 {
 
+/*
+Background thread of file_loader_mode::prefault; the loader that started it joins it before unmapping.
+*/
+struct posix_loader_prefault;
+
 struct linux_statx_timestamp {
 ::std::int_least64_t tv_sec;
 ::std::uint_least32_t tv_nsec, pad;
@@ -152,8 +160,125 @@ malloc
 	}
 };
 
+#if !(defined(_WIN32) || (defined(__NEWLIB__)&&!defined(__CYGWIN__)) || defined(__MSDOS__) || defined(_PICOLIBC__) || (defined(__wasm__)&&!defined(_WASI_EMULATED_MMAN)))
+inline int posix_loader_madvise(void* address,std::size_t size,int advice) noexcept
+{
+#if defined(__linux__) && defined(__NR_madvise)
+	return system_call<__NR_madvise,int>(address,size,advice);
+#elif defined(POSIX_MADV_NORMAL)
+	return -noexcept_call(::posix_madvise,address,size,advice);
+#else
+	return 0;
+#endif
+}
+
+#if defined(__linux__) && defined(__NR_madvise) && __has_include(<pthread.h>)
+struct posix_loader_prefault
+{
+	char* address;
+	std::size_t size;
+	pthread_t tid;
+	bool stop;
+};
+
+/*
+Walks the mapping in 4 MiB steps and checks stop between them. The loader owns the thread and joins it before the
+mapping goes away, so the range is always valid here.
+*/
+inline void* posix_loader_prefault_routine(void* arg) noexcept
+{
+	auto& pf{*static_cast<posix_loader_prefault*>(arg)};
+	constexpr int linux_madv_willneed{3};
+	constexpr int linux_madv_populate_read{22};
+	constexpr std::size_t chunk{static_cast<std::size_t>(4u)<<20u};
+	for(std::size_t i{};i<pf.size&&!__atomic_load_n(__builtin_addressof(pf.stop),__ATOMIC_RELAXED);)
+	{
+		std::size_t this_round{pf.size-i};
+		if(chunk<this_round)
+			this_round=chunk;
+		int ret{posix_loader_madvise(pf.address+i,this_round,linux_madv_populate_read)};
+		if(ret==-EINTR)
+			continue;
+		if(ret==-EINVAL)
+		{
+			//MADV_POPULATE_READ requires Linux 5.14; readahead is the best we can do on older kernels
+			posix_loader_madvise(pf.address+i,pf.size-i,linux_madv_willneed);
+			break;
+		}
+		if(ret<0)
+			break;
+		i+=this_round;
+	}
+	return nullptr;
+}
+
+inline posix_loader_prefault* posix_loader_start_prefault(char* address,std::size_t size) noexcept
+{
+	using prefault_allocator = ::fast_io::native_typed_global_allocator<posix_loader_prefault>;
+	auto pf{prefault_allocator::allocate(1)};
+	pf->address=address;
+	pf->size=size;
+	pf->stop=false;
+	if(noexcept_call(::pthread_create,__builtin_addressof(pf->tid),nullptr,posix_loader_prefault_routine,pf)!=0)
+	{
+		prefault_allocator::deallocate_n(pf,1);
+		return nullptr;
+	}
+	return pf;
+}
+
+inline void posix_loader_stop_prefault(posix_loader_prefault* pf) noexcept
+{
+	if(pf==nullptr)
+		return;
+	__atomic_store_n(__builtin_addressof(pf->stop),true,__ATOMIC_RELAXED);
+	noexcept_call(::pthread_join,pf->tid,nullptr);
+	::fast_io::native_typed_global_allocator<posix_loader_prefault>::deallocate_n(pf,1);
+}
+#endif
+
+inline posix_loader_prefault* posix_loader_apply_mode(char* address,std::size_t size,file_loader_mode mode) noexcept
+{
+	posix_loader_prefault* pf{};
+#if defined(MADV_SEQUENTIAL)
+	if((mode&file_loader_mode::sequential)==file_loader_mode::sequential)
+		posix_loader_madvise(address,size,MADV_SEQUENTIAL);
+#endif
+#if defined(MADV_RANDOM)
+	if((mode&file_loader_mode::random)==file_loader_mode::random)
+		posix_loader_madvise(address,size,MADV_RANDOM);
+#endif
+#if defined(MADV_HUGEPAGE)
+	if((mode&file_loader_mode::huge_page)==file_loader_mode::huge_page)
+		posix_loader_madvise(address,size,MADV_HUGEPAGE);
+#endif
+	bool willneed{(mode&file_loader_mode::willneed)==file_loader_mode::willneed};
+	if((mode&file_loader_mode::prefault)==file_loader_mode::prefault)
+	{
+#if defined(__linux__) && defined(__NR_madvise) && __has_include(<pthread.h>)
+		pf=posix_loader_start_prefault(address,size);
+		if(pf==nullptr)
+#endif
+			willneed=true;
+	}
+#if defined(MADV_WILLNEED)
+	if(willneed)
+		posix_loader_madvise(address,size,MADV_WILLNEED);
+#else
+	(void)willneed;
+#endif
+	return pf;
+}
+#endif
+
+#if !(defined(__linux__) && defined(__NR_madvise) && __has_include(<pthread.h>))
+inline void posix_loader_stop_prefault(posix_loader_prefault*) noexcept
+{}
+#endif
+
 template<bool allocation>
-inline char* posix_load_address(int fd,std::size_t file_size)
+inline char* posix_load_address(int fd,std::size_t file_size,[[maybe_unused]] file_loader_mode mode=file_loader_mode::none,
+	[[maybe_unused]] posix_loader_prefault** prefault=nullptr)
 {
 	if constexpr(allocation)
 	{
@@ -180,12 +305,26 @@ inline char* posix_load_address(int fd,std::size_t file_size)
 #else
 	if(file_size==0)
 		return (char*)-1;
-	return reinterpret_cast<char*>(
+	if(mode==file_loader_mode::none)
+		return reinterpret_cast<char*>(
 sys_mmap(nullptr,file_size,PROT_READ|PROT_WRITE,MAP_PRIVATE
 #if defined(MAP_POPULATE)
 |MAP_POPULATE
 #endif
 ,fd,0));
+	bool const read_only{(mode&file_loader_mode::read_only)==file_loader_mode::read_only};
+	int flags{read_only?MAP_SHARED:MAP_PRIVATE};
+#if defined(MAP_POPULATE)
+	if((mode&(file_loader_mode::lazy|file_loader_mode::prefault))==file_loader_mode::none)
+		flags|=MAP_POPULATE;
+#endif
+	auto address{reinterpret_cast<char*>(sys_mmap(nullptr,file_size,read_only?PROT_READ:(PROT_READ|PROT_WRITE),flags,fd,0))};
+	auto pf{posix_loader_apply_mode(address,file_size,mode)};
+	if(prefault)
+		*prefault=pf;
+	else
+		posix_loader_stop_prefault(pf);
+	return address;
 #endif
 	}
 }
@@ -253,35 +392,37 @@ struct posix_file_loader_return_value_t
 {
 	char* address_begin;
 	char* address_end;
+	posix_loader_prefault* prefault{};
 };
 
 template<bool allocation>
-inline posix_file_loader_return_value_t posix_load_address_impl(int fd)
+inline posix_file_loader_return_value_t posix_load_address_impl(int fd,file_loader_mode mode=file_loader_mode::none)
 {
 	std::size_t size{posix_loader_get_file_size(fd)};
-	auto add{posix_load_address<allocation>(fd,size)};
-	return {add,add+size};
+	posix_loader_prefault* prefault{};
+	auto add{posix_load_address<allocation>(fd,size,mode,__builtin_addressof(prefault))};
+	return {add,add+size,prefault};
 }
 
 template<bool allocation>
-inline auto posix_load_file_impl(native_fs_dirent fsdirent,open_mode om,perms pm)
+inline auto posix_load_file_impl(native_fs_dirent fsdirent,open_mode om,perms pm,file_loader_mode mode=file_loader_mode::none)
 {
 	posix_file pf(fsdirent,om,pm);
-	return posix_load_address_impl<allocation>(pf.fd);
+	return posix_load_address_impl<allocation>(pf.fd,mode);
 }
 
 template<bool allocation,::fast_io::constructible_to_os_c_str T>
-inline auto posix_load_file_impl(T const& str,open_mode om,perms pm)
+inline auto posix_load_file_impl(T const& str,open_mode om,perms pm,file_loader_mode mode=file_loader_mode::none)
 {
 	posix_file pf(str,om,pm);
-	return posix_load_address_impl<allocation>(pf.fd);
+	return posix_load_address_impl<allocation>(pf.fd,mode);
 }
 
 template<bool allocation,::fast_io::constructible_to_os_c_str T>
-inline auto posix_load_file_impl(native_at_entry ent,T const& str,open_mode om,perms pm)
+inline auto posix_load_file_impl(native_at_entry ent,T const& str,open_mode om,perms pm,file_loader_mode mode=file_loader_mode::none)
 {
 	posix_file pf(ent,str,om,pm);
-	return posix_load_address_impl<allocation>(pf.fd);
+	return posix_load_address_impl<allocation>(pf.fd,mode);
 }
 
 
@@ -332,6 +473,17 @@ public:
 
 	pointer address_begin{};
 	pointer address_end{};
+	/*
+	Only the mmap-backed loaders start a prefault thread; allocation_file_loader carries no handle for it.
+	*/
+#ifndef __INTELLISENSE__
+#if __has_cpp_attribute(msvc::no_unique_address)
+[[msvc::no_unique_address]]
+#elif __has_cpp_attribute(no_unique_address) >= 201803
+[[no_unique_address]]
+#endif
+#endif
+	::std::conditional_t<allocation,::fast_io::details::empty,posix_loader_prefault*> prefault{};
 	inline constexpr posix_file_loader_impl() noexcept requires(allocation)=default;
 	inline constexpr posix_file_loader_impl() noexcept : address_begin((char*)-1),address_end((char*)-1){}
 	inline explicit posix_file_loader_impl(posix_at_entry pate)
@@ -339,12 +491,16 @@ public:
 		auto ret{posix_load_address_impl<allocation>(pate.fd)};
 		address_begin=ret.address_begin;
 		address_end=ret.address_end;
+		if constexpr(!allocation)
+			prefault=ret.prefault;
 	}
 	inline explicit posix_file_loader_impl(native_fs_dirent fsdirent,open_mode om = open_mode::in, perms pm=static_cast<perms>(436))
 	{
 		auto ret{posix_load_file_impl<allocation>(fsdirent,om,pm)};
 		address_begin=ret.address_begin;
 		address_end=ret.address_end;
+		if constexpr(!allocation)
+			prefault=ret.prefault;
 	}
 	template<::fast_io::constructible_to_os_c_str T>
 	inline explicit posix_file_loader_impl(T const& filename,open_mode om = open_mode::in,perms pm=static_cast<perms>(436))
@@ -352,6 +508,8 @@ public:
 		auto ret{posix_load_file_impl<allocation>(filename,om,pm)};
 		address_begin=ret.address_begin;
 		address_end=ret.address_end;
+		if constexpr(!allocation)
+			prefault=ret.prefault;
 	}
 	template<::fast_io::constructible_to_os_c_str T>
 	inline explicit posix_file_loader_impl(native_at_entry ent,T const& filename,open_mode om = open_mode::in,perms pm=static_cast<perms>(436))
@@ -359,29 +517,78 @@ public:
 		auto ret{posix_load_file_impl<allocation>(ent,filename,om,pm)};
 		address_begin=ret.address_begin;
 		address_end=ret.address_end;
+		if constexpr(!allocation)
+			prefault=ret.prefault;
+	}
+	inline void stop_prefault() noexcept
+	{
+		if constexpr(!allocation)
+		{
+			posix_loader_stop_prefault(prefault);
+			prefault=nullptr;
+		}
 	}
 	posix_file_loader_impl(posix_file_loader_impl const&)=delete;
 	posix_file_loader_impl& operator=(posix_file_loader_impl const&)=delete;
-	constexpr posix_file_loader_impl(posix_file_loader_impl&& __restrict other) noexcept:address_begin(other.address_begin),address_end(other.address_end)
+	constexpr posix_file_loader_impl(posix_file_loader_impl&& __restrict other) noexcept:address_begin(other.address_begin),address_end(other.address_end),prefault(other.prefault)
 	{
 		if constexpr(allocation)
 			other.address_end=other.address_begin=nullptr;
 		else
+		{
+			other.prefault=nullptr;
 			other.address_end=other.address_begin=(char*)-1;
+		}
 	}
 	posix_file_loader_impl& operator=(posix_file_loader_impl && __restrict other) noexcept
 	{
+		this->stop_prefault();
 		posix_unload_address<allocation>(address_begin,static_cast<std::size_t>(address_end-address_begin));
 		address_begin=other.address_begin;
 		address_end=other.address_end;
+		prefault=other.prefault;
 		if constexpr(allocation)
 			other.address_end=other.address_begin=nullptr;
 		else
+		{
+			other.prefault=nullptr;
 			other.address_end=other.address_begin=(char*)-1;
+		}
 		return *this;
 	}
 
 
+	inline explicit posix_file_loader_impl(file_loader_mode mode,posix_at_entry pate) requires(!allocation)
+	{
+		auto ret{posix_load_address_impl<allocation>(pate.fd,mode)};
+		address_begin=ret.address_begin;
+		address_end=ret.address_end;
+		prefault=ret.prefault;
+	}
+	inline explicit posix_file_loader_impl(file_loader_mode mode,native_fs_dirent fsdirent,open_mode om = open_mode::in, perms pm=static_cast<perms>(436)) requires(!allocation)
+	{
+		auto ret{posix_load_file_impl<allocation>(fsdirent,om,pm,mode)};
+		address_begin=ret.address_begin;
+		address_end=ret.address_end;
+		prefault=ret.prefault;
+	}
+	template<::fast_io::constructible_to_os_c_str T>
+	inline explicit posix_file_loader_impl(file_loader_mode mode,T const& filename,open_mode om = open_mode::in,perms pm=static_cast<perms>(436)) requires(!allocation)
+	{
+		auto ret{posix_load_file_impl<allocation>(filename,om,pm,mode)};
+		address_begin=ret.address_begin;
+		address_end=ret.address_end;
+		prefault=ret.prefault;
+	}
+	template<::fast_io::constructible_to_os_c_str T>
+	inline explicit posix_file_loader_impl(file_loader_mode mode,native_at_entry ent,T const& filename,open_mode om = open_mode::in,perms pm=static_cast<perms>(436)) requires(!allocation)
+	{
+		auto ret{posix_load_file_impl<allocation>(ent,filename,om,pm,mode)};
+		address_begin=ret.address_begin;
+		address_end=ret.address_end;
+		prefault=ret.prefault;
+	}
+
 	inline explicit posix_file_loader_impl(file_loader_extra_bytes exb,posix_at_entry pate) requires(allocation)
 	{
 		auto ret{posix_load_address_allocation_extra_impl(exb.n,pate.fd)};
@@ -499,6 +706,7 @@ public:
 	}
 	inline void close()
 	{
+		this->stop_prefault();
 		posix_unload_address<allocation>(address_begin,static_cast<std::size_t>(address_end-address_begin));
 		if constexpr(allocation)
 			address_end=address_begin=nullptr;
@@ -508,8 +716,9 @@ public:
 #if __has_cpp_attribute(nodiscard)
 	[[nodiscard]]
 #endif
-	inline constexpr pointer release() noexcept
+	inline pointer release() noexcept
 	{
+		this->stop_prefault();
 		pointer temp{address_begin};
 		if constexpr(allocation)
 			address_end=address_begin=nullptr;
@@ -519,6 +728,7 @@ public:
 	}
 	~posix_file_loader_impl()
 	{
+		this->stop_prefault();
 		posix_unload_address<allocation>(address_begin,static_cast<std::size_t>(address_end-address_begin));
 	}
 };
@@ -0,0 +1,300 @@
+﻿#pragma once
+
+namespace fast_io
+{
+
+/*
+Maps a bounded window of a file instead of the whole file, so files larger than the address space or the memory
+budget can still be scanned straight out of the page cache. Sliding keeps everything from the caller's cursor
+onwards mapped (the overlap), so a record crossing a window boundary is always seen contiguously as long as it fits
+in one window; longer records grow the window.
+It is a buffer_input_stream: ibuffer_underflow slides to the next window.
+*/
+
+namespace details
+{
+
+inline std::uint_least64_t posix_window_loader_get_file_size(int fd)
+{
+	auto st{fstat_impl(fd)};
+	return static_cast<std::uint_least64_t>(st.size);
+}
+
+inline std::size_t posix_window_loader_page_size() noexcept
+{
+#if defined(_SC_PAGESIZE)
+	long pgsz{noexcept_call(::sysconf,_SC_PAGESIZE)};
+	if(0<pgsz)
+		return static_cast<std::size_t>(pgsz);
+#endif
+	return 4096;
+}
+
+}
+
+class posix_file_window_loader
+{
+public:
+	using char_type = char;
+	using native_handle_type = int;
+	static inline constexpr std::size_t default_window_size{static_cast<std::size_t>(64u)<<20u};
+	posix_file file;
+	std::uint_least64_t file_size{};
+	std::uint_least64_t window_offset{};
+	char const* begin_ptr{};
+	char const* curr_ptr{};
+	char const* end_ptr{};
+	std::size_t window_size{default_window_size};
+	constexpr posix_file_window_loader() noexcept = default;
+	inline explicit posix_file_window_loader(posix_file&& pf,std::size_t wsize=default_window_size):file(::std::move(pf))
+	{
+		init(wsize);
+	}
+	inline explicit posix_file_window_loader(native_fs_dirent fsdirent,std::size_t wsize=default_window_size,open_mode om = open_mode::in, perms pm=static_cast<perms>(436)):
+		file(fsdirent,om,pm)
+	{
+		init(wsize);
+	}
+	template<::fast_io::constructible_to_os_c_str T>
+	inline explicit posix_file_window_loader(T const& filename,std::size_t wsize=default_window_size,open_mode om = open_mode::in,perms pm=static_cast<perms>(436)):
+		file(filename,om,pm)
+	{
+		init(wsize);
+	}
+	template<::fast_io::constructible_to_os_c_str T>
+	inline explicit posix_file_window_loader(native_at_entry ent,T const& filename,std::size_t wsize=default_window_size,open_mode om = open_mode::in,perms pm=static_cast<perms>(436)):
+		file(ent,filename,om,pm)
+	{
+		init(wsize);
+	}
+	posix_file_window_loader(posix_file_window_loader const&)=delete;
+	posix_file_window_loader& operator=(posix_file_window_loader const&)=delete;
+	posix_file_window_loader(posix_file_window_loader&& __restrict other) noexcept:
+		file(::std::move(other.file)),file_size(other.file_size),window_offset(other.window_offset),
+		begin_ptr(other.begin_ptr),curr_ptr(other.curr_ptr),end_ptr(other.end_ptr),window_size(other.window_size)
+	{
+		other.file_size=other.window_offset=0;
+		other.end_ptr=other.curr_ptr=other.begin_ptr=nullptr;
+	}
+	posix_file_window_loader& operator=(posix_file_window_loader&& __restrict other) noexcept
+	{
+		unmap();
+		file=::std::move(other.file);
+		file_size=other.file_size;
+		window_offset=other.window_offset;
+		begin_ptr=other.begin_ptr;
+		curr_ptr=other.curr_ptr;
+		end_ptr=other.end_ptr;
+		window_size=other.window_size;
+		other.file_size=other.window_offset=0;
+		other.end_ptr=other.curr_ptr=other.begin_ptr=nullptr;
+		return *this;
+	}
+	constexpr native_handle_type native_handle() const noexcept
+	{
+		return file.fd;
+	}
+	/*
+	File offset of ibuffer_curr.
+	*/
+	constexpr std::uint_least64_t position() const noexcept
+	{
+		return window_offset+static_cast<std::uint_least64_t>(curr_ptr-begin_ptr);
+	}
+	constexpr bool window_reaches_eof() const noexcept
+	{
+		return window_offset+static_cast<std::uint_least64_t>(end_ptr-begin_ptr)==file_size;
+	}
+	/*
+	Remaps so the window starts at or just before file offset pos (rounded down to a page) and curr points at pos.
+	*/
+	void seek_window(std::uint_least64_t pos)
+	{
+		if(file_size<pos)
+			pos=file_size;
+		std::uint_least64_t const page_mask{static_cast<std::uint_least64_t>(details::posix_window_loader_page_size()-1u)};
+		std::uint_least64_t const aligned{pos&~page_mask};
+		std::uint_least64_t remain{file_size-aligned};
+		std::size_t const pos_in_window{static_cast<std::size_t>(pos-aligned)};
+		std::size_t bytes{window_size};
+		if(bytes<pos_in_window+1u)
+			bytes=pos_in_window+1u;
+		if(remain<bytes)
+			bytes=static_cast<std::size_t>(remain);
+		unmap();
+		window_offset=aligned;
+		if(bytes==0)
+			return;
+		auto address{reinterpret_cast<char const*>(details::sys_mmap(nullptr,bytes,PROT_READ,MAP_SHARED,file.fd,aligned))};
+#if defined(MADV_SEQUENTIAL)
+		details::posix_loader_madvise(const_cast<char*>(address),bytes,MADV_SEQUENTIAL);
+#endif
+		begin_ptr=address;
+		curr_ptr=address+pos_in_window;
+		end_ptr=address+bytes;
+	}
+	/*
+	Slides forward keeping [keep,end) mapped. When keep is already the start of the window the record does not fit,
+	so the window doubles. Returns false when the window already reaches the end of the file.
+	*/
+	bool slide(char const* keep)
+	{
+		if(window_reaches_eof())
+			return false;
+		std::uint_least64_t const keep_pos{window_offset+static_cast<std::uint_least64_t>(keep-begin_ptr)};
+		std::uint_least64_t const page_mask{static_cast<std::uint_least64_t>(details::posix_window_loader_page_size()-1u)};
+		if((keep_pos&~page_mask)==window_offset)
+		{
+			constexpr std::size_t mx{std::numeric_limits<std::size_t>::max()};
+			window_size=(mx/2u<window_size)?mx:(window_size<<1u);
+		}
+		seek_window(keep_pos);
+		return true;
+	}
+	void close()
+	{
+		unmap();
+		file.close();
+	}
+	~posix_file_window_loader()
+	{
+		unmap();
+	}
+private:
+	void init(std::size_t wsize)
+	{
+		std::size_t const pgsz{details::posix_window_loader_page_size()};
+		if(wsize<pgsz)
+			wsize=pgsz;
+		window_size=wsize;
+		file_size=details::posix_window_loader_get_file_size(file.fd);
+		seek_window(0);
+	}
+	void unmap() noexcept
+	{
+		if(begin_ptr)
+			details::sys_munmap(const_cast<char*>(begin_ptr),static_cast<std::size_t>(end_ptr-begin_ptr));
+		end_ptr=curr_ptr=begin_ptr=nullptr;
+	}
+};
+
+[[nodiscard]] inline char const* ibuffer_begin(posix_file_window_loader& loader) noexcept
+{
+	return loader.begin_ptr;
+}
+
+[[nodiscard]] inline char const* ibuffer_curr(posix_file_window_loader& loader) noexcept
+{
+	return loader.curr_ptr;
+}
+
+[[nodiscard]] inline char const* ibuffer_end(posix_file_window_loader& loader) noexcept
+{
+	return loader.end_ptr;
+}
+
+inline void ibuffer_set_curr(posix_file_window_loader& loader,char const* ptr) noexcept
+{
+	loader.curr_ptr=ptr;
+}
+
+[[nodiscard]] inline bool ibuffer_underflow(posix_file_window_loader& loader)
+{
+	if(!loader.slide(loader.end_ptr))
+		return false;
+	return loader.curr_ptr!=loader.end_ptr;
+}
+
+template<::std::contiguous_iterator Iter>
+requires std::same_as<::std::iter_value_t<Iter>,char>
+[[nodiscard]] inline Iter read(posix_file_window_loader& loader,Iter first,Iter last)
+{
+	if(loader.curr_ptr==loader.end_ptr)
+	{
+		if(!ibuffer_underflow(loader))
+			return first;
+	}
+	std::size_t diff{static_cast<std::size_t>(last-first)};
+	std::size_t const avail{static_cast<std::size_t>(loader.end_ptr-loader.curr_ptr)};
+	if(avail<diff)
+		diff=avail;
+	auto it{::fast_io::details::non_overlapped_copy_n(loader.curr_ptr,diff,::std::to_address(first))};
+	loader.curr_ptr+=diff;
+	return first+(it-::std::to_address(first));
+}
+
+/*
+Line scanning over the window without copying: every line is a basic_line_scanner_contiguous_view pointing into the
+mapping. A view stays valid until the next increment.
+*/
+struct posix_file_window_line_scanner
+{
+	using char_type = char;
+	using context_type = basic_line_scanner_contiguous_view<char>;
+	struct iterator
+	{
+		posix_file_window_line_scanner* ptr{};
+		inline constexpr context_type& operator*() const noexcept
+		{
+			return ptr->context;
+		}
+		inline iterator& operator++()
+		{
+			if(!ptr->next())
+				ptr=nullptr;
+			return *this;
+		}
+	};
+	posix_file_window_loader* loader{};
+	context_type context{};
+	inline bool next()
+	{
+		for(;;)
+		{
+			char const* first{loader->curr_ptr};
+			char const* last{loader->end_ptr};
+			auto it{::fast_io::find_lf(first,last)};
+			if(it!=last)[[likely]]
+			{
+				context.view_begin_ptr=first;
+				context.view_end_ptr=it;
+				loader->curr_ptr=it+1;
+				return true;
+			}
+			if(!loader->slide(first))
+			{
+				if(first==last)
+					return false;
+				context.view_begin_ptr=first;
+				context.view_end_ptr=last;
+				loader->curr_ptr=last;
+				return true;
+			}
+		}
+	}
+	inline iterator begin()
+	{
+		return ++iterator{this};
+	}
+	inline constexpr ::std::default_sentinel_t end() const noexcept
+	{
+		return {};
+	}
+};
+
+inline constexpr bool operator==(posix_file_window_line_scanner::iterator it,::std::default_sentinel_t) noexcept
+{
+	return it.ptr==nullptr;
+}
+
+inline constexpr bool operator==(::std::default_sentinel_t,posix_file_window_line_scanner::iterator it) noexcept
+{
+	return it.ptr==nullptr;
+}
+
+inline posix_file_window_line_scanner line_scanner(posix_file_window_loader& loader) noexcept
+{
+	return {__builtin_addressof(loader)};
+}
+
+}
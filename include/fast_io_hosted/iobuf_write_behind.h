@@ -0,0 +1,352 @@
+#pragma once
+
+/*
+buffer_mode::write_behind for output basic_io_buffer. A buffer that fills up is handed to a flusher thread owned by
+the stream and the producer carries on in the next free buffer, so the write syscall, and any device stall behind
+it, happens off the producer's thread. iobuf_write_behind_buffers buffers rotate: one being filled and the rest
+queued or being written, in order, through the address of the stream's handle. The producer only waits when every
+buffer is queued.
+flush() hands over the partial buffer and returns once all of it has been written to the handle, so it is the same
+barrier it is without write-behind. Whatever the flusher's write throws is rethrown by the next hand-over or flush, and
+everything queued after the failed write is dropped.
+The context, its buffers and the thread are created on the first overflow, so an untouched stream costs nothing.
+*/
+
+#if ((__STDC_HOSTED__==1 && (!defined(_GLIBCXX_HOSTED) || _GLIBCXX_HOSTED==1) && !defined(_LIBCPP_FREESTANDING)) || defined(FAST_IO_ENABLE_HOSTED_FEATURES)) && !defined(__SINGLE_THREAD__) && !defined(_WIN32) && __has_include(<pthread.h>)
+#include<pthread.h>
+#ifdef __cpp_exceptions
+#include<exception>
+#endif
+#define FAST_IO_IOBUF_WRITE_BEHIND_HAS_THREADS
+#endif
+
+#if defined(FAST_IO_IOBUF_WRITE_BEHIND_HAS_THREADS)
+
+namespace fast_io
+{
+
+inline constexpr std::size_t iobuf_write_behind_buffers{3};
+
+namespace details
+{
+
+struct iobuf_write_behind_job
+{
+	void* handle;
+	std::byte* buffer;
+	std::size_t bytes;
+};
+
+struct iobuf_write_behind_context
+{
+	using write_function = void(*)(void*,std::byte const*,std::size_t);
+	using deallocate_function = void(*)(std::byte*,std::size_t) noexcept;
+	write_function write_fn;
+	deallocate_function deallocate_fn;
+	std::size_t buffer_bytes;
+	std::byte* buffers[::fast_io::iobuf_write_behind_buffers];
+	std::byte* free_buffers[::fast_io::iobuf_write_behind_buffers];
+	std::size_t free_count;
+	iobuf_write_behind_job queue[::fast_io::iobuf_write_behind_buffers];
+	std::size_t queue_head;
+	std::size_t queue_count;
+	bool writing;
+	bool stopping;
+	bool failed;
+#ifdef __cpp_exceptions
+	::std::exception_ptr failure;
+#endif
+	::pthread_mutex_t mutex;
+	::pthread_cond_t work_cond;
+	::pthread_cond_t done_cond;
+	::pthread_t flusher;
+};
+
+template<typename handle_type,std::integral char_type>
+inline void iobuf_write_behind_write_shim(void* handle,std::byte const* first,std::size_t bytes)
+{
+	auto const chars{reinterpret_cast<char_type const*>(first)};
+	write(io_ref(*static_cast<handle_type*>(handle)),chars,chars+bytes/sizeof(char_type));
+}
+
+template<typename allocator_type,bool secure_clear,std::integral char_type>
+inline void iobuf_write_behind_deallocate_shim(std::byte* buffer,std::size_t bytes) noexcept
+{
+	::fast_io::details::deallocate_iobuf_space<secure_clear,char_type,allocator_type>(reinterpret_cast<char_type*>(buffer),bytes/sizeof(char_type));
+}
+
+inline void* iobuf_write_behind_flusher_routine(void* arg) noexcept
+{
+	auto& ctx{*static_cast<iobuf_write_behind_context*>(arg)};
+	noexcept_call(::pthread_mutex_lock,__builtin_addressof(ctx.mutex));
+	for(;;)
+	{
+		while(ctx.queue_count==0&&!ctx.stopping)
+		{
+			noexcept_call(::pthread_cond_wait,__builtin_addressof(ctx.work_cond),__builtin_addressof(ctx.mutex));
+		}
+		if(ctx.queue_count==0)
+		{
+			break;
+		}
+		iobuf_write_behind_job const job{ctx.queue[ctx.queue_head]};
+		ctx.queue_head=(ctx.queue_head+1u)%iobuf_write_behind_buffers;
+		--ctx.queue_count;
+		ctx.writing=true;
+		bool const skip{ctx.failed};
+		noexcept_call(::pthread_mutex_unlock,__builtin_addressof(ctx.mutex));
+		if(!skip)
+		{
+#ifdef __cpp_exceptions
+			try
+			{
+#endif
+				ctx.write_fn(job.handle,job.buffer,job.bytes);
+#ifdef __cpp_exceptions
+			}
+			catch(...)
+			{
+				noexcept_call(::pthread_mutex_lock,__builtin_addressof(ctx.mutex));
+				ctx.failure=::std::current_exception();
+				ctx.failed=true;
+				noexcept_call(::pthread_mutex_unlock,__builtin_addressof(ctx.mutex));
+			}
+#endif
+		}
+		noexcept_call(::pthread_mutex_lock,__builtin_addressof(ctx.mutex));
+		ctx.writing=false;
+		ctx.free_buffers[ctx.free_count]=job.buffer;
+		++ctx.free_count;
+		noexcept_call(::pthread_cond_signal,__builtin_addressof(ctx.done_cond));
+	}
+	noexcept_call(::pthread_mutex_unlock,__builtin_addressof(ctx.mutex));
+	return nullptr;
+}
+
+/*
+Throws the flusher's error, if any, with ctx.mutex held by the caller; the lock is released first.
+*/
+inline void iobuf_write_behind_check_failure_unlock(iobuf_write_behind_context& ctx)
+{
+	bool const failed{ctx.failed};
+#ifdef __cpp_exceptions
+	::std::exception_ptr failure;
+	if(failed)[[unlikely]]
+	{
+		failure=ctx.failure;
+	}
+#endif
+	noexcept_call(::pthread_mutex_unlock,__builtin_addressof(ctx.mutex));
+	if(failed)[[unlikely]]
+	{
+#ifdef __cpp_exceptions
+		::std::rethrow_exception(failure);
+#else
+		fast_terminate();
+#endif
+	}
+}
+
+/*
+Frees the buffers allocated so far and the context itself, before the mutex and condition variables exist.
+*/
+inline void iobuf_write_behind_free_context(iobuf_write_behind_context* ctx) noexcept
+{
+	for(std::size_t i{};i!=::fast_io::iobuf_write_behind_buffers;++i)
+	{
+		if(ctx->buffers[i])
+		{
+			ctx->deallocate_fn(ctx->buffers[i],ctx->buffer_bytes);
+		}
+	}
+	ctx->~iobuf_write_behind_context();
+	::fast_io::native_typed_global_allocator<iobuf_write_behind_context>::deallocate_n(ctx,1);
+}
+
+inline void iobuf_write_behind_release_context(iobuf_write_behind_context* ctx) noexcept
+{
+	noexcept_call(::pthread_cond_destroy,__builtin_addressof(ctx->done_cond));
+	noexcept_call(::pthread_cond_destroy,__builtin_addressof(ctx->work_cond));
+	noexcept_call(::pthread_mutex_destroy,__builtin_addressof(ctx->mutex));
+	iobuf_write_behind_free_context(ctx);
+}
+
+template<typename allocator_type,bool secure_clear,std::size_t bfs,typename handle_type,std::integral char_type>
+#if __has_cpp_attribute(__gnu__::__cold__)
+[[__gnu__::__cold__]]
+#endif
+inline void iobuf_write_behind_create(iobuf_write_behind_pointers<char_type>& pointers)
+{
+	/*
+	Value-initialized, so every buffers[] slot is null until its allocation succeeds and a throwing allocator leaks
+	nothing.
+	*/
+	auto ctx{::new (::fast_io::native_typed_global_allocator<iobuf_write_behind_context>::allocate(1)) iobuf_write_behind_context{}};
+	ctx->write_fn=iobuf_write_behind_write_shim<handle_type,char_type>;
+	ctx->deallocate_fn=iobuf_write_behind_deallocate_shim<allocator_type,secure_clear,char_type>;
+	ctx->buffer_bytes=bfs*sizeof(char_type);
+#ifdef __cpp_exceptions
+	try
+	{
+#endif
+		for(std::size_t i{};i!=::fast_io::iobuf_write_behind_buffers;++i)
+		{
+			ctx->buffers[i]=reinterpret_cast<std::byte*>(::fast_io::details::allocate_iobuf_space<char_type,allocator_type>(bfs));
+		}
+#ifdef __cpp_exceptions
+	}
+	catch(...)
+	{
+		iobuf_write_behind_free_context(ctx);
+		throw;
+	}
+#endif
+	ctx->free_count=::fast_io::iobuf_write_behind_buffers-1u;
+	for(std::size_t i{};i!=ctx->free_count;++i)
+	{
+		ctx->free_buffers[i]=ctx->buffers[i+1u];
+	}
+	noexcept_call(::pthread_mutex_init,__builtin_addressof(ctx->mutex),nullptr);
+	noexcept_call(::pthread_cond_init,__builtin_addressof(ctx->work_cond),nullptr);
+	noexcept_call(::pthread_cond_init,__builtin_addressof(ctx->done_cond),nullptr);
+	int const ret{noexcept_call(::pthread_create,__builtin_addressof(ctx->flusher),nullptr,iobuf_write_behind_flusher_routine,ctx)};
+	if(ret)[[unlikely]]
+	{
+		iobuf_write_behind_release_context(ctx);
+		throw_posix_error(ret);
+	}
+	pointers.context=ctx;
+	pointers.buffer_curr=pointers.buffer_begin=reinterpret_cast<char_type*>(ctx->buffers[0]);
+	pointers.buffer_end=pointers.buffer_begin+bfs;
+}
+
+/*
+Queues the filled part of the current buffer and switches to a free one, waiting for the flusher if none is free.
+*/
+template<std::integral char_type,typename handle_type>
+inline void iobuf_write_behind_hand_over(handle_type& handle,iobuf_write_behind_pointers<char_type>& pointers)
+{
+	auto& ctx{*pointers.context};
+	std::size_t const bytes{static_cast<std::size_t>(pointers.buffer_curr-pointers.buffer_begin)*sizeof(char_type)};
+	noexcept_call(::pthread_mutex_lock,__builtin_addressof(ctx.mutex));
+	if(ctx.failed)[[unlikely]]
+	{
+		pointers.buffer_curr=pointers.buffer_begin;
+		iobuf_write_behind_check_failure_unlock(ctx);
+	}
+	ctx.queue[(ctx.queue_head+ctx.queue_count)%iobuf_write_behind_buffers]=
+		{__builtin_addressof(handle),reinterpret_cast<std::byte*>(pointers.buffer_begin),bytes};
+	++ctx.queue_count;
+	noexcept_call(::pthread_cond_signal,__builtin_addressof(ctx.work_cond));
+	while(ctx.free_count==0)
+	{
+		noexcept_call(::pthread_cond_wait,__builtin_addressof(ctx.done_cond),__builtin_addressof(ctx.mutex));
+	}
+	--ctx.free_count;
+	std::byte* const next{ctx.free_buffers[ctx.free_count]};
+	noexcept_call(::pthread_mutex_unlock,__builtin_addressof(ctx.mutex));
+	pointers.buffer_curr=pointers.buffer_begin=reinterpret_cast<char_type*>(next);
+	pointers.buffer_end=pointers.buffer_begin+ctx.buffer_bytes/sizeof(char_type);
+}
+
+/*
+Leaves an empty current buffer, creating the context on first use.
+*/
+template<typename allocator_type,bool secure_clear,std::size_t bfs,typename handle_type,std::integral char_type>
+inline void iobuf_write_behind_constant_flush_prepare(handle_type& handle,iobuf_write_behind_pointers<char_type>& pointers)
+{
+	if(pointers.context==nullptr)
+	{
+		iobuf_write_behind_create<allocator_type,secure_clear,bfs,handle_type>(pointers);
+	}
+	else if(pointers.buffer_curr!=pointers.buffer_begin)
+	{
+		iobuf_write_behind_hand_over(handle,pointers);
+	}
+}
+
+template<typename allocator_type,bool secure_clear,std::size_t bfs,typename handle_type,std::integral char_type>
+inline void iobuf_write_behind_overflow(handle_type& handle,iobuf_write_behind_pointers<char_type>& pointers,char_type ch)
+{
+	iobuf_write_behind_constant_flush_prepare<allocator_type,secure_clear,bfs>(handle,pointers);
+	*pointers.buffer_curr=ch;
+	++pointers.buffer_curr;
+}
+
+/*
+Writes that do not fit are copied through the rotating buffers even when larger than one, so they stay ordered
+behind what is queued without the producer waiting for it to drain.
+*/
+template<typename allocator_type,bool secure_clear,std::size_t bfs,typename handle_type,std::integral char_type,::std::random_access_iterator Iter>
+inline void iobuf_write_behind_write(handle_type& handle,iobuf_write_behind_pointers<char_type>& pointers,Iter first,Iter last)
+{
+	if(pointers.context==nullptr)
+	{
+		iobuf_write_behind_create<allocator_type,secure_clear,bfs,handle_type>(pointers);
+	}
+	for(;;)
+	{
+		std::size_t const remain_space{static_cast<std::size_t>(pointers.buffer_end-pointers.buffer_curr)};
+		std::size_t const diff{static_cast<std::size_t>(last-first)};
+		if(diff<=remain_space)
+		{
+			pointers.buffer_curr=::fast_io::details::non_overlapped_copy_n(first,diff,pointers.buffer_curr);
+			return;
+		}
+		pointers.buffer_curr=::fast_io::details::non_overlapped_copy_n(first,remain_space,pointers.buffer_curr);
+		first+=remain_space;
+		iobuf_write_behind_hand_over(handle,pointers);
+	}
+}
+
+inline void iobuf_write_behind_wait_locked(iobuf_write_behind_context& ctx) noexcept
+{
+	while(ctx.queue_count!=0||ctx.writing)
+	{
+		noexcept_call(::pthread_cond_wait,__builtin_addressof(ctx.done_cond),__builtin_addressof(ctx.mutex));
+	}
+}
+
+template<std::integral char_type>
+inline void iobuf_write_behind_wait(iobuf_write_behind_pointers<char_type>& pointers) noexcept
+{
+	auto& ctx{*pointers.context};
+	noexcept_call(::pthread_mutex_lock,__builtin_addressof(ctx.mutex));
+	iobuf_write_behind_wait_locked(ctx);
+	noexcept_call(::pthread_mutex_unlock,__builtin_addressof(ctx.mutex));
+}
+
+/*
+Hands over the current buffer and waits until the flusher has written everything.
+*/
+template<typename handle_type,std::integral char_type>
+inline void iobuf_write_behind_flush(handle_type& handle,iobuf_write_behind_pointers<char_type>& pointers)
+{
+	if(pointers.buffer_curr!=pointers.buffer_begin)
+	{
+		iobuf_write_behind_hand_over(handle,pointers);
+	}
+	auto& ctx{*pointers.context};
+	noexcept_call(::pthread_mutex_lock,__builtin_addressof(ctx.mutex));
+	iobuf_write_behind_wait_locked(ctx);
+	iobuf_write_behind_check_failure_unlock(ctx);
+}
+
+template<std::integral char_type>
+inline void iobuf_write_behind_destroy(iobuf_write_behind_pointers<char_type>& pointers) noexcept
+{
+	auto ctx{pointers.context};
+	noexcept_call(::pthread_mutex_lock,__builtin_addressof(ctx->mutex));
+	ctx->stopping=true;
+	noexcept_call(::pthread_cond_signal,__builtin_addressof(ctx->work_cond));
+	noexcept_call(::pthread_mutex_unlock,__builtin_addressof(ctx->mutex));
+	noexcept_call(::pthread_join,ctx->flusher,nullptr);
+	iobuf_write_behind_release_context(ctx);
+	pointers={};
+}
+
+}
+
+}
+
+#endif
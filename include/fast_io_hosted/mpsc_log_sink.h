@@ -0,0 +1,485 @@
+#pragma once
+
+/*
+A shared log output that producers never block on a mutex for. print() to a basic_mpsc_log_sink formats into a
+buffer owned by the calling thread; unlock() then publishes the finished record into a lock-free multi-producer
+ring, and a single writer thread drains the ring into the underlying stream, handing up to
+mpsc_log_sink_max_batch records to one scatter_write. Records from one thread reach the stream in the order that
+thread printed them; records from different threads are interleaved whole, never torn.
+
+The ring is ring_size bytes of 8-byte words. A producer reserves space by advancing head with a compare-exchange,
+copies its record in and commits it by storing the record's header word last, with release. The writer consumes
+committed records from tail in position order, zeroes what it consumed so that a header word reads as zero until it
+is committed again, and advances tail. Records too large for the ring are copied to the heap and only a pointer goes
+through the ring. When the ring is full producers yield until the writer catches up; when it is empty the writer
+sleeps on a condition variable and the first producer to commit afterwards wakes it.
+
+The per-thread record buffer is shared by every sink of the same character type, so do not print to one sink from
+inside the formatting of a record for another.
+*/
+
+#if ((__STDC_HOSTED__==1 && (!defined(_GLIBCXX_HOSTED) || _GLIBCXX_HOSTED==1) && !defined(_LIBCPP_FREESTANDING)) || defined(FAST_IO_ENABLE_HOSTED_FEATURES)) && !defined(__SINGLE_THREAD__) && !defined(_WIN32) && __has_include(<pthread.h>) && __has_include(<sched.h>)
+#include<pthread.h>
+#include<sched.h>
+#define FAST_IO_MPSC_LOG_SINK_HAS_THREADS
+#endif
+
+#if defined(FAST_IO_MPSC_LOG_SINK_HAS_THREADS)
+
+namespace fast_io
+{
+
+inline constexpr std::size_t mpsc_log_sink_default_ring_size{static_cast<std::size_t>(1)<<22u};
+
+/*
+IOV_MAX on Linux and the BSDs.
+*/
+inline constexpr std::size_t mpsc_log_sink_max_batch{1024};
+
+namespace details
+{
+
+/*
+A header word is (size<<3)|kind and never zero once committed. size is the payload in bytes for records and the
+skipped span in words for padding, which fills the end of the ring when a record does not fit before the wrap.
+*/
+inline constexpr std::uint_least64_t mpsc_log_record_inline{1};
+inline constexpr std::uint_least64_t mpsc_log_record_indirect{2};
+inline constexpr std::uint_least64_t mpsc_log_record_padding{3};
+inline constexpr std::uint_least64_t mpsc_log_record_flush{4};
+
+inline constexpr std::size_t mpsc_log_record_words(std::size_t bytes) noexcept
+{
+	return 1u+(bytes+7u)/8u;
+}
+
+inline constexpr std::size_t mpsc_log_writer_spins{16};
+
+template<std::integral char_type>
+inline ::fast_io::dynamic_io_buffer<char_type,::fast_io::native_global_allocator>& mpsc_log_record_buffer() noexcept
+{
+	thread_local ::fast_io::dynamic_io_buffer<char_type,::fast_io::native_global_allocator> buffer;
+	if(buffer.buffer_begin==nullptr)[[unlikely]]
+	{
+		oreserve(buffer,256u/sizeof(char_type));
+	}
+	return buffer;
+}
+
+/*
+Out of the class so the sink's own flush() does not hide the handle's.
+*/
+template<typename T>
+inline void mpsc_log_sink_flush_handle(T& handle)
+{
+	flush(handle);
+}
+
+template<typename sink_type>
+inline void* mpsc_log_sink_writer_routine(void* arg) noexcept
+{
+	static_cast<sink_type*>(arg)->writer_loop();
+	return nullptr;
+}
+
+}
+
+template<output_stream T,std::size_t ring_size=mpsc_log_sink_default_ring_size>
+requires (4096u<=ring_size&&(ring_size&(ring_size-1u))==0)
+class basic_mpsc_log_sink
+{
+public:
+	using handle_type = T;
+	using char_type = typename handle_type::char_type;
+	using unlocked_handle_type = ::fast_io::dynamic_io_buffer<char_type,::fast_io::native_global_allocator>;
+	using word_allocator = ::fast_io::native_typed_global_allocator<std::uint_least64_t>;
+	using byte_allocator = ::fast_io::native_typed_global_allocator<std::byte>;
+	static inline constexpr std::size_t ring_words{ring_size/8u};
+	/*
+	Larger records go through the heap so one record never needs more than an eighth of the ring.
+	*/
+	static inline constexpr std::size_t max_inline_bytes{ring_size/8u};
+
+	/*
+	Only the writer thread touches handle while the sink is alive.
+	*/
+	T handle;
+private:
+	std::uint_least64_t* ring{};
+	alignas(64) std::size_t head{};
+	alignas(64) std::size_t tail{};
+	alignas(64) bool sleeping{};
+	bool stopping{};
+	bool failed{};
+	::fast_io::error failure{};
+	::pthread_mutex_t mutex;
+	::pthread_cond_t cond;
+	::pthread_t writer;
+public:
+	template<typename... Args>
+	requires std::constructible_from<T,Args...>
+	explicit basic_mpsc_log_sink(Args&& ...args):handle(::std::forward<Args>(args)...)
+	{
+		ring=word_allocator::allocate(ring_words);
+		::fast_io::details::my_memset(ring,0,ring_size);
+		noexcept_call(::pthread_mutex_init,__builtin_addressof(mutex),nullptr);
+		noexcept_call(::pthread_cond_init,__builtin_addressof(cond),nullptr);
+		int const ret{noexcept_call(::pthread_create,__builtin_addressof(writer),nullptr,
+			::fast_io::details::mpsc_log_sink_writer_routine<basic_mpsc_log_sink>,this)};
+		if(ret)[[unlikely]]
+		{
+			this->release_resources();
+			throw_posix_error(ret);
+		}
+	}
+	basic_mpsc_log_sink(basic_mpsc_log_sink const&)=delete;
+	basic_mpsc_log_sink& operator=(basic_mpsc_log_sink const&)=delete;
+	/*
+	Every record published before destruction reaches handle. No thread may still be printing to the sink.
+	*/
+	~basic_mpsc_log_sink()
+	{
+		__atomic_store_n(__builtin_addressof(stopping),true,__ATOMIC_RELEASE);
+		noexcept_call(::pthread_mutex_lock,__builtin_addressof(mutex));
+		noexcept_call(::pthread_cond_signal,__builtin_addressof(cond));
+		noexcept_call(::pthread_mutex_unlock,__builtin_addressof(mutex));
+		noexcept_call(::pthread_join,writer,nullptr);
+		this->release_resources();
+	}
+
+	/*
+	lock() opens a record in the calling thread's buffer, unlocked_handle() is that buffer and unlock() publishes it.
+	*/
+	inline void lock() noexcept
+	{
+		auto& buffer{::fast_io::details::mpsc_log_record_buffer<char_type>()};
+		buffer.buffer_curr=buffer.buffer_begin;
+	}
+	inline unlocked_handle_type& unlocked_handle() noexcept
+	{
+		return ::fast_io::details::mpsc_log_record_buffer<char_type>();
+	}
+	inline void unlock() noexcept
+	{
+		auto& buffer{::fast_io::details::mpsc_log_record_buffer<char_type>()};
+		this->publish(buffer.buffer_begin,static_cast<std::size_t>(buffer.buffer_curr-buffer.buffer_begin)*sizeof(char_type));
+	}
+
+	inline void publish(void const* data,std::size_t bytes) noexcept
+	{
+		if(bytes==0)
+			return;
+		if(max_inline_bytes<bytes)[[unlikely]]
+		{
+			this->publish_indirect(data,bytes);
+			return;
+		}
+		std::uint_least64_t* rec{ring+(this->reserve(::fast_io::details::mpsc_log_record_words(bytes))&(ring_words-1u))};
+		::fast_io::details::my_memcpy(rec+1,data,bytes);
+		this->commit(rec,(static_cast<std::uint_least64_t>(bytes)<<3u)|::fast_io::details::mpsc_log_record_inline);
+	}
+
+	/*
+	Waits until everything the calling thread published before the call has been written, then flushes handle from
+	the writer thread. Rethrows the first error the writer hit.
+	*/
+	inline void flush()
+	{
+		std::size_t const pos{this->reserve(1u)};
+		this->commit(ring+(pos&(ring_words-1u)),::fast_io::details::mpsc_log_record_flush);
+		while(static_cast<std::ptrdiff_t>(__atomic_load_n(__builtin_addressof(tail),__ATOMIC_ACQUIRE)-pos)<=0)
+		{
+			noexcept_call(::sched_yield);
+		}
+		if(__atomic_load_n(__builtin_addressof(failed),__ATOMIC_ACQUIRE))[[unlikely]]
+		{
+#ifdef __cpp_exceptions
+			throw failure;
+#else
+			fast_terminate();
+#endif
+		}
+	}
+
+	inline void writer_loop() noexcept
+	{
+		std::size_t idle{};
+		for(;;)
+		{
+			if(this->drain())
+			{
+				idle=0;
+				continue;
+			}
+			if(__atomic_load_n(__builtin_addressof(stopping),__ATOMIC_ACQUIRE))
+			{
+				if(!this->drain())
+					return;
+				continue;
+			}
+			if(idle!=::fast_io::details::mpsc_log_writer_spins)
+			{
+				++idle;
+				noexcept_call(::sched_yield);
+				continue;
+			}
+			idle=0;
+			noexcept_call(::pthread_mutex_lock,__builtin_addressof(mutex));
+			__atomic_store_n(__builtin_addressof(sleeping),true,__ATOMIC_RELAXED);
+			__atomic_thread_fence(__ATOMIC_SEQ_CST);
+			if(!this->committed_at_tail()&&!__atomic_load_n(__builtin_addressof(stopping),__ATOMIC_ACQUIRE))
+			{
+				noexcept_call(::pthread_cond_wait,__builtin_addressof(cond),__builtin_addressof(mutex));
+			}
+			__atomic_store_n(__builtin_addressof(sleeping),false,__ATOMIC_RELAXED);
+			noexcept_call(::pthread_mutex_unlock,__builtin_addressof(mutex));
+		}
+	}
+
+private:
+	inline void release_resources() noexcept
+	{
+		noexcept_call(::pthread_cond_destroy,__builtin_addressof(cond));
+		noexcept_call(::pthread_mutex_destroy,__builtin_addressof(mutex));
+		word_allocator::deallocate_n(ring,ring_words);
+	}
+
+	/*
+	Claims words contiguous words and returns the position they start at. A claim that would cross the end of the ring also
+	claims the rest of this lap and commits it as padding.
+	*/
+	inline std::size_t reserve(std::size_t words) noexcept
+	{
+		std::size_t pos{__atomic_load_n(__builtin_addressof(head),__ATOMIC_RELAXED)};
+		for(;;)
+		{
+			std::size_t const off{pos&(ring_words-1u)};
+			std::size_t const room{ring_words-off};
+			std::size_t const total{words<=room?words:room+words};
+			/*
+			Acquire pairs with the writer's release of tail, after which the words behind tail are zero.
+			*/
+			std::size_t const t{__atomic_load_n(__builtin_addressof(tail),__ATOMIC_ACQUIRE)};
+			if(ring_words-(pos-t)<total)
+			{
+				this->wake_writer();
+				noexcept_call(::sched_yield);
+				pos=__atomic_load_n(__builtin_addressof(head),__ATOMIC_RELAXED);
+				continue;
+			}
+			if(__atomic_compare_exchange_n(__builtin_addressof(head),__builtin_addressof(pos),pos+total,true,__ATOMIC_RELAXED,__ATOMIC_RELAXED))
+			{
+				if(words<=room)
+					return pos;
+				this->commit(ring+off,(static_cast<std::uint_least64_t>(room)<<3u)|::fast_io::details::mpsc_log_record_padding);
+				return pos+room;
+			}
+		}
+	}
+
+	inline void commit(std::uint_least64_t* rec,std::uint_least64_t header) noexcept
+	{
+		__atomic_store_n(rec,header,__ATOMIC_RELEASE);
+		this->wake_writer();
+	}
+
+	/*
+	The fence orders the header store before the sleeping load, and the writer's sleeping store before its header
+	load, so either the writer sees the record or this thread sees it asleep.
+	*/
+	inline void wake_writer() noexcept
+	{
+		__atomic_thread_fence(__ATOMIC_SEQ_CST);
+		if(__atomic_load_n(__builtin_addressof(sleeping),__ATOMIC_RELAXED)&&
+			__atomic_exchange_n(__builtin_addressof(sleeping),false,__ATOMIC_RELAXED))
+		{
+			noexcept_call(::pthread_mutex_lock,__builtin_addressof(mutex));
+			noexcept_call(::pthread_cond_signal,__builtin_addressof(cond));
+			noexcept_call(::pthread_mutex_unlock,__builtin_addressof(mutex));
+		}
+	}
+
+#if __has_cpp_attribute(__gnu__::__cold__)
+	[[__gnu__::__cold__]]
+#endif
+	inline void publish_indirect(void const* data,std::size_t bytes) noexcept
+	{
+		std::byte* copy{byte_allocator::allocate(bytes)};
+		::fast_io::details::my_memcpy(copy,data,bytes);
+		std::uint_least64_t* rec{ring+(this->reserve(::fast_io::details::mpsc_log_record_words(sizeof(copy)))&(ring_words-1u))};
+		::fast_io::details::my_memcpy(rec+1,__builtin_addressof(copy),sizeof(copy));
+		this->commit(rec,(static_cast<std::uint_least64_t>(bytes)<<3u)|::fast_io::details::mpsc_log_record_indirect);
+	}
+
+	inline bool committed_at_tail() const noexcept
+	{
+		return __atomic_load_n(ring+(tail&(ring_words-1u)),__ATOMIC_ACQUIRE)!=0;
+	}
+
+	inline void write_batch(io_scatter_t const* scatters,std::size_t n)
+	{
+		if constexpr(scatter_output_stream<T>)
+		{
+			while(n)
+			{
+				io_scatter_status_t const ret{scatter_write(handle,io_scatters_t{scatters,n})};
+				if(ret.position==n)
+					return;
+				scatters+=ret.position;
+				n-=ret.position;
+				if(ret.position_in_scatter)
+				{
+					auto const first{reinterpret_cast<char_type const*>(scatters->base)};
+					write(handle,first+ret.position_in_scatter/sizeof(char_type),first+scatters->len/sizeof(char_type));
+					++scatters;
+					--n;
+				}
+			}
+		}
+		else
+		{
+			for(io_scatter_t const* i{scatters},*e{scatters+n};i!=e;++i)
+			{
+				auto const first{reinterpret_cast<char_type const*>(i->base)};
+				write(handle,first,first+i->len/sizeof(char_type));
+			}
+		}
+	}
+
+	/*
+	Writes one batch of committed records and retires them. Returns false when there was nothing to do.
+	*/
+	inline bool drain() noexcept
+	{
+		std::size_t const start{tail};
+		std::size_t pos{start};
+		io_scatter_t scatters[mpsc_log_sink_max_batch];
+		std::size_t n{};
+		bool flush_requested{};
+		/*
+		A full ring wraps straight back onto start, whose header is still committed.
+		*/
+		while(n!=mpsc_log_sink_max_batch&&pos-start!=ring_words)
+		{
+			std::uint_least64_t* rec{ring+(pos&(ring_words-1u))};
+			std::uint_least64_t const header{__atomic_load_n(rec,__ATOMIC_ACQUIRE)};
+			if(header==0)
+				break;
+			std::size_t const size{static_cast<std::size_t>(header>>3u)};
+			std::uint_least64_t const kind{header&7u};
+			if(kind==::fast_io::details::mpsc_log_record_padding)
+			{
+				pos+=size;
+				continue;
+			}
+			if(kind==::fast_io::details::mpsc_log_record_flush)
+			{
+				++pos;
+				flush_requested=true;
+				break;
+			}
+			if(kind==::fast_io::details::mpsc_log_record_inline)
+			{
+				scatters[n]={rec+1,size};
+				pos+=::fast_io::details::mpsc_log_record_words(size);
+			}
+			else
+			{
+				std::byte const* copy;
+				::fast_io::details::my_memcpy(__builtin_addressof(copy),rec+1,sizeof(copy));
+				scatters[n]={copy,size};
+				pos+=::fast_io::details::mpsc_log_record_words(sizeof(copy));
+			}
+			++n;
+		}
+		if(pos==start)
+			return false;
+		if(!__atomic_load_n(__builtin_addressof(failed),__ATOMIC_RELAXED))
+		{
+#ifdef __cpp_exceptions
+			try
+			{
+#endif
+				this->write_batch(scatters,n);
+				if(flush_requested)
+				{
+					if constexpr(flush_output_stream<T>)
+					{
+						::fast_io::details::mpsc_log_sink_flush_handle(handle);
+					}
+				}
+#ifdef __cpp_exceptions
+			}
+			catch(::fast_io::error e)
+			{
+				failure=e;
+				__atomic_store_n(__builtin_addressof(failed),true,__ATOMIC_RELEASE);
+			}
+#endif
+		}
+		this->retire(start,pos);
+		__atomic_store_n(__builtin_addressof(tail),pos,__ATOMIC_RELEASE);
+		return true;
+	}
+
+	/*
+	Frees heap copies and zeroes [first,last) so the words read as uncommitted on the next lap.
+	*/
+	inline void retire(std::size_t first,std::size_t last) noexcept
+	{
+		for(std::size_t pos{first};pos!=last;)
+		{
+			std::uint_least64_t* rec{ring+(pos&(ring_words-1u))};
+			std::uint_least64_t const header{*rec};
+			std::size_t const size{static_cast<std::size_t>(header>>3u)};
+			std::uint_least64_t const kind{header&7u};
+			if(kind==::fast_io::details::mpsc_log_record_padding)
+			{
+				pos+=size;
+			}
+			else if(kind==::fast_io::details::mpsc_log_record_flush)
+			{
+				++pos;
+			}
+			else if(kind==::fast_io::details::mpsc_log_record_inline)
+			{
+				pos+=::fast_io::details::mpsc_log_record_words(size);
+			}
+			else
+			{
+				std::byte* copy;
+				::fast_io::details::my_memcpy(__builtin_addressof(copy),rec+1,sizeof(copy));
+				byte_allocator::deallocate_n(copy,size);
+				pos+=::fast_io::details::mpsc_log_record_words(sizeof(copy));
+			}
+		}
+		std::size_t const off{first&(ring_words-1u)};
+		std::size_t const words{last-first};
+		if(ring_words-off<words)
+		{
+			::fast_io::details::my_memset(ring+off,0,(ring_words-off)*sizeof(std::uint_least64_t));
+			::fast_io::details::my_memset(ring,0,(words-(ring_words-off))*sizeof(std::uint_least64_t));
+		}
+		else
+		{
+			::fast_io::details::my_memset(ring+off,0,words*sizeof(std::uint_least64_t));
+		}
+	}
+};
+
+template<output_stream T,std::size_t ring_size,::std::contiguous_iterator Iter>
+requires std::same_as<typename T::char_type,::std::iter_value_t<Iter>>
+inline void write(basic_mpsc_log_sink<T,ring_size>& sink,Iter first,Iter last) noexcept
+{
+	sink.publish(::std::to_address(first),static_cast<std::size_t>(last-first)*sizeof(typename T::char_type));
+}
+
+template<output_stream T,std::size_t ring_size>
+inline void flush(basic_mpsc_log_sink<T,ring_size>& sink)
+{
+	sink.flush();
+}
+
+}
+
+#endif
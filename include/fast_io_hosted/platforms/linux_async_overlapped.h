@@ -0,0 +1,63 @@
+#pragma once
+
+namespace fast_io
+{
+
+namespace details
+{
+
+/*
+Type erased completion callback, shared by linux_io_uring_scheduler (the sqe's user_data points to it) and
+linux_epoll_scheduler. Callbacks receive the number of bytes transferred and the errno value of the operation
+(0 for success), which is the contract async_coro.h expects.
+*/
+struct linux_async_overlapped_base
+{
+	virtual void invoke(std::size_t,int) noexcept = 0;
+	virtual ~linux_async_overlapped_base() = default;
+};
+
+template<typename Func>
+struct linux_async_overlapped_derived final:linux_async_overlapped_base
+{
+	Func func;
+	template<typename... Args>
+	requires std::constructible_from<Func,Args...>
+	explicit linux_async_overlapped_derived(Args&& ...args):func(::std::forward<Args>(args)...){}
+	void invoke(std::size_t transferred,int err) noexcept override
+	{
+		func(transferred,err);
+	}
+};
+
+}
+
+class linux_async_overlapped
+{
+public:
+	details::linux_async_overlapped_base* ptr{};
+	constexpr linux_async_overlapped() noexcept = default;
+	template<typename Func>
+	requires (!std::same_as<std::remove_cvref_t<Func>,linux_async_overlapped>)
+	explicit linux_async_overlapped(std::in_place_t,Func&& func):
+		ptr(new details::linux_async_overlapped_derived<std::remove_cvref_t<Func>>(::std::forward<Func>(func))){}
+	linux_async_overlapped(linux_async_overlapped const&)=delete;
+	linux_async_overlapped& operator=(linux_async_overlapped const&)=delete;
+	constexpr linux_async_overlapped(linux_async_overlapped&& __restrict other) noexcept:ptr(other.ptr)
+	{
+		other.ptr=nullptr;
+	}
+	linux_async_overlapped& operator=(linux_async_overlapped&& __restrict other) noexcept
+	{
+		delete ptr;
+		ptr=other.ptr;
+		other.ptr=nullptr;
+		return *this;
+	}
+	~linux_async_overlapped()
+	{
+		delete ptr;
+	}
+};
+
+}
@@ -0,0 +1,464 @@
+﻿#pragma once
+#include<sys/epoll.h>
+
+/*
+Readiness based fallback for kernels or sandboxes where io_uring is unavailable.
+One linux_epoll_scheduler is one edge-triggered reactor. It is not thread safe; use one per thread.
+Pollable descriptors (sockets, pipes, ttys) are switched to O_NONBLOCK on first use. The flag lives on the open file
+description, so other holders of the file see it too, and it is not restored. Every operation is tried immediately
+and only parked on the descriptor's wait queue on EAGAIN. Descriptors epoll refuses (regular files) are serviced
+synchronously and their completions delivered from the next io_async_wait, so callers see the same callback contract
+as linux_io_uring_scheduler. State is kept per descriptor number and checked again whenever the descriptor has nothing
+parked, so a number closed without cancel() and reused is registered afresh.
+*/
+
+namespace fast_io
+{
+
+namespace details
+{
+
+enum class linux_epoll_operation_kind:char unsigned
+{
+read,write,scatter_read,scatter_write,accept
+};
+
+struct linux_epoll_operation
+{
+	linux_epoll_operation* next;
+	linux_async_overlapped_base* callback;
+	void const* base;
+	std::size_t len;
+	std::ptrdiff_t offset;
+	std::size_t transferred;
+	int err;
+	int fd;
+	linux_epoll_operation_kind kind;
+};
+
+struct linux_epoll_operation_queue
+{
+	linux_epoll_operation* head;
+	linux_epoll_operation* tail;
+};
+
+inline constexpr void linux_epoll_queue_push(linux_epoll_operation_queue& q,linux_epoll_operation* op) noexcept
+{
+	op->next=nullptr;
+	if(q.tail)
+		q.tail->next=op;
+	else
+		q.head=op;
+	q.tail=op;
+}
+
+inline constexpr linux_epoll_operation* linux_epoll_queue_pop(linux_epoll_operation_queue& q) noexcept
+{
+	auto op{q.head};
+	if(op)
+	{
+		q.head=op->next;
+		if(q.head==nullptr)
+			q.tail=nullptr;
+	}
+	return op;
+}
+
+enum class linux_epoll_fd_registration:char unsigned
+{
+none,pollable,unpollable
+};
+
+struct linux_epoll_fd_state
+{
+	linux_epoll_operation_queue read_queue;
+	linux_epoll_operation_queue write_queue;
+	linux_epoll_fd_registration registration;
+};
+
+/*
+Returns the raw syscall result: non negative on success, -errno on failure.
+*/
+inline std::ptrdiff_t linux_epoll_perform_operation(linux_epoll_operation const& op,bool pollable) noexcept
+{
+	switch(op.kind)
+	{
+	case linux_epoll_operation_kind::read:
+		if(!pollable&&op.offset!=-1)
+			return system_call<__NR_pread64,std::ptrdiff_t>(op.fd,op.base,op.len,op.offset);
+		return system_call<__NR_read,std::ptrdiff_t>(op.fd,op.base,op.len);
+	case linux_epoll_operation_kind::write:
+		if(!pollable&&op.offset!=-1)
+			return system_call<__NR_pwrite64,std::ptrdiff_t>(op.fd,op.base,op.len,op.offset);
+		return system_call<__NR_write,std::ptrdiff_t>(op.fd,op.base,op.len);
+	case linux_epoll_operation_kind::scatter_read:
+		if(!pollable&&op.offset!=-1)
+			return system_call<__NR_preadv,std::ptrdiff_t>(op.fd,op.base,op.len,op.offset,0);
+		return system_call<__NR_readv,std::ptrdiff_t>(op.fd,op.base,op.len);
+	case linux_epoll_operation_kind::scatter_write:
+		if(!pollable&&op.offset!=-1)
+			return system_call<__NR_pwritev,std::ptrdiff_t>(op.fd,op.base,op.len,op.offset,0);
+		return system_call<__NR_writev,std::ptrdiff_t>(op.fd,op.base,op.len);
+	default:
+		return system_call<__NR_accept4,std::ptrdiff_t>(op.fd,nullptr,nullptr,SOCK_CLOEXEC);
+	}
+}
+
+}
+
+class linux_epoll_scheduler
+{
+public:
+	using native_handle_type = int;
+	int fd{-1};
+	details::linux_epoll_fd_state* fd_states{};
+	std::size_t fd_states_size{};
+	details::linux_epoll_operation* free_operations{};
+	details::linux_epoll_operation_queue ready_queue{};
+	constexpr linux_epoll_scheduler() noexcept = default;
+	explicit linux_epoll_scheduler(io_async_t):fd(system_call<__NR_epoll_create1,int>(EPOLL_CLOEXEC))
+	{
+		system_call_throw_error(fd);
+	}
+	linux_epoll_scheduler(linux_epoll_scheduler const&)=delete;
+	linux_epoll_scheduler& operator=(linux_epoll_scheduler const&)=delete;
+	constexpr linux_epoll_scheduler(linux_epoll_scheduler&& __restrict other) noexcept:
+		fd(other.fd),fd_states(other.fd_states),fd_states_size(other.fd_states_size),
+		free_operations(other.free_operations),ready_queue(other.ready_queue)
+	{
+		other.fd=-1;
+		other.fd_states=nullptr;
+		other.fd_states_size=0;
+		other.free_operations=nullptr;
+		other.ready_queue={};
+	}
+	linux_epoll_scheduler& operator=(linux_epoll_scheduler&& __restrict other) noexcept
+	{
+		close_impl();
+		fd=other.fd;
+		fd_states=other.fd_states;
+		fd_states_size=other.fd_states_size;
+		free_operations=other.free_operations;
+		ready_queue=other.ready_queue;
+		other.fd=-1;
+		other.fd_states=nullptr;
+		other.fd_states_size=0;
+		other.free_operations=nullptr;
+		other.ready_queue={};
+		return *this;
+	}
+	constexpr native_handle_type native_handle() const noexcept
+	{
+		return fd;
+	}
+	explicit constexpr operator bool() const noexcept
+	{
+		return fd!=-1;
+	}
+	void close()
+	{
+		if(fd!=-1)[[likely]]
+		{
+			release_memory();
+			details::sys_close_throw_error(fd);
+		}
+	}
+	~linux_epoll_scheduler()
+	{
+		close_impl();
+	}
+	/*
+	Queues an operation. It is attempted right away; on success or a hard error the completion is delivered from the
+	next io_async_wait/io_async_poll rather than reentrantly from here.
+	*/
+	void submit(details::linux_epoll_operation_kind kind,int target_fd,void const* base,std::size_t len,
+		linux_async_overlapped& overlapped,std::ptrdiff_t offset)
+	{
+		auto& state{fd_state(target_fd)};
+		auto op{allocate_operation()};
+		*op={nullptr,overlapped.ptr,base,len,offset,0,0,target_fd,kind};
+		bool const is_read{kind==details::linux_epoll_operation_kind::read||
+			kind==details::linux_epoll_operation_kind::scatter_read||
+			kind==details::linux_epoll_operation_kind::accept};
+		auto& q{is_read?state.read_queue:state.write_queue};
+		if(state.registration==details::linux_epoll_fd_registration::pollable&&q.head)
+		{
+			//preserve ordering behind operations already waiting for readiness
+			details::linux_epoll_queue_push(q,op);
+			return;
+		}
+		if(try_complete(*op,state.registration==details::linux_epoll_fd_registration::pollable))
+			details::linux_epoll_queue_push(ready_queue,op);
+		else
+			details::linux_epoll_queue_push(q,op);
+	}
+	/*
+	Delivers completions. timeout follows epoll_wait: -1 blocks until at least one completion, 0 never blocks.
+	Returns the number of completion callbacks invoked.
+	*/
+	std::size_t run_once(int timeout)
+	{
+		std::size_t completed{drain_ready()};
+		if(completed)
+			return completed;
+		constexpr std::size_t max_events{64};
+		::epoll_event events[max_events];
+		for(;;)
+		{
+			int ret{system_call<__NR_epoll_pwait,int>(fd,events,static_cast<int>(max_events),timeout,nullptr,static_cast<std::size_t>(0))};
+			if(ret==-EINTR)
+				continue;
+			system_call_throw_error(ret);
+			for(int i{};i!=ret;++i)
+			{
+				auto const& ev{events[i]};
+				int const evfd{ev.data.fd};
+				std::uint_least32_t const evs{ev.events};
+				bool const failure{(evs&(EPOLLERR|EPOLLHUP))!=0};
+				if((evs&(EPOLLIN|EPOLLRDHUP))!=0||failure)
+					completed+=process_queue(evfd,true);
+				if((evs&EPOLLOUT)!=0||failure)
+					completed+=process_queue(evfd,false);
+			}
+			completed+=drain_ready();
+			if(completed||timeout!=-1)
+				return completed;
+		}
+	}
+	/*
+	Forgets a descriptor before it is closed. Pending operations on it complete with ECANCELED.
+	*/
+	void cancel(int target_fd)
+	{
+		if(target_fd<0||fd_states_size<=static_cast<std::size_t>(target_fd))
+			return;
+		auto& state{fd_states[target_fd]};
+		for(auto q:{&state.read_queue,&state.write_queue})
+		{
+			for(details::linux_epoll_operation* op;(op=details::linux_epoll_queue_pop(*q));)
+			{
+				op->err=ECANCELED;
+				details::linux_epoll_queue_push(ready_queue,op);
+			}
+		}
+		if(state.registration==details::linux_epoll_fd_registration::pollable)
+			system_call<__NR_epoll_ctl,int>(fd,EPOLL_CTL_DEL,target_fd,nullptr);
+		state.registration=details::linux_epoll_fd_registration::none;
+	}
+private:
+	details::linux_epoll_fd_state& fd_state(int target_fd)
+	{
+		if(target_fd<0)
+			throw_posix_error(EBADF);
+		std::size_t const pos{static_cast<std::size_t>(target_fd)};
+		if(fd_states_size<=pos)
+		{
+			std::size_t new_size{fd_states_size?fd_states_size:64};
+			for(;new_size<=pos;new_size<<=1);
+			fd_states=::fast_io::native_typed_global_allocator<details::linux_epoll_fd_state>::reallocate_zero_n(fd_states,fd_states_size,new_size);
+			fd_states_size=new_size;
+		}
+		auto& state{fd_states[pos]};
+		if(state.registration==details::linux_epoll_fd_registration::none||
+			(state.read_queue.head==nullptr&&state.write_queue.head==nullptr))
+			refresh_fd(target_fd,state);
+		return state;
+	}
+	static constexpr ::epoll_event fd_event(int target_fd) noexcept
+	{
+		::epoll_event ev{};
+		ev.events=EPOLLIN|EPOLLOUT|EPOLLRDHUP|EPOLLET;
+		ev.data.fd=target_fd;
+		return ev;
+	}
+	/*
+	Adds target_fd to the epoll set and sets O_NONBLOCK on it, which changes the caller's file for everyone sharing
+	its open file description. epoll refusing the file (EPERM) marks it unpollable instead.
+	*/
+	void register_fd(int target_fd,details::linux_epoll_fd_state& state)
+	{
+		::epoll_event ev{fd_event(target_fd)};
+		int ret{system_call<__NR_epoll_ctl,int>(fd,EPOLL_CTL_ADD,target_fd,__builtin_addressof(ev))};
+		if(ret==-EPERM)
+		{
+			state.registration=details::linux_epoll_fd_registration::unpollable;
+			return;
+		}
+		if(ret!=-EEXIST)
+			system_call_throw_error(ret);
+		int flags{system_call<__NR_fcntl,int>(target_fd,F_GETFL,0)};
+		system_call_throw_error(flags);
+		if((flags&O_NONBLOCK)!=O_NONBLOCK)
+			system_call_throw_error(system_call<__NR_fcntl,int>(target_fd,F_SETFL,flags|O_NONBLOCK));
+		state.registration=details::linux_epoll_fd_registration::pollable;
+	}
+	/*
+	An idle descriptor may have been closed and its number reused since it was registered; the kernel drops a closed
+	file from the epoll set by itself. EPOLL_CTL_MOD on a registered one re-arms the edge trigger and fails with
+	ENOENT (or EPERM for a regular file) for a different file, which is then registered, and made non-blocking, like
+	a new one. This costs one epoll_ctl per operation submitted to an idle descriptor.
+	*/
+	void refresh_fd(int target_fd,details::linux_epoll_fd_state& state)
+	{
+		if(state.registration==details::linux_epoll_fd_registration::pollable)
+		{
+			::epoll_event ev{fd_event(target_fd)};
+			int ret{system_call<__NR_epoll_ctl,int>(fd,EPOLL_CTL_MOD,target_fd,__builtin_addressof(ev))};
+			if(ret!=-ENOENT&&ret!=-EPERM)
+			{
+				system_call_throw_error(ret);
+				return;
+			}
+		}
+		register_fd(target_fd,state);
+	}
+	static bool try_complete(details::linux_epoll_operation& op,bool pollable) noexcept
+	{
+		for(;;)
+		{
+			std::ptrdiff_t ret{details::linux_epoll_perform_operation(op,pollable)};
+			if(ret==-EINTR)
+				continue;
+			if(ret==-EAGAIN)
+				return false;
+			if(linux_system_call_fails(ret))
+				op.err=static_cast<int>(-ret);
+			else
+				op.transferred=static_cast<std::size_t>(ret);
+			return true;
+		}
+	}
+	std::size_t process_queue(int evfd,bool is_read) noexcept
+	{
+		if(evfd<0||fd_states_size<=static_cast<std::size_t>(evfd))
+			return 0;
+		std::size_t completed{};
+		for(;;)
+		{
+			auto& state{fd_states[evfd]};
+			auto& q{is_read?state.read_queue:state.write_queue};
+			auto op{q.head};
+			if(op==nullptr||!try_complete(*op,true))
+				break;
+			details::linux_epoll_queue_pop(q);
+			complete(op);
+			++completed;
+		}
+		return completed;
+	}
+	std::size_t drain_ready() noexcept
+	{
+		std::size_t completed{};
+		for(details::linux_epoll_operation* op;(op=details::linux_epoll_queue_pop(ready_queue));++completed)
+			complete(op);
+		return completed;
+	}
+	void complete(details::linux_epoll_operation* op) noexcept
+	{
+		auto callback{op->callback};
+		std::size_t const transferred{op->transferred};
+		int const err{op->err};
+		op->next=free_operations;
+		free_operations=op;
+		if(callback)
+			callback->invoke(transferred,err);
+	}
+	details::linux_epoll_operation* allocate_operation() noexcept
+	{
+		auto op{free_operations};
+		if(op)
+		{
+			free_operations=op->next;
+			return op;
+		}
+		return ::fast_io::native_typed_global_allocator<details::linux_epoll_operation>::allocate(1);
+	}
+	void release_memory() noexcept
+	{
+		using op_allocator = ::fast_io::native_typed_global_allocator<details::linux_epoll_operation>;
+		auto release_queue{[](details::linux_epoll_operation_queue& q) noexcept
+		{
+			for(details::linux_epoll_operation* op;(op=details::linux_epoll_queue_pop(q));)
+				op_allocator::deallocate_n(op,1);
+		}};
+		for(std::size_t i{};i!=fd_states_size;++i)
+		{
+			release_queue(fd_states[i].read_queue);
+			release_queue(fd_states[i].write_queue);
+		}
+		release_queue(ready_queue);
+		for(auto op{free_operations};op;)
+		{
+			auto next{op->next};
+			op_allocator::deallocate_n(op,1);
+			op=next;
+		}
+		free_operations=nullptr;
+		::fast_io::native_typed_global_allocator<details::linux_epoll_fd_state>::deallocate_n(fd_states,fd_states_size);
+		fd_states=nullptr;
+		fd_states_size=0;
+	}
+	void close_impl() noexcept
+	{
+		if(fd!=-1)[[likely]]
+		{
+			release_memory();
+			details::sys_close(fd);
+			fd=-1;
+		}
+	}
+};
+
+inline std::size_t io_async_wait(linux_epoll_scheduler& scheduler)
+{
+	return scheduler.run_once(-1);
+}
+
+inline std::size_t io_async_poll(linux_epoll_scheduler& scheduler)
+{
+	return scheduler.run_once(0);
+}
+
+template<std::integral ch_type,::std::contiguous_iterator Iter>
+inline void async_read_callback(linux_epoll_scheduler& scheduler,basic_posix_io_observer<ch_type> piob,Iter first,Iter last,linux_async_overlapped& overlapped,std::ptrdiff_t offset)
+{
+	scheduler.submit(details::linux_epoll_operation_kind::read,piob.fd,::std::to_address(first),
+		static_cast<std::size_t>(last-first)*sizeof(*first),overlapped,offset);
+}
+
+template<std::integral ch_type,::std::contiguous_iterator Iter>
+inline void async_write_callback(linux_epoll_scheduler& scheduler,basic_posix_io_observer<ch_type> piob,Iter first,Iter last,linux_async_overlapped& overlapped,std::ptrdiff_t offset)
+{
+	scheduler.submit(details::linux_epoll_operation_kind::write,piob.fd,::std::to_address(first),
+		static_cast<std::size_t>(last-first)*sizeof(*first),overlapped,offset);
+}
+
+template<std::integral ch_type>
+inline void async_scatter_read_callback(linux_epoll_scheduler& scheduler,basic_posix_io_observer<ch_type> piob,io_scatters_t scatters,linux_async_overlapped& overlapped,std::ptrdiff_t offset)
+{
+	scheduler.submit(details::linux_epoll_operation_kind::scatter_read,piob.fd,scatters.base,scatters.len,overlapped,offset);
+}
+
+template<std::integral ch_type>
+inline void async_scatter_write_callback(linux_epoll_scheduler& scheduler,basic_posix_io_observer<ch_type> piob,io_scatters_t scatters,linux_async_overlapped& overlapped,std::ptrdiff_t offset)
+{
+	scheduler.submit(details::linux_epoll_operation_kind::scatter_write,piob.fd,scatters.base,scatters.len,overlapped,offset);
+}
+
+/*
+Accepts one connection on a listening socket. The accepted descriptor is reported through the transferred value
+of the callback; wrap it with posix_file_factory to take ownership.
+*/
+template<std::integral ch_type>
+inline void async_accept_callback(linux_epoll_scheduler& scheduler,basic_posix_io_observer<ch_type> listener,linux_async_overlapped& overlapped)
+{
+	scheduler.submit(details::linux_epoll_operation_kind::accept,listener.fd,nullptr,0,overlapped,-1);
+}
+
+template<std::integral ch_type>
+inline void cancel(linux_epoll_scheduler& scheduler,basic_posix_io_observer<ch_type> piob)
+{
+	scheduler.cancel(piob.fd);
+}
+
+}
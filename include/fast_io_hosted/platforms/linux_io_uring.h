@@ -0,0 +1,647 @@
+﻿#pragma once
+/*
+Raw io_uring backend. We do not depend on liburing. The ABI here follows include/uapi/linux/io_uring.h
+https://github.com/torvalds/linux/blob/master/include/uapi/linux/io_uring.h
+*/
+
+namespace fast_io
+{
+
+namespace linux_io_uring
+{
+
+struct io_sqring_offsets
+{
+	std::uint_least32_t head;
+	std::uint_least32_t tail;
+	std::uint_least32_t ring_mask;
+	std::uint_least32_t ring_entries;
+	std::uint_least32_t flags;
+	std::uint_least32_t dropped;
+	std::uint_least32_t array;
+	std::uint_least32_t resv1;
+	std::uint_least64_t user_addr;
+};
+
+struct io_cqring_offsets
+{
+	std::uint_least32_t head;
+	std::uint_least32_t tail;
+	std::uint_least32_t ring_mask;
+	std::uint_least32_t ring_entries;
+	std::uint_least32_t overflow;
+	std::uint_least32_t cqes;
+	std::uint_least32_t flags;
+	std::uint_least32_t resv1;
+	std::uint_least64_t user_addr;
+};
+
+struct io_uring_params
+{
+	std::uint_least32_t sq_entries;
+	std::uint_least32_t cq_entries;
+	std::uint_least32_t flags;
+	std::uint_least32_t sq_thread_cpu;
+	std::uint_least32_t sq_thread_idle;
+	std::uint_least32_t features;
+	std::uint_least32_t wq_fd;
+	std::uint_least32_t resv[3];
+	io_sqring_offsets sq_off;
+	io_cqring_offsets cq_off;
+};
+
+struct io_uring_sqe
+{
+	std::uint_least8_t opcode;
+	std::uint_least8_t flags;
+	std::uint_least16_t ioprio;
+	std::int_least32_t fd;
+	std::uint_least64_t off;
+	std::uint_least64_t addr;
+	std::uint_least32_t len;
+	std::uint_least32_t op_flags;
+	std::uint_least64_t user_data;
+	std::uint_least16_t buf_index;
+	std::uint_least16_t personality;
+	std::int_least32_t splice_fd_in;
+	std::uint_least64_t addr3;
+	std::uint_least64_t pad2;
+};
+
+struct io_uring_cqe
+{
+	std::uint_least64_t user_data;
+	std::int_least32_t res;
+	std::uint_least32_t flags;
+};
+
+static_assert(sizeof(io_uring_sqe)==64);
+static_assert(sizeof(io_uring_cqe)==16);
+static_assert(sizeof(io_uring_params)==120);
+
+enum class opcode:std::uint_least8_t
+{
+nop=0,
+readv=1,
+writev=2,
+fsync=3,
+read_fixed=4,
+write_fixed=5,
+poll_add=6,
+poll_remove=7,
+sync_file_range=8,
+sendmsg=9,
+recvmsg=10,
+timeout=11,
+timeout_remove=12,
+accept=13,
+async_cancel=14,
+link_timeout=15,
+connect=16,
+fallocate=17,
+openat=18,
+close=19,
+files_update=20,
+statx=21,
+read=22,
+write=23,
+fadvise=24,
+madvise=25,
+send=26,
+recv=27
+};
+
+inline constexpr std::uint_least8_t sqe_fixed_file{1u<<0u};
+inline constexpr std::uint_least8_t sqe_io_link{1u<<2u};
+
+inline constexpr std::uint_least32_t setup_sqpoll{1u<<1u};
+inline constexpr std::uint_least32_t sq_need_wakeup{1u<<0u};
+
+inline constexpr std::uint_least32_t feat_single_mmap{1u<<0u};
+inline constexpr std::uint_least32_t feat_nodrop{1u<<1u};
+
+inline constexpr std::uint_least32_t enter_getevents{1u<<0u};
+inline constexpr std::uint_least32_t enter_sq_wakeup{1u<<1u};
+
+inline constexpr std::uint_least64_t off_sq_ring{0};
+inline constexpr std::uint_least64_t off_cq_ring{0x8000000};
+inline constexpr std::uint_least64_t off_sqes{0x10000000};
+
+inline constexpr std::uint_least32_t register_buffers{0};
+inline constexpr std::uint_least32_t unregister_buffers{1};
+inline constexpr std::uint_least32_t register_files{2};
+inline constexpr std::uint_least32_t unregister_files{3};
+
+}
+
+namespace details
+{
+
+inline int linux_io_uring_setup_impl(std::uint_least32_t entries,::fast_io::linux_io_uring::io_uring_params* params) noexcept
+{
+	return system_call<__NR_io_uring_setup,int>(entries,params);
+}
+
+inline int linux_io_uring_enter_impl(int fd,std::uint_least32_t to_submit,std::uint_least32_t min_complete,std::uint_least32_t flags) noexcept
+{
+	return system_call<__NR_io_uring_enter,int>(fd,to_submit,min_complete,flags,nullptr,static_cast<std::size_t>(0));
+}
+
+inline void linux_io_uring_register_impl(int fd,std::uint_least32_t opcode,void const* arg,std::uint_least32_t nr_args)
+{
+	system_call_throw_error(system_call<__NR_io_uring_register,int>(fd,opcode,arg,nr_args));
+}
+
+template<typename T>
+inline T* linux_io_uring_ring_ptr(void* base,std::uint_least32_t offset) noexcept
+{
+	return reinterpret_cast<T*>(reinterpret_cast<char*>(base)+offset);
+}
+
+}
+
+/*
+Registered file handle. Operations on it set IOSQE_FIXED_FILE so the kernel skips the fd table lookup.
+*/
+template<std::integral ch_type>
+struct basic_linux_io_uring_fixed_file
+{
+	using char_type = ch_type;
+	std::uint_least32_t index{};
+};
+
+/*
+Registered buffer index for read_fixed/write_fixed. The range passed to the operation must lie inside the buffer
+registered at this index.
+*/
+struct linux_io_uring_fixed_buffer
+{
+	std::uint_least16_t index{};
+};
+
+class linux_io_uring_scheduler
+{
+public:
+	using native_handle_type = int;
+	int fd{-1};
+	void* sq_ring{};
+	void* cq_ring{};
+	::fast_io::linux_io_uring::io_uring_sqe* sqes{};
+	::fast_io::linux_io_uring::io_uring_cqe* cqes{};
+	std::uint_least32_t* sq_head{};
+	std::uint_least32_t* sq_tail{};
+	std::uint_least32_t* sq_flags{};
+	std::uint_least32_t* sq_array{};
+	std::uint_least32_t* cq_head{};
+	std::uint_least32_t* cq_tail{};
+	std::size_t sq_ring_size{};
+	std::size_t cq_ring_size{};
+	std::size_t sqes_size{};
+	std::uint_least32_t sq_mask{};
+	std::uint_least32_t sq_entries{};
+	std::uint_least32_t cq_mask{};
+	std::uint_least32_t setup_flags{};
+	std::uint_least32_t sqe_local_tail{};
+	std::uint_least32_t sqe_submitted{};
+	constexpr linux_io_uring_scheduler() noexcept = default;
+	explicit linux_io_uring_scheduler(std::uint_least32_t entries,std::uint_least32_t flags=0)
+	{
+		::fast_io::linux_io_uring::io_uring_params params{};
+		params.flags=flags;
+		int ret{details::linux_io_uring_setup_impl(entries,__builtin_addressof(params))};
+		system_call_throw_error(ret);
+		fd=ret;
+		setup_flags=flags;
+#if __cpp_exceptions
+		try
+		{
+#endif
+			map_rings(params);
+#if __cpp_exceptions
+		}
+		catch(...)
+		{
+			close_impl();
+			throw;
+		}
+#endif
+	}
+	linux_io_uring_scheduler(linux_io_uring_scheduler const&)=delete;
+	linux_io_uring_scheduler& operator=(linux_io_uring_scheduler const&)=delete;
+	constexpr linux_io_uring_scheduler(linux_io_uring_scheduler&& __restrict other) noexcept:
+		fd(other.fd),sq_ring(other.sq_ring),cq_ring(other.cq_ring),sqes(other.sqes),cqes(other.cqes),
+		sq_head(other.sq_head),sq_tail(other.sq_tail),sq_flags(other.sq_flags),sq_array(other.sq_array),
+		cq_head(other.cq_head),cq_tail(other.cq_tail),
+		sq_ring_size(other.sq_ring_size),cq_ring_size(other.cq_ring_size),sqes_size(other.sqes_size),
+		sq_mask(other.sq_mask),sq_entries(other.sq_entries),cq_mask(other.cq_mask),setup_flags(other.setup_flags),
+		sqe_local_tail(other.sqe_local_tail),sqe_submitted(other.sqe_submitted)
+	{
+		other.fd=-1;
+		other.sq_ring=nullptr;
+		other.cq_ring=nullptr;
+		other.sqes=nullptr;
+	}
+	linux_io_uring_scheduler& operator=(linux_io_uring_scheduler&& __restrict other) noexcept
+	{
+		close_impl();
+		fd=other.fd;
+		sq_ring=other.sq_ring;
+		cq_ring=other.cq_ring;
+		sqes=other.sqes;
+		cqes=other.cqes;
+		sq_head=other.sq_head;
+		sq_tail=other.sq_tail;
+		sq_flags=other.sq_flags;
+		sq_array=other.sq_array;
+		cq_head=other.cq_head;
+		cq_tail=other.cq_tail;
+		sq_ring_size=other.sq_ring_size;
+		cq_ring_size=other.cq_ring_size;
+		sqes_size=other.sqes_size;
+		sq_mask=other.sq_mask;
+		sq_entries=other.sq_entries;
+		cq_mask=other.cq_mask;
+		setup_flags=other.setup_flags;
+		sqe_local_tail=other.sqe_local_tail;
+		sqe_submitted=other.sqe_submitted;
+		other.fd=-1;
+		other.sq_ring=nullptr;
+		other.cq_ring=nullptr;
+		other.sqes=nullptr;
+		return *this;
+	}
+	constexpr native_handle_type native_handle() const noexcept
+	{
+		return fd;
+	}
+	explicit constexpr operator bool() const noexcept
+	{
+		return fd!=-1;
+	}
+	~linux_io_uring_scheduler()
+	{
+		close_impl();
+	}
+	/*
+	Returns a zeroed submission queue entry. Nothing is submitted to the kernel until submit() or io_async_wait(),
+	so many operations queued between two waits cost one io_uring_enter.
+	*/
+	::fast_io::linux_io_uring::io_uring_sqe* get_sqe()
+	{
+		if(sqe_local_tail-__atomic_load_n(sq_head,__ATOMIC_ACQUIRE)==sq_entries)[[unlikely]]
+		{
+			submit();
+			if(sqe_local_tail-__atomic_load_n(sq_head,__ATOMIC_ACQUIRE)==sq_entries)[[unlikely]]
+				throw_posix_error(EBUSY);
+		}
+		auto sqe{sqes+(sqe_local_tail&sq_mask)};
+		*sqe={};
+		++sqe_local_tail;
+		return sqe;
+	}
+	/*
+	Publishes every queued sqe to the kernel with a single io_uring_enter and returns how many were consumed.
+	*/
+	std::uint_least32_t submit(std::uint_least32_t min_complete=0)
+	{
+		std::uint_least32_t const to_submit{flush_sq()};
+		std::uint_least32_t flags{};
+		if(min_complete)
+			flags|=::fast_io::linux_io_uring::enter_getevents;
+		if((setup_flags&::fast_io::linux_io_uring::setup_sqpoll)==::fast_io::linux_io_uring::setup_sqpoll)
+		{
+			if((__atomic_load_n(sq_flags,__ATOMIC_RELAXED)&::fast_io::linux_io_uring::sq_need_wakeup)==0&&!min_complete)
+				return to_submit;
+			flags|=::fast_io::linux_io_uring::enter_sq_wakeup;
+		}
+		else if(to_submit==0&&!min_complete)
+			return 0;
+		int ret;
+		for(;;)
+		{
+			ret=details::linux_io_uring_enter_impl(fd,to_submit,min_complete,flags);
+			if(ret!=-EINTR)[[likely]]
+				break;
+		}
+		system_call_throw_error(ret);
+		return static_cast<std::uint_least32_t>(ret);
+	}
+	/*
+	Invokes callbacks of all completions currently in the completion queue without entering the kernel.
+	*/
+	std::size_t reap() noexcept
+	{
+		std::size_t reaped{};
+		for(;;)
+		{
+			std::uint_least32_t const head{*cq_head};
+			if(head==__atomic_load_n(cq_tail,__ATOMIC_ACQUIRE))
+				break;
+			auto const& cqe{cqes[head&cq_mask]};
+			auto ovp{reinterpret_cast<details::linux_async_overlapped_base*>(static_cast<std::uintptr_t>(cqe.user_data))};
+			std::int_least32_t const res{cqe.res};
+			/*
+			Publish the head before invoking. The callback may resume a coroutine which queues more work
+			or even calls reap() again.
+			*/
+			__atomic_store_n(cq_head,head+1,__ATOMIC_RELEASE);
+			++reaped;
+			if(ovp==nullptr)
+				continue;
+			if(res<0)
+				ovp->invoke(0,static_cast<int>(-res));
+			else
+				ovp->invoke(static_cast<std::size_t>(static_cast<std::uint_least32_t>(res)),0);
+		}
+		return reaped;
+	}
+	void register_buffers(io_scatters_t buffers)
+	{
+		details::linux_io_uring_register_impl(fd,::fast_io::linux_io_uring::register_buffers,buffers.base,static_cast<std::uint_least32_t>(buffers.len));
+	}
+	void unregister_buffers()
+	{
+		details::linux_io_uring_register_impl(fd,::fast_io::linux_io_uring::unregister_buffers,nullptr,0);
+	}
+	void register_files(int const* fds,std::size_t n)
+	{
+		details::linux_io_uring_register_impl(fd,::fast_io::linux_io_uring::register_files,fds,static_cast<std::uint_least32_t>(n));
+	}
+	void unregister_files()
+	{
+		details::linux_io_uring_register_impl(fd,::fast_io::linux_io_uring::unregister_files,nullptr,0);
+	}
+	void close()
+	{
+		if(fd!=-1)[[likely]]
+		{
+			unmap_rings();
+			/*
+			sys_close_throw_error sets fd to -1 even when close(2) reports an error, so the destructor never closes a
+			descriptor number another thread may have reused since.
+			*/
+			details::sys_close_throw_error(fd);
+		}
+	}
+private:
+	std::uint_least32_t flush_sq() noexcept
+	{
+		std::uint_least32_t tail{*sq_tail};
+		std::uint_least32_t const to_submit{sqe_local_tail-sqe_submitted};
+		for(std::uint_least32_t i{};i!=to_submit;++i)
+		{
+			sq_array[tail&sq_mask]=sqe_submitted&sq_mask;
+			++tail;
+			++sqe_submitted;
+		}
+		__atomic_store_n(sq_tail,tail,__ATOMIC_RELEASE);
+		return to_submit;
+	}
+	void map_rings(::fast_io::linux_io_uring::io_uring_params const& params)
+	{
+		sq_ring_size=params.sq_off.array+params.sq_entries*sizeof(std::uint_least32_t);
+		cq_ring_size=params.cq_off.cqes+params.cq_entries*sizeof(::fast_io::linux_io_uring::io_uring_cqe);
+		bool const single_mmap{(params.features&::fast_io::linux_io_uring::feat_single_mmap)==::fast_io::linux_io_uring::feat_single_mmap};
+		if(single_mmap)
+		{
+			if(sq_ring_size<cq_ring_size)
+				sq_ring_size=cq_ring_size;
+			cq_ring_size=sq_ring_size;
+		}
+		sq_ring=details::sys_mmap(nullptr,sq_ring_size,PROT_READ|PROT_WRITE,MAP_SHARED|MAP_POPULATE,fd,::fast_io::linux_io_uring::off_sq_ring);
+		if(single_mmap)
+			cq_ring=sq_ring;
+		else
+			cq_ring=details::sys_mmap(nullptr,cq_ring_size,PROT_READ|PROT_WRITE,MAP_SHARED|MAP_POPULATE,fd,::fast_io::linux_io_uring::off_cq_ring);
+		sqes_size=params.sq_entries*sizeof(::fast_io::linux_io_uring::io_uring_sqe);
+		sqes=reinterpret_cast<::fast_io::linux_io_uring::io_uring_sqe*>(
+			details::sys_mmap(nullptr,sqes_size,PROT_READ|PROT_WRITE,MAP_SHARED|MAP_POPULATE,fd,::fast_io::linux_io_uring::off_sqes));
+		sq_head=details::linux_io_uring_ring_ptr<std::uint_least32_t>(sq_ring,params.sq_off.head);
+		sq_tail=details::linux_io_uring_ring_ptr<std::uint_least32_t>(sq_ring,params.sq_off.tail);
+		sq_flags=details::linux_io_uring_ring_ptr<std::uint_least32_t>(sq_ring,params.sq_off.flags);
+		sq_array=details::linux_io_uring_ring_ptr<std::uint_least32_t>(sq_ring,params.sq_off.array);
+		sq_mask=*details::linux_io_uring_ring_ptr<std::uint_least32_t>(sq_ring,params.sq_off.ring_mask);
+		sq_entries=*details::linux_io_uring_ring_ptr<std::uint_least32_t>(sq_ring,params.sq_off.ring_entries);
+		cq_head=details::linux_io_uring_ring_ptr<std::uint_least32_t>(cq_ring,params.cq_off.head);
+		cq_tail=details::linux_io_uring_ring_ptr<std::uint_least32_t>(cq_ring,params.cq_off.tail);
+		cq_mask=*details::linux_io_uring_ring_ptr<std::uint_least32_t>(cq_ring,params.cq_off.ring_mask);
+		cqes=details::linux_io_uring_ring_ptr<::fast_io::linux_io_uring::io_uring_cqe>(cq_ring,params.cq_off.cqes);
+		sqe_local_tail=sqe_submitted=*sq_tail;
+	}
+	void unmap_rings() noexcept
+	{
+		if(sqes)
+			details::sys_munmap(sqes,sqes_size);
+		if(cq_ring&&cq_ring!=sq_ring)
+			details::sys_munmap(cq_ring,cq_ring_size);
+		if(sq_ring)
+			details::sys_munmap(sq_ring,sq_ring_size);
+		sqes=nullptr;
+		cqes=nullptr;
+		cq_ring=sq_ring=nullptr;
+		sq_head=sq_tail=sq_flags=sq_array=cq_head=cq_tail=nullptr;
+		sqe_local_tail=sqe_submitted=0;
+	}
+	void close_impl() noexcept
+	{
+		if(fd!=-1)[[likely]]
+		{
+			unmap_rings();
+			details::sys_close(fd);
+			fd=-1;
+		}
+	}
+};
+
+namespace details
+{
+
+inline void linux_io_uring_prep_rw(::fast_io::linux_io_uring::io_uring_sqe* sqe,
+	::fast_io::linux_io_uring::opcode op,int fd,void const* addr,std::size_t len,std::ptrdiff_t offset,
+	linux_async_overlapped& overlapped) noexcept
+{
+	sqe->opcode=static_cast<std::uint_least8_t>(op);
+	sqe->fd=fd;
+	sqe->off=static_cast<std::uint_least64_t>(static_cast<std::int_least64_t>(offset));
+	sqe->addr=static_cast<std::uint_least64_t>(reinterpret_cast<std::uintptr_t>(addr));
+	if constexpr(sizeof(std::uint_least32_t)<sizeof(std::size_t))
+	{
+		if(static_cast<std::size_t>(UINT_LEAST32_MAX)<len)
+			len=static_cast<std::size_t>(UINT_LEAST32_MAX);
+	}
+	sqe->len=static_cast<std::uint_least32_t>(len);
+	sqe->user_data=static_cast<std::uint_least64_t>(reinterpret_cast<std::uintptr_t>(overlapped.ptr));
+}
+
+inline void linux_io_uring_async_io_impl(linux_io_uring_scheduler& scheduler,::fast_io::linux_io_uring::opcode op,
+	int fd,std::uint_least8_t sqe_flags,void const* addr,std::size_t len,linux_async_overlapped& overlapped,std::ptrdiff_t offset)
+{
+	auto sqe{scheduler.get_sqe()};
+	linux_io_uring_prep_rw(sqe,op,fd,addr,len,offset,overlapped);
+	sqe->flags=sqe_flags;
+}
+
+inline void linux_io_uring_async_fixed_io_impl(linux_io_uring_scheduler& scheduler,::fast_io::linux_io_uring::opcode op,
+	int fd,std::uint_least8_t sqe_flags,void const* addr,std::size_t len,std::uint_least16_t buf_index,linux_async_overlapped& overlapped,std::ptrdiff_t offset)
+{
+	auto sqe{scheduler.get_sqe()};
+	linux_io_uring_prep_rw(sqe,op,fd,addr,len,offset,overlapped);
+	sqe->flags=sqe_flags;
+	sqe->buf_index=buf_index;
+}
+
+}
+
+/*
+Submits every queued operation, blocks until at least one completes and invokes the completion callbacks.
+Returns the number of completions reaped.
+*/
+inline std::size_t io_async_wait(linux_io_uring_scheduler& scheduler)
+{
+	std::size_t reaped{scheduler.reap()};
+	if(reaped)
+		return reaped;
+	scheduler.submit(1);
+	return scheduler.reap();
+}
+
+/*
+Submits every queued operation and reaps whatever has already completed without blocking.
+*/
+inline std::size_t io_async_poll(linux_io_uring_scheduler& scheduler)
+{
+	scheduler.submit();
+	return scheduler.reap();
+}
+
+template<std::integral ch_type,::std::contiguous_iterator Iter>
+inline void async_read_callback(linux_io_uring_scheduler& scheduler,basic_posix_io_observer<ch_type> piob,Iter first,Iter last,linux_async_overlapped& overlapped,std::ptrdiff_t offset)
+{
+	details::linux_io_uring_async_io_impl(scheduler,::fast_io::linux_io_uring::opcode::read,piob.fd,0,
+		::std::to_address(first),static_cast<std::size_t>(last-first)*sizeof(*first),overlapped,offset);
+}
+
+template<std::integral ch_type,::std::contiguous_iterator Iter>
+inline void async_write_callback(linux_io_uring_scheduler& scheduler,basic_posix_io_observer<ch_type> piob,Iter first,Iter last,linux_async_overlapped& overlapped,std::ptrdiff_t offset)
+{
+	details::linux_io_uring_async_io_impl(scheduler,::fast_io::linux_io_uring::opcode::write,piob.fd,0,
+		::std::to_address(first),static_cast<std::size_t>(last-first)*sizeof(*first),overlapped,offset);
+}
+
+template<std::integral ch_type>
+inline void async_scatter_read_callback(linux_io_uring_scheduler& scheduler,basic_posix_io_observer<ch_type> piob,io_scatters_t scatters,linux_async_overlapped& overlapped,std::ptrdiff_t offset)
+{
+	details::linux_io_uring_async_io_impl(scheduler,::fast_io::linux_io_uring::opcode::readv,piob.fd,0,
+		scatters.base,scatters.len,overlapped,offset);
+}
+
+template<std::integral ch_type>
+inline void async_scatter_write_callback(linux_io_uring_scheduler& scheduler,basic_posix_io_observer<ch_type> piob,io_scatters_t scatters,linux_async_overlapped& overlapped,std::ptrdiff_t offset)
+{
+	details::linux_io_uring_async_io_impl(scheduler,::fast_io::linux_io_uring::opcode::writev,piob.fd,0,
+		scatters.base,scatters.len,overlapped,offset);
+}
+
+template<std::integral ch_type,::std::contiguous_iterator Iter>
+inline void async_read_callback(linux_io_uring_scheduler& scheduler,basic_linux_io_uring_fixed_file<ch_type> ff,Iter first,Iter last,linux_async_overlapped& overlapped,std::ptrdiff_t offset)
+{
+	details::linux_io_uring_async_io_impl(scheduler,::fast_io::linux_io_uring::opcode::read,static_cast<int>(ff.index),
+		::fast_io::linux_io_uring::sqe_fixed_file,
+		::std::to_address(first),static_cast<std::size_t>(last-first)*sizeof(*first),overlapped,offset);
+}
+
+template<std::integral ch_type,::std::contiguous_iterator Iter>
+inline void async_write_callback(linux_io_uring_scheduler& scheduler,basic_linux_io_uring_fixed_file<ch_type> ff,Iter first,Iter last,linux_async_overlapped& overlapped,std::ptrdiff_t offset)
+{
+	details::linux_io_uring_async_io_impl(scheduler,::fast_io::linux_io_uring::opcode::write,static_cast<int>(ff.index),
+		::fast_io::linux_io_uring::sqe_fixed_file,
+		::std::to_address(first),static_cast<std::size_t>(last-first)*sizeof(*first),overlapped,offset);
+}
+
+template<std::integral ch_type>
+inline void async_scatter_read_callback(linux_io_uring_scheduler& scheduler,basic_linux_io_uring_fixed_file<ch_type> ff,io_scatters_t scatters,linux_async_overlapped& overlapped,std::ptrdiff_t offset)
+{
+	details::linux_io_uring_async_io_impl(scheduler,::fast_io::linux_io_uring::opcode::readv,static_cast<int>(ff.index),
+		::fast_io::linux_io_uring::sqe_fixed_file,scatters.base,scatters.len,overlapped,offset);
+}
+
+template<std::integral ch_type>
+inline void async_scatter_write_callback(linux_io_uring_scheduler& scheduler,basic_linux_io_uring_fixed_file<ch_type> ff,io_scatters_t scatters,linux_async_overlapped& overlapped,std::ptrdiff_t offset)
+{
+	details::linux_io_uring_async_io_impl(scheduler,::fast_io::linux_io_uring::opcode::writev,static_cast<int>(ff.index),
+		::fast_io::linux_io_uring::sqe_fixed_file,scatters.base,scatters.len,overlapped,offset);
+}
+
+template<std::integral ch_type,::std::contiguous_iterator Iter>
+inline void async_read_fixed_callback(linux_io_uring_scheduler& scheduler,basic_posix_io_observer<ch_type> piob,Iter first,Iter last,linux_io_uring_fixed_buffer fb,linux_async_overlapped& overlapped,std::ptrdiff_t offset)
+{
+	details::linux_io_uring_async_fixed_io_impl(scheduler,::fast_io::linux_io_uring::opcode::read_fixed,piob.fd,0,
+		::std::to_address(first),static_cast<std::size_t>(last-first)*sizeof(*first),fb.index,overlapped,offset);
+}
+
+template<std::integral ch_type,::std::contiguous_iterator Iter>
+inline void async_write_fixed_callback(linux_io_uring_scheduler& scheduler,basic_posix_io_observer<ch_type> piob,Iter first,Iter last,linux_io_uring_fixed_buffer fb,linux_async_overlapped& overlapped,std::ptrdiff_t offset)
+{
+	details::linux_io_uring_async_fixed_io_impl(scheduler,::fast_io::linux_io_uring::opcode::write_fixed,piob.fd,0,
+		::std::to_address(first),static_cast<std::size_t>(last-first)*sizeof(*first),fb.index,overlapped,offset);
+}
+
+template<std::integral ch_type,::std::contiguous_iterator Iter>
+inline void async_read_fixed_callback(linux_io_uring_scheduler& scheduler,basic_linux_io_uring_fixed_file<ch_type> ff,Iter first,Iter last,linux_io_uring_fixed_buffer fb,linux_async_overlapped& overlapped,std::ptrdiff_t offset)
+{
+	details::linux_io_uring_async_fixed_io_impl(scheduler,::fast_io::linux_io_uring::opcode::read_fixed,static_cast<int>(ff.index),
+		::fast_io::linux_io_uring::sqe_fixed_file,
+		::std::to_address(first),static_cast<std::size_t>(last-first)*sizeof(*first),fb.index,overlapped,offset);
+}
+
+template<std::integral ch_type,::std::contiguous_iterator Iter>
+inline void async_write_fixed_callback(linux_io_uring_scheduler& scheduler,basic_linux_io_uring_fixed_file<ch_type> ff,Iter first,Iter last,linux_io_uring_fixed_buffer fb,linux_async_overlapped& overlapped,std::ptrdiff_t offset)
+{
+	details::linux_io_uring_async_fixed_io_impl(scheduler,::fast_io::linux_io_uring::opcode::write_fixed,static_cast<int>(ff.index),
+		::fast_io::linux_io_uring::sqe_fixed_file,
+		::std::to_address(first),static_cast<std::size_t>(last-first)*sizeof(*first),fb.index,overlapped,offset);
+}
+
+template<std::integral ch_type>
+struct io_async_scheduler_t<basic_posix_io_observer<ch_type>>
+{
+	using type = linux_io_uring_scheduler;
+};
+
+template<std::integral ch_type>
+struct io_async_overlapped_t<basic_posix_io_observer<ch_type>>
+{
+	using type = linux_async_overlapped;
+};
+
+template<std::integral ch_type>
+struct io_async_scheduler_t<basic_posix_file<ch_type>>
+{
+	using type = linux_io_uring_scheduler;
+};
+
+template<std::integral ch_type>
+struct io_async_overlapped_t<basic_posix_file<ch_type>>
+{
+	using type = linux_async_overlapped;
+};
+
+template<std::integral ch_type>
+struct io_async_scheduler_t<basic_linux_io_uring_fixed_file<ch_type>>
+{
+	using type = linux_io_uring_scheduler;
+};
+
+template<std::integral ch_type>
+struct io_async_overlapped_t<basic_linux_io_uring_fixed_file<ch_type>>
+{
+	using type = linux_async_overlapped;
+};
+
+using linux_io_uring_fixed_file = basic_linux_io_uring_fixed_file<char>;
+using wlinux_io_uring_fixed_file = basic_linux_io_uring_fixed_file<wchar_t>;
+using u8linux_io_uring_fixed_file = basic_linux_io_uring_fixed_file<char8_t>;
+using u16linux_io_uring_fixed_file = basic_linux_io_uring_fixed_file<char16_t>;
+using u32linux_io_uring_fixed_file = basic_linux_io_uring_fixed_file<char32_t>;
+
+}
@@ -1,5 +1,4 @@
 ﻿#pragma once
-// To verify __NR_copy_file_range
 namespace fast_io
 {
 
@@ -34,66 +33,396 @@ inline basic_linux_zero_copy_entry<ch_type> zero_copy_out_handle(basic_posix_pip
 namespace details
 {
 
-inline std::uintmax_t linux_send_file_transmit_raw_impl(int out_fd,int in_fd)
+/*
+Which kernel primitive can move bytes between two descriptors without bouncing through user space:
+regular->regular: copy_file_range (reflinks on XFS/Btrfs, server side copy on NFS/CIFS), then sendfile
+pipe on either side: splice directly
+regular->anything: sendfile
+anything else (socket->file, socket->socket): splice through an internal pipe
+Each stage reports how far it got; whatever it could not move falls through to the next, and finally to
+the userspace copy loop.
+*/
+
+inline constexpr unsigned linux_splice_f_move{1u};
+inline constexpr unsigned linux_splice_f_more{4u};
+
+inline constexpr std::uint_least64_t linux_zero_copy_unbounded{std::numeric_limits<std::uint_least64_t>::max()};
+
+struct linux_zero_copy_result
 {
-	return raw_transmit_decay(posix_io_observer{out_fd},posix_io_observer{in_fd});
-}
+	std::uint_least64_t transmitted;
+	bool finished;
+};
 
-inline std::uintmax_t zero_copy_transmit_define_impl(int out_fd,int in_fd)
+inline constexpr std::size_t linux_zero_copy_round(std::uint_least64_t count) noexcept
 {
 	using posix_ssize_t = std::make_signed_t<std::size_t>;
 	constexpr std::size_t transmit_a_round{static_cast<std::size_t>(std::numeric_limits<posix_ssize_t>::max())};
-	std::uintmax_t total_bytes{};
-	for(;;)
+	if(count<transmit_a_round)
+		return static_cast<std::size_t>(count);
+	return transmit_a_round;
+}
+
+/*
+Drives one primitive until EOF, count is exhausted or the primitive fails. Failures are not errors here;
+the caller continues with the next strategy from where this one stopped.
+*/
+template<typename Func>
+inline linux_zero_copy_result linux_zero_copy_loop(std::uint_least64_t count,Func func) noexcept
+{
+	std::uint_least64_t total_bytes{};
+	for(;count;)
 	{
-		posix_ssize_t diff{
-#if defined(__NR_sendfile64)
-		system_call<__NR_sendfile64,posix_ssize_t>
-#else
-		system_call<__NR_sendfile,posix_ssize_t>
-#endif
-		(out_fd,in_fd,nullptr,transmit_a_round)};
+		std::ptrdiff_t diff{func(linux_zero_copy_round(count))};
+		if(diff==-EINTR)
+			continue;
 		if(linux_system_call_fails(diff))[[unlikely]]
-			return total_bytes+linux_send_file_transmit_raw_impl(out_fd,in_fd);
-		else if(diff==0)[[unlikely]]
+			return {total_bytes,false};
+		else if(diff==0)
 			break;
-		total_bytes+=static_cast<std::size_t>(diff);
+		std::uint_least64_t diff64{static_cast<std::uint_least64_t>(diff)};
+		total_bytes+=diff64;
+		if(count!=linux_zero_copy_unbounded)
+			count-=diff64;
 	}
-	return total_bytes;
+	return {total_bytes,true};
 }
 
-inline std::uint_least64_t zero_copy_transmit_define64_impl(int out_fd,int in_fd,std::uint_least64_t count)
+inline linux_zero_copy_result linux_sendfile_transmit_impl(int out_fd,int in_fd,std::uint_least64_t count) noexcept
 {
-	using posix_ssize_t = std::make_signed_t<std::size_t>;
-	constexpr std::size_t transmit_a_round{static_cast<std::size_t>(std::numeric_limits<posix_ssize_t>::max())};
-	std::uint_least64_t total_bytes{};
-	for(;;)
+	return linux_zero_copy_loop(count,[&](std::size_t round) noexcept
 	{
-		std::uint_least64_t to_transmit_this_round{transmit_a_round};
-		if(count<to_transmit_this_round)
-			to_transmit_this_round=count;
-		auto diff{
+		return
 #if defined(__NR_sendfile64)
-		system_call<__NR_sendfile64,posix_ssize_t>
+		system_call<__NR_sendfile64,std::ptrdiff_t>
 #else
-		system_call<__NR_sendfile,posix_ssize_t>
+		system_call<__NR_sendfile,std::ptrdiff_t>
 #endif
-		(out_fd,in_fd,nullptr,to_transmit_this_round)};
-		if(linux_system_call_fails(diff))[[unlikely]]
+		(out_fd,in_fd,nullptr,round);
+	});
+}
+
+#if defined(__NR_copy_file_range)
+/*
+procfs, sysfs and other pseudo files report a size of 0 and copy_file_range copies nothing from them. A first call
+that moves nothing is therefore not trusted as end of file: the caller falls back to sendfile and read/write, which
+see the real contents (and agree on an empty file).
+*/
+inline constexpr linux_zero_copy_result linux_copy_file_range_result(linux_zero_copy_result res,std::uint_least64_t count) noexcept
+{
+	if(res.finished&&res.transmitted==0&&count!=0)
+		res.finished=false;
+	return res;
+}
+
+inline linux_zero_copy_result linux_copy_file_range_transmit_impl(int out_fd,int in_fd,std::uint_least64_t count) noexcept
+{
+	return linux_copy_file_range_result(linux_zero_copy_loop(count,[&](std::size_t round) noexcept
+	{
+		return system_call<__NR_copy_file_range,std::ptrdiff_t>(in_fd,nullptr,out_fd,nullptr,round,0u);
+	}),count);
+}
+#endif
+
+#if defined(__NR_splice)
+inline linux_zero_copy_result linux_splice_transmit_impl(int out_fd,int in_fd,std::uint_least64_t count) noexcept
+{
+	return linux_zero_copy_loop(count,[&](std::size_t round) noexcept
+	{
+		return system_call<__NR_splice,std::ptrdiff_t>(in_fd,nullptr,out_fd,nullptr,round,linux_splice_f_move|linux_splice_f_more);
+	});
+}
+
+struct linux_splice_pipe
+{
+	int fds[2]{-1,-1};
+	linux_splice_pipe() noexcept
+	{
+		if(linux_system_call_fails(system_call<__NR_pipe2,int>(fds,O_CLOEXEC)))[[unlikely]]
+		{
+			fds[0]=-1;
+			fds[1]=-1;
+		}
+	}
+	linux_splice_pipe(linux_splice_pipe const&)=delete;
+	linux_splice_pipe& operator=(linux_splice_pipe const&)=delete;
+	~linux_splice_pipe()
+	{
+		if(fds[0]!=-1)
+		{
+			sys_close(fds[0]);
+			sys_close(fds[1]);
+		}
+	}
+};
+
+struct linux_zero_copy_pollfd
+{
+	int fd;
+	short events;
+	short revents;
+};
+
+inline constexpr short linux_zero_copy_pollout{4};
+
+/*
+A non-blocking output (a socket handed over by an event loop, say) answers EAGAIN once its buffer is full. Bytes
+already in the internal pipe have been taken from the input, so rather than fail with them stranded, wait until the
+output drains.
+*/
+inline void linux_zero_copy_wait_writable(int out_fd)
+{
+	linux_zero_copy_pollfd pfd{out_fd,linux_zero_copy_pollout,0};
+	for(;;)
+	{
+		int ret{
+#if defined(__NR_ppoll)
+		system_call<__NR_ppoll,int>(__builtin_addressof(pfd),1u,nullptr,nullptr,static_cast<std::size_t>(0))
+#else
+		system_call<__NR_poll,int>(__builtin_addressof(pfd),1u,-1)
+#endif
+		};
+		if(ret==-EINTR)
+			continue;
+		system_call_throw_error(ret);
+		return;
+	}
+}
+
+/*
+Bytes already spliced into the internal pipe belong to the caller. If the output side stops accepting splices,
+push them out with plain read/write before falling back so nothing is lost.
+*/
+inline void linux_splice_pipe_drain_impl(int out_fd,int pipe_in_fd,std::size_t pending)
+{
+	char buffer[4096];
+	for(;pending;)
+	{
+		std::size_t to_read{pending<sizeof(buffer)?pending:sizeof(buffer)};
+		auto readed{system_call<__NR_read,std::ptrdiff_t>(pipe_in_fd,buffer,to_read)};
+		if(readed==-EINTR)
+			continue;
+		system_call_throw_error(readed);
+		for(char const* it{buffer},*ed{buffer+readed};it!=ed;)
 		{
-			return total_bytes+::fast_io::raw_transmit64_decay(posix_io_observer{out_fd},posix_io_observer{in_fd},count);
+			auto written{system_call<__NR_write,std::ptrdiff_t>(out_fd,it,static_cast<std::size_t>(ed-it))};
+			if(written==-EINTR)
+				continue;
+			if(written==-EAGAIN)
+			{
+				linux_zero_copy_wait_writable(out_fd);
+				continue;
+			}
+			system_call_throw_error(written);
+			it+=written;
 		}
-		else if(diff==0)[[unlikely]]
+		pending-=static_cast<std::size_t>(readed);
+	}
+}
+
+inline linux_zero_copy_result linux_splice_through_pipe_transmit_impl(int out_fd,int in_fd,std::uint_least64_t count)
+{
+	linux_splice_pipe pipe;
+	if(pipe.fds[0]==-1)[[unlikely]]
+		return {0,false};
+	constexpr int linux_f_setpipe_sz{1031};
+	constexpr int linux_f_getpipe_sz{1032};
+	system_call<__NR_fcntl,int>(pipe.fds[1],linux_f_setpipe_sz,1048576);
+	int pipe_capacity{system_call<__NR_fcntl,int>(pipe.fds[1],linux_f_getpipe_sz,0)};
+	std::size_t chunk{65536};
+	if(0<pipe_capacity)
+		chunk=static_cast<std::size_t>(pipe_capacity);
+	std::uint_least64_t total_bytes{};
+	for(;count;)
+	{
+		std::size_t round{linux_zero_copy_round(count)};
+		if(chunk<round)
+			round=chunk;
+		std::ptrdiff_t in_spliced{system_call<__NR_splice,std::ptrdiff_t>(in_fd,nullptr,pipe.fds[1],nullptr,round,linux_splice_f_move|linux_splice_f_more)};
+		if(in_spliced==-EINTR)
+			continue;
+		if(linux_system_call_fails(in_spliced))[[unlikely]]
+			return {total_bytes,false};
+		else if(in_spliced==0)
 			break;
-		std::uint_least64_t diff64{static_cast<std::uint_least64_t>(diff)};
+		std::size_t pending{static_cast<std::size_t>(in_spliced)};
+		for(;pending;)
+		{
+			std::ptrdiff_t out_spliced{system_call<__NR_splice,std::ptrdiff_t>(pipe.fds[0],nullptr,out_fd,nullptr,pending,linux_splice_f_move|linux_splice_f_more)};
+			if(out_spliced==-EINTR)
+				continue;
+			if(out_spliced==-EAGAIN)
+			{
+				linux_zero_copy_wait_writable(out_fd);
+				continue;
+			}
+			if(linux_system_call_fails(out_spliced))[[unlikely]]
+			{
+				linux_splice_pipe_drain_impl(out_fd,pipe.fds[0],pending);
+				return {total_bytes+static_cast<std::uint_least64_t>(in_spliced),false};
+			}
+			pending-=static_cast<std::size_t>(out_spliced);
+		}
+		std::uint_least64_t diff64{static_cast<std::uint_least64_t>(in_spliced)};
 		total_bytes+=diff64;
-		count-=diff64;
-		if(count==0)
+		if(count!=linux_zero_copy_unbounded)
+			count-=diff64;
+	}
+	return {total_bytes,true};
+}
+#endif
+
+inline std::uint_least64_t linux_zero_copy_transmit_impl(int out_fd,int in_fd,std::uint_least64_t count)
+{
+	file_type const in_type{fstat_impl(in_fd).type};
+	file_type const out_type{fstat_impl(out_fd).type};
+	std::uint_least64_t total_bytes{};
+	auto advance{[&](linux_zero_copy_result res) noexcept
+	{
+		total_bytes+=res.transmitted;
+		if(count!=linux_zero_copy_unbounded)
+			count-=res.transmitted;
+		return res.finished;
+	}};
+#if defined(__NR_copy_file_range)
+	if(in_type==file_type::regular&&out_type==file_type::regular)
+	{
+		if(advance(linux_copy_file_range_transmit_impl(out_fd,in_fd,count)))
+			return total_bytes;
+	}
+#endif
+#if defined(__NR_splice)
+	if(in_type==file_type::fifo||out_type==file_type::fifo)
+	{
+		if(advance(linux_splice_transmit_impl(out_fd,in_fd,count)))
+			return total_bytes;
+	}
+#endif
+	if(in_type==file_type::regular||in_type==file_type::block)
+	{
+		if(advance(linux_sendfile_transmit_impl(out_fd,in_fd,count)))
+			return total_bytes;
+	}
+#if defined(__NR_splice)
+	else if(in_type!=file_type::fifo&&out_type!=file_type::fifo)
+	{
+		if(advance(linux_splice_through_pipe_transmit_impl(out_fd,in_fd,count)))
+			return total_bytes;
+	}
+#endif
+	if(count==linux_zero_copy_unbounded)
+		return total_bytes+raw_transmit_decay(posix_io_observer{out_fd},posix_io_observer{in_fd});
+	return total_bytes+::fast_io::raw_transmit64_decay(posix_io_observer{out_fd},posix_io_observer{in_fd},count);
+}
+
+inline std::uintmax_t zero_copy_transmit_define_impl(int out_fd,int in_fd)
+{
+	return static_cast<std::uintmax_t>(linux_zero_copy_transmit_impl(out_fd,in_fd,linux_zero_copy_unbounded));
+}
+
+inline std::uint_least64_t zero_copy_transmit_define64_impl(int out_fd,int in_fd,std::uint_least64_t count)
+{
+	if(count==linux_zero_copy_unbounded)[[unlikely]]
+		--count;
+	return linux_zero_copy_transmit_impl(out_fd,in_fd,count);
+}
+
+/*
+Positional variants: the input descriptor's file offset is never read nor moved, so any number of threads may
+ship disjoint ranges of one shared descriptor concurrently. Only seekable inputs make sense here.
+*/
+
+inline linux_zero_copy_result linux_sendfile_pread_transmit_impl(int out_fd,int in_fd,std::uint_least64_t& offset,std::uint_least64_t count) noexcept
+{
+	return linux_zero_copy_loop(count,[&](std::size_t round) noexcept
+	{
+		std::int_least64_t off{static_cast<std::int_least64_t>(offset)};
+		std::ptrdiff_t ret{
+#if defined(__NR_sendfile64)
+		system_call<__NR_sendfile64,std::ptrdiff_t>
+#else
+		system_call<__NR_sendfile,std::ptrdiff_t>
+#endif
+		(out_fd,in_fd,__builtin_addressof(off),round)};
+		if(!linux_system_call_fails(ret))
+			offset+=static_cast<std::uint_least64_t>(ret);
+		return ret;
+	});
+}
+
+#if defined(__NR_copy_file_range)
+inline linux_zero_copy_result linux_copy_file_range_pread_transmit_impl(int out_fd,int in_fd,std::uint_least64_t& offset,std::uint_least64_t count) noexcept
+{
+	return linux_copy_file_range_result(linux_zero_copy_loop(count,[&](std::size_t round) noexcept
+	{
+		std::int_least64_t off{static_cast<std::int_least64_t>(offset)};
+		std::ptrdiff_t ret{system_call<__NR_copy_file_range,std::ptrdiff_t>(in_fd,__builtin_addressof(off),out_fd,nullptr,round,0u)};
+		if(!linux_system_call_fails(ret))
+			offset+=static_cast<std::uint_least64_t>(ret);
+		return ret;
+	}),count);
+}
+#endif
+
+inline std::uint_least64_t linux_pread_transmit_raw_impl(int out_fd,int in_fd,std::uint_least64_t offset,std::uint_least64_t count)
+{
+	constexpr std::size_t buffer_size{transmit_buffer_size_cache<char>};
+	buffer_alloc_arr_ptr<char,false> array_ptr(buffer_size);
+	std::uint_least64_t total_bytes{};
+	for(;count;)
+	{
+		std::size_t to_read{buffer_size};
+		if(count<to_read)
+			to_read=static_cast<std::size_t>(count);
+		std::size_t readed{posix_pread_impl(in_fd,array_ptr.ptr,to_read,static_cast<std::intmax_t>(offset))};
+		if(readed==0)
 			break;
+		for(char const *it{array_ptr.ptr},*ed{array_ptr.ptr+readed};it!=ed;)
+			it+=posix_write_impl(out_fd,it,static_cast<std::size_t>(ed-it));
+		offset+=readed;
+		total_bytes+=readed;
+		if(count!=linux_zero_copy_unbounded)
+			count-=readed;
 	}
 	return total_bytes;
 }
 
+inline std::uint_least64_t linux_zero_copy_pread_transmit_impl(int out_fd,int in_fd,std::uint_least64_t offset,std::uint_least64_t count)
+{
+	std::uint_least64_t total_bytes{};
+	auto advance{[&](linux_zero_copy_result res) noexcept
+	{
+		total_bytes+=res.transmitted;
+		if(count!=linux_zero_copy_unbounded)
+			count-=res.transmitted;
+		return res.finished;
+	}};
+#if defined(__NR_copy_file_range)
+	if(fstat_impl(out_fd).type==file_type::regular)
+	{
+		if(advance(linux_copy_file_range_pread_transmit_impl(out_fd,in_fd,offset,count)))
+			return total_bytes;
+	}
+#endif
+	if(advance(linux_sendfile_pread_transmit_impl(out_fd,in_fd,offset,count)))
+		return total_bytes;
+	return total_bytes+linux_pread_transmit_raw_impl(out_fd,in_fd,offset,count);
+}
+
+#if defined(__NR_vmsplice)
+inline std::size_t linux_vmsplice_impl(int pipe_fd,io_scatters_t sp)
+{
+	for(;;)
+	{
+		auto ret{system_call<__NR_vmsplice,std::ptrdiff_t>(pipe_fd,sp.base,sp.len,0u)};
+		if(ret==-EINTR)
+			continue;
+		system_call_throw_error(ret);
+		return static_cast<std::size_t>(ret);
+	}
+}
+#endif
+
 }
 
 template<std::integral ch_type1,std::integral ch_type2>
@@ -118,7 +447,7 @@ inline std::uint_least64_t zero_copy_transmit64_define(io_alias_t,basic_linux_ze
 			{
 				copy_this_round=mx;
 			}
-			chars+=::fast_io::details::zero_copy_transmit_define64_impl(io_alias,outs.fd,ins.fd,characters,copy_this_round)/sizeof(input_char_type_size);
+			chars+=::fast_io::details::zero_copy_transmit_define64_impl(outs.fd,ins.fd,copy_this_round*input_char_type_size)/input_char_type_size;
 			if(!overflow_copy)[[likely]]
 				break;
 			characters-=mx;
@@ -131,4 +460,50 @@ inline std::uint_least64_t zero_copy_transmit64_define(io_alias_t,basic_linux_ze
 	}
 }
 
+template<std::integral ch_type1,std::integral ch_type2>
+inline std::uint_least64_t zero_copy_random_access_transmit64_define(io_alias_t,basic_linux_zero_copy_entry<ch_type1> outs,basic_linux_zero_copy_entry<ch_type2> ins,std::uint_least64_t offset,std::uint_least64_t characters)
+{
+	constexpr std::size_t input_char_type_size{sizeof(ch_type2)};
+	if constexpr(input_char_type_size!=1)
+	{
+		constexpr std::uint_least64_t mx{std::numeric_limits<std::uint_least64_t>::max()/input_char_type_size};
+		if(mx<offset)[[unlikely]]
+			throw_posix_error(EINVAL);
+		if(mx<characters)
+			characters=mx;
+		return ::fast_io::details::linux_zero_copy_pread_transmit_impl(outs.fd,ins.fd,offset*input_char_type_size,characters*input_char_type_size)/input_char_type_size;
+	}
+	else
+	{
+		if(characters==::fast_io::details::linux_zero_copy_unbounded)[[unlikely]]
+			--characters;
+		return ::fast_io::details::linux_zero_copy_pread_transmit_impl(outs.fd,ins.fd,offset,characters);
+	}
+}
+
+#if defined(__NR_vmsplice)
+/*
+Maps user pages into a pipe instead of copying them. The pages are referenced, not stolen: the buffer must stay
+untouched until the reader has consumed the data. Like write(), it may transfer less than requested.
+*/
+template<std::integral ch_type>
+inline io_scatter_status_t vmsplice_write(basic_posix_io_observer<ch_type> pipe_out,io_scatters_t sp)
+{
+	return details::scatter_size_to_status(details::linux_vmsplice_impl(pipe_out.fd,sp),sp);
+}
+
+template<std::integral ch_type,::std::contiguous_iterator Iter>
+inline Iter vmsplice_write(basic_posix_io_observer<ch_type> pipe_out,Iter first,Iter last)
+{
+	io_scatter_t sc{::std::to_address(first),static_cast<std::size_t>(last-first)*sizeof(*first)};
+	return first+details::linux_vmsplice_impl(pipe_out.fd,{__builtin_addressof(sc),1})/sizeof(*first);
+}
+
+template<std::integral ch_type,::std::contiguous_iterator Iter>
+inline Iter vmsplice_write(basic_posix_pipe<ch_type>& p,Iter first,Iter last)
+{
+	return vmsplice_write(p.out(),first,last);
+}
+#endif
+
 }
@@ -9,4 +9,13 @@
 #elif !defined(__NEWLIB__) && !defined(__MSDOS__) && (!defined(__wasm__) || (defined(__wasi__)&&defined(_WASI_EMULATED_MMAN))) && __has_include(<sys/mman.h>)
 #include"posix_mapping.h"
 #include"omap.h"
+#if defined(__linux__)
+#include"linux_async_overlapped.h"
+#endif
+#if defined(__linux__) && defined(__NR_io_uring_setup) && defined(__NR_io_uring_enter) && defined(__NR_io_uring_register)
+#include"linux_io_uring.h"
+#endif
+#if defined(__linux__) && defined(__NR_epoll_create1) && defined(__NR_epoll_pwait) && __has_include(<sys/epoll.h>)
+#include"linux_epoll.h"
+#endif
 #endif
@@ -1,5 +1,6 @@
 #pragma once
 #include"time.h"
+#include"local_time_cache.h"
 
 #if (defined(_WIN32) && !defined(__WINE__)) || defined(__CYGWIN__)
 #include"win32_timezone.h"
@@ -0,0 +1,243 @@
+#pragma once
+
+/*
+Per-thread memo of the local civil date and UTC offset for logging-style timestamp printing.
+A miss consults the C library's timezone (IANA tzfile transitions through localtime_r where the platform has
+tm_gmtoff) and records the span of UTC seconds that shares both the local date and the offset: the local day, cut
+short at a DST or other offset transition. Inside that span a timestamp costs one subtraction and the hour/minute
+splits, and printing copies the pre-rendered "YYYY-MM-DDT" prefix and "+hh:mm" suffix. The span assumes at most
+one offset transition per local day, which holds for every zone in the tz database.
+fast_io::posix_tzset invalidates the caches of all threads; call it after changing TZ.
+*/
+
+namespace fast_io
+{
+
+namespace details
+{
+
+inline constexpr std::size_t local_time_cache_prefix_capacity{32};
+inline constexpr std::size_t local_time_cache_suffix_capacity{16};
+/*
+Source of local_time_cache::stamp, shared by every thread so that no two refreshes anywhere get the same stamp.
+*/
+inline std::size_t local_time_cache_stamp_counter{};
+
+inline std::int_least32_t local_utc_offset_impl(std::int_least64_t seconds)
+{
+#if (!defined(_WIN32) || defined(__CYGWIN__)) && !defined(__MSDOS__) && !(defined(__NEWLIB__)&&!defined(__CYGWIN__)) && !defined(__AVR__) && !defined(_PICOLIBC__) && !defined(__serenity__)
+	auto res{unix_timestamp_to_tm_impl<true>(seconds)};
+#if defined(__TM_GMTOFF)
+	return static_cast<std::int_least32_t>(res.__TM_GMTOFF);
+#else
+	return static_cast<std::int_least32_t>(res.tm_gmtoff);
+#endif
+#else
+	return to_iso8601_local_impl(seconds,0,posix_daylight()).timezone;
+#endif
+}
+
+}
+
+class local_time_cache
+{
+public:
+	std::int_least64_t span_begin{};
+	std::int_least64_t span_end{};
+	/*
+	UTC second of the local midnight that starts the cached date, so seconds past it give the time of day.
+	*/
+	std::int_least64_t midnight{};
+	std::size_t generation{};
+	/*
+	Identifies the refresh that rendered prefix and suffix; never 0 once the cache has been filled.
+	*/
+	std::size_t stamp{};
+	std::int_least64_t year{};
+	std::uint_least8_t month{};
+	std::uint_least8_t day{};
+	std::uint_least8_t prefix_len{};
+	std::uint_least8_t suffix_len{};
+	std::int_least32_t timezone{};
+	char prefix[::fast_io::details::local_time_cache_prefix_capacity];
+	char suffix[::fast_io::details::local_time_cache_suffix_capacity];
+
+	/*
+	Returns seconds since the local midnight of seconds, refreshing the cache when seconds leaves the cached span.
+	*/
+	inline std::uint_least32_t lookup(std::int_least64_t seconds)
+	{
+		if(span_begin<=seconds&&seconds<span_end&&
+			generation==__atomic_load_n(__builtin_addressof(::fast_io::details::local_time_cache_generation),__ATOMIC_RELAXED))[[likely]]
+		{
+			return static_cast<std::uint_least32_t>(seconds-midnight);
+		}
+		return this->refresh(seconds);
+	}
+
+	inline void invalidate() noexcept
+	{
+		span_begin=span_end=0;
+	}
+
+private:
+	inline std::uint_least32_t refresh(std::int_least64_t seconds)
+	{
+		generation=__atomic_load_n(__builtin_addressof(::fast_io::details::local_time_cache_generation),__ATOMIC_RELAXED);
+		std::int_least32_t const offset{::fast_io::details::local_utc_offset_impl(seconds)};
+		std::int_least64_t const local_seconds{seconds+offset};
+		std::int_least64_t local_days{local_seconds/86400};
+		if(local_seconds%86400<0)
+		{
+			--local_days;
+		}
+		midnight=local_days*86400-offset;
+		std::int_least64_t begin{midnight};
+		std::int_least64_t end{midnight+86400};
+		/*
+		Narrow the day to the part that shares this offset; each side has at most one transition to search for.
+		*/
+		if(::fast_io::details::local_utc_offset_impl(begin)!=offset)
+		{
+			std::int_least64_t other{begin};
+			begin=seconds;
+			while(1<begin-other)
+			{
+				std::int_least64_t const mid{other+(begin-other)/2};
+				if(::fast_io::details::local_utc_offset_impl(mid)==offset)
+					begin=mid;
+				else
+					other=mid;
+			}
+		}
+		if(::fast_io::details::local_utc_offset_impl(end-1)!=offset)
+		{
+			std::int_least64_t same{seconds};
+			--end;
+			while(1<end-same)
+			{
+				std::int_least64_t const mid{same+(end-same)/2};
+				if(::fast_io::details::local_utc_offset_impl(mid)==offset)
+					same=mid;
+				else
+					end=mid;
+			}
+		}
+		auto const date{::fast_io::details::unix_timestamp_to_iso8601_tsp_impl_internal(local_seconds,0,offset)};
+		year=date.year;
+		month=date.month;
+		day=date.day;
+		timezone=offset;
+		char* iter{::fast_io::details::chrono_year_impl(prefix,year)};
+		*iter=char_literal_v<u8'-',char>;
+		++iter;
+		iter=::fast_io::details::chrono_two_digits_impl<true>(iter,month);
+		*iter=char_literal_v<u8'-',char>;
+		++iter;
+		iter=::fast_io::details::chrono_two_digits_impl<true>(iter,day);
+		*iter=char_literal_v<u8'T',char>;
+		++iter;
+		prefix_len=static_cast<std::uint_least8_t>(iter-prefix);
+		if(offset==0)
+		{
+			*suffix=char_literal_v<u8'Z',char>;
+			iter=suffix+1;
+		}
+		else
+		{
+			iter=::fast_io::details::print_reserve_timezone_impl(suffix,offset);
+		}
+		suffix_len=static_cast<std::uint_least8_t>(iter-suffix);
+		stamp=__atomic_add_fetch(__builtin_addressof(::fast_io::details::local_time_cache_stamp_counter),1,__ATOMIC_RELAXED);
+		span_begin=begin;
+		span_end=end;
+		return static_cast<std::uint_least32_t>(seconds-midnight);
+	}
+};
+
+/*
+A local timestamp resolved against a local_time_cache. The date and offset are held by value, so it stays valid
+whatever the cache serves next and on any thread; printing copies the cache's rendered prefix and suffix only while
+the printing thread's cache still holds the refresh named by stamp.
+*/
+struct cached_local_timestamp
+{
+	std::int_least64_t year{};
+	std::uint_least8_t month{};
+	std::uint_least8_t day{};
+	std::uint_least32_t seconds_of_day{};
+	std::int_least32_t timezone{};
+	std::uint_least64_t subseconds{};
+	std::size_t stamp{};
+};
+
+inline local_time_cache& local_time_cache_thread_local() noexcept
+{
+	thread_local local_time_cache cache;
+	return cache;
+}
+
+/*
+Same result as local(timestamp) with the timezone database's offset for that instant, served from the calling
+thread's cache.
+*/
+template<std::int_least64_t off_to_epoch>
+inline cached_local_timestamp cached_local(basic_timestamp<off_to_epoch> timestamp)
+{
+	if constexpr(off_to_epoch==0)
+	{
+		auto& cache{::fast_io::local_time_cache_thread_local()};
+		std::uint_least32_t const seconds_of_day{cache.lookup(timestamp.seconds)};
+		return {cache.year,cache.month,cache.day,seconds_of_day,cache.timezone,timestamp.subseconds,cache.stamp};
+	}
+	else
+	{
+		return ::fast_io::cached_local(static_cast<unix_timestamp>(timestamp));
+	}
+}
+
+inline constexpr iso8601_timestamp to_iso8601(cached_local_timestamp const& tsp) noexcept
+{
+	return {tsp.year,tsp.month,tsp.day,
+		static_cast<std::uint_least8_t>(tsp.seconds_of_day/3600u),
+		static_cast<std::uint_least8_t>(tsp.seconds_of_day/60u%60u),
+		static_cast<std::uint_least8_t>(tsp.seconds_of_day%60u),
+		tsp.subseconds,tsp.timezone};
+}
+
+template<std::integral char_type>
+inline constexpr std::size_t print_reserve_size(io_reserve_type_t<char_type,cached_local_timestamp>) noexcept
+{
+	return print_reserve_size(io_reserve_type<char_type,iso8601_timestamp>);
+}
+
+template<std::integral char_type>
+inline char_type* print_reserve_define(io_reserve_type_t<char_type,cached_local_timestamp>,char_type* iter,cached_local_timestamp const& tsp) noexcept
+{
+	if constexpr(!std::same_as<char_type,char>)
+	{
+		return ::fast_io::details::print_reserve_iso8601_timestamp_impl(iter,::fast_io::to_iso8601(tsp));
+	}
+	else
+	{
+		auto const& cache{::fast_io::local_time_cache_thread_local()};
+		if(tsp.stamp==0||tsp.stamp!=cache.stamp)[[unlikely]]
+		{
+			return ::fast_io::details::print_reserve_iso8601_timestamp_impl(iter,::fast_io::to_iso8601(tsp));
+		}
+		iter=::fast_io::details::non_overlapped_copy_n(cache.prefix,cache.prefix_len,iter);
+		std::uint_least32_t const sod{tsp.seconds_of_day};
+		iter=::fast_io::details::chrono_two_digits_impl<true>(iter,static_cast<std::uint_least8_t>(sod/3600u));
+		*iter=char_literal_v<u8':',char_type>;
+		++iter;
+		iter=::fast_io::details::chrono_two_digits_impl<true>(iter,static_cast<std::uint_least8_t>(sod/60u%60u));
+		*iter=char_literal_v<u8':',char_type>;
+		++iter;
+		iter=::fast_io::details::chrono_two_digits_impl<true>(iter,static_cast<std::uint_least8_t>(sod%60u));
+		if(tsp.subseconds)
+			iter=::fast_io::details::output_iso8601_subseconds(iter,tsp.subseconds);
+		return ::fast_io::details::non_overlapped_copy_n(cache.suffix,cache.suffix_len,iter);
+	}
+}
+
+}
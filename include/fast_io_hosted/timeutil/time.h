@@ -657,6 +657,11 @@ inline iso8601_timestamp to_iso8601_local_impl(std::int_least64_t seconds,std::u
 #endif
 extern void m_tzset() noexcept __asm__("tzset");
 #endif
+
+/*
+Bumped by posix_tzset so every thread's local_time_cache notices a timezone change.
+*/
+inline std::size_t local_time_cache_generation{};
 }
 
 inline void posix_tzset() noexcept
@@ -668,6 +673,7 @@ inline void posix_tzset() noexcept
 #elif !defined(__AVR__)&&(!defined(__wasi__) || defined(__wasilibc_unmodified_upstream))
 	noexcept_call(tzset);
 #endif
+	__atomic_fetch_add(__builtin_addressof(details::local_time_cache_generation),1,__ATOMIC_RELAXED);
 }
 
 #if defined(_WIN32) && !defined(__BIONIC__) && !defined(__CYGWIN__) && (defined(_UCRT) || defined(_MSC_VER))
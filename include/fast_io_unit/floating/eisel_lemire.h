@@ -0,0 +1,401 @@
+#pragma once
+/*
+Algorithm: Eisel-Lemire, with the simple decimal conversion of Nigel Tao as the slow path
+Reference: Daniel Lemire, Number Parsing at a Gigabyte per Second; fast_float; Wuffs
+*/
+namespace fast_io::details
+{
+
+template<typename flt>
+struct eisel_lemire_traits;
+
+template<>
+struct eisel_lemire_traits<float>
+{
+	inline static constexpr std::int_least32_t min_exponent_round_to_even{-17};
+	inline static constexpr std::int_least32_t max_exponent_round_to_even{10};
+	inline static constexpr std::int_least32_t smallest_power_of_ten{-65};
+	inline static constexpr std::int_least32_t largest_power_of_ten{38};
+	inline static constexpr std::int_least32_t max_exponent_fast_path{10};
+	inline static constexpr std::int_least32_t minimum_exponent{-127};
+};
+
+template<>
+struct eisel_lemire_traits<double>
+{
+	inline static constexpr std::int_least32_t min_exponent_round_to_even{-4};
+	inline static constexpr std::int_least32_t max_exponent_round_to_even{23};
+	inline static constexpr std::int_least32_t smallest_power_of_ten{-342};
+	inline static constexpr std::int_least32_t largest_power_of_ten{308};
+	inline static constexpr std::int_least32_t max_exponent_fast_path{22};
+	inline static constexpr std::int_least32_t minimum_exponent{-1023};
+};
+
+/*
+mantissa has the implicit bit stripped, power2 is the biased exponent.
+*/
+struct adjusted_mantissa
+{
+	std::uint_least64_t mantissa;
+	std::int_least32_t power2;
+};
+
+template<typename flt>
+inline constexpr std::int_least32_t eisel_lemire_infinite_power{static_cast<std::int_least32_t>((1u<<iec559_traits<flt>::ebits)-1u)};
+
+/*
+floor(log2(10^q))+63, exact for -342<=q<=308
+*/
+inline constexpr std::int_least32_t eisel_lemire_power(std::int_least32_t q) noexcept
+{
+	return (((152170+65536)*q)>>16)+63;
+}
+
+template<std::size_t bit_precision>
+inline constexpr uint64x2 eisel_lemire_product_approximation(std::int_least32_t q,std::uint_least64_t w) noexcept
+{
+	std::size_t const index{static_cast<std::size_t>(q-eisel_lemire_smallest_power_of_five)};
+	constexpr std::uint_least64_t precision_mask{UINT_LEAST64_MAX>>bit_precision};
+	auto const& pw{eisel_lemire_pow5_tb[index]};
+	uint64x2 first;
+	first.lo=::fast_io::details::intrinsics::umul(w,pw.hi,first.hi);
+	if((first.hi&precision_mask)==precision_mask)
+	{
+		std::uint_least64_t second_hi{::fast_io::details::intrinsics::umul_least64_high(w,pw.lo)};
+		first.lo+=second_hi;
+		if(second_hi>first.lo)
+		{
+			++first.hi;
+		}
+	}
+	return first;
+}
+
+/*
+w*10^q correctly rounded when w is exact (at most 19 significant digits).
+*/
+template<typename flt>
+inline constexpr adjusted_mantissa eisel_lemire_compute_float(std::int_least32_t q,std::uint_least64_t w) noexcept
+{
+	using trait = eisel_lemire_traits<flt>;
+	constexpr std::int_least32_t mbits{static_cast<std::int_least32_t>(iec559_traits<flt>::mbits)};
+	constexpr std::int_least32_t infinite_power{eisel_lemire_infinite_power<flt>};
+	if(w==0||q<trait::smallest_power_of_ten)
+	{
+		return {0,0};
+	}
+	if(trait::largest_power_of_ten<q)
+	{
+		return {0,infinite_power};
+	}
+	std::int_least32_t const lz{static_cast<std::int_least32_t>(::std::countl_zero(w))};
+	w<<=lz;
+	auto const product{eisel_lemire_product_approximation<static_cast<std::size_t>(mbits+3)>(q,w)};
+	std::int_least32_t const upperbit{static_cast<std::int_least32_t>(product.hi>>63u)};
+	std::int_least32_t const shift{upperbit+64-mbits-3};
+	adjusted_mantissa answer{product.hi>>shift,
+		eisel_lemire_power(q)+upperbit-lz-trait::minimum_exponent};
+	if(answer.power2<=0)
+	{
+		if(64<=-answer.power2+1)
+		{
+			return {0,0};
+		}
+		answer.mantissa>>=-answer.power2+1;
+		answer.mantissa+=(answer.mantissa&1u);
+		answer.mantissa>>=1u;
+		answer.power2=(answer.mantissa<(static_cast<std::uint_least64_t>(1u)<<mbits))?0:1;
+		return answer;
+	}
+	if(product.lo<=1u&&trait::min_exponent_round_to_even<=q&&q<=trait::max_exponent_round_to_even&&
+		(answer.mantissa&3u)==1u)
+	{
+		if((answer.mantissa<<shift)==product.hi)
+		{
+			answer.mantissa&=~static_cast<std::uint_least64_t>(1u);
+		}
+	}
+	answer.mantissa+=(answer.mantissa&1u);
+	answer.mantissa>>=1u;
+	if((static_cast<std::uint_least64_t>(2u)<<mbits)<=answer.mantissa)
+	{
+		answer.mantissa=(static_cast<std::uint_least64_t>(1u)<<mbits);
+		++answer.power2;
+	}
+	answer.mantissa&=~(static_cast<std::uint_least64_t>(1u)<<mbits);
+	if(infinite_power<=answer.power2)
+	{
+		return {0,infinite_power};
+	}
+	return answer;
+}
+
+template<typename flt>
+inline constexpr flt adjusted_mantissa_to_float(adjusted_mantissa am,bool negative) noexcept
+{
+	using mantissa_type = typename iec559_traits<flt>::mantissa_type;
+	constexpr std::size_t mbits{iec559_traits<flt>::mbits};
+	constexpr std::size_t ebits{iec559_traits<flt>::ebits};
+	mantissa_type bits{static_cast<mantissa_type>(am.mantissa)};
+	bits|=static_cast<mantissa_type>(static_cast<mantissa_type>(am.power2)<<mbits);
+	bits|=static_cast<mantissa_type>(static_cast<mantissa_type>(negative)<<(mbits+ebits));
+	return
+#if defined(__has_builtin)
+#if __has_builtin(__builtin_bit_cast)
+	__builtin_bit_cast(flt,bits);
+#else
+	bit_cast<flt>(bits);
+#endif
+#elif defined(_MSC_VER) && __cpp_lib_bit_cast >= 201806L
+	__builtin_bit_cast(flt,bits);
+#else
+	bit_cast<flt>(bits);
+#endif
+}
+
+/*
+High precision decimal used when Eisel-Lemire cannot decide: more than 19 significant digits and w, w+1 round
+differently. 768 digits are enough for any halfway case of binary64; anything beyond only matters as nonzero.
+*/
+inline constexpr std::uint_least32_t hpd_max_digits{768};
+inline constexpr std::int_least32_t hpd_decimal_point_range{2047};
+
+struct high_precision_decimal
+{
+	std::uint_least32_t num_digits{};
+	std::int_least32_t decimal_point{};
+	bool truncated{};
+	char unsigned digits[hpd_max_digits];
+};
+
+inline constexpr void hpd_trim(high_precision_decimal& h) noexcept
+{
+	while(h.num_digits!=0&&h.digits[h.num_digits-1u]==0)
+	{
+		--h.num_digits;
+	}
+}
+
+inline constexpr void hpd_left_shift(high_precision_decimal& h,std::uint_least32_t shift) noexcept
+{
+	if(h.num_digits==0)
+	{
+		return;
+	}
+	constexpr std::uint_least32_t tmpsize{hpd_max_digits+20u};
+	char unsigned tmp[tmpsize];
+	std::uint_least32_t write_index{tmpsize};
+	std::uint_least64_t n{};
+	for(std::uint_least32_t read_index{h.num_digits};read_index!=0;)
+	{
+		--read_index;
+		n+=static_cast<std::uint_least64_t>(h.digits[read_index])<<shift;
+		std::uint_least64_t const quotient{n/10u};
+		tmp[--write_index]=static_cast<char unsigned>(n-10u*quotient);
+		n=quotient;
+	}
+	for(;n!=0;)
+	{
+		std::uint_least64_t const quotient{n/10u};
+		tmp[--write_index]=static_cast<char unsigned>(n-10u*quotient);
+		n=quotient;
+	}
+	std::uint_least32_t const new_digits{tmpsize-write_index};
+	std::uint_least32_t keep{new_digits};
+	if(hpd_max_digits<keep)
+	{
+		keep=hpd_max_digits;
+		for(std::uint_least32_t i{write_index+keep};i!=tmpsize;++i)
+		{
+			if(tmp[i])
+			{
+				h.truncated=true;
+				break;
+			}
+		}
+	}
+	for(std::uint_least32_t i{};i!=keep;++i)
+	{
+		h.digits[i]=tmp[write_index+i];
+	}
+	h.decimal_point+=static_cast<std::int_least32_t>(new_digits-h.num_digits);
+	h.num_digits=keep;
+	hpd_trim(h);
+}
+
+inline constexpr void hpd_right_shift(high_precision_decimal& h,std::uint_least32_t shift) noexcept
+{
+	std::uint_least32_t read_index{},write_index{};
+	std::uint_least64_t n{};
+	while((n>>shift)==0)
+	{
+		if(read_index<h.num_digits)
+		{
+			n=10u*n+h.digits[read_index++];
+		}
+		else if(n==0)
+		{
+			return;
+		}
+		else
+		{
+			while((n>>shift)==0)
+			{
+				n*=10u;
+				++read_index;
+			}
+			break;
+		}
+	}
+	h.decimal_point-=static_cast<std::int_least32_t>(read_index)-1;
+	if(h.decimal_point< -hpd_decimal_point_range)
+	{
+		h.num_digits=0;
+		h.decimal_point=0;
+		h.truncated=false;
+		return;
+	}
+	std::uint_least64_t const mask{(static_cast<std::uint_least64_t>(1u)<<shift)-1u};
+	while(read_index<h.num_digits)
+	{
+		char unsigned const new_digit{static_cast<char unsigned>(n>>shift)};
+		n=10u*(n&mask)+h.digits[read_index++];
+		h.digits[write_index++]=new_digit;
+	}
+	while(n!=0)
+	{
+		char unsigned const new_digit{static_cast<char unsigned>(n>>shift)};
+		n=10u*(n&mask);
+		if(write_index<hpd_max_digits)
+		{
+			h.digits[write_index++]=new_digit;
+		}
+		else if(new_digit)
+		{
+			h.truncated=true;
+		}
+	}
+	h.num_digits=write_index;
+	hpd_trim(h);
+}
+
+inline constexpr std::uint_least64_t hpd_round(high_precision_decimal const& h) noexcept
+{
+	if(h.num_digits==0||h.decimal_point<0)
+	{
+		return 0;
+	}
+	else if(18<h.decimal_point)
+	{
+		return UINT_LEAST64_MAX;
+	}
+	std::uint_least32_t const dp{static_cast<std::uint_least32_t>(h.decimal_point)};
+	std::uint_least64_t n{};
+	for(std::uint_least32_t i{};i!=dp;++i)
+	{
+		n=10u*n+((i<h.num_digits)?h.digits[i]:0u);
+	}
+	bool round_up{};
+	if(dp<h.num_digits)
+	{
+		round_up=5u<=h.digits[dp];
+		if(h.digits[dp]==5u&&dp+1u==h.num_digits)
+		{
+			round_up=h.truncated||(dp!=0&&(h.digits[dp-1u]&1u));
+		}
+	}
+	if(round_up)
+	{
+		++n;
+	}
+	return n;
+}
+
+template<typename flt>
+inline constexpr adjusted_mantissa hpd_compute_float(high_precision_decimal& d) noexcept
+{
+	constexpr std::int_least32_t mbits{static_cast<std::int_least32_t>(iec559_traits<flt>::mbits)};
+	constexpr std::int_least32_t infinite_power{eisel_lemire_infinite_power<flt>};
+	constexpr std::int_least32_t minimum_exponent{eisel_lemire_traits<flt>::minimum_exponent};
+	if(d.num_digits==0||d.decimal_point< -324)
+	{
+		return {0,0};
+	}
+	if(310<=d.decimal_point)
+	{
+		return {0,infinite_power};
+	}
+	constexpr std::uint_least32_t max_shift{60};
+	constexpr std::uint_least32_t num_powers{19};
+	constexpr char unsigned decimal_powers[num_powers]{0,3,6,9,13,16,19,23,26,29,33,36,39,43,46,49,53,56,59};
+	std::int_least32_t exp2{};
+	while(0<d.decimal_point)
+	{
+		std::uint_least32_t const n{static_cast<std::uint_least32_t>(d.decimal_point)};
+		std::uint_least32_t const shift{(n<num_powers)?decimal_powers[n]:max_shift};
+		hpd_right_shift(d,shift);
+		if(d.decimal_point< -hpd_decimal_point_range)
+		{
+			return {0,0};
+		}
+		exp2+=static_cast<std::int_least32_t>(shift);
+	}
+	while(d.decimal_point<=0)
+	{
+		std::uint_least32_t shift;
+		if(d.decimal_point==0)
+		{
+			if(5u<=d.digits[0])
+			{
+				break;
+			}
+			shift=(d.digits[0]<2u)?2u:1u;
+		}
+		else
+		{
+			std::uint_least32_t const n{static_cast<std::uint_least32_t>(-d.decimal_point)};
+			shift=(n<num_powers)?decimal_powers[n]:max_shift;
+		}
+		hpd_left_shift(d,shift);
+		if(hpd_decimal_point_range<d.decimal_point)
+		{
+			return {0,infinite_power};
+		}
+		exp2-=static_cast<std::int_least32_t>(shift);
+	}
+	--exp2;
+	while(exp2<minimum_exponent+1)
+	{
+		std::uint_least32_t n{static_cast<std::uint_least32_t>(minimum_exponent+1-exp2)};
+		if(max_shift<n)
+		{
+			n=max_shift;
+		}
+		hpd_right_shift(d,n);
+		exp2+=static_cast<std::int_least32_t>(n);
+	}
+	if(infinite_power<=exp2-minimum_exponent)
+	{
+		return {0,infinite_power};
+	}
+	hpd_left_shift(d,static_cast<std::uint_least32_t>(mbits+1));
+	std::uint_least64_t mantissa{hpd_round(d)};
+	if((static_cast<std::uint_least64_t>(1u)<<(mbits+1))<=mantissa)
+	{
+		hpd_right_shift(d,1u);
+		++exp2;
+		mantissa=hpd_round(d);
+		if(infinite_power<=exp2-minimum_exponent)
+		{
+			return {0,infinite_power};
+		}
+	}
+	adjusted_mantissa answer{mantissa&((static_cast<std::uint_least64_t>(1u)<<mbits)-1u),exp2-minimum_exponent};
+	if(mantissa<(static_cast<std::uint_least64_t>(1u)<<mbits))
+	{
+		--answer.power2;
+	}
+	return answer;
+}
+
+}
@@ -3,6 +3,9 @@
 #include"punning.h"
 #include"hexfloat.h"
 #include"roundtrip.h"
+#include"eisel_lemire_tb.h"
+#include"eisel_lemire.h"
+#include"scan.h"
 
 namespace fast_io
 {
@@ -0,0 +1,842 @@
+#pragma once
+/*
+Algorithm: Eisel-Lemire with Clinger's fast path, simple decimal conversion as the slow path
+Reference: fast_float
+*/
+namespace fast_io
+{
+
+namespace details
+{
+
+template<bool noskipws,bool comma,::fast_io::manipulators::floating_format fm>
+inline constexpr ::fast_io::manipulators::scalar_flags flt_scan_mani_flags_cache{.noskipws=noskipws,.comma=comma,.floating=fm};
+
+template<typename flt>
+using flt_scan_work_type = ::std::conditional_t<sizeof(flt)==sizeof(float),float,double>;
+
+template<typename flt>
+inline constexpr bool flt_scan_supported{(sizeof(flt)==sizeof(float)||sizeof(flt)==sizeof(double))&&
+	::std::numeric_limits<::std::remove_cvref_t<flt>>::is_iec559};
+
+template<::std::integral char_type>
+inline constexpr bool flt_scan_is_digit(char_type ch) noexcept
+{
+	using unsigned_char_type = my_make_unsigned_t<char_type>;
+	unsigned_char_type uch{static_cast<unsigned_char_type>(ch)};
+	return !char_digit_to_literal<10,char_type>(uch);
+}
+
+template<::std::integral char_type>
+inline constexpr std::uint_least32_t flt_scan_digit_value(char_type ch) noexcept
+{
+	using unsigned_char_type = my_make_unsigned_t<char_type>;
+	unsigned_char_type uch{static_cast<unsigned_char_type>(ch)};
+	char_digit_to_literal<10,char_type>(uch);
+	return static_cast<std::uint_least32_t>(uch);
+}
+
+template<char8_t lower,::std::integral char_type>
+inline constexpr bool flt_scan_is_letter(char_type ch) noexcept
+{
+	return ch==char_literal_v<lower,char_type>||ch==char_literal_v<static_cast<char8_t>(lower-(u8'a'-u8'A')),char_type>;
+}
+
+/*
+SWAR check and conversion of eight ASCII digits, read little-endian.
+*/
+inline constexpr bool flt_scan_is_eight_digits(std::uint_least64_t val) noexcept
+{
+	return (((val&0xF0F0F0F0F0F0F0F0u)|(((val+0x0606060606060606u)&0xF0F0F0F0F0F0F0F0u)>>4u))==0x3333333333333333u);
+}
+
+inline constexpr std::uint_least32_t flt_scan_parse_eight_digits(std::uint_least64_t val) noexcept
+{
+	constexpr std::uint_least64_t mask{0x000000FF000000FFu};
+	constexpr std::uint_least64_t mul1{0x000F424000000064u};
+	constexpr std::uint_least64_t mul2{0x0000271000000001u};
+	val-=0x3030303030303030u;
+	val=(val*10u)+(val>>8u);
+	return static_cast<std::uint_least32_t>((((val&mask)*mul1)+(((val>>16u)&mask)*mul2))>>32u);
+}
+
+template<::std::integral char_type>
+inline constexpr bool flt_scan_use_swar{sizeof(char_type)==1&&!::fast_io::details::is_ebcdic<char_type>&&
+	::std::endian::native==::std::endian::little};
+
+template<::std::integral char_type>
+inline constexpr char_type const* flt_scan_digits(char_type const* first,char_type const* last,std::uint_least64_t& w) noexcept
+{
+	if constexpr(flt_scan_use_swar<char_type>)
+	{
+#if __cpp_if_consteval >= 202106L || __cpp_lib_is_constant_evaluated >= 201811L
+#if __cpp_if_consteval >= 202106L
+		if !consteval
+#else
+		if(!std::is_constant_evaluated())
+#endif
+		{
+			for(;8<=last-first;first+=8)
+			{
+				std::uint_least64_t val;
+				::fast_io::details::my_memcpy(__builtin_addressof(val),first,sizeof(val));
+				if(!flt_scan_is_eight_digits(val))
+				{
+					break;
+				}
+				w=w*100000000u+flt_scan_parse_eight_digits(val);
+			}
+		}
+#endif
+	}
+	for(;first!=last&&flt_scan_is_digit(*first);++first)
+	{
+		w=w*10u+flt_scan_digit_value(*first);
+	}
+	return first;
+}
+
+struct flt_scan_decimal_span
+{
+	std::size_t int_digits;
+	std::size_t frac_digits;
+	std::int_least64_t exp10;
+	bool has_fraction;
+};
+
+template<::std::integral char_type>
+inline constexpr void hpd_parse_decimal(high_precision_decimal& h,char_type const* first,flt_scan_decimal_span const& sp) noexcept
+{
+	constexpr char_type zero{char_literal_v<u8'0',char_type>};
+	std::size_t total{},last_nonzero{};
+	std::int_least64_t dp{};
+	auto push{[&](char_type ch) noexcept
+	{
+		std::uint_least32_t const d{flt_scan_digit_value(ch)};
+		if(total<hpd_max_digits)
+		{
+			h.digits[total]=static_cast<char unsigned>(d);
+		}
+		++total;
+		if(d)
+		{
+			last_nonzero=total;
+		}
+	}};
+	auto int_end{first+sp.int_digits};
+	for(;first!=int_end&&*first==zero;++first);
+	for(;first!=int_end;++first)
+	{
+		push(*first);
+	}
+	dp=static_cast<std::int_least64_t>(total);
+	if(sp.has_fraction)
+	{
+		++first;
+		auto frac_end{first+sp.frac_digits};
+		if(total==0)
+		{
+			for(;first!=frac_end&&*first==zero;++first)
+			{
+				--dp;
+			}
+		}
+		for(;first!=frac_end;++first)
+		{
+			push(*first);
+		}
+	}
+	h.truncated=hpd_max_digits<last_nonzero;
+	h.num_digits=static_cast<std::uint_least32_t>(h.truncated?hpd_max_digits:last_nonzero);
+	std::int_least64_t decimal_point{dp+sp.exp10};
+	constexpr std::int_least64_t clamp{static_cast<std::int_least64_t>(1)<<30};
+	if(decimal_point< -clamp)
+	{
+		decimal_point=-clamp;
+	}
+	else if(clamp<decimal_point)
+	{
+		decimal_point=clamp;
+	}
+	h.decimal_point=static_cast<std::int_least32_t>(decimal_point);
+	for(std::uint_least32_t i{h.num_digits};i<19u;++i)
+	{
+		h.digits[i]=0;
+	}
+}
+
+template<typename flt,::std::integral char_type>
+#if __has_cpp_attribute(__gnu__::__cold__)
+[[__gnu__::__cold__]]
+#endif
+inline constexpr adjusted_mantissa flt_scan_slow_path(char_type const* first,flt_scan_decimal_span const& sp) noexcept
+{
+	high_precision_decimal h;
+	hpd_parse_decimal(h,first,sp);
+	return hpd_compute_float<flt>(h);
+}
+
+template<typename flt>
+inline constexpr bool flt_scan_clinger_enabled{
+#if defined(__FLT_EVAL_METHOD__) && __FLT_EVAL_METHOD__ != 0
+false
+#else
+true
+#endif
+};
+
+template<typename flt>
+inline constexpr flt flt_scan_exact_pow10(std::uint_least32_t n) noexcept
+{
+	flt v{1};
+	for(;n;--n)
+	{
+		v*=static_cast<flt>(10);
+	}
+	return v;
+}
+
+template<typename flt>
+inline constexpr auto flt_scan_pow10_tb{[]() noexcept
+{
+	constexpr std::size_t n{static_cast<std::size_t>(eisel_lemire_traits<flt>::max_exponent_fast_path)+1u};
+	::fast_io::freestanding::array<flt,n> tb{};
+	for(std::size_t i{};i!=n;++i)
+	{
+		tb[i]=flt_scan_exact_pow10<flt>(static_cast<std::uint_least32_t>(i));
+	}
+	return tb;
+}()};
+
+template<typename flt,::std::integral char_type>
+inline constexpr parse_code flt_scan_decimal_to_float(char_type const* mantissa_first,flt_scan_decimal_span const& sp,
+	std::uint_least64_t w,bool negative,flt& t) noexcept
+{
+	constexpr char_type zero{char_literal_v<u8'0',char_type>};
+	std::size_t digit_count{sp.int_digits+sp.frac_digits};
+	std::int_least64_t exponent{sp.exp10-static_cast<std::int_least64_t>(sp.frac_digits)};
+	bool too_many_digits{};
+	if(19u<digit_count)
+	{
+		auto it{mantissa_first};
+		auto int_end{mantissa_first+sp.int_digits};
+		for(;it!=int_end&&*it==zero;++it)
+		{
+			--digit_count;
+		}
+		if(it==int_end&&sp.has_fraction)
+		{
+			++it;
+			for(auto frac_end{it+sp.frac_digits};it!=frac_end&&*it==zero;++it)
+			{
+				--digit_count;
+			}
+		}
+		if(19u<digit_count)
+		{
+			too_many_digits=true;
+			constexpr std::uint_least64_t minimal_nineteen_digit_integer{1000000000000000000u};
+			w=0;
+			it=mantissa_first;
+			for(;w<minimal_nineteen_digit_integer&&it!=int_end;++it)
+			{
+				w=w*10u+flt_scan_digit_value(*it);
+			}
+			if(minimal_nineteen_digit_integer<=w)
+			{
+				exponent=sp.exp10+static_cast<std::int_least64_t>(int_end-it);
+			}
+			else
+			{
+				auto frac_first{int_end+1};
+				it=frac_first;
+				for(auto frac_end{frac_first+sp.frac_digits};w<minimal_nineteen_digit_integer&&it!=frac_end;++it)
+				{
+					w=w*10u+flt_scan_digit_value(*it);
+				}
+				exponent=sp.exp10-static_cast<std::int_least64_t>(it-frac_first);
+			}
+		}
+	}
+	using trait = eisel_lemire_traits<flt>;
+	if constexpr(flt_scan_clinger_enabled<flt>)
+	{
+		constexpr std::uint_least64_t max_mantissa{static_cast<std::uint_least64_t>(1u)<<(iec559_traits<flt>::mbits+1u)};
+		if(!too_many_digits&&w<=max_mantissa&&-trait::max_exponent_fast_path<=exponent&&exponent<=trait::max_exponent_fast_path)
+		{
+			flt value{static_cast<flt>(w)};
+			if(exponent<0)
+			{
+				value/=flt_scan_pow10_tb<flt>[static_cast<std::size_t>(-exponent)];
+			}
+			else
+			{
+				value*=flt_scan_pow10_tb<flt>[static_cast<std::size_t>(exponent)];
+			}
+			t=negative?-value:value;
+			return parse_code::ok;
+		}
+	}
+	constexpr std::int_least64_t clamp{static_cast<std::int_least64_t>(1)<<30};
+	if(exponent< -clamp)
+	{
+		exponent=-clamp;
+	}
+	else if(clamp<exponent)
+	{
+		exponent=clamp;
+	}
+	std::int_least32_t const q{static_cast<std::int_least32_t>(exponent)};
+	auto am{eisel_lemire_compute_float<flt>(q,w)};
+	if(too_many_digits)
+	{
+		auto am1{eisel_lemire_compute_float<flt>(q,w+1u)};
+		if(am.mantissa!=am1.mantissa||am.power2!=am1.power2)
+		{
+			am=flt_scan_slow_path<flt>(mantissa_first,sp);
+		}
+	}
+	if(am.power2==eisel_lemire_infinite_power<flt>)
+	{
+		return parse_code::overflow;
+	}
+	t=adjusted_mantissa_to_float<flt>(am,negative);
+	return parse_code::ok;
+}
+
+template<::std::integral char_type>
+inline constexpr parse_result<char_type const*> flt_scan_special_impl(char_type const* first,char_type const* last) noexcept
+{
+	constexpr char8_t inf_str[]{u8"infinity"};
+	constexpr char8_t nan_str[]{u8"nan"};
+	constexpr std::size_t need{3u};
+	bool const isnan{flt_scan_is_letter<u8'n'>(*first)};
+	char8_t const* str{isnan?nan_str:inf_str};
+	std::size_t const full{isnan?need:8u};
+	std::size_t i{};
+	for(;i!=full;++i,++first)
+	{
+		if(first==last)
+		{
+			if(i<need)
+			{
+				return {first,parse_code::invalid};
+			}
+			if(i!=need)
+			{
+				first-=static_cast<std::ptrdiff_t>(i-need);
+			}
+			return {first,parse_code::ok};
+		}
+		char_type const ch{*first};
+		char8_t const c{str[i]};
+		bool matched;
+		switch(c)
+		{
+		case u8'a':matched=flt_scan_is_letter<u8'a'>(ch);break;
+		case u8'f':matched=flt_scan_is_letter<u8'f'>(ch);break;
+		case u8'i':matched=flt_scan_is_letter<u8'i'>(ch);break;
+		case u8'n':matched=flt_scan_is_letter<u8'n'>(ch);break;
+		case u8't':matched=flt_scan_is_letter<u8't'>(ch);break;
+		default:matched=flt_scan_is_letter<u8'y'>(ch);
+		}
+		if(!matched)
+		{
+			if(i<need)
+			{
+				return {first,parse_code::invalid};
+			}
+			if(i!=need)
+			{
+				first-=static_cast<std::ptrdiff_t>(i-need);
+			}
+			return {first,parse_code::ok};
+		}
+	}
+	return {first,parse_code::ok};
+}
+
+template<bool comma,::std::integral char_type>
+inline constexpr char_type flt_scan_decimal_point{comma?char_literal_v<u8',',char_type>:char_literal_v<u8'.',char_type>};
+
+template<::std::integral char_type>
+inline constexpr std::int_least64_t flt_scan_exponent_digits(char_type const*& first,char_type const* last) noexcept
+{
+	std::int_least64_t e{};
+	for(;first!=last&&flt_scan_is_digit(*first);++first)
+	{
+		if(e<0x10000000)
+		{
+			e=e*10+static_cast<std::int_least64_t>(flt_scan_digit_value(*first));
+		}
+	}
+	return e;
+}
+
+template<::fast_io::manipulators::floating_format fm,bool comma,::std::integral char_type,typename flt>
+inline constexpr parse_result<char_type const*> scan_decimal_float_impl(char_type const* first,char_type const* last,bool negative,flt& t) noexcept
+{
+	constexpr char_type decimal_point{flt_scan_decimal_point<comma,char_type>};
+	char_type const* mantissa_first{first};
+	std::uint_least64_t w{};
+	auto it{flt_scan_digits(first,last,w)};
+	flt_scan_decimal_span sp{static_cast<std::size_t>(it-first),0,0,false};
+	if(it!=last&&*it==decimal_point)
+	{
+		sp.has_fraction=true;
+		auto frac_first{it+1};
+		it=flt_scan_digits(frac_first,last,w);
+		sp.frac_digits=static_cast<std::size_t>(it-frac_first);
+	}
+	if(sp.int_digits+sp.frac_digits==0)
+	{
+		return {it,parse_code::invalid};
+	}
+	if constexpr(fm!=::fast_io::manipulators::floating_format::fixed)
+	{
+		bool has_exponent{};
+		if(it!=last&&flt_scan_is_letter<u8'e'>(*it))
+		{
+			auto exp_it{it+1};
+			bool neg_exp{};
+			if(exp_it!=last)
+			{
+				if(*exp_it==char_literal_v<u8'-',char_type>)
+				{
+					neg_exp=true;
+					++exp_it;
+				}
+				else if(*exp_it==char_literal_v<u8'+',char_type>)
+				{
+					++exp_it;
+				}
+			}
+			if(exp_it==last)
+			{
+				return {exp_it,parse_code::invalid};
+			}
+			if(flt_scan_is_digit(*exp_it))
+			{
+				std::int_least64_t e{flt_scan_exponent_digits(exp_it,last)};
+				sp.exp10=neg_exp?-e:e;
+				it=exp_it;
+				has_exponent=true;
+			}
+			else if constexpr(fm==::fast_io::manipulators::floating_format::scientific)
+			{
+				return {exp_it,parse_code::invalid};
+			}
+		}
+		if constexpr(fm==::fast_io::manipulators::floating_format::scientific)
+		{
+			if(!has_exponent)
+			{
+				return {it,parse_code::invalid};
+			}
+		}
+	}
+	using work_type = flt_scan_work_type<flt>;
+	work_type value;
+	auto ec{flt_scan_decimal_to_float<work_type>(mantissa_first,sp,w,negative,value)};
+	if(ec==parse_code::ok)
+	{
+		t=static_cast<flt>(value);
+	}
+	return {it,ec};
+}
+
+template<::std::integral char_type>
+inline constexpr bool flt_scan_hex_digit(char_type ch,std::uint_least32_t& d) noexcept
+{
+	using unsigned_char_type = my_make_unsigned_t<char_type>;
+	unsigned_char_type uch{static_cast<unsigned_char_type>(ch)};
+	if(char_digit_to_literal<16,char_type>(uch))
+	{
+		return false;
+	}
+	d=static_cast<std::uint_least32_t>(uch);
+	return true;
+}
+
+template<bool comma,::std::integral char_type,typename flt>
+inline constexpr parse_result<char_type const*> scan_hexfloat_impl(char_type const* first,char_type const* last,bool negative,flt& t) noexcept
+{
+	if(*first==char_literal_v<u8'0',char_type>&&last-first>1&&flt_scan_is_letter<u8'x'>(first[1]))
+	{
+		first+=2;
+	}
+	std::uint_least64_t m{};
+	std::int_least64_t e2{};
+	std::uint_least32_t sig{};
+	bool sticky{},any_digit{};
+	std::uint_least32_t d;
+	for(;first!=last&&flt_scan_hex_digit(*first,d);++first)
+	{
+		any_digit=true;
+		if(sig<16u)
+		{
+			m=(m<<4u)|d;
+			if(m)
+			{
+				++sig;
+			}
+		}
+		else
+		{
+			sticky|=(d!=0);
+			e2+=4;
+		}
+	}
+	if(first!=last&&*first==flt_scan_decimal_point<comma,char_type>)
+	{
+		++first;
+		for(;first!=last&&flt_scan_hex_digit(*first,d);++first)
+		{
+			any_digit=true;
+			if(sig<16u)
+			{
+				m=(m<<4u)|d;
+				if(m)
+				{
+					++sig;
+				}
+				e2-=4;
+			}
+			else
+			{
+				sticky|=(d!=0);
+			}
+		}
+	}
+	if(!any_digit)
+	{
+		return {first,parse_code::invalid};
+	}
+	if(first!=last&&flt_scan_is_letter<u8'p'>(*first))
+	{
+		auto exp_it{first+1};
+		bool neg_exp{};
+		if(exp_it!=last)
+		{
+			if(*exp_it==char_literal_v<u8'-',char_type>)
+			{
+				neg_exp=true;
+				++exp_it;
+			}
+			else if(*exp_it==char_literal_v<u8'+',char_type>)
+			{
+				++exp_it;
+			}
+		}
+		if(exp_it==last)
+		{
+			return {exp_it,parse_code::invalid};
+		}
+		if(flt_scan_is_digit(*exp_it))
+		{
+			std::int_least64_t e{flt_scan_exponent_digits(exp_it,last)};
+			e2+=neg_exp?-e:e;
+			first=exp_it;
+		}
+	}
+	using work_type = flt_scan_work_type<flt>;
+	constexpr std::int_least32_t mbits{static_cast<std::int_least32_t>(iec559_traits<work_type>::mbits)};
+	constexpr std::int_least64_t bias{-static_cast<std::int_least64_t>(eisel_lemire_traits<work_type>::minimum_exponent)};
+	constexpr std::int_least32_t infinite_power{eisel_lemire_infinite_power<work_type>};
+	adjusted_mantissa am{};
+	if(m)
+	{
+		std::int_least32_t const lz{static_cast<std::int_least32_t>(::std::countl_zero(m))};
+		m<<=lz;
+		std::int_least64_t biased{e2+63-lz+bias};
+		if(infinite_power<=biased)
+		{
+			return {first,parse_code::overflow};
+		}
+		std::int_least64_t rshift{64-(mbits+1)};
+		if(biased<=0)
+		{
+			rshift+=1-biased;
+		}
+		std::uint_least64_t kept{},round_bit{};
+		if(rshift<64)
+		{
+			kept=m>>rshift;
+		}
+		if(rshift<=64)
+		{
+			round_bit=(m>>(rshift-1))&1u;
+		}
+		if(rshift<=64)
+		{
+			sticky|=(m&((static_cast<std::uint_least64_t>(1u)<<(rshift-1))-1u))!=0;
+		}
+		else
+		{
+			sticky|=m!=0;
+		}
+		if(round_bit&&(sticky||(kept&1u)))
+		{
+			++kept;
+		}
+		if(biased<=0)
+		{
+			am.power2=(kept>>mbits)!=0?1:0;
+		}
+		else
+		{
+			if((kept>>(mbits+1))!=0)
+			{
+				kept>>=1u;
+				++biased;
+				if(infinite_power<=biased)
+				{
+					return {first,parse_code::overflow};
+				}
+			}
+			am.power2=static_cast<std::int_least32_t>(biased);
+		}
+		am.mantissa=kept&((static_cast<std::uint_least64_t>(1u)<<mbits)-1u);
+	}
+	t=static_cast<flt>(adjusted_mantissa_to_float<work_type>(am,negative));
+	return {first,parse_code::ok};
+}
+
+template<::fast_io::manipulators::floating_format fm,bool comma,::std::integral char_type,typename flt>
+inline constexpr parse_result<char_type const*> scan_float_contiguous_none_space_part_define_impl(char_type const* first,char_type const* last,flt& t) noexcept
+{
+	static_assert(flt_scan_supported<flt>,"currently only support iec559 float32 and float64, sorry");
+	if(first==last)
+	{
+		return {first,parse_code::invalid};
+	}
+	bool negative{};
+	if(*first==char_literal_v<u8'-',char_type>)
+	{
+		negative=true;
+		++first;
+		if(first==last)
+		{
+			return {first,parse_code::invalid};
+		}
+	}
+	if(flt_scan_is_letter<u8'i'>(*first)||flt_scan_is_letter<u8'n'>(*first))
+	{
+		bool const isnan{flt_scan_is_letter<u8'n'>(*first)};
+		auto ret{flt_scan_special_impl(first,last)};
+		if(ret.code==parse_code::ok)
+		{
+			using work_type = flt_scan_work_type<flt>;
+			work_type v{isnan ? ::std::numeric_limits<work_type>::quiet_NaN() : ::std::numeric_limits<work_type>::infinity()};
+			t=static_cast<flt>(negative?-v:v);
+		}
+		return ret;
+	}
+	if constexpr(fm==::fast_io::manipulators::floating_format::hexfloat)
+	{
+		return scan_hexfloat_impl<comma>(first,last,negative,t);
+	}
+	else
+	{
+		return scan_decimal_float_impl<fm,comma>(first,last,negative,t);
+	}
+}
+
+template<::fast_io::manipulators::floating_format fm,bool noskipws,bool comma,::std::integral char_type,typename flt>
+inline constexpr parse_result<char_type const*> scan_float_contiguous_define_impl(char_type const* first,char_type const* last,flt& t) noexcept
+{
+	if constexpr(!noskipws)
+	{
+		first=::fast_io::details::find_space_common_impl<false,true>(first,last);
+		if(first==last)
+			return {first,parse_code::end_of_file};
+	}
+	return scan_float_contiguous_none_space_part_define_impl<fm,comma>(first,last,t);
+}
+
+/*
+Characters that may continue a floating-point token; the context version buffers exactly these across underflows.
+*/
+template<::fast_io::manipulators::floating_format fm,bool comma,::std::integral char_type>
+inline constexpr bool flt_scan_is_token_char(char_type ch) noexcept
+{
+	if constexpr(fm==::fast_io::manipulators::floating_format::hexfloat)
+	{
+		std::uint_least32_t d;
+		if(flt_scan_hex_digit(ch,d)||flt_scan_is_letter<u8'x'>(ch)||flt_scan_is_letter<u8'p'>(ch)||
+			ch==flt_scan_decimal_point<comma,char_type>)
+		{
+			return true;
+		}
+	}
+	else
+	{
+		if(flt_scan_is_digit(ch)||ch==flt_scan_decimal_point<comma,char_type>)
+		{
+			return true;
+		}
+		if constexpr(fm!=::fast_io::manipulators::floating_format::fixed)
+		{
+			if(flt_scan_is_letter<u8'e'>(ch))
+			{
+				return true;
+			}
+		}
+	}
+	return ch==char_literal_v<u8'-',char_type>||ch==char_literal_v<u8'+',char_type>||
+		flt_scan_is_letter<u8'i'>(ch)||flt_scan_is_letter<u8'n'>(ch)||flt_scan_is_letter<u8'f'>(ch)||
+		flt_scan_is_letter<u8't'>(ch)||flt_scan_is_letter<u8'y'>(ch)||flt_scan_is_letter<u8'a'>(ch);
+}
+
+template<::fast_io::manipulators::floating_format fm,bool noskipws,bool comma,::std::integral char_type,typename flt>
+inline constexpr parse_result<char_type const*> scan_float_context_define_impl(::fast_io::details::basic_concat_buffer<char_type>& buf,
+	char_type const* first,char_type const* last,flt& t) noexcept
+{
+	std::size_t const old_size{static_cast<std::size_t>(buf.buffer_curr-buf.buffer_begin)};
+	if constexpr(!noskipws)
+	{
+		if(old_size==0)
+		{
+			first=::fast_io::details::find_space_common_impl<false,true>(first,last);
+			if(first==last)
+				return {first,parse_code::partial};
+		}
+	}
+	auto it{first};
+	for(;it!=last&&flt_scan_is_token_char<fm,comma>(*it);++it);
+	std::size_t const diff{static_cast<std::size_t>(it-first)};
+	std::size_t const new_size{old_size+diff};
+	std::size_t const capacity{static_cast<std::size_t>(buf.buffer_end-buf.buffer_begin)};
+	if(capacity<new_size)
+	{
+		basic_concat_buffer_strlike_reserve_cold_impl(buf,(new_size<(capacity<<1u))?(capacity<<1u):new_size,capacity);
+	}
+	buf.buffer_curr=non_overlapped_copy_n(first,diff,buf.buffer_curr);
+	if(it==last)
+	{
+		return {it,parse_code::partial};
+	}
+	char_type const* bfirst{buf.buffer_begin};
+	auto [p,ec]=scan_float_contiguous_none_space_part_define_impl<fm,comma>(bfirst,bfirst+new_size,t);
+	buf.buffer_curr=buf.buffer_begin;
+	std::size_t const consumed{static_cast<std::size_t>(p-bfirst)};
+	if(consumed<old_size)
+	{
+		return {first,parse_code::invalid};
+	}
+	return {first+(consumed-old_size),ec};
+}
+
+template<::fast_io::manipulators::floating_format fm,bool noskipws,bool comma,::std::integral char_type,typename flt>
+#if __has_cpp_attribute(__gnu__::__cold__)
+[[__gnu__::__cold__]]
+#endif
+inline constexpr parse_code scan_float_context_eof_define_impl(::fast_io::details::basic_concat_buffer<char_type>& buf,flt& t) noexcept
+{
+	if(buf.buffer_curr==buf.buffer_begin)
+	{
+		if constexpr(noskipws)
+		{
+			return parse_code::invalid;
+		}
+		else
+		{
+			return parse_code::end_of_file;
+		}
+	}
+	char_type const* bfirst{buf.buffer_begin};
+	char_type const* blast{buf.buffer_curr};
+	buf.buffer_curr=buf.buffer_begin;
+	return scan_float_contiguous_none_space_part_define_impl<fm,comma>(bfirst,blast,t).code;
+}
+
+template<::fast_io::manipulators::floating_format fm>
+inline constexpr ::fast_io::manipulators::floating_format flt_scan_format{
+	(fm==::fast_io::manipulators::floating_format::decimal)?::fast_io::manipulators::floating_format::general:fm};
+
+}
+
+namespace manipulators
+{
+
+template<bool noskipws=false,::fast_io::details::my_floating_point flt>
+inline constexpr scalar_manip_t<::fast_io::details::flt_scan_mani_flags_cache<noskipws,false,floating_format::general>,flt&> general_get(flt& t) noexcept
+{
+	return {t};
+}
+
+template<bool noskipws=false,::fast_io::details::my_floating_point flt>
+inline constexpr scalar_manip_t<::fast_io::details::flt_scan_mani_flags_cache<noskipws,true,floating_format::general>,flt&> comma_general_get(flt& t) noexcept
+{
+	return {t};
+}
+
+template<bool noskipws=false,::fast_io::details::my_floating_point flt>
+inline constexpr scalar_manip_t<::fast_io::details::flt_scan_mani_flags_cache<noskipws,false,floating_format::fixed>,flt&> fixed_get(flt& t) noexcept
+{
+	return {t};
+}
+
+template<bool noskipws=false,::fast_io::details::my_floating_point flt>
+inline constexpr scalar_manip_t<::fast_io::details::flt_scan_mani_flags_cache<noskipws,true,floating_format::fixed>,flt&> comma_fixed_get(flt& t) noexcept
+{
+	return {t};
+}
+
+template<bool noskipws=false,::fast_io::details::my_floating_point flt>
+inline constexpr scalar_manip_t<::fast_io::details::flt_scan_mani_flags_cache<noskipws,false,floating_format::scientific>,flt&> scientific_get(flt& t) noexcept
+{
+	return {t};
+}
+
+template<bool noskipws=false,::fast_io::details::my_floating_point flt>
+inline constexpr scalar_manip_t<::fast_io::details::flt_scan_mani_flags_cache<noskipws,true,floating_format::scientific>,flt&> comma_scientific_get(flt& t) noexcept
+{
+	return {t};
+}
+
+template<bool noskipws=false,::fast_io::details::my_floating_point flt>
+inline constexpr scalar_manip_t<::fast_io::details::flt_scan_mani_flags_cache<noskipws,false,floating_format::hexfloat>,flt&> hexfloat_get(flt& t) noexcept
+{
+	return {t};
+}
+
+template<bool noskipws=false,::fast_io::details::my_floating_point flt>
+inline constexpr scalar_manip_t<::fast_io::details::flt_scan_mani_flags_cache<noskipws,true,floating_format::hexfloat>,flt&> comma_hexfloat_get(flt& t) noexcept
+{
+	return {t};
+}
+
+}
+
+template<details::my_floating_point flt>
+inline constexpr ::fast_io::manipulators::scalar_manip_t<::fast_io::details::flt_scan_mani_flags_cache<false,false,::fast_io::manipulators::floating_format::general>,flt&> scan_alias_define(io_alias_t,flt& t) noexcept
+{
+	return {t};
+}
+
+template<std::integral char_type,manipulators::scalar_flags flags,details::my_floating_point flt>
+inline constexpr io_type_t<::fast_io::details::basic_concat_buffer<char_type>> scan_context_type(io_reserve_type_t<char_type,::fast_io::manipulators::scalar_manip_t<flags,flt&>>) noexcept
+{
+	return {};
+}
+
+template<::std::integral char_type,manipulators::scalar_flags flags,details::my_floating_point flt>
+inline constexpr parse_result<char_type const*> scan_contiguous_define(io_reserve_type_t<char_type,::fast_io::manipulators::scalar_manip_t<flags,flt&>>,char_type const* begin,char_type const* end,::fast_io::manipulators::scalar_manip_t<flags,flt&> t) noexcept
+{
+	return details::scan_float_contiguous_define_impl<details::flt_scan_format<flags.floating>,flags.noskipws,flags.comma>(begin,end,t.reference);
+}
+
+template<::std::integral char_type,manipulators::scalar_flags flags,details::my_floating_point flt>
+inline constexpr parse_result<char_type const*> scan_context_define(io_reserve_type_t<char_type,::fast_io::manipulators::scalar_manip_t<flags,flt&>>,::fast_io::details::basic_concat_buffer<char_type>& state,char_type const* begin,char_type const* end,::fast_io::manipulators::scalar_manip_t<flags,flt&> t) noexcept
+{
+	return details::scan_float_context_define_impl<details::flt_scan_format<flags.floating>,flags.noskipws,flags.comma>(state,begin,end,t.reference);
+}
+
+template<::std::integral char_type,manipulators::scalar_flags flags,details::my_floating_point flt>
+inline constexpr parse_code scan_context_eof_define(io_reserve_type_t<char_type,::fast_io::manipulators::scalar_manip_t<flags,flt&>>,::fast_io::details::basic_concat_buffer<char_type>& state,::fast_io::manipulators::scalar_manip_t<flags,flt&> t) noexcept
+{
+	return details::scan_float_context_eof_define_impl<details::flt_scan_format<flags.floating>,flags.noskipws,flags.comma>(state,t.reference);
+}
+
+}
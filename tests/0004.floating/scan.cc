@@ -0,0 +1,74 @@
+﻿#include<fast_io.h>
+#include<cstring>
+#include<random>
+#include"../check.h"
+
+using namespace fast_io::io;
+using namespace fast_io_test;
+
+template<typename flt,typename P,typename G>
+inline bool roundtrip(flt v,P pr,G gt)
+{
+	char buffer[1024];
+	fast_io::obuffer_view obv(buffer,buffer+sizeof(buffer));
+	print(obv,pr(v));
+	fast_io::ibuffer_view ibv(obv.cbegin(),obv.cend());
+	flt r{};
+	if(!scan<true>(ibv,gt(r)))
+	{
+		return false;
+	}
+	return std::memcmp(__builtin_addressof(r),__builtin_addressof(v),sizeof(flt))==0;
+}
+
+/*
+Decimal text is printed from double: the shortest double representation of a float still rounds back to that float.
+*/
+template<typename flt,typename U>
+inline void test_type(std::mt19937_64& eng)
+{
+	using namespace fast_io::mnp;
+	for(std::size_t i{};i!=100000;++i)
+	{
+		U bits{static_cast<U>(eng())};
+		flt v;
+		std::memcpy(__builtin_addressof(v),__builtin_addressof(bits),sizeof(flt));
+		if(v!=v||v-v!=v-v)
+		{
+			continue;
+		}
+		check(roundtrip(v,[](flt x){return static_cast<double>(x);},[](flt& x){return general_get(x);}),"general round trip");
+		check(roundtrip(v,[](flt x){return scientific(static_cast<double>(x));},[](flt& x){return scientific_get(x);}),"scientific round trip");
+		check(roundtrip(v,[](flt x){return comma_scientific(static_cast<double>(x));},[](flt& x){return comma_scientific_get(x);}),"comma_scientific round trip");
+		check(roundtrip(v,[](flt x){return fixed(static_cast<double>(x));},[](flt& x){return fixed_get(x);}),"fixed round trip");
+		check(roundtrip(v,[](flt x){return hexfloat(x);},[](flt& x){return hexfloat_get(x);}),"hexfloat round trip");
+		check(roundtrip(v,[](flt x){return comma_hexfloat(x);},[](flt& x){return comma_hexfloat_get(x);}),"comma_hexfloat round trip");
+	}
+}
+
+int main()
+{
+	std::mt19937_64 eng;
+	test_type<double,std::uint_least64_t>(eng);
+	test_type<float,std::uint_least32_t>(eng);
+	/*
+	More than 19 significant digits sitting right next to the halfway point between two doubles take the slow path.
+	*/
+	double a,b,c,d;
+	constexpr char str[]{"9007199254740993.0000000000000000000000000000001 9007199254740993 1e-400 -inf"};
+	fast_io::ibuffer_view ibv(str,str+sizeof(str)-1);
+	scan(ibv,a,b,c,d);
+	check(a==9007199254740994.0&&b==9007199254740992.0&&c==0&&d==-std::numeric_limits<double>::infinity(),"slow path rounding");
+	/*
+	A partial "infinity" at the end of input is "inf" followed by unread letters, just as it is mid-stream.
+	*/
+	for(std::string_view e:{"infin","infin ","infinity","inf"})
+	{
+		fast_io::ibuffer_view iv(e.data(),e.data()+e.size());
+		double x{};
+		scan(iv,x);
+		std::size_t const consumed{static_cast<std::size_t>(ibuffer_curr(iv)-e.data())};
+		check(x==std::numeric_limits<double>::infinity()&&consumed==(e.starts_with("infinity")?8u:3u),"partial infinity");
+	}
+	return report();
+}
@@ -0,0 +1,132 @@
+#include<string>
+#include<string_view>
+#include<random>
+#include<fast_io.h>
+#include<fast_io_device.h>
+#include"../check.h"
+
+using namespace fast_io::io;
+using namespace fast_io_test;
+
+/*
+Needs a file system that accepts O_DIRECT (tmpfs before Linux 6.6 does not), so the file lives in the working
+directory rather than in io_temp.
+*/
+inline constexpr char8_t direct_file_name[]{u8"direct_test.txt"};
+
+inline std::string read_back()
+{
+	fast_io::native_file file(direct_file_name,fast_io::open_mode::in);
+	std::string text(static_cast<std::size_t>(seek(file,0,fast_io::seekdir::end)),'\0');
+	seek(file,0,fast_io::seekdir::beg);
+	text.resize(static_cast<std::size_t>(read(file,text.data(),text.data()+text.size())-text.data()));
+	return text;
+}
+
+inline bool aligned(void const* p)
+{
+	return reinterpret_cast<std::uintptr_t>(p)%fast_io::io_direct_alignment==0;
+}
+
+template<fast_io::buffer_mode extra,std::size_t bfs>
+inline std::string test_output(std::uint_least64_t seed)
+{
+	std::mt19937_64 eng(seed);
+	std::string expected;
+	{
+		fast_io::basic_io_buffer<fast_io::native_file,fast_io::buffer_mode::out|fast_io::buffer_mode::direct|extra,
+			fast_io::basic_decorators<char>,bfs> obf(direct_file_name,
+			fast_io::open_mode::out|fast_io::open_mode::direct);
+		for(std::size_t i{};i!=3000;++i)
+		{
+			switch(eng()%8)
+			{
+			case 0:
+			{
+				std::string const big(eng()%(3*bfs),static_cast<char>('a'+i%26));
+				write(obf,big.data(),big.data()+big.size());
+				expected.append(big);
+				break;
+			}
+			case 1:
+				put(obf,'#');
+				expected.push_back('#');
+				break;
+			default:
+			{
+				std::uint_least64_t const v{eng()};
+				println(obf,"line ",i," value ",v);
+				expected.append(fast_io::concat<std::string>("line ",i," value ",v,"\n"));
+			}
+			}
+			check(aligned(obuffer_begin(obf)),"output buffer is block aligned");
+			if(i%1000==999)
+			{
+				flush(obf);
+				check(read_back()==expected,"flush leaves the file at the stream's length");
+			}
+		}
+	}
+	check(read_back()==expected,"close writes the partial last block and truncates");
+	return expected;
+}
+
+inline void test_seek_output()
+{
+	{
+		fast_io::basic_io_buffer<fast_io::native_file,fast_io::buffer_mode::out|fast_io::buffer_mode::direct>
+			obf(direct_file_name,fast_io::open_mode::out|fast_io::open_mode::direct);
+		print(obf,"0123456789");
+		check(seek(obf,0,fast_io::seekdir::cur)==10,"seek reports the logical position");
+		check(seek(obf,0,fast_io::seekdir::beg)==0,"seek back to the first block");
+		print(obf,"abc");
+	}
+	check(read_back()=="abc","the file ends where the stream does");
+}
+
+template<std::size_t bfs>
+inline void test_input(std::string const& expected,std::uint_least64_t seed)
+{
+	std::mt19937_64 eng(seed);
+	fast_io::basic_io_buffer<fast_io::native_file,fast_io::buffer_mode::in|fast_io::buffer_mode::direct,
+		fast_io::basic_decorators<char>,bfs> ibf(direct_file_name,
+		fast_io::open_mode::in|fast_io::open_mode::direct);
+	std::string text;
+	std::string chunk;
+	for(;;)
+	{
+		chunk.resize(1+eng()%(3*bfs));
+		std::size_t const n{static_cast<std::size_t>(read(ibf,chunk.data()+1,chunk.data()+chunk.size())-(chunk.data()+1))};
+		text.append(chunk.data()+1,n);
+		check(ibuffer_begin(ibf)==nullptr||aligned(ibuffer_begin(ibf)),"input buffer is block aligned");
+		if(n==0)
+			break;
+	}
+	check(text==expected,"reads into unaligned memory");
+	for(std::size_t i{};i!=200;++i)
+	{
+		std::size_t const position{static_cast<std::size_t>(eng()%expected.size())};
+		check(seek(ibf,static_cast<std::intmax_t>(position),fast_io::seekdir::beg)==position,"seek position");
+		std::size_t const length{1+static_cast<std::size_t>(eng()%10000)};
+		chunk.resize(length);
+		std::size_t const n{static_cast<std::size_t>(read(ibf,chunk.data(),chunk.data()+chunk.size())-chunk.data())};
+		chunk.resize(n);
+		if(chunk!=std::string_view(expected).substr(position,length))
+		{
+			check(false,"read after an unaligned seek");
+			break;
+		}
+	}
+}
+
+int main()
+{
+	auto const expected{test_output<fast_io::buffer_mode{},4096>(1)};
+	test_input<4096>(expected,2);
+	test_input<fast_io::io_default_buffer_size<char>>(expected,3);
+	test_output<fast_io::buffer_mode::pooled,fast_io::io_default_buffer_size<char>>(4);
+	test_output<fast_io::buffer_mode::secure_clear,16384>(5);
+	test_seek_output();
+	fast_io::native_unlinkat(fast_io::at_fdcwd(),direct_file_name);
+	return report();
+}
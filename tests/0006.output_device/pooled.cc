@@ -0,0 +1,165 @@
+#include<atomic>
+#include<thread>
+#include<vector>
+#include<string>
+#include<string_view>
+#include<fast_io.h>
+#include<fast_io_device.h>
+#include"../check.h"
+
+using namespace fast_io::io;
+using namespace fast_io_test;
+
+inline std::atomic<std::size_t> upstream_allocations{};
+inline std::atomic<std::size_t> upstream_deallocations{};
+
+struct counting_upstream
+{
+	static inline void* allocate(std::size_t n) noexcept
+	{
+		upstream_allocations.fetch_add(1,std::memory_order_relaxed);
+		return fast_io::c_malloc_allocator::allocate(n);
+	}
+	static inline void deallocate(void* p) noexcept
+	{
+		if(p==nullptr)
+			return;
+		upstream_deallocations.fetch_add(1,std::memory_order_relaxed);
+		fast_io::c_malloc_allocator::deallocate(p);
+	}
+};
+
+inline constexpr std::size_t block{4096};
+using pool = fast_io::basic_iobuf_pool_allocator<block,counting_upstream>;
+inline constexpr std::size_t thread_cache{fast_io::details::iobuf_pool_thread_cache_size};
+inline constexpr std::size_t global_slots{fast_io::details::iobuf_pool_global_slots};
+
+/*
+Each case runs on its own thread so the thread caches start empty and are drained when it ends.
+*/
+inline void test_tiers()
+{
+	constexpr std::size_t extra{5};
+	std::vector<void*> blocks;
+	std::jthread([&]
+	{
+		void* p{pool::allocate(block)};
+		pool::deallocate_n(p,block);
+		check(pool::allocate(block)==p,"thread cache hands back the last buffer");
+		pool::deallocate_n(p,block);
+		check(upstream_allocations.load()==1,"one upstream allocation for a reused buffer");
+		for(std::size_t i{};i!=thread_cache+global_slots+extra;++i)
+			blocks.push_back(pool::allocate(block));
+		std::size_t const before{upstream_deallocations.load()};
+		for(auto e:blocks)
+			pool::deallocate_n(e,block);
+		check(upstream_deallocations.load()-before==extra,"only buffers beyond the cache and the slots go upstream");
+	}).join();
+	std::jthread([&]
+	{
+		std::size_t const before{upstream_allocations.load()};
+		std::vector<void*> claimed;
+		for(std::size_t i{};i!=global_slots;++i)
+			claimed.push_back(pool::allocate(block));
+		check(upstream_allocations.load()==before,"another thread claims the global slots");
+		for(auto e:claimed)
+			pool::deallocate_n(e,block);
+	}).join();
+	void* odd{pool::allocate(block+1)};
+	pool::deallocate_n(odd,block+1);
+	pool::trim();
+	check(upstream_allocations.load()==upstream_deallocations.load(),"trim returns every buffer");
+}
+
+inline void test_concurrent()
+{
+	{
+		std::vector<std::jthread> threads;
+		for(std::size_t t{};t!=4;++t)
+			threads.emplace_back([t]
+			{
+				std::vector<void*> held;
+				for(std::size_t i{};i!=20000;++i)
+				{
+					if(held.size()<(i*(t+3))%23)
+					{
+						auto p{reinterpret_cast<char unsigned*>(pool::allocate(block))};
+						p[0]=p[block-1]=static_cast<char unsigned>(t);
+						held.push_back(p);
+					}
+					else if(!held.empty())
+					{
+						auto p{reinterpret_cast<char unsigned*>(held.back())};
+						check(p[0]==t&&p[block-1]==t,"no buffer is handed to two owners");
+						held.pop_back();
+						pool::deallocate_n(p,block);
+					}
+				}
+				for(auto e:held)
+					pool::deallocate_n(e,block);
+			});
+	}
+	pool::trim();
+	check(upstream_allocations.load()==upstream_deallocations.load(),"concurrent use returns every buffer");
+}
+
+inline void test_huge_page()
+{
+	using huge = fast_io::basic_iobuf_pool_allocator<fast_io::details::iobuf_pool_huge_page_size>;
+	std::jthread([]
+	{
+		auto p{reinterpret_cast<char unsigned*>(huge::allocate(huge::block_size))};
+		if constexpr(huge::huge_page_backed)
+			check(reinterpret_cast<std::size_t>(p)%fast_io::details::iobuf_pool_huge_page_size==0,"huge page buffer is 2 MiB aligned");
+		for(std::size_t i{};i!=huge::block_size;i+=4096)
+			p[i]=1;
+		huge::deallocate_n(p,huge::block_size);
+		check(huge::allocate(huge::block_size)==p,"huge page buffer is reused");
+		huge::deallocate_n(p,huge::block_size);
+	}).join();
+	huge::trim();
+}
+
+/*
+Short-lived pooled files on several threads: every file on a thread reuses the same warm buffer and the output is
+intact.
+*/
+inline void test_files()
+{
+	using file_type = fast_io::basic_io_buffer<fast_io::native_file,fast_io::buffer_mode::out|fast_io::buffer_mode::pooled>;
+	{
+		std::vector<std::jthread> threads;
+		for(std::size_t t{};t!=4;++t)
+			threads.emplace_back([t]
+			{
+				char const* first_buffer{};
+				for(std::size_t i{};i!=200;++i)
+				{
+					file_type obf(fast_io::io_temp);
+					println(obf,"thread ",t," file ",i);
+					if(i==0)
+						first_buffer=obuffer_begin(obf);
+					else if(obuffer_begin(obf)!=first_buffer)
+					{
+						check(false,"each file reuses the thread's buffer");
+						break;
+					}
+					flush(obf);
+					std::string text(64,'\0');
+					auto n{::pread(obf.handle.fd,text.data(),text.size(),0)};
+					text.resize(n<0?0:static_cast<std::size_t>(n));
+					check(text==fast_io::concat<std::string>("thread ",t," file ",i,"\n"),"pooled output is intact");
+				}
+			});
+	}
+	fast_io::basic_iobuf_pool_allocator<file_type::buffer_size>::trim();
+}
+
+int main()
+{
+	test_tiers();
+	test_concurrent();
+	test_huge_page();
+	test_files();
+	return report();
+}
@@ -0,0 +1,169 @@
+//also build with -fsanitize=thread to cover the flusher thread
+#include<string>
+#include<string_view>
+#include<thread>
+#include<chrono>
+#include<random>
+#include<fast_io.h>
+#include<fast_io_device.h>
+#include"../check.h"
+
+using namespace fast_io::io;
+using namespace fast_io_test;
+
+/*
+An output device that takes its time, so the producer runs well ahead of the flusher.
+*/
+struct slow_output
+{
+	using char_type = char;
+	std::string* sink{};
+};
+
+inline void write(slow_output out,char const* first,char const* last)
+{
+	std::this_thread::sleep_for(std::chrono::microseconds(200));
+	out.sink->append(first,last);
+}
+
+template<typename handle_type,std::size_t bfs>
+using write_behind_buffer_of = fast_io::basic_io_buffer<handle_type,fast_io::buffer_mode::out|fast_io::buffer_mode::write_behind,
+	fast_io::basic_decorators<char>,bfs>;
+
+template<std::size_t bfs>
+using write_behind_buffer = write_behind_buffer_of<slow_output,bfs>;
+
+template<std::size_t bfs>
+inline void test_contents(std::uint_least64_t seed)
+{
+	std::mt19937_64 eng(seed);
+	std::string written,expected;
+	{
+		write_behind_buffer<bfs> obf(slow_output{__builtin_addressof(written)});
+		for(std::size_t i{};i!=2000;++i)
+		{
+			switch(eng()%4)
+			{
+			case 0:
+			{
+				std::string const big(eng()%(3*bfs),static_cast<char>('a'+i%26));
+				print(obf,big);
+				expected.append(big);
+				break;
+			}
+			case 1:
+				put(obf,'#');
+				expected.push_back('#');
+				break;
+			default:
+			{
+				std::uint_least64_t const v{eng()%1000000};
+				println(obf,"line ",i," value ",v);
+				expected.append(fast_io::concat<std::string>("line ",i," value ",v,"\n"));
+			}
+			}
+			if(i%500==499)
+			{
+				flush(obf);
+				check(written==expected,"flush is a barrier");
+			}
+		}
+	}
+	check(written==expected,"every byte written in order");
+}
+
+inline void test_file_and_move()
+{
+	fast_io::native_file file(fast_io::io_temp);
+	std::string expected;
+	{
+		fast_io::basic_io_buffer<fast_io::native_io_observer,fast_io::buffer_mode::out|fast_io::buffer_mode::write_behind,
+			fast_io::basic_decorators<char>,4096> obf(fast_io::native_io_observer{file.fd});
+		for(std::size_t i{};i!=10000;++i)
+		{
+			println(obf,"first ",i);
+			expected.append(fast_io::concat<std::string>("first ",i,"\n"));
+		}
+		auto moved{std::move(obf)};
+		for(std::size_t i{};i!=10000;++i)
+		{
+			println(moved,"second ",i);
+			expected.append(fast_io::concat<std::string>("second ",i,"\n"));
+		}
+	}
+	seek(file,0,fast_io::seekdir::beg);
+	std::string text(expected.size()+1,'\0');
+	text.resize(static_cast<std::size_t>(read(file,text.data(),text.data()+text.size())-text.data()));
+	check(text==expected,"file contents after move");
+}
+
+inline void test_error()
+{
+	fast_io::native_file readonly(u8"/dev/null",fast_io::open_mode::in);
+	fast_io::basic_io_buffer<fast_io::native_io_observer,fast_io::buffer_mode::out|fast_io::buffer_mode::write_behind,
+		fast_io::basic_decorators<char>,64> obf(fast_io::native_io_observer{readonly.fd});
+	/*
+	print's reserve path flushes through noexcept obuffer_constant_flush_prepare, so only raw writes and flush() may
+	report the error here.
+	*/
+	auto throws_posix_error{[](auto f)
+	{
+		try
+		{
+			f();
+		}
+		catch(fast_io::error const& e)
+		{
+			return e.domain==fast_io::posix_domain_value;
+		}
+		return false;
+	}};
+	constexpr std::string_view line{"cannot be written\n"};
+	check(throws_posix_error([&]{write(obf,line.data(),line.data()+line.size());flush(obf);}),"flush reports the flusher's error");
+	std::string const big(1000,'x');
+	check(throws_posix_error([&]{write(obf,big.data(),big.data()+big.size());}),"later writes report it too");
+}
+
+/*
+A device that fails with something other than fast_io::error: the flusher must still hand it to the producer.
+*/
+struct device_gone
+{};
+
+struct throwing_output
+{
+	using char_type = char;
+};
+
+inline void write(throwing_output,char const*,char const*)
+{
+	throw device_gone{};
+}
+
+inline void test_foreign_error()
+{
+	write_behind_buffer_of<throwing_output,64> obf(throwing_output{});
+	bool thrown{};
+	try
+	{
+		std::string const big(1000,'x');
+		write(obf,big.data(),big.data()+big.size());
+		flush(obf);
+	}
+	catch(device_gone const&)
+	{
+		thrown=true;
+	}
+	check(thrown,"flush rethrows a foreign exception");
+}
+
+int main()
+{
+	test_contents<64>(1);
+	test_contents<4096>(2);
+	test_contents<fast_io::io_default_buffer_size<char>>(3);
+	test_file_and_move();
+	test_error();
+	test_foreign_error();
+	return report();
+}
@@ -0,0 +1,150 @@
+#include<string>
+#include<string_view>
+#include<fast_io.h>
+#include<fast_io_device.h>
+#include"../check.h"
+
+using namespace fast_io::io;
+using namespace fast_io_test;
+
+/*
+Scans the header through an input buffer of bfs bytes so small buffers hit every partial state of the scanner.
+Returns false when the scan rejects the header.
+*/
+template<std::size_t bfs,typename header_buffer>
+inline bool scan_header(std::string_view text,header_buffer& hb)
+{
+	fast_io::native_file file(fast_io::io_temp);
+	write(file,text.data(),text.data()+text.size());
+	seek(file,0,fast_io::seekdir::beg);
+	fast_io::basic_io_buffer<fast_io::native_io_observer,fast_io::buffer_mode::in,fast_io::basic_decorators<char>,bfs> ibf{fast_io::native_io_observer{file.fd}};
+	try
+	{
+		scan(ibf,hb);
+	}
+	catch(fast_io::error const&)
+	{
+		return false;
+	}
+	return true;
+}
+
+template<typename header_buffer>
+inline std::string_view value_of(header_buffer const& hb,std::string_view name)
+{
+	std::size_t const i{hb.find(name.data(),name.size())};
+	if(i==hb.npos)
+		return "<missing>";
+	auto const v{hb.field(i).value};
+	return {v.ptr,v.n};
+}
+
+template<std::size_t bfs,std::size_t header_size>
+inline void test_request()
+{
+	constexpr std::string_view request{"POST /upload?x=1 HTTP/1.1\r\n"
+		"Host: example.com\r\n"
+		"content-LENGTH:   1234 \t\r\n"
+		"Connection: Keep-Alive, Upgrade\r\n"
+		"X-Empty:\r\n"
+		"Cookie: a=1\r\n"
+		"COOKIE: b=2\r\n"
+		"Upgrade: websocket\r\n\r\n"
+		"body that must not be consumed"};
+	fast_io::basic_http_header_buffer<char,header_size> hb;
+	if(!scan_header<bfs>(request,hb))
+	{
+		check(false,"valid request rejected");
+		return;
+	}
+	check(std::string_view(hb.request().ptr,hb.request().n)=="POST","request");
+	check(hb.field_size()==7,"field count");
+	check(value_of(hb,"HOST")=="example.com","case-insensitive lookup");
+	check(value_of(hb,"Content-Length")=="1234","value trimmed");
+	check(value_of(hb,"x-empty")=="","empty value");
+	check(value_of(hb,"cookie")=="a=1","first duplicate wins");
+	check(value_of(hb,"Cookie2")=="<missing>","missing field");
+	check(value_of(hb,"Hos")=="<missing>","prefix is not a match");
+	check(hb.find("Upgrade")==6,"literal lookup");
+	auto const last{hb.field(6)};
+	check(std::string_view(last.key.ptr,last.key.n)=="Upgrade"&&std::string_view(last.value.ptr,last.value.n)=="websocket","field by index");
+	check(hb.has_content_length&&hb.content_length==1234,"content length decoded");
+	check(!hb.chunked&&!hb.has_transfer_encoding,"not chunked");
+	check(hb.connection_keep_alive&&hb.connection_upgrade&&!hb.connection_close,"connection options");
+}
+
+inline void test_response()
+{
+	constexpr std::string_view response{"HTTP/1.1 200 OK\r\n"
+		"Transfer-Encoding: gzip, chunked\r\n"
+		"Connection: close\r\n\r\n"};
+	fast_io::http_header_buffer hb;
+	check(scan_header<7>(response,hb),"response accepted");
+	check(std::string_view(hb.code().ptr,hb.code().n)=="200","status code");
+	check(hb.chunked&&!hb.has_content_length,"chunked decoded");
+	check(hb.connection_close,"connection close");
+	fast_io::http_header_buffer hb2;
+	check(scan_header<4096>("HTTP/1.1 200 OK\r\nTransfer-Encoding: chunked, gzip\r\n\r\n",hb2)&&!hb2.chunked&&hb2.has_transfer_encoding,"chunked must be the final coding");
+	fast_io::http_header_buffer hb3;
+	check(scan_header<4096>("HTTP/1.1 200 OK\r\nTransfer-Encoding: gzip\r\nTransfer-Encoding: chunked\r\nTransfer-Encoding:\r\n\r\n",hb3)&&hb3.chunked,"final coding across field lines");
+	fast_io::http_header_buffer hb4;
+	check(scan_header<4096>("POST / HTTP/1.1\r\nTransfer-Encoding: gzip,\r\nTransfer-Encoding: chunked\r\n\r\n",hb4)&&hb4.chunked&&hb4.has_transfer_encoding,"chunked request");
+}
+
+inline void test_many_fields()
+{
+	std::string text{"GET / HTTP/1.1\r\n"};
+	for(std::size_t i{};i!=fast_io::http_header_field_capacity;++i)
+		text.append("X-Field-"+std::to_string(i)+": "+std::to_string(i*7)+"\r\n");
+	fast_io::http_header_buffer hb;
+	check(scan_header<4096>(text+"\r\n",hb),"capacity fields accepted");
+	bool ok{hb.field_size()==fast_io::http_header_field_capacity};
+	for(std::size_t i{};i!=fast_io::http_header_field_capacity;++i)
+		ok&=value_of(hb,"x-field-"+std::to_string(i))==std::to_string(i*7);
+	check(ok,"every field found");
+	fast_io::http_header_buffer hb2;
+	check(!scan_header<4096>(text+"X-One-Too-Many: 1\r\n\r\n",hb2),"too many fields rejected");
+}
+
+inline void test_invalid()
+{
+	constexpr std::string_view cases[]{
+		"GET / HTTP/1.1\r\nHost : a\r\n\r\n",
+		"GET / HTTP/1.1\r\nHost: a\r\n folded\r\n\r\n",
+		"GET / HTTP/1.1\r\nNoColon\r\n\r\n",
+		"GET / HTTP/1.1\r\n: empty name\r\n\r\n",
+		"GET / HTTP/1.1\r\nContent-Length: 12a\r\n\r\n",
+		"GET / HTTP/1.1\r\nContent-Length: 5\r\nContent-Length: 6\r\n\r\n",
+		"GET / HTTP/1.1\r\nContent-Length: 99999999999999999999999\r\n\r\n",
+		"GET / HTTP/1.1\r\nContent-Length:\r\n\r\n",
+		"POST / HTTP/1.1\r\nContent-Length: 5\r\nTransfer-Encoding: chunked\r\n\r\n",
+		"POST / HTTP/1.1\r\nTransfer-Encoding: gzip, chunked\r\ncontent-length: 0\r\n\r\n",
+		"POST / HTTP/1.1\r\nContent-Length: 5\r\nTransfer-Encoding: gzip\r\n\r\n",
+		"POST / HTTP/1.1\r\nTransfer-Encoding: chunked, identity\r\nContent-Length: 5\r\n\r\n",
+		"HTTP/1.1 200 OK\r\nTransfer-Encoding: gzip\r\nContent-Length: 5\r\n\r\n",
+		"POST / HTTP/1.1\r\nTransfer-Encoding: chunked, gzip\r\n\r\n",
+		"POST / HTTP/1.1\r\nTransfer-Encoding: chunked\r\nTransfer-Encoding:\r\nTransfer-Encoding: gzip\r\n\r\n",
+		"POST / HTTP/1.1\r\nTransfer-Encoding:\r\n\r\n"};
+	for(auto c : cases)
+	{
+		fast_io::http_header_buffer hb;
+		if(scan_header<4096>(c,hb))
+		{
+			check(false,"accepted invalid header");
+			perrln(c);
+		}
+	}
+	fast_io::http_header_buffer hb;
+	check(scan_header<4096>("GET / HTTP/1.1\r\nContent-Length: 5\r\ncontent-length: 5\r\n\r\n",hb)&&hb.content_length==5,"repeated equal content length");
+}
+
+int main()
+{
+	test_request<4096,4096>();
+	test_request<1,4096>();
+	test_request<13,100000>();
+	test_response();
+	test_many_fields();
+	test_invalid();
+	return report();
+}
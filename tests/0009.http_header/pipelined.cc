@@ -0,0 +1,135 @@
+#include<string>
+#include<string_view>
+#include<vector>
+#include<random>
+#include<fast_io.h>
+#include<fast_io_device.h>
+#include"../check.h"
+
+using namespace fast_io::io;
+using namespace fast_io_test;
+
+struct request
+{
+	std::string path;
+	std::string cookie;
+	std::string body;
+};
+
+/*
+Keep-alive traffic as one byte stream: mostly small requests, some with bodies, some with cookies far larger than
+the input buffer, and stray empty lines between requests.
+*/
+inline std::string make_stream(std::vector<request>& reqs,std::size_t count,std::mt19937_64& eng)
+{
+	std::string stream;
+	for(std::size_t i{};i!=count;++i)
+	{
+		request r;
+		r.path="/item/"+std::to_string(i);
+		if(eng()%10==0)
+			r.cookie.assign(1+eng()%300000,static_cast<char>('a'+eng()%26));
+		if(eng()%3==0)
+			r.body.assign(eng()%5000,static_cast<char>('A'+eng()%26));
+		if(eng()%20==0)
+			stream.append("\r\n");
+		stream.append((r.body.empty()?"GET ":"POST ")+r.path+" HTTP/1.1\r\nHost: localhost\r\nX-Id: "+std::to_string(i)+"\r\n");
+		if(!r.cookie.empty())
+			stream.append("Cookie: "+r.cookie+"\r\n");
+		if(!r.body.empty())
+			stream.append("Content-Length: "+std::to_string(r.body.size())+"\r\n");
+		stream.append("\r\n");
+		stream.append(r.body);
+		reqs.push_back(std::move(r));
+	}
+	return stream;
+}
+
+inline std::string_view to_view(auto s)
+{
+	return {s.ptr,s.n};
+}
+
+template<std::size_t bfs>
+inline void test_pipeline(std::size_t count,std::uint_least64_t seed)
+{
+	std::mt19937_64 eng(seed);
+	std::vector<request> reqs;
+	auto const stream{make_stream(reqs,count,eng)};
+	fast_io::native_file file(fast_io::io_temp);
+	write(file,stream.data(),stream.data()+stream.size());
+	seek(file,0,fast_io::seekdir::beg);
+	fast_io::basic_io_buffer<fast_io::native_io_observer,fast_io::buffer_mode::in,fast_io::basic_decorators<char>,bfs> ibf{fast_io::native_io_observer{file.fd}};
+	fast_io::http_request_scanner scanner;
+	std::size_t i{},mismatches{},zero_copy{};
+	std::string body;
+	for(;scanner.next(ibf);++i)
+	{
+		auto const& h{scanner.header};
+		if(i==reqs.size())
+		{
+			check(false,"more requests than sent");
+			break;
+		}
+		auto const& r{reqs[i]};
+		bool ok{to_view(h.code())==r.path&&to_view(h.request())==(r.body.empty()?"GET":"POST")};
+		std::size_t const id{h.find("x-id")};
+		ok&=id!=h.npos&&to_view(h.field(id).value)==std::to_string(i);
+		std::size_t const cookie{h.find("Cookie")};
+		ok&=r.cookie.empty()?cookie==h.npos:(cookie!=h.npos&&to_view(h.field(cookie).value)==r.cookie);
+		ok&=h.has_content_length==!r.body.empty();
+		zero_copy+=h.buffer!=scanner.spill_begin;
+		if(h.has_content_length)
+		{
+			body.resize(h.content_length);
+			read_all(ibf,body.data(),body.data()+body.size());
+			ok&=body==r.body;
+		}
+		mismatches+=!ok;
+	}
+	check(i==reqs.size(),"request count");
+	check(mismatches==0,"request contents");
+	if constexpr(131072<=bfs)
+		check(zero_copy*2>count,"most requests are zero copy");
+}
+
+template<typename F>
+inline bool throws_parse_code(fast_io::parse_code expected,F f)
+{
+	try
+	{
+		f();
+	}
+	catch(fast_io::error const& e)
+	{
+		return e.domain==fast_io::parse_domain_value&&static_cast<fast_io::parse_code>(e.code)==expected;
+	}
+	return false;
+}
+
+inline void test_errors()
+{
+	auto scan_all{[](std::string_view text,std::size_t max_header_size)
+	{
+		fast_io::native_file file(fast_io::io_temp);
+		write(file,text.data(),text.data()+text.size());
+		seek(file,0,fast_io::seekdir::beg);
+		fast_io::basic_io_buffer<fast_io::native_io_observer,fast_io::buffer_mode::in,fast_io::basic_decorators<char>,64> ibf{fast_io::native_io_observer{file.fd}};
+		fast_io::http_request_scanner scanner(max_header_size);
+		while(scanner.next(ibf));
+	}};
+	check(throws_parse_code(fast_io::parse_code::end_of_file,[&]{scan_all("GET / HTTP/1.1\r\nHost: a\r\n\r\nGET / HTTP/1.1\r\nHost:",1000);}),"truncated header");
+	check(throws_parse_code(fast_io::parse_code::overflow,[&]{scan_all("GET / HTTP/1.1\r\nCookie: "+std::string(2000,'x')+"\r\n\r\n",1000);}),"oversized header");
+	check(throws_parse_code(fast_io::parse_code::invalid,[&]{scan_all("GET / HTTP/1.1\r\nBad\rLine: x\r\n\r\n",1000);}),"bare carriage return");
+	check(!throws_parse_code(fast_io::parse_code::end_of_file,[&]{scan_all("GET / HTTP/1.1\r\nHost: a\r\n\r\n\r\n",1000);}),"trailing empty line is a clean end");
+}
+
+int main()
+{
+	test_pipeline<131072>(3000,1);
+	test_pipeline<4096>(1000,2);
+	test_pipeline<61>(300,3);
+	test_pipeline<1>(100,4);
+	test_errors();
+	return report();
+}
@@ -0,0 +1,77 @@
+#include<string>
+#include<string_view>
+#include<fast_io.h>
+#include<fast_io_device.h>
+#include"../check.h"
+
+using namespace fast_io::io;
+using namespace fast_io_test;
+
+/*
+The prefault thread must be joined by whatever ends the mapping, so once every loader is gone the process is back
+to a single thread.
+*/
+inline std::size_t thread_count()
+{
+	fast_io::native_file_loader status(u8"/proc/self/status");
+	std::string_view text{status.data(),status.size()};
+	constexpr std::string_view key{"Threads:"};
+	auto pos{text.find(key)};
+	if(pos==std::string_view::npos)
+		return 0;
+	std::size_t n{};
+	for(pos+=key.size();pos!=text.size()&&(text[pos]==' '||text[pos]=='\t');++pos);
+	for(;pos!=text.size()&&'0'<=text[pos]&&text[pos]<='9';++pos)
+		n=n*10+static_cast<std::size_t>(text[pos]-'0');
+	return n;
+}
+
+inline bool matches(fast_io::native_file_loader const& loader,std::string const& expected)
+{
+	return std::string_view(loader.data(),loader.size())==expected;
+}
+
+static_assert(sizeof(fast_io::allocation_file_loader)==2*sizeof(char*),"allocation_file_loader carries no prefault handle");
+
+int main()
+{
+	fast_io::native_file file(fast_io::io_temp);
+	std::string expected(static_cast<std::size_t>(48u)<<20u,'\0');
+	for(std::size_t i{};i!=expected.size();++i)
+		expected[i]=static_cast<char>('a'+i%23);
+	write(file,expected.data(),expected.data()+expected.size());
+	std::size_t const baseline{thread_count()};
+	constexpr auto prefault{fast_io::file_loader_mode::prefault};
+	for(std::size_t i{};i!=64;++i)
+	{
+		fast_io::native_file_loader loader(prefault,at(file));
+		check(loader.size()==expected.size(),"size of a prefaulted mapping");
+	}
+	check(thread_count()==baseline,"destructor joins the prefault thread");
+	{
+		fast_io::native_file_loader loader(prefault,at(file));
+		loader.close();
+		check(thread_count()==baseline,"close joins the prefault thread");
+	}
+	{
+		fast_io::native_file_loader a(prefault,at(file));
+		fast_io::native_file_loader b(prefault,at(file));
+		a=std::move(b);
+		fast_io::native_file_loader c(std::move(a));
+		check(matches(c,expected),"contents survive moves");
+	}
+	check(thread_count()==baseline,"moved loaders join exactly once");
+	{
+		fast_io::native_file_loader loader(prefault|fast_io::file_loader_mode::sequential,at(file));
+		check(matches(loader,expected),"prefault with sequential");
+	}
+	check(thread_count()==baseline,"no thread outlives its loader");
+	{
+		seek(file,0,fast_io::seekdir::beg);
+		fast_io::allocation_file_loader a(at(file));
+		fast_io::allocation_file_loader b(std::move(a));
+		a=std::move(b);
+		check(std::string_view(a.data(),a.size())==expected,"allocation loader contents survive moves");
+	}
+	return report();
+}
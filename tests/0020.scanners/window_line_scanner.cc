@@ -0,0 +1,114 @@
+#include<string>
+#include<string_view>
+#include<vector>
+#include<random>
+#include<fast_io.h>
+#include<fast_io_device.h>
+#include"../check.h"
+
+using namespace fast_io::io;
+using namespace fast_io_test;
+
+/*
+One-page windows over a file of many pages: most lines straddle a window boundary, and a few are longer than a
+page so the window has to grow.
+*/
+inline std::size_t const page_size{fast_io::details::posix_window_loader_page_size()};
+
+inline fast_io::native_file_window_loader make_loader(std::string const& text)
+{
+	fast_io::native_file file(fast_io::io_temp);
+	write(file,text.data(),text.data()+text.size());
+	return fast_io::native_file_window_loader(std::move(file),page_size);
+}
+
+inline void test_lines(std::vector<std::string> const& lines,bool trailing_lf)
+{
+	std::string text;
+	for(auto const& e:lines)
+	{
+		text.append(e);
+		text.push_back('\n');
+	}
+	if(!trailing_lf)
+		text.pop_back();
+	auto loader{make_loader(text)};
+	std::size_t i{};
+	std::size_t straddling{};
+	std::uint_least64_t pos{};
+	for(auto e: line_scanner(loader))
+	{
+		std::string_view ev{e.begin(),e.end()};
+		if(i==lines.size()||ev!=lines[i])
+		{
+			check(false,"line content across window boundaries");
+			return;
+		}
+		if(pos/page_size!=(pos+ev.size())/page_size)
+			++straddling;
+		pos+=ev.size()+1;
+		++i;
+	}
+	check(i==lines.size(),"line count");
+	check(straddling!=0,"some lines straddle a window boundary");
+}
+
+inline void test_read(std::string const& text,std::uint_least64_t seed)
+{
+	std::mt19937_64 eng(seed);
+	auto loader{make_loader(text)};
+	std::string got;
+	std::string chunk;
+	for(;;)
+	{
+		chunk.resize(1+eng()%(3*page_size));
+		auto it{read(loader,chunk.data(),chunk.data()+chunk.size())};
+		if(it==chunk.data())
+			break;
+		got.append(chunk.data(),it);
+	}
+	check(got==text,"read through sliding windows");
+	for(std::size_t i{};i!=100;++i)
+	{
+		std::uint_least64_t const position{eng()%text.size()};
+		loader.seek_window(position);
+		check(loader.position()==position,"seek_window position");
+		std::size_t const n{static_cast<std::size_t>(loader.end_ptr-loader.curr_ptr)};
+		if(std::string_view(loader.curr_ptr,n)!=std::string_view(text).substr(static_cast<std::size_t>(position),n))
+		{
+			check(false,"window content after seek_window");
+			break;
+		}
+	}
+}
+
+int main()
+{
+	std::mt19937_64 eng(1);
+	std::vector<std::string> lines;
+	std::size_t total{};
+	for(std::size_t i{};total<16*page_size;++i)
+	{
+		std::size_t len{static_cast<std::size_t>(eng()%200)};
+		if(i%97==96)
+			len=page_size+static_cast<std::size_t>(eng()%(3*page_size));
+		std::string line(len,'\0');
+		for(auto& c:line)
+			c=static_cast<char>('a'+eng()%26);
+		total+=line.size()+1;
+		lines.push_back(std::move(line));
+	}
+	test_lines(lines,true);
+	test_lines(lines,false);
+	lines.emplace_back();
+	lines.emplace_back(3*page_size,'x');
+	test_lines(lines,true);
+	std::string text;
+	for(auto const& e:lines)
+	{
+		text.append(e);
+		text.push_back('\n');
+	}
+	test_read(text,2);
+	return report();
+}
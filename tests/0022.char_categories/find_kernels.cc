@@ -0,0 +1,118 @@
+#include<fast_io.h>
+#include<random>
+#include<vector>
+#include"../check.h"
+
+using namespace fast_io::io;
+using namespace fast_io_test;
+
+/*
+The AVX2 and AVX-512BW find kernels behind the runtime dispatch must agree with a scalar loop for a character,
+C whitespace and HTML whitespace (which excludes 0x0b), in both find and find-not form, for any length, alignment
+and character width. Each tier the CPU supports is called directly, then the dispatched entry points.
+*/
+
+template<unsigned kind,typename char_type>
+inline bool matches(char_type ch) noexcept
+{
+	if constexpr(kind==0)
+		return ch==char_type{'\n'};
+	else if constexpr(kind==1)
+		return fast_io::char_category::is_c_space(ch);
+	else
+		return fast_io::char_category::is_html_whitespace(ch);
+}
+
+template<unsigned kind,bool findnot,typename char_type>
+inline char_type const* scalar_find(char_type const* first,char_type const* last) noexcept
+{
+	for(;first!=last&&matches<kind>(*first)==findnot;++first);
+	return first;
+}
+
+/*
+The kernels stop at the tail shorter than one vector; the caller finishes it with the scalar loop.
+*/
+template<unsigned kind,bool findnot,typename char_type,typename Kernel>
+inline void check_kernel(char_type const* first,char_type const* last,Kernel kernel)
+{
+	auto it{kernel(first,last)};
+	if(it!=last&&matches<kind>(*it)==findnot)
+		it=scalar_find<kind,findnot>(it,last);
+	check(it==scalar_find<kind,findnot>(first,last),"vector kernel agrees with the scalar loop");
+}
+
+template<unsigned kind,bool findnot,typename char_type>
+inline void check_all(char_type const* first,char_type const* last)
+{
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+	if constexpr(fast_io::details::runtime_simd_dispatch_char_type<char_type>)
+	{
+		using enum fast_io::details::cpu_flags::runtime_simd_level;
+		auto const level{fast_io::details::cpu_flags::get_runtime_simd_level()};
+		constexpr char_type ch{'\n'};
+		if(level==avx2||level==avx512bw)
+			check_kernel<kind,findnot>(first,last,[](char_type const* f,char_type const* l)
+			{
+				return fast_io::details::runtime_find_avx2_impl<kind,findnot>(f,l,ch);
+			});
+		if(level==avx512bw)
+			check_kernel<kind,findnot>(first,last,[](char_type const* f,char_type const* l)
+			{
+				return fast_io::details::runtime_find_avx512bw_impl<kind,findnot>(f,l,ch);
+			});
+	}
+#endif
+	if constexpr(kind==0)
+	{
+		//4-byte characters go to wmemchr under glibc, not to these kernels
+		if constexpr(sizeof(char_type)!=4)
+			check(fast_io::details::find_ch_impl<u8'\n',findnot>(first,last)==scalar_find<kind,findnot>(first,last),"find_ch_impl agrees with the scalar loop");
+	}
+	else
+		check(fast_io::details::find_space_impl<kind==2,findnot>(first,last)==scalar_find<kind,findnot>(first,last),"find_space_impl agrees with the scalar loop");
+}
+
+/*
+Mostly one filler value with a sprinkling of every whitespace byte, 0x0b, and values that only match after a wrong
+narrowing (0x10a, 0x120) for the wider character types.
+*/
+template<typename char_type>
+inline void test(std::mt19937_64& eng)
+{
+	constexpr char32_t specials[]{0x09,0x0a,0x0b,0x0c,0x0d,0x20,0x85,0xa0,0x10a,0x120,0x10020};
+	std::vector<char_type> buf(4096+64);
+	for(std::size_t round{};round!=2000;++round)
+	{
+		bool const dense{round%2==1};
+		char_type const filler{dense?char_type{' '}:char_type{'a'}};
+		for(auto& e:buf)
+		{
+			if(eng()%(dense?200u:64u)==0)
+				e=static_cast<char_type>(specials[eng()%std::size(specials)]);
+			else if(dense&&eng()%300u==0)
+				e=char_type{'a'};
+			else
+				e=filler;
+		}
+		std::size_t const n{static_cast<std::size_t>(eng()%(round<1000u?300u:4096u))};
+		char_type const* first{buf.data()+eng()%64u};
+		char_type const* last{first+n};
+		check_all<0,false>(first,last);
+		check_all<0,true>(first,last);
+		check_all<1,false>(first,last);
+		check_all<1,true>(first,last);
+		check_all<2,false>(first,last);
+		check_all<2,true>(first,last);
+	}
+}
+
+int main()
+{
+	std::mt19937_64 eng;
+	test<char>(eng);
+	test<char8_t>(eng);
+	test<char16_t>(eng);
+	test<char32_t>(eng);
+	return report();
+}
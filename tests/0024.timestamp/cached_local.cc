@@ -0,0 +1,84 @@
+#include<string>
+#include<fast_io.h>
+#include<random>
+#include<cstdlib>
+#include<ctime>
+#include<thread>
+#include"../check.h"
+
+using namespace fast_io::io;
+using namespace fast_io_test;
+
+/*
+localtime_r is the reference: same date, time of day and offset as the tz database gives for every instant.
+*/
+inline fast_io::iso8601_timestamp reference_local(std::int_least64_t seconds,std::uint_least64_t subseconds)
+{
+	std::time_t t{static_cast<std::time_t>(seconds)};
+	struct tm tm;
+	localtime_r(&t,&tm);
+	return {tm.tm_year+1900,static_cast<std::uint_least8_t>(tm.tm_mon+1),static_cast<std::uint_least8_t>(tm.tm_mday),
+		static_cast<std::uint_least8_t>(tm.tm_hour),static_cast<std::uint_least8_t>(tm.tm_min),static_cast<std::uint_least8_t>(tm.tm_sec),
+		subseconds,static_cast<std::int_least32_t>(tm.tm_gmtoff)};
+}
+
+inline void check_zone(char const* tz)
+{
+	::setenv("TZ",tz,1);
+	fast_io::posix_tzset();
+	std::mt19937_64 eng(fast_io::cstr_len(tz));
+	std::size_t mismatches{};
+	auto compare{[&](std::int_least64_t seconds,std::uint_least64_t subseconds)
+	{
+		fast_io::unix_timestamp const ts{seconds,subseconds};
+		auto const expected{reference_local(seconds,subseconds)};
+		auto const got{fast_io::cached_local(ts)};
+		if(fast_io::concat(got)!=fast_io::concat(expected)||fast_io::concat(fast_io::to_iso8601(got))!=fast_io::concat(expected)||
+			fast_io::wconcat(got)!=fast_io::wconcat(expected))
+		{
+			if(mismatches++<5)
+				perrln(fast_io::mnp::os_c_str(tz)," ",seconds,": ",fast_io::cached_local(ts)," expected ",expected);
+		}
+	}};
+	/*
+	Walk forward through 2019-2026 with a step coprime to an hour so every transition is approached from both
+	sides, then jump around to force misses in both directions.
+	*/
+	for(std::int_least64_t s{1546300800};s<1798761600;s+=587)
+		compare(s,0);
+	for(std::size_t i{};i!=200000;++i)
+		compare(static_cast<std::int_least64_t>(eng()%4102444800u),eng()%2?0:eng()%fast_io::uint_least64_subseconds_per_second);
+	for(std::int_least64_t s{-86400*3};s<86400*3;s+=7)
+		compare(s,0);
+	check(mismatches==0,"cached_local agrees with localtime_r");
+}
+
+/*
+Timestamps outlive the cache state they were made from: several in one print, and one printed by another thread.
+*/
+inline void check_held()
+{
+	::setenv("TZ","UTC",1);
+	fast_io::posix_tzset();
+	fast_io::unix_timestamp const a{1700000000,0};
+	fast_io::unix_timestamp const b{1800000000,500000000000000000u};
+	check(fast_io::concat(fast_io::cached_local(a)," ",fast_io::cached_local(b))==fast_io::concat(fast_io::local(a)," ",fast_io::local(b)),
+		"two timestamps in one print");
+	::setenv("TZ","CET-1CEST,M3.5.0,M10.5.0/3",1);
+	fast_io::posix_tzset();
+	auto const held{fast_io::cached_local(a)};
+	auto const expected{fast_io::concat(reference_local(a.seconds,0))};
+	fast_io::cached_local(b);
+	std::string other;
+	std::thread([&]{ other=fast_io::concat(held); }).join();
+	check(fast_io::concat(held)==expected&&other==expected,"held timestamp after the cache moved on");
+}
+
+int main()
+{
+	check_held();
+	for(char const* tz : {"UTC0","CET-1CEST,M3.5.0,M10.5.0/3","EST5EDT,M3.2.0,M11.1.0","<+0530>-5:30","<-0330>3:30<-0230>,M3.2.0,M11.1.0",
+		"Australia/Lord_Howe","America/Sao_Paulo","Asia/Kathmandu","Europe/Dublin"})
+		check_zone(tz);
+	return report();
+}
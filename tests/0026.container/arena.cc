@@ -0,0 +1,30 @@
+#include<fast_io.h>
+#include<fast_io_dsal/vector.h>
+
+int main()
+{
+	fast_io::arena_resource arena(4096);
+	std::size_t total{};
+	for(std::size_t round{};round!=100;++round)
+	{
+		{
+			fast_io::arena_allocator_scope scope(arena);
+			fast_io::vector<std::size_t,fast_io::thread_local_arena_allocator> v;
+			for(std::size_t i{};i!=100000;++i)
+				v.push_back(i);
+			for(auto e:v)
+				total+=e;
+		}
+		arena.reset();
+	}
+	using handle_allocator = fast_io::arena_allocator::allocator_type;
+	void* p{handle_allocator::handle_allocate_aligned(__builtin_addressof(arena),64,100)};
+	void* q{handle_allocator::handle_reallocate_n(__builtin_addressof(arena),p,100,200)};
+	fast_io::arena_resource huge(1,true);
+	huge.allocate(10);
+	::fast_io::io::println("total=",total,
+		"\naligned=",reinterpret_cast<std::size_t>(p)%64==0,
+		"\ngrown in place=",p==q,
+		"\nsingle chunk after reset=",arena.chunk->prev==nullptr,
+		"\nhuge page chunk aligned=",reinterpret_cast<std::size_t>(huge.chunk)%huge.huge_page_size==0);
+}
@@ -0,0 +1,82 @@
+#include<string_view>
+#include<fast_io.h>
+#include<fast_io_dsal/vector.h>
+#include"../check.h"
+
+using namespace fast_io::io;
+using namespace fast_io_test;
+
+using arena_vector = fast_io::vector<std::size_t,fast_io::thread_local_arena_allocator>;
+
+inline void fill(arena_vector& v,std::size_t n)
+{
+	for(std::size_t i{};i!=n;++i)
+		v.push_back(v.size());
+}
+
+inline bool holds_sequence(arena_vector const& v,std::size_t n)
+{
+	if(v.size()!=n)
+		return false;
+	for(std::size_t i{};i!=n;++i)
+		if(v[i]!=i)
+			return false;
+	return true;
+}
+
+inline bool in_arena(fast_io::arena_resource const& arena,void const* p)
+{
+	auto bp{reinterpret_cast<std::byte const*>(p)};
+	for(auto c{arena.chunk};c!=nullptr;c=c->prev)
+		if(reinterpret_cast<std::byte const*>(c)<bp&&bp<reinterpret_cast<std::byte const*>(c)+c->size)
+			return true;
+	return false;
+}
+
+/*
+Blocks crossing scope boundaries: the sanitizer reports a bad free or a leak if one is handed back to the wrong
+place.
+*/
+int main()
+{
+	fast_io::arena_resource outer(4096);
+	fast_io::arena_resource inner(4096);
+	{
+		arena_vector v;
+		fill(v,1000);
+		check(!in_arena(outer,v.data()),"allocated upstream outside any scope");
+		fast_io::arena_allocator_scope scope(outer);
+		arena_vector moved(std::move(v));
+		fill(moved,100);
+		check(holds_sequence(moved,1100),"upstream block freed inside a scope");
+	}
+	{
+		arena_vector v;
+		{
+			fast_io::arena_allocator_scope scope(outer);
+			fill(v,100000);
+			check(in_arena(outer,v.data()),"growth inside a scope comes from its arena");
+		}
+		fill(v,100000);
+		check(holds_sequence(v,200000),"arena block reallocated after its scope ended");
+		check(!in_arena(outer,v.data()),"growth after the scope comes from upstream");
+	}
+	{
+		fast_io::arena_allocator_scope outer_scope(outer);
+		arena_vector v;
+		fill(v,1000);
+		check(in_arena(outer,v.data()),"allocated from the outer arena");
+		{
+			fast_io::arena_allocator_scope inner_scope(inner);
+			arena_vector w;
+			fill(w,1000);
+			check(in_arena(inner,w.data()),"new memory comes from the inner arena");
+			fill(v,100000);
+			check(in_arena(inner,v.data()),"outer block grown inside the inner scope");
+		}
+		fill(v,100000);
+		check(holds_sequence(v,201000),"inner arena block grown and freed in the outer scope");
+		check(in_arena(outer,v.data()),"growth back in the outer scope");
+	}
+	return report();
+}
@@ -0,0 +1,164 @@
+#include<algorithm>
+#include<atomic>
+#include<thread>
+#include<vector>
+#include<string_view>
+#include<fast_io.h>
+#include"../check.h"
+
+using namespace fast_io::io;
+using namespace fast_io_test;
+
+inline std::atomic<std::size_t> upstream_allocations{};
+inline std::atomic<std::size_t> upstream_deallocations{};
+
+struct counting_upstream
+{
+	static inline void* allocate(std::size_t n) noexcept
+	{
+		upstream_allocations.fetch_add(1,std::memory_order_relaxed);
+		return fast_io::c_malloc_allocator::allocate(n);
+	}
+	static inline void deallocate(void* p) noexcept
+	{
+		if(p==nullptr)
+			return;
+		upstream_deallocations.fetch_add(1,std::memory_order_relaxed);
+		fast_io::c_malloc_allocator::deallocate(p);
+	}
+};
+
+using cache = fast_io::thread_local_cache_allocator<counting_upstream>;
+
+inline constexpr std::size_t min_block{static_cast<std::size_t>(1u)<<fast_io::details::thread_local_cache_min_shift};
+inline constexpr std::size_t max_block{fast_io::details::thread_local_cache_max_block_size};
+
+inline std::size_t class_size(std::size_t n)
+{
+	std::size_t s{min_block};
+	for(;s<n;s<<=1u);
+	return s;
+}
+
+/*
+Every size from one below to one above each class boundary gets its class size back, and a freed block is handed
+out again for the next request of the same class.
+*/
+inline void test_boundaries()
+{
+	check(max_block==static_cast<std::size_t>(131072u),"largest class is 128 KiB");
+	for(std::size_t s{min_block};s<=max_block*2u;s<<=1u)
+	{
+		for(std::size_t n:{s-1u,s,s+1u})
+		{
+			auto [p,got]{cache::allocate_at_least(n)};
+			std::size_t const expected{n<=max_block?class_size(n):n};
+			check(got==expected,"allocate_at_least rounds up to the class size");
+			auto bp{reinterpret_cast<unsigned char*>(p)};
+			for(std::size_t i{};i!=got;++i)
+				bp[i]=static_cast<unsigned char>(i);
+			cache::deallocate_n(p,n);
+			if(n<=max_block)
+				check(cache::allocate_at_least(got).ptr==p,"freed block is reused for its class");
+			else
+				p=cache::allocate(n);
+			cache::deallocate_n(p,n);
+		}
+	}
+	auto [p,got]{cache::allocate_at_least(0)};
+	check(got==min_block,"zero bytes map to the smallest class");
+	cache::deallocate_n(p,0);
+}
+
+/*
+Run on a fresh thread so the lists start empty: only blocks beyond the class limit go back to upstream.
+*/
+inline void test_cap(std::size_t n)
+{
+	std::size_t const cls{fast_io::details::thread_local_cache_class_of(n)};
+	std::size_t const limit{fast_io::details::thread_local_cache_class_limit(cls)};
+	std::size_t const extra{10};
+	std::jthread([&]
+	{
+		std::vector<void*> blocks;
+		for(std::size_t i{};i!=limit+extra;++i)
+			blocks.push_back(cache::allocate(n));
+		std::size_t const before{upstream_deallocations.load()};
+		for(auto p:blocks)
+			cache::deallocate_n(p,n);
+		check(upstream_deallocations.load()-before==extra,"per-class cap sends the overflow to upstream");
+		std::size_t const allocations{upstream_allocations.load()};
+		for(auto& p:blocks)
+			p=cache::allocate(n);
+		check(upstream_allocations.load()-allocations==extra,"cached blocks are served before upstream");
+		for(auto p:blocks)
+			cache::deallocate_n(p,n);
+	});
+}
+
+/*
+Blocks allocated on one thread and freed on another join the freeing thread's list, and every list is handed back
+to upstream when its thread exits.
+*/
+inline void test_cross_thread()
+{
+	constexpr std::size_t n{4096};
+	constexpr std::size_t count{64};
+	std::vector<void*> blocks;
+	std::jthread([&]
+	{
+		for(std::size_t i{};i!=count;++i)
+			blocks.push_back(cache::allocate(n));
+	}).join();
+	std::size_t const allocations{upstream_allocations.load()};
+	std::size_t const deallocations{upstream_deallocations.load()};
+	std::jthread([&]
+	{
+		for(auto p:blocks)
+			cache::deallocate_n(p,n);
+		check(upstream_deallocations.load()==deallocations,"cross-thread frees stay in the freeing thread");
+		std::vector<void*> reused;
+		for(std::size_t i{};i!=count;++i)
+			reused.push_back(cache::allocate(n));
+		check(std::equal(reused.begin(),reused.end(),blocks.rbegin()),"freeing thread reuses the foreign blocks");
+		for(auto p:reused)
+			cache::deallocate_n(p,n);
+	}).join();
+	check(upstream_allocations.load()==allocations,"no upstream allocation while the cache has blocks");
+	check(upstream_deallocations.load()-deallocations==count,"thread exit drains the lists");
+}
+
+/*
+Over-aligned blocks are not cached: they come from and go back to upstream at once.
+*/
+inline void test_aligned()
+{
+	using adapter = fast_io::generic_allocator_adapter<cache>;
+	std::jthread([&]
+	{
+		std::size_t const allocations{upstream_allocations.load()};
+		std::size_t const deallocations{upstream_deallocations.load()};
+		for(std::size_t alignment:{64u,256u,4096u})
+		{
+			void* p{adapter::allocate_aligned(alignment,1000)};
+			check(reinterpret_cast<std::uintptr_t>(p)%alignment==0,"aligned block is aligned");
+			p=adapter::reallocate_aligned_n(p,1000,alignment,3000);
+			check(reinterpret_cast<std::uintptr_t>(p)%alignment==0,"reallocated block is aligned");
+			adapter::deallocate_aligned_n(p,alignment,3000);
+		}
+		check(upstream_allocations.load()-allocations==6,"aligned allocations go to upstream");
+		check(upstream_deallocations.load()-deallocations==6,"aligned frees go to upstream");
+	}).join();
+}
+
+int main()
+{
+	std::jthread(test_boundaries).join();
+	test_cap(1);
+	test_cap(4096);
+	test_cap(max_block);
+	test_cross_thread();
+	test_aligned();
+	check(upstream_allocations.load()==upstream_deallocations.load(),"everything went back to upstream");
+	return report();
+}
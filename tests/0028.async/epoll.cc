@@ -0,0 +1,51 @@
+#include<fast_io.h>
+#include<fast_io_hosted/async_coro.h>
+
+using namespace fast_io::io;
+
+fast_io::task reader(fast_io::linux_epoll_scheduler& scheduler,fast_io::posix_file& pf,std::size_t& received)
+{
+	char buffer[64];
+	auto it{co_await fast_io::async_read(scheduler,pf,buffer,buffer+sizeof(buffer),-1)};
+	print("pipe: ",fast_io::mnp::strvw(buffer,it));
+	received=static_cast<std::size_t>(it-buffer);
+}
+
+fast_io::task writer(fast_io::linux_epoll_scheduler& scheduler,fast_io::posix_file& pf,bool& finished)
+{
+	co_await fast_io::async_println(scheduler,pf,"hello epoll ",42);
+	finished=true;
+}
+
+fast_io::task file_roundtrip(fast_io::linux_epoll_scheduler& scheduler,fast_io::posix_file& pf,bool& finished)
+{
+	char const message[]="regular files complete synchronously\n";
+	co_await fast_io::async_write(scheduler,pf,message,message+sizeof(message)-1,0);
+	char buffer[64];
+	auto it{co_await fast_io::async_read(scheduler,pf,buffer,buffer+sizeof(buffer),0)};
+	print(fast_io::mnp::strvw(buffer,it));
+	finished=true;
+}
+
+int main()
+{
+	fast_io::linux_epoll_scheduler scheduler(fast_io::io_async);
+	for(std::size_t round{};round!=2;++round)
+	{
+		//the second pipe reuses the numbers of the first, closed without cancel()
+		fast_io::posix_pipe pipe;
+		std::size_t received{};
+		bool written{};
+		reader(scheduler,pipe.in(),received);
+		writer(scheduler,pipe.out(),written);
+		while(!received||!written)
+			fast_io::io_async_wait(scheduler);
+	}
+
+	fast_io::posix_file pf(u8"epoll.txt",fast_io::open_mode::in|fast_io::open_mode::out|fast_io::open_mode::trunc|fast_io::open_mode::creat);
+	bool finished{};
+	file_roundtrip(scheduler,pf,finished);
+	while(!finished)
+		fast_io::io_async_wait(scheduler);
+	fast_io::native_unlinkat(fast_io::at_fdcwd(),u8"epoll.txt");
+}
@@ -0,0 +1,47 @@
+#include<fast_io.h>
+#include<fast_io_hosted/async_coro.h>
+
+using namespace fast_io::io;
+
+fast_io::task roundtrip(fast_io::linux_io_uring_scheduler& scheduler,fast_io::posix_file& pf,bool& finished)
+{
+	char const message[]="hello io_uring\n";
+	co_await fast_io::async_write(scheduler,pf,message,message+sizeof(message)-1,0);
+	char buffer[64];
+	auto it{co_await fast_io::async_read(scheduler,pf,buffer,buffer+sizeof(buffer),0)};
+	print(fast_io::mnp::strvw(buffer,it));
+	co_await fast_io::async_println(scheduler,0,pf,"async_println ",42);
+	finished=true;
+}
+
+int main()
+{
+	fast_io::linux_io_uring_scheduler scheduler(64);
+	fast_io::posix_file pf(u8"io_uring.txt",fast_io::open_mode::in|fast_io::open_mode::out|fast_io::open_mode::trunc|fast_io::open_mode::creat);
+	bool finished{};
+	roundtrip(scheduler,pf,finished);
+	while(!finished)
+		fast_io::io_async_wait(scheduler);
+
+	int fds[1]{pf.fd};
+	scheduler.register_files(fds,1);
+	char buffer[64];
+	fast_io::io_scatter_t registered{buffer,sizeof(buffer)};
+	scheduler.register_buffers({__builtin_addressof(registered),1});
+	bool fixed_finished{};
+	fast_io::linux_async_overlapped overlapped(std::in_place,[&](std::size_t transferred,int err)
+	{
+		if(err)
+			fast_io::throw_posix_error(err);
+		println("fixed read: ",fast_io::mnp::strvw(buffer,buffer+transferred));
+		fixed_finished=true;
+	});
+	fast_io::async_read_fixed_callback(scheduler,fast_io::linux_io_uring_fixed_file{0},
+		buffer,buffer+sizeof(buffer),fast_io::linux_io_uring_fixed_buffer{0},overlapped,0);
+	while(!fixed_finished)
+		fast_io::io_async_wait(scheduler);
+	scheduler.close();
+	if(scheduler)
+		perrln("close left the ring open");
+	fast_io::native_unlinkat(fast_io::at_fdcwd(),u8"io_uring.txt");
+}
@@ -0,0 +1,147 @@
+#include<fast_io.h>
+#include<random>
+#include<vector>
+#include"../check.h"
+
+using namespace fast_io::io;
+using namespace fast_io_test;
+
+/*
+Reference: the scalar DFA one code point at a time, which is what general_code_cvt_full did before the vector kernels.
+*/
+template<typename U>
+inline std::vector<U> reference_from_utf8(std::vector<char8_t> const& in)
+{
+	std::vector<U> out(in.size()+8);
+	U* dst{out.data()};
+	char8_t const* first{in.data()};
+	char8_t const* last{first+in.size()};
+	while(first!=last)
+	{
+		auto [failed,src,code]=fast_io::details::codecvt::advance_with_big_table(first,last);
+		if(failed)
+		{
+			code=0xFFFD;
+			src=last;
+		}
+		first=src;
+		if constexpr(sizeof(U)==4)
+			*dst++=code;
+		else
+			dst+=fast_io::details::codecvt::get_utf_code_units<fast_io::encoding_scheme::utf>(code,dst);
+	}
+	out.resize(static_cast<std::size_t>(dst-out.data()));
+	return out;
+}
+
+template<typename U>
+inline std::vector<U> convert(std::vector<char8_t> const& in)
+{
+	std::vector<U> out(in.size());
+	out.resize(static_cast<std::size_t>(fast_io::details::codecvt::general_code_cvt_full(in.data(),in.data()+in.size(),out.data())-out.data()));
+	return out;
+}
+
+template<typename T>
+inline std::vector<char8_t> convert_to_utf8(std::vector<T> const& in)
+{
+	std::vector<char8_t> out(in.size()*(sizeof(T)==2?3:4));
+	out.resize(static_cast<std::size_t>(fast_io::details::codecvt::general_code_cvt_full(in.data(),in.data()+in.size(),out.data())-out.data()));
+	return out;
+}
+
+inline char32_t random_code_point(std::mt19937_64& eng,std::size_t cls)
+{
+	switch(cls)
+	{
+	case 0:return static_cast<char32_t>(eng()%0x80u);
+	case 1:return static_cast<char32_t>(0x80u+eng()%0x780u);
+	case 2:
+	{
+		char32_t c;
+		do
+			c=static_cast<char32_t>(0x800u+eng()%0xF800u);
+		while(0xD800u<=c&&c<0xE000u);
+		return c;
+	}
+	default:return static_cast<char32_t>(0x10000u+eng()%0x100000u);
+	}
+}
+
+int main()
+{
+	std::mt19937_64 eng;
+	for(std::size_t round{};round!=4000;++round)
+	{
+		std::vector<char32_t> cps;
+		std::size_t const n{static_cast<std::size_t>(eng()%1500u)};
+		std::size_t const mix{round%6u};
+		for(std::size_t i{};i!=n;++i)
+		{
+			std::size_t cls{mix<4u?mix:static_cast<std::size_t>(eng()%4u)};
+			if(mix==5u&&eng()%4u)
+				cls=0;
+			cps.push_back(random_code_point(eng,cls));
+		}
+		std::vector<char8_t> u8(cps.size()*4);
+		std::vector<char16_t> u16(cps.size()*2);
+		{
+			char8_t* p{u8.data()};
+			char16_t* q{u16.data()};
+			for(auto c : cps)
+			{
+				p+=fast_io::get_utf_code_units(c,p);
+				q+=fast_io::get_utf_code_units(c,q);
+			}
+			u8.resize(static_cast<std::size_t>(p-u8.data()));
+			u16.resize(static_cast<std::size_t>(q-u16.data()));
+		}
+		check(convert<char32_t>(u8)==std::vector<char32_t>(cps.begin(),cps.end()),"UTF-8 to UTF-32");
+		check(convert<char16_t>(u8)==u16,"UTF-8 to UTF-16");
+		check(convert_to_utf8(u16)==u8,"UTF-16 to UTF-8");
+		check(convert_to_utf8(cps)==u8,"UTF-32 to UTF-8");
+		/*
+		Corrupt a few bytes: ill-formed input must produce exactly the replacements of the scalar decoder.
+		*/
+		if(!u8.empty())
+		{
+			for(std::size_t i{},m{static_cast<std::size_t>(eng()%4u)};i!=m;++i)
+				u8[static_cast<std::size_t>(eng()%u8.size())]=static_cast<char8_t>(eng());
+		}
+		check(convert<char32_t>(u8)==reference_from_utf8<char32_t>(u8),"ill-formed UTF-8 to UTF-32 matches the scalar decoder");
+		check(convert<char16_t>(u8)==reference_from_utf8<char16_t>(u8),"ill-formed UTF-8 to UTF-16 matches the scalar decoder");
+	}
+	/*
+	Lone and swapped surrogates in UTF-16 input sitting inside otherwise vectorizable runs.
+	*/
+	{
+		std::vector<char16_t> u16(200,u'中');
+		u16[40]=0xDC00;
+		u16[100]=0xD83D;
+		u16[150]=0xD83D;
+		u16[151]=0xDE00;
+		auto u8{convert_to_utf8(u16)};
+		std::vector<char8_t> expected;
+		for(std::size_t i{};i!=u16.size();++i)
+		{
+			char8_t buf[4];
+			std::size_t len;
+			if(i==40||i==100)
+			{
+				len=fast_io::details::codecvt::get_utf8_invalid_code_units(buf);
+				if(i==100)
+					++i;
+			}
+			else if(i==150)
+			{
+				len=fast_io::get_utf_code_units(U'\U0001F600',buf);
+				++i;
+			}
+			else
+				len=fast_io::get_utf_code_units(U'中',buf);
+			expected.insert(expected.end(),buf,buf+len);
+		}
+		check(u8==expected,"unpaired surrogates in UTF-16");
+	}
+	return report();
+}
@@ -0,0 +1,50 @@
+#include<fast_io.h>
+#include<fast_io_crypto.h>
+#include<random>
+#include<vector>
+#include"../check.h"
+
+using namespace fast_io::io;
+using namespace fast_io_test;
+
+/*
+Every crc tier (slice-by-16, sse4.2 crc32, pclmulqdq folding) must agree with the byte-at-a-time table loop
+for any length and alignment.
+*/
+template<fast_io::details::crc32_option opt>
+inline std::uint_least32_t reference(std::uint_least32_t crc,std::byte const* first,std::byte const* last)
+{
+	return fast_io::details::calculate_crc32_common(crc,first,last,
+		opt==fast_io::details::crc32_option::crc32?fast_io::details::crc32_tb:fast_io::details::crc32c_tb);
+}
+
+template<typename context>
+inline std::uint_least32_t check_value()
+{
+	constexpr char8_t msg[]{u8"123456789"};
+	context ctx;
+	ctx.update(reinterpret_cast<std::byte const*>(msg),reinterpret_cast<std::byte const*>(msg)+9);
+	ctx.do_final();
+	return ctx.digest_value();
+}
+
+int main()
+{
+	check(check_value<fast_io::crc32_context>()==0xCBF43926u,"crc32 check value");
+	check(check_value<fast_io::crc32c_context>()==0xE3069283u,"crc32c check value");
+	std::mt19937_64 eng;
+	std::vector<std::byte> buf(100000);
+	for(auto& e : buf)
+		e=static_cast<std::byte>(eng());
+	for(std::size_t round{};round!=3000;++round)
+	{
+		std::size_t const n{static_cast<std::size_t>(eng()%(round<2000u?300u:90000u))};
+		std::byte const* first{buf.data()+eng()%64u};
+		std::byte const* last{first+n};
+		std::uint_least32_t const crc{static_cast<std::uint_least32_t>(eng())};
+		using enum fast_io::details::crc32_option;
+		check(fast_io::details::calculate_crc32<crc32>(crc,first,last)==reference<crc32>(crc,first,last),"crc32 matches the table loop");
+		check(fast_io::details::calculate_crc32<crc32c>(crc,first,last)==reference<crc32c>(crc,first,last),"crc32c matches the table loop");
+	}
+	return report();
+}
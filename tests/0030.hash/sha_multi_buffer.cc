@@ -0,0 +1,75 @@
+#include<fast_io.h>
+#include<fast_io_crypto.h>
+#include<random>
+#include<vector>
+#include"../check.h"
+
+using namespace fast_io::io;
+using namespace fast_io_test;
+
+/*
+Every multi-buffer kernel the machine supports must produce the digests of the one-message-at-a-time contexts,
+for batches whose messages differ in length so lanes are refilled at different times.
+*/
+template<typename context>
+inline void check_batch(std::vector<std::vector<std::byte>> const& messages,auto batch)
+{
+	constexpr std::size_t digest_size{context::digest_size};
+	std::vector<std::byte> digests(messages.size()*digest_size);
+	std::vector<fast_io::hash_batch_entry> entries(messages.size());
+	for(std::size_t i{};i!=messages.size();++i)
+		entries[i]={messages[i].data(),messages[i].data()+messages[i].size(),digests.data()+i*digest_size};
+	batch(entries.data(),entries.data()+entries.size());
+	for(std::size_t i{};i!=messages.size();++i)
+	{
+		context ctx;
+		ctx.update(messages[i].data(),messages[i].data()+messages[i].size());
+		ctx.do_final();
+		std::byte expected[digest_size];
+		ctx.digest_to_byte_ptr(expected);
+		check(std::equal(expected,expected+digest_size,digests.data()+i*digest_size),"batch digest matches the single-message context");
+	}
+}
+
+template<typename context>
+inline void check_all_kernels(std::vector<std::vector<std::byte>> const& messages)
+{
+	check_batch<context>(messages,fast_io::hash_batch<context>);
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+	using traits = fast_io::details::sha2_multi_buffer_context_traits<context>;
+	using T = typename traits::hasher_type;
+	using I = typename traits::initializer_type;
+	using value_type = typename fast_io::details::sha2_multi_buffer_traits<T>::value_type;
+	__builtin_cpu_init();
+	if(__builtin_cpu_supports("avx2"))
+		check_batch<context>(messages,[](auto f,auto l){fast_io::details::sha2_multi_buffer_impl<T,I,32/sizeof(value_type)>(f,l,fast_io::details::sha2_multi_buffer_avx2_kernel<T>);});
+	if(__builtin_cpu_supports("avx512bw"))
+		check_batch<context>(messages,[](auto f,auto l){fast_io::details::sha2_multi_buffer_impl<T,I,64/sizeof(value_type)>(f,l,fast_io::details::sha2_multi_buffer_avx512bw_kernel<T>);});
+	if constexpr(std::same_as<T,fast_io::details::sha256::sha256>)
+	{
+		if(fast_io::details::sha256_multi_buffer_has_shani())
+			check_batch<context>(messages,[](auto f,auto l){fast_io::details::sha2_multi_buffer_impl<T,I,2>(f,l,fast_io::details::sha256_multi_buffer_shani_kernel);});
+	}
+#endif
+}
+
+int main()
+{
+	std::mt19937_64 eng;
+	for(std::size_t round{};round!=40;++round)
+	{
+		std::vector<std::vector<std::byte>> messages(static_cast<std::size_t>(eng()%70u));
+		for(auto& m : messages)
+		{
+			m.resize(static_cast<std::size_t>(round%4u==0?eng()%20000u:eng()%300u));
+			for(auto& e : m)
+				e=static_cast<std::byte>(eng());
+		}
+		check_all_kernels<fast_io::sha256_context>(messages);
+		check_all_kernels<fast_io::sha224_context>(messages);
+		check_all_kernels<fast_io::sha512_context>(messages);
+		check_all_kernels<fast_io::sha384_context>(messages);
+		check_batch<fast_io::crc32c_context>(messages,fast_io::hash_batch<fast_io::crc32c_context>);
+	}
+	return report();
+}
@@ -0,0 +1,129 @@
+#include<fast_io.h>
+#include<fast_io_crypto.h>
+#include<random>
+#include<vector>
+#include<cstring>
+#include<atomic>
+#include<stdexcept>
+#include"../check.h"
+
+using namespace fast_io::io;
+using namespace fast_io_test;
+
+template<typename context>
+inline std::vector<std::byte> digest_of(std::vector<std::byte> const& message)
+{
+	std::vector<std::byte> out(context::digest_size);
+	context ctx{};
+	ctx.update(message.data(),message.data()+message.size());
+	ctx.do_final();
+	ctx.digest_to_byte_ptr(out.data());
+	return out;
+}
+
+/*
+Reference: the recursive Merkle Tree Hash definition of RFC 6962, section 2.1.
+*/
+template<typename context>
+inline std::vector<std::byte> mth(std::byte const* first,std::size_t leaves,std::size_t last_leaf_size,std::size_t chunk)
+{
+	std::vector<std::byte> message;
+	if(leaves==1)
+	{
+		message.push_back(std::byte{0});
+		message.insert(message.end(),first,first+last_leaf_size);
+	}
+	else
+	{
+		std::size_t k{1};
+		while(k*2<leaves)
+			k*=2;
+		auto l{mth<context>(first,k,chunk,chunk)};
+		auto r{mth<context>(first+k*chunk,leaves-k,last_leaf_size,chunk)};
+		message.push_back(std::byte{1});
+		message.insert(message.end(),l.begin(),l.end());
+		message.insert(message.end(),r.begin(),r.end());
+	}
+	return digest_of<context>(message);
+}
+
+template<typename context>
+inline void check_tree(std::vector<std::byte> const& data,std::size_t chunk)
+{
+	std::vector<std::byte> expected;
+	if(data.empty())
+	{
+		expected=digest_of<context>(data);
+	}
+	else
+	{
+		std::size_t const leaves{(data.size()-1)/chunk+1};
+		expected=mth<context>(data.data(),leaves,data.size()-(leaves-1)*chunk,chunk);
+	}
+	for(std::size_t threads : {1u,3u,8u,0u})
+	{
+		std::vector<std::byte> digest(context::digest_size);
+		fast_io::tree_hash<context>(data.data(),data.data()+data.size(),digest.data(),threads,chunk);
+		check(digest==expected,"tree_hash matches RFC 6962");
+		auto reader{[&](std::byte* buffer,std::size_t n,std::uintmax_t offset) noexcept
+		{
+			std::memcpy(buffer,data.data()+offset,n);
+		}};
+		fast_io::tree_hash_ranged<context>(reader,data.size(),digest.data(),threads,chunk);
+		check(digest==expected,"tree_hash_ranged matches RFC 6962");
+	}
+}
+
+/*
+A throwing reader stops the workers; tree_hash_ranged joins them all and rethrows on the calling thread.
+*/
+inline void check_throwing_reader()
+{
+	std::vector<std::byte> data(200000);
+	for(std::size_t threads : {1u,4u})
+	{
+		std::atomic<std::size_t> calls{};
+		auto reader{[&](std::byte* buffer,std::size_t n,std::uintmax_t offset)
+		{
+			if(calls.fetch_add(1)==3)
+				throw std::runtime_error("read failed");
+			std::memcpy(buffer,data.data()+offset,n);
+		}};
+		std::byte digest[32];
+		bool thrown{};
+		try
+		{
+			fast_io::tree_hash_ranged<fast_io::sha256_context>(reader,data.size(),digest,threads,1000);
+		}
+		catch(std::runtime_error const&)
+		{
+			thrown=true;
+		}
+		check(thrown,"tree_hash_ranged rethrows a reader exception");
+	}
+}
+
+int main()
+{
+	{
+		std::byte const zero{};
+		std::byte digest[32];
+		fast_io::tree_hash<fast_io::sha256_context>(&zero,&zero+1,digest);
+		constexpr unsigned char leaf_hash[32]{0x96,0xa2,0x96,0xd2,0x24,0xf2,0x85,0xc6,0x7b,0xee,0x93,0xc3,0x0f,0x8a,0x30,0x91,
+			0x57,0xf0,0xda,0xa3,0x5d,0xc5,0xb8,0x7e,0x41,0x0b,0x78,0x63,0x0a,0x09,0xcf,0xc7};
+		check(std::memcmp(digest,leaf_hash,32)==0,"single leaf hash");
+	}
+	std::mt19937_64 eng;
+	for(std::size_t size : {0u,1u,999u,1000u,1001u,3005u,17000u,40000u,123457u})
+	{
+		std::vector<std::byte> data(size);
+		for(auto& e : data)
+			e=static_cast<std::byte>(eng());
+		check_tree<fast_io::sha256_context>(data,1000);
+		check_tree<fast_io::sha512_context>(data,1000);
+		check_tree<fast_io::crc32c_context>(data,1000);
+		check_tree<fast_io::sha256_context>(data,64);
+	}
+	check_throwing_reader();
+	return report();
+}
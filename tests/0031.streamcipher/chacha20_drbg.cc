@@ -0,0 +1,222 @@
+#include<fast_io.h>
+#include<fast_io_crypto.h>
+#include<vector>
+#include<array>
+#include<algorithm>
+#include<string_view>
+#include<unistd.h>
+#include<sys/wait.h>
+#include"../check.h"
+
+using namespace fast_io::io;
+using namespace fast_io_test;
+
+/*
+Entropy source that always yields 0,1,2,...,31 so the engine output can be recomputed.
+*/
+struct fixed_seed
+{
+	using char_type = char;
+};
+
+inline constexpr fixed_seed io_value_handle(fixed_seed s) noexcept
+{
+	return s;
+}
+
+template<::std::contiguous_iterator Iter>
+inline Iter read(fixed_seed,Iter first,Iter last)
+{
+	for(auto it{first};it!=last;++it)
+		*it=static_cast<char>((it-first)%32);
+	return last;
+}
+
+inline std::vector<std::byte> reference_keystream(std::byte const* key,std::uint_least32_t counter,std::size_t n)
+{
+	std::byte const nonce[12]{};
+	std::uint_least32_t state[16];
+	fast_io::details::chacha::chacha20_init_state(state,key,counter,nonce);
+	std::vector<std::byte> out(n);
+	for(std::size_t i{};i<n;i+=64)
+	{
+		std::byte ks[64];
+		fast_io::details::chacha::chacha_main_routine(ks,state);
+		++state[12];
+		for(std::size_t j{};j!=64&&i+j!=n;++j)
+			out[i+j]=ks[j];
+	}
+	return out;
+}
+
+inline std::array<std::byte,32> fixed_key()
+{
+	std::array<std::byte,32> key;
+	for(std::size_t i{};i!=32;++i)
+		key[i]=static_cast<std::byte>(i);
+	return key;
+}
+
+/*
+Draws follow the fast-key-erasure buffer exactly: the first 32 bytes of each 4 KiB keystream buffer become the
+next key and the remaining 4064 bytes are handed out in order.
+*/
+inline void test_draws()
+{
+	fast_io::basic_chacha20_drbg_engine<fixed_seed> engine;
+	auto key{fixed_key()};
+	bool ok{true};
+	for(std::size_t buffer{};buffer!=3;++buffer)
+	{
+		auto ks{reference_keystream(key.data(),0,4096)};
+		for(std::size_t off{32};off!=4096;off+=sizeof(std::size_t))
+		{
+			std::size_t expected;
+			__builtin_memcpy(&expected,ks.data()+off,sizeof(expected));
+			if(engine()!=expected)
+				ok=false;
+		}
+		__builtin_memcpy(key.data(),ks.data(),32);
+	}
+	check(ok,"draws");
+}
+
+inline void test_fill()
+{
+	{
+		fast_io::basic_chacha20_drbg_engine<fixed_seed> engine;
+		std::vector<std::byte> out(10000);
+		engine.fill(out.data(),out.data()+out.size());
+		auto const key{fixed_key()};
+		auto const ks{reference_keystream(key.data(),0,158*64)};
+		check(std::equal(out.begin(),out.end(),ks.begin()),"bulk fill");
+		/*
+		The partial last block used up counter 156; the refill continues at 157 and keeps bytes 32.. of it.
+		*/
+		std::size_t expected;
+		__builtin_memcpy(&expected,ks.data()+157*64+32,sizeof(expected));
+		check(engine()==expected,"draw after bulk fill");
+	}
+	{
+		fast_io::basic_chacha20_drbg_engine<fixed_seed> a;
+		fast_io::basic_chacha20_drbg_engine<fixed_seed> b;
+		std::vector<std::byte> pieces(4064*3);
+		std::size_t pos{};
+		for(std::size_t step{1};pos!=pieces.size();step=step*7%61+1)
+		{
+			std::size_t const n{std::min(step,pieces.size()-pos)};
+			a.fill(pieces.data()+pos,pieces.data()+pos+n);
+			pos+=n;
+		}
+		std::vector<std::size_t> draws(pieces.size()/sizeof(std::size_t));
+		for(auto& e : draws)
+			e=b();
+		check(__builtin_memcmp(pieces.data(),draws.data(),pieces.size())==0,"small fills match draws");
+	}
+	{
+		fast_io::basic_chacha20_drbg_engine<fixed_seed> engine;
+		std::vector<std::uint_least32_t> out(3*(1u<<20u)/4+5);
+		engine.fill(out.data(),out.data()+out.size());
+		std::size_t zeros{};
+		for(auto e : out)
+			zeros+=e==0;
+		check(zeros<4,"large fill is not blank");
+	}
+}
+
+inline void test_reseed()
+{
+	fast_io::basic_chacha20_drbg_engine<fixed_seed> engine;
+	std::size_t const before{engine.refills_until_reseed};
+	for(std::size_t i{};i!=300*508;++i)
+		engine();
+	check(engine.refills_until_reseed<before,"reseed interval");
+}
+
+inline void test_white_hole()
+{
+	fast_io::basic_chacha20_drbg_engine<fast_io::native_white_hole> a;
+	fast_io::basic_chacha20_drbg_engine<fast_io::native_white_hole> b;
+	check(a()!=b(),"independent engines");
+	auto& tl{fast_io::chacha20_drbg_thread_local_engine<fast_io::native_white_hole>()};
+	check(&tl==&fast_io::chacha20_drbg_thread_local_engine<fast_io::native_white_hole>(),"thread local engine");
+	std::size_t values[4];
+	tl.fill(values,values+4);
+	check(values[0]!=values[1]||values[2]!=values[3],"thread local fill");
+}
+
+/*
+A forked child must not replay the parent's buffered output.
+*/
+inline void test_fork()
+{
+	fast_io::basic_chacha20_drbg_engine<fast_io::native_white_hole> engine;
+	engine();
+	int fds[2];
+	if(::pipe(fds)!=0)
+	{
+		check(false,"pipe");
+		return;
+	}
+	pid_t const pid{::fork()};
+	if(pid==0)
+	{
+		std::size_t v[2]{engine(),engine()};
+		[[maybe_unused]] auto r{::write(fds[1],v,sizeof(v))};
+		::_exit(0);
+	}
+	std::size_t parent[2]{engine(),engine()};
+	std::size_t child[2]{};
+	[[maybe_unused]] auto r{::read(fds[0],child,sizeof(child))};
+	int status;
+	::waitpid(pid,&status,0);
+	::close(fds[0]);
+	::close(fds[1]);
+	check(parent[0]!=child[0]&&parent[1]!=child[1],"fork reseeds the child");
+}
+
+/*
+Siblings forked from one parent whose engine reads through a buffered white hole: each child inherits the same
+read-ahead bytes, so only a reseed straight from the kernel keeps them apart.
+*/
+inline void test_fork_siblings()
+{
+	fast_io::basic_chacha20_drbg_engine<fast_io::ibuf_white_hole> engine;
+	engine();
+	std::size_t child[2][2]{};
+	for(auto& e : child)
+	{
+		int fds[2];
+		if(::pipe(fds)!=0)
+		{
+			check(false,"pipe");
+			return;
+		}
+		pid_t const pid{::fork()};
+		if(pid==0)
+		{
+			std::size_t v[2]{engine(),engine()};
+			[[maybe_unused]] auto r{::write(fds[1],v,sizeof(v))};
+			::_exit(0);
+		}
+		[[maybe_unused]] auto r{::read(fds[0],e,sizeof(e))};
+		int status;
+		::waitpid(pid,&status,0);
+		::close(fds[0]);
+		::close(fds[1]);
+	}
+	check(child[0][0]!=child[1][0]&&child[0][1]!=child[1][1],"sibling children diverge");
+	std::size_t const parent{engine()};
+	check(parent!=child[0][0]&&parent!=child[1][0],"children diverge from the parent");
+}
+
+int main()
+{
+	test_draws();
+	test_fill();
+	test_reseed();
+	test_white_hole();
+	test_fork();
+	test_fork_siblings();
+	return report();
+}
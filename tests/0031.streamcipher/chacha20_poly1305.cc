@@ -0,0 +1,261 @@
+#include<fast_io.h>
+#include<fast_io_device.h>
+#include<fast_io_crypto.h>
+#include<random>
+#include<vector>
+#include"../check.h"
+
+using namespace fast_io::io;
+using namespace fast_io_test;
+
+inline std::vector<std::byte> from_hex(std::string_view hex)
+{
+	std::vector<std::byte> v;
+	auto digit{[](char c){return c<='9'?c-'0':c-'a'+10;}};
+	for(std::size_t i{};i+1<hex.size();)
+	{
+		if(hex[i]==' ')
+		{
+			++i;
+			continue;
+		}
+		v.push_back(static_cast<std::byte>(digit(hex[i])*16+digit(hex[i+1])));
+		i+=2;
+	}
+	return v;
+}
+
+inline std::vector<std::byte> from_text(std::string_view text)
+{
+	std::vector<std::byte> v(text.size());
+	__builtin_memcpy(v.data(),text.data(),text.size());
+	return v;
+}
+
+/*
+Reference: one scalar block at a time, which is all chacha_main_routine offered before the multi-block kernels.
+*/
+inline std::vector<std::byte> reference_xor(std::uint_least32_t const* init,std::vector<std::byte> const& in)
+{
+	std::uint_least32_t state[16];
+	__builtin_memcpy(state,init,sizeof(state));
+	std::vector<std::byte> out(in.size());
+	for(std::size_t i{};i<in.size();i+=64)
+	{
+		std::byte ks[64];
+		fast_io::details::chacha::chacha_main_routine(ks,state);
+		++state[12];
+		for(std::size_t j{};j!=64&&i+j!=in.size();++j)
+			out[i+j]=in[i+j]^ks[j];
+	}
+	return out;
+}
+
+inline std::vector<std::byte> reference_poly1305(std::byte const* key,std::vector<std::byte> const& msg)
+{
+	fast_io::details::poly1305::poly1305_state st;
+	fast_io::details::poly1305::poly1305_init(st,key);
+	fast_io::details::poly1305::poly1305_blocks_scalar(st,msg.data(),msg.size()/16,1u<<24);
+	std::size_t const tail{msg.size()%16};
+	if(tail)
+	{
+		std::byte last[16]{};
+		__builtin_memcpy(last,msg.data()+msg.size()-tail,tail);
+		last[tail]=std::byte{1};
+		fast_io::details::poly1305::poly1305_blocks_scalar(st,last,1,0);
+	}
+	std::vector<std::byte> tag(16);
+	fast_io::details::poly1305::poly1305_finish(st,tag.data());
+	return tag;
+}
+
+inline void test_vectors()
+{
+	auto const sunscreen{from_text("Ladies and Gentlemen of the class of '99: If I could offer you only one tip for the future, sunscreen would be it.")};
+	/*
+	RFC 8439 2.4.2
+	*/
+	{
+		auto const key{from_hex("000102030405060708090a0b0c0d0e0f101112131415161718191a1b1c1d1e1f")};
+		auto const nonce{from_hex("000000000000004a00000000")};
+		std::uint_least32_t state[16];
+		fast_io::details::chacha::chacha20_init_state(state,key.data(),1,nonce.data());
+		std::vector<std::byte> out(sunscreen.size());
+		fast_io::details::chacha::chacha20_xor(state,sunscreen.data(),out.data(),out.size());
+		check(out==from_hex("6e2e359a2568f98041ba0728dd0d6981e97e7aec1d4360c20a27afccfd9fae0bf91b65c5524733ab8f593dabcd62b3571639d624e65152ab8f530c359f0861d807ca0dbf500d6a6156a38e088a22b65e52bc514d16ccf806818ce91ab77937365af90bbf74a35be6b40b8eedf2785e42874d"),"RFC 8439 ChaCha20");
+	}
+	/*
+	RFC 8439 2.5.2
+	*/
+	{
+		auto const key{from_hex("85d6be7857556d337f4452fe42d506a80103808afb0db2fd4abff6af4149f51b")};
+		auto const msg{from_text("Cryptographic Forum Research Group")};
+		std::byte tag[16];
+		fast_io::details::poly1305::poly1305_mac(key.data(),msg.data(),msg.data()+msg.size(),tag);
+		check(std::vector<std::byte>(tag,tag+16)==from_hex("a8061dc1305136c6c22b8baf0c0127a9"),"RFC 8439 Poly1305");
+	}
+	/*
+	RFC 8439 2.8.2
+	*/
+	{
+		auto const key{from_hex("808182838485868788898a8b8c8d8e8f909192939495969798999a9b9c9d9e9f")};
+		auto const nonce{from_hex("070000004041424344454647")};
+		auto const aad{from_hex("50515253c0c1c2c3c4c5c6c7")};
+		std::vector<std::byte> ct(sunscreen.size());
+		std::byte tag[16];
+		fast_io::chacha20_poly1305_encrypt(key.data(),nonce.data(),aad.data(),aad.data()+aad.size(),
+			sunscreen.data(),sunscreen.data()+sunscreen.size(),ct.data(),tag);
+		check(ct==from_hex("d31a8d34648e60db7b86afbc53ef7ec2a4aded51296e08fea9e2b5a736ee62d63dbea45e8ca9671282fafb69da92728b1a71de0a9e060b2905d6a5b67ecd3b3692ddbd7f2d778b8c9803aee328091b58fab324e4fad675945585808b4831d7bc3ff4def08e4b7a9de576d26586cec64b6116"),"RFC 8439 AEAD ciphertext");
+		check(std::vector<std::byte>(tag,tag+16)==from_hex("1ae10b594f09e26a7e902ecbd0600691"),"RFC 8439 AEAD tag");
+		std::vector<std::byte> pt(ct.size());
+		check(fast_io::chacha20_poly1305_decrypt(key.data(),nonce.data(),aad.data(),aad.data()+aad.size(),
+			ct.data(),ct.data()+ct.size(),tag,pt.data()),"RFC 8439 AEAD decrypts");
+		check(pt==sunscreen,"RFC 8439 AEAD plaintext");
+		ct[7]^=std::byte{1};
+		std::vector<std::byte> untouched(ct.size());
+		check(!fast_io::chacha20_poly1305_decrypt(key.data(),nonce.data(),aad.data(),aad.data()+aad.size(),
+			ct.data(),ct.data()+ct.size(),tag,untouched.data()),"forged ciphertext is rejected");
+		check(untouched==std::vector<std::byte>(ct.size()),"rejected plaintext is left untouched");
+	}
+}
+
+/*
+Every length and counter offset around the 4/8/16-block groups and the 4-block Poly1305 groups.
+*/
+inline void test_random()
+{
+	std::mt19937_64 eng;
+	for(std::size_t round{};round!=3000;++round)
+	{
+		std::size_t const n{round<1200?round:static_cast<std::size_t>(eng()%20000u)};
+		std::vector<std::byte> data(n);
+		for(auto& e : data)
+			e=static_cast<std::byte>(eng());
+		std::byte key[32];
+		std::byte nonce[12];
+		for(auto& e : key)
+			e=static_cast<std::byte>(eng());
+		for(auto& e : nonce)
+			e=static_cast<std::byte>(eng());
+		std::uint_least32_t state[16];
+		fast_io::details::chacha::chacha20_init_state(state,key,static_cast<std::uint_least32_t>(round%7==0?0xfffffff0u:eng()),nonce);
+		auto const expected{reference_xor(state,data)};
+		std::vector<std::byte> out(n);
+		fast_io::details::chacha::chacha20_xor(state,data.data(),out.data(),n);
+		check(out==expected,"ChaCha20 matches the reference");
+		std::byte tag[16];
+		fast_io::details::poly1305::poly1305_mac(key,data.data(),data.data()+n,tag);
+		check(std::vector<std::byte>(tag,tag+16)==reference_poly1305(key,data),"Poly1305 matches the reference");
+	}
+}
+
+/*
+Round trip through basic_io_buffer with the record decorators: small writes, writes larger than a record and a
+reading buffer smaller than a record, so records straddle reads.
+*/
+inline void test_decorators()
+{
+	std::byte key[32];
+	std::byte nonce[12];
+	for(std::size_t i{};i!=32;++i)
+		key[i]=static_cast<std::byte>(i*7+1);
+	for(std::size_t i{};i!=12;++i)
+		nonce[i]=static_cast<std::byte>(i*13+5);
+	std::mt19937_64 eng;
+	std::vector<char> text(3000000);
+	for(auto& e : text)
+		e=static_cast<char>('a'+eng()%26);
+	fast_io::native_file file(fast_io::io_temp);
+	{
+		using obuf_type = fast_io::basic_io_buffer<fast_io::native_io_observer,fast_io::buffer_mode::out|fast_io::buffer_mode::secure_clear|fast_io::buffer_mode::construct_decorator,
+			fast_io::basic_decorators<char,fast_io::empty_decorator,fast_io::chacha20_poly1305_encrypt_deco_t>>;
+		obuf_type obf(fast_io::basic_decorators<char,fast_io::empty_decorator,fast_io::chacha20_poly1305_encrypt_deco_t>{{},{key,nonce}},file);
+		for(std::size_t i{};i!=text.size();)
+		{
+			std::size_t len{eng()%3==0?static_cast<std::size_t>(eng()%100000u):static_cast<std::size_t>(eng()%100u)};
+			if(text.size()-i<len)
+				len=text.size()-i;
+			write(obf,text.data()+i,text.data()+i+len);
+			i+=len;
+		}
+	}
+	auto const read_back{[&](fast_io::native_io_observer in)
+	{
+		seek(in,0,fast_io::seekdir::beg);
+		using ibuf_type = fast_io::basic_io_buffer<fast_io::native_io_observer,fast_io::buffer_mode::in|fast_io::buffer_mode::secure_clear|fast_io::buffer_mode::construct_decorator,
+			fast_io::basic_decorators<char,fast_io::chacha20_poly1305_decrypt_deco_t>,1000>;
+		ibuf_type ibf(fast_io::basic_decorators<char,fast_io::chacha20_poly1305_decrypt_deco_t>{{key,nonce},{}},in);
+		std::vector<char> back(text.size()+100);
+		char* p{back.data()};
+		for(;;)
+		{
+			std::size_t const len{1+static_cast<std::size_t>(eng()%50000u)};
+			std::size_t const room{static_cast<std::size_t>(back.data()+back.size()-p)};
+			char* q{read(ibf,p,p+(len<room?len:room))};
+			if(q==p)
+				break;
+			p=q;
+		}
+		back.resize(static_cast<std::size_t>(p-back.data()));
+		return back;
+	}};
+	check(read_back(file)==text,"decorator round trip");
+	/*
+	Flip one ciphertext byte: reading must fail instead of returning forged plaintext.
+	*/
+	std::vector<char> ciphertext(text.size()+text.size()/100+1000);
+	seek(file,0,fast_io::seekdir::beg);
+	ciphertext.resize(static_cast<std::size_t>(read(file,ciphertext.data(),ciphertext.data()+ciphertext.size())-ciphertext.data()));
+	ciphertext[100000]^=1;
+	fast_io::native_file tampered(fast_io::io_temp);
+	write(tampered,ciphertext.data(),ciphertext.data()+ciphertext.size());
+	bool thrown{};
+	try
+	{
+		read_back(tampered);
+	}
+	catch(fast_io::error const&)
+	{
+		thrown=true;
+	}
+	check(thrown,"a flipped ciphertext byte throws");
+	/*
+	Cut the stream inside a record: end of file must raise instead of quietly dropping the partial record.
+	*/
+	ciphertext[100000]^=1;
+	fast_io::native_file truncated(fast_io::io_temp);
+	write(truncated,ciphertext.data(),ciphertext.data()+ciphertext.size()-1);
+	thrown=false;
+	try
+	{
+		read_back(truncated);
+	}
+	catch(fast_io::error const&)
+	{
+		thrown=true;
+	}
+	check(thrown,"a cut inside a record throws");
+	/*
+	Drop the final record: the cut falls on a record boundary and must raise all the same.
+	*/
+	fast_io::native_file unfinished(fast_io::io_temp);
+	write(unfinished,ciphertext.data(),ciphertext.data()+ciphertext.size()-fast_io::chacha20_poly1305_record_overhead);
+	thrown=false;
+	try
+	{
+		read_back(unfinished);
+	}
+	catch(fast_io::error const&)
+	{
+		thrown=true;
+	}
+	check(thrown,"a dropped final record throws");
+}
+
+int main()
+{
+	test_vectors();
+	test_random();
+	test_decorators();
+	return report();
+}
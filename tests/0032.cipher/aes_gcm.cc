@@ -0,0 +1,332 @@
+#include<fast_io.h>
+#include<fast_io_device.h>
+#include<fast_io_crypto.h>
+#include<random>
+#include<utility>
+#include<vector>
+#include"../check.h"
+
+using namespace fast_io::io;
+using namespace fast_io_test;
+
+inline std::vector<std::byte> from_hex(std::string_view hex)
+{
+	std::vector<std::byte> v;
+	auto digit{[](char c){return c<='9'?c-'0':c-'a'+10;}};
+	for(std::size_t i{};i+1<hex.size();i+=2)
+		v.push_back(static_cast<std::byte>(digit(hex[i])*16+digit(hex[i+1])));
+	return v;
+}
+
+template<std::size_t keysize>
+inline std::span<std::byte const,keysize> key_span(std::vector<std::byte> const& v)
+{
+	return std::span<std::byte const,keysize>(v.data(),keysize);
+}
+
+/*
+Block-at-a-time references on the portable primitives, which the vectors below pin down.
+*/
+template<std::size_t keysize,bool inc32>
+inline std::vector<std::byte> reference_ctr(fast_io::aes<keysize> const& cipher,std::byte* counter,std::vector<std::byte> const& in)
+{
+	std::vector<std::byte> out(in.size());
+	for(std::size_t i{};i<in.size();i+=16)
+	{
+		std::byte ks[16];
+		fast_io::details::aes::aes_portable_encrypt_block(cipher.key_schedule,cipher.rounds,counter,ks);
+		fast_io::details::aes::aes_ctr_increment<inc32>(counter);
+		for(std::size_t j{};j!=16&&i+j!=in.size();++j)
+			out[i+j]=in[i+j]^ks[j];
+	}
+	return out;
+}
+
+inline void reference_ghash(std::uint_least64_t const* h,std::uint_least64_t* s,std::vector<std::byte> const& in)
+{
+	for(std::size_t i{};i<in.size();i+=16)
+	{
+		std::byte block[16]{};
+		for(std::size_t j{};j!=16&&i+j!=in.size();++j)
+			block[j]=in[i+j];
+		s[0]^=fast_io::details::aes::aes_gcm_load_be64(block);
+		s[1]^=fast_io::details::aes::aes_gcm_load_be64(block+8);
+		fast_io::details::aes::aes_gcm_gf_mul(s,h);
+	}
+}
+
+template<std::size_t keysize>
+inline std::vector<std::byte> reference_gcm(std::vector<std::byte> const& key,std::byte const* nonce,std::vector<std::byte> const& aad,std::vector<std::byte> const& pt)
+{
+	fast_io::aes<keysize> cipher(key_span<keysize>(key));
+	std::byte hb[16]{};
+	fast_io::details::aes::aes_portable_encrypt_block(cipher.key_schedule,cipher.rounds,hb,hb);
+	std::uint_least64_t const h[2]{fast_io::details::aes::aes_gcm_load_be64(hb),fast_io::details::aes::aes_gcm_load_be64(hb+8)};
+	std::byte j0[16]{};
+	for(std::size_t i{};i!=12;++i)
+		j0[i]=nonce[i];
+	j0[15]=std::byte{1};
+	std::byte counter[16];
+	__builtin_memcpy(counter,j0,16);
+	counter[15]=std::byte{2};
+	auto out{reference_ctr<keysize,true>(cipher,counter,pt)};
+	std::uint_least64_t s[2]{};
+	reference_ghash(h,s,aad);
+	reference_ghash(h,s,out);
+	s[0]^=static_cast<std::uint_least64_t>(aad.size())*8u;
+	s[1]^=static_cast<std::uint_least64_t>(pt.size())*8u;
+	fast_io::details::aes::aes_gcm_gf_mul(s,h);
+	std::byte tag[16];
+	fast_io::details::aes::aes_gcm_store_be64(tag,s[0]);
+	fast_io::details::aes::aes_gcm_store_be64(tag+8,s[1]);
+	fast_io::details::aes::aes_portable_encrypt_block(cipher.key_schedule,cipher.rounds,j0,j0);
+	for(std::size_t i{};i!=16;++i)
+		out.push_back(tag[i]^j0[i]);
+	return out;
+}
+
+template<std::size_t keysize>
+inline void test_block(std::string_view pt_hex,std::string_view ct_hex)
+{
+	std::vector<std::byte> key(keysize);
+	for(std::size_t i{};i!=keysize;++i)
+		key[i]=static_cast<std::byte>(i);
+	auto const pt{from_hex(pt_hex)};
+	auto const ct{from_hex(ct_hex)};
+	std::byte out[16];
+	fast_io::aes<keysize> enc(key_span<keysize>(key));
+	enc(pt.data(),1,out);
+	check(std::vector<std::byte>(out,out+16)==ct,"FIPS-197 encryption");
+	fast_io::details::aes::aes_portable_encrypt_block(enc.key_schedule,enc.rounds,pt.data(),out);
+	check(std::vector<std::byte>(out,out+16)==ct,"FIPS-197 portable encryption");
+	fast_io::aes<keysize,true> dec(key_span<keysize>(key));
+	dec(ct.data(),1,out);
+	check(std::vector<std::byte>(out,out+16)==pt,"FIPS-197 decryption");
+	fast_io::details::aes::aes_portable_decrypt_block(dec.key_schedule,dec.rounds,ct.data(),out);
+	check(std::vector<std::byte>(out,out+16)==pt,"FIPS-197 portable decryption");
+}
+
+template<std::size_t keysize>
+inline void test_gcm(std::string_view key_hex,std::string_view nonce_hex,std::string_view aad_hex,std::string_view pt_hex,std::string_view ct_hex,std::string_view tag_hex)
+{
+	auto const key{from_hex(key_hex)};
+	auto const nonce{from_hex(nonce_hex)};
+	auto const aad{from_hex(aad_hex)};
+	auto const pt{from_hex(pt_hex)};
+	fast_io::aes_gcm<keysize> gcm(key_span<keysize>(key));
+	std::vector<std::byte> ct(pt.size());
+	std::byte tag[16];
+	std::span<std::byte const,12> const n(nonce.data(),12);
+	gcm.encrypt(n,aad.data(),aad.data()+aad.size(),pt.data(),pt.data()+pt.size(),ct.data(),tag);
+	check(ct==from_hex(ct_hex),"GCM ciphertext");
+	check(std::vector<std::byte>(tag,tag+16)==from_hex(tag_hex),"GCM tag");
+	std::vector<std::byte> back(pt.size());
+	check(gcm.decrypt(n,aad.data(),aad.data()+aad.size(),ct.data(),ct.data()+ct.size(),tag,back.data()),"GCM decrypts");
+	check(back==pt,"GCM plaintext");
+	tag[3]^=std::byte{0x10};
+	std::vector<std::byte> untouched(pt.size());
+	check(!gcm.decrypt(n,aad.data(),aad.data()+aad.size(),ct.data(),ct.data()+ct.size(),tag,untouched.data()),"forged tag is rejected");
+	check(untouched==std::vector<std::byte>(pt.size()),"rejected plaintext is left untouched");
+}
+
+inline void test_vectors()
+{
+	/*
+	FIPS-197 appendix C
+	*/
+	test_block<16>("00112233445566778899aabbccddeeff","69c4e0d86a7b0430d8cdb78070b4c55a");
+	test_block<24>("00112233445566778899aabbccddeeff","dda97ca4864cdfe06eaf70a0ec0d7191");
+	test_block<32>("00112233445566778899aabbccddeeff","8ea2b7ca516745bfeafc49904b496089");
+	/*
+	SP 800-38A F.5.1, through the decorator in pieces that split blocks
+	*/
+	{
+		auto const key{from_hex("2b7e151628aed2a6abf7158809cf4f3c")};
+		auto const iv{from_hex("f0f1f2f3f4f5f6f7f8f9fafbfcfdfeff")};
+		auto const pt{from_hex("6bc1bee22e409f96e93d7e117393172aae2d8a571e03ac9c9eb76fac45af8e5130c81c46a35ce411e5fbc1191a0a52eff69f2445df4f9b17ad2b417be66c3710")};
+		fast_io::aes_ctr_deco_t<16> deco(key_span<16>(key),std::span<std::byte const,16>(iv.data(),16));
+		std::vector<std::byte> ct(pt.size());
+		std::size_t const cuts[]{0,5,16,17,40,64};
+		for(std::size_t i{};i+1!=std::size(cuts);++i)
+			fast_io::details::aes::aes_ctr_deco_xor(deco,pt.data()+cuts[i],pt.data()+cuts[i+1],ct.data()+cuts[i]);
+		check(ct==from_hex("874d6191b620e3261bef6864990db6ce9806f66b7970fdff8617187bb9fffdff5ae4df3edbd5d35e5b4f09020db03eab1e031dda2fbe03d1792170a0f3009cee"),"SP 800-38A CTR");
+	}
+	/*
+	The GCM specification's test cases 2, 4, 10 and 16
+	*/
+	test_gcm<16>("00000000000000000000000000000000","000000000000000000000000","","00000000000000000000000000000000",
+		"0388dace60b6a392f328c2b971b2fe78","ab6e47d42cec13bdf53a67b21257bddf");
+	std::string_view const pt{"d9313225f88406e5a55909c5aff5269a86a7a9531534f7da2e4c303d8a318a721c3c0c95956809532fcf0e2449a6b525b16aedf5aa0de657ba637b39"};
+	std::string_view const aad{"feedfacedeadbeeffeedfacedeadbeefabaddad2"};
+	test_gcm<16>("feffe9928665731c6d6a8f9467308308","cafebabefacedbaddecaf888",aad,pt,
+		"42831ec2217774244b7221b784d0d49ce3aa212f2c02a4e035c17e2329aca12e21d514b25466931c7d8f6a5aac84aa051ba30b396a0aac973d58e091","5bc94fbc3221a5db94fae95ae7121a47");
+	test_gcm<24>("feffe9928665731c6d6a8f9467308308feffe9928665731c","cafebabefacedbaddecaf888",aad,pt,
+		"3980ca0b3c00e841eb06fac4872a2757859e1ceaa6efd984628593b40ca1e19c7d773d00c144c525ac619d18c84a3f4718e2448b2fe324d9ccda2710","2519498e80f1478f37ba55bd6d27618c");
+	test_gcm<32>("feffe9928665731c6d6a8f9467308308feffe9928665731c6d6a8f9467308308","cafebabefacedbaddecaf888",aad,pt,
+		"522dc1f099567d07f47f37a32a84427d643a8cdcbfe5c0c97598a2bd2555d1aa8cb08e48590dbb3da7b08b1056828838c5f61e6393ba7a0abcc9f662","76fc6ece0f4e1768cddf8853bb2d551b");
+}
+
+/*
+Every length around the 8/16/32-block batches, counters that carry across 32 and 64 bits, all key sizes.
+*/
+template<std::size_t keysize>
+inline void test_random()
+{
+	std::mt19937_64 eng(keysize);
+	for(std::size_t round{};round!=1500;++round)
+	{
+		std::size_t const n{round<700?round:static_cast<std::size_t>(eng()%40000u)};
+		std::vector<std::byte> data(n),aad(static_cast<std::size_t>(eng()%70u)),key(keysize);
+		for(auto& e : data)
+			e=static_cast<std::byte>(eng());
+		for(auto& e : aad)
+			e=static_cast<std::byte>(eng());
+		for(auto& e : key)
+			e=static_cast<std::byte>(eng());
+		std::byte nonce[12];
+		for(auto& e : nonce)
+			e=static_cast<std::byte>(eng());
+		if(round%5==0)
+		{
+			nonce[8]=nonce[9]=nonce[10]=nonce[11]=std::byte{0xff};
+		}
+		fast_io::aes_gcm<keysize> gcm(key_span<keysize>(key));
+		std::vector<std::byte> out(n+16);
+		gcm.encrypt(nonce,aad.data(),aad.data()+aad.size(),data.data(),data.data()+n,out.data(),out.data()+n);
+		check(out==reference_gcm<keysize>(key,nonce,aad,data),"GCM matches the reference");
+		std::vector<std::byte> back(n);
+		check(gcm.decrypt(nonce,aad.data(),aad.data()+aad.size(),out.data(),out.data()+n,out.data()+n,back.data()),"GCM decrypts its own output");
+		check(back==data,"GCM round trip");
+		std::byte counter[16];
+		for(auto& e : counter)
+			e=static_cast<std::byte>(eng());
+		if(round%3==0)
+		{
+			for(std::size_t i{8};i!=16;++i)
+				counter[i]=std::byte{0xff};
+			counter[15]=static_cast<std::byte>(0xff-eng()%40u);
+		}
+		std::byte ref_counter[16];
+		__builtin_memcpy(ref_counter,counter,16);
+		auto const expected{reference_ctr<keysize,false>(gcm.cipher,ref_counter,data)};
+		std::vector<std::byte> ctr_out(n);
+		fast_io::details::aes::aes_ctr_xor<fast_io::aes<keysize>::rounds,false>(gcm.cipher.key_schedule,counter,data.data(),ctr_out.data(),n);
+		check(ctr_out==expected,"CTR matches the reference");
+		check(std::vector<std::byte>(counter,counter+16)==std::vector<std::byte>(ref_counter,ref_counter+16),"CTR counter matches the reference");
+	}
+}
+
+/*
+Round trips through basic_io_buffer: CTR both ways, GCM records straddling a reading buffer smaller than a record,
+and a flipped ciphertext byte, a cut record or a dropped final record that must make reading throw.
+*/
+template<typename encrypt_deco,typename decrypt_deco>
+inline void test_decorators(encrypt_deco enc,decrypt_deco const& dec,bool authenticated)
+{
+	std::mt19937_64 eng;
+	std::vector<char> text(1000000);
+	for(auto& e : text)
+		e=static_cast<char>('a'+eng()%26);
+	fast_io::native_file file(fast_io::io_temp);
+	{
+		fast_io::basic_io_buffer<fast_io::native_io_observer,fast_io::buffer_mode::out|fast_io::buffer_mode::secure_clear|fast_io::buffer_mode::construct_decorator,
+			fast_io::basic_decorators<char,fast_io::empty_decorator,encrypt_deco>> obf(fast_io::basic_decorators<char,fast_io::empty_decorator,encrypt_deco>{{},std::move(enc)},file);
+		for(std::size_t i{};i!=text.size();)
+		{
+			std::size_t len{eng()%3==0?static_cast<std::size_t>(eng()%100000u):static_cast<std::size_t>(eng()%100u)};
+			if(text.size()-i<len)
+				len=text.size()-i;
+			write(obf,text.data()+i,text.data()+i+len);
+			i+=len;
+		}
+	}
+	auto const read_back{[&](fast_io::native_io_observer in)
+	{
+		seek(in,0,fast_io::seekdir::beg);
+		fast_io::basic_io_buffer<fast_io::native_io_observer,fast_io::buffer_mode::in|fast_io::buffer_mode::secure_clear|fast_io::buffer_mode::construct_decorator,
+			fast_io::basic_decorators<char,decrypt_deco>,1000> ibf(fast_io::basic_decorators<char,decrypt_deco>{dec,{}},in);
+		std::vector<char> back(text.size()+100);
+		char* p{back.data()};
+		for(;;)
+		{
+			std::size_t const len{1+static_cast<std::size_t>(eng()%50000u)};
+			std::size_t const room{static_cast<std::size_t>(back.data()+back.size()-p)};
+			char* q{read(ibf,p,p+(len<room?len:room))};
+			if(q==p)
+				break;
+			p=q;
+		}
+		back.resize(static_cast<std::size_t>(p-back.data()));
+		return back;
+	}};
+	check(read_back(file)==text,"decorator round trip");
+	if(authenticated)
+	{
+		std::vector<char> ciphertext(text.size()+text.size()/100+1000);
+		seek(file,0,fast_io::seekdir::beg);
+		ciphertext.resize(static_cast<std::size_t>(read(file,ciphertext.data(),ciphertext.data()+ciphertext.size())-ciphertext.data()));
+		ciphertext[100000]^=1;
+		fast_io::native_file tampered(fast_io::io_temp);
+		write(tampered,ciphertext.data(),ciphertext.data()+ciphertext.size());
+		bool thrown{};
+		try
+		{
+			read_back(tampered);
+		}
+		catch(fast_io::error const&)
+		{
+			thrown=true;
+		}
+		check(thrown,"a flipped ciphertext byte throws");
+		/*
+		Cut the stream inside a record: end of file must raise instead of quietly dropping the partial record.
+		*/
+		ciphertext[100000]^=1;
+		fast_io::native_file truncated(fast_io::io_temp);
+		write(truncated,ciphertext.data(),ciphertext.data()+ciphertext.size()-1);
+		thrown=false;
+		try
+		{
+			read_back(truncated);
+		}
+		catch(fast_io::error const&)
+		{
+			thrown=true;
+		}
+		check(thrown,"a cut inside a record throws");
+		/*
+		Drop the final record: the cut falls on a record boundary and must raise all the same.
+		*/
+		fast_io::native_file unfinished(fast_io::io_temp);
+		write(unfinished,ciphertext.data(),ciphertext.data()+ciphertext.size()-fast_io::aes_gcm_record_overhead);
+		thrown=false;
+		try
+		{
+			read_back(unfinished);
+		}
+		catch(fast_io::error const&)
+		{
+			thrown=true;
+		}
+		check(thrown,"a dropped final record throws");
+	}
+}
+
+int main()
+{
+	test_vectors();
+	test_random<16>();
+	test_random<24>();
+	test_random<32>();
+	std::byte key[32];
+	std::byte nonce[16];
+	for(std::size_t i{};i!=32;++i)
+		key[i]=static_cast<std::byte>(i*7+1);
+	for(std::size_t i{};i!=16;++i)
+		nonce[i]=static_cast<std::byte>(i*13+5);
+	std::span<std::byte const,32> const k(key);
+	std::span<std::byte const,12> const n(nonce,12);
+	test_decorators(fast_io::aes_ctr_deco_t<32>(k,nonce),fast_io::aes_ctr_deco_t<32>(k,nonce),false);
+	test_decorators(fast_io::aes_gcm_encrypt_deco_t<32>(k,n),fast_io::aes_gcm_decrypt_deco_t<32>(k,n),true);
+	return report();
+}
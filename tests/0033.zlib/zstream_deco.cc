@@ -0,0 +1,180 @@
+//link with -lz
+#include<fast_io.h>
+#include<fast_io_device.h>
+#include<fast_io_driver/zlib_driver.h>
+#include<random>
+#include<string>
+#include<vector>
+#include<unistd.h>
+#include"../check.h"
+
+using namespace fast_io::io;
+using namespace fast_io_test;
+
+using zstream_format = fast_io::zlib::zstream_format;
+
+/*
+Logs compress well, random bytes do not, long runs of zeros expand to far more than one input buffer: all three
+must survive the round trip.
+*/
+inline std::vector<char> make_text(std::size_t size,std::mt19937_64& eng)
+{
+	std::vector<char> text;
+	text.reserve(size);
+	while(text.size()<size)
+	{
+		switch(eng()%3)
+		{
+		case 0:
+		{
+			std::string const line{"[info] request "+std::to_string(eng()%1000)+" served in "+std::to_string(eng()%100)+"ms\n"};
+			text.insert(text.end(),line.begin(),line.end());
+			break;
+		}
+		case 1:
+			for(std::size_t i{eng()%5000};i--;)
+				text.push_back(static_cast<char>(eng()));
+			break;
+		default:
+			text.insert(text.end(),eng()%3000000,'\0');
+		}
+	}
+	text.resize(size);
+	return text;
+}
+
+template<std::size_t bfs>
+inline void write_compressed(fast_io::native_io_observer out,std::vector<char> const& text,fast_io::zlib::deflate_deco_t deco,std::mt19937_64& eng)
+{
+	using decorators = fast_io::basic_decorators<char,fast_io::empty_decorator,fast_io::zlib::deflate_deco_t>;
+	fast_io::basic_io_buffer<fast_io::native_io_observer,fast_io::buffer_mode::out|fast_io::buffer_mode::construct_decorator,decorators,bfs>
+		obf(decorators{{},::std::move(deco)},out);
+	for(std::size_t i{};i!=text.size();)
+	{
+		std::size_t len{eng()%3==0?static_cast<std::size_t>(eng()%1000000u):static_cast<std::size_t>(eng()%100u)};
+		if(text.size()-i<len)
+			len=text.size()-i;
+		write(obf,text.data()+i,text.data()+i+len);
+		i+=len;
+		if(eng()%50==0)
+			flush(obf);
+	}
+}
+
+template<std::size_t bfs>
+inline std::vector<char> read_decompressed(fast_io::native_io_observer in,zstream_format format,std::size_t expected,std::mt19937_64& eng)
+{
+	seek(in,0,fast_io::seekdir::beg);
+	using decorators = fast_io::basic_decorators<char,fast_io::zlib::inflate_deco_t>;
+	fast_io::basic_io_buffer<fast_io::native_io_observer,fast_io::buffer_mode::in|fast_io::buffer_mode::construct_decorator,decorators,bfs>
+		ibf(decorators{fast_io::zlib::inflate_deco_t(format),{}},in);
+	std::vector<char> back(expected+100);
+	char* p{back.data()};
+	for(;;)
+	{
+		std::size_t const len{eng()%2?1+static_cast<std::size_t>(eng()%64u):1+static_cast<std::size_t>(eng()%1000000u)};
+		std::size_t const room{static_cast<std::size_t>(back.data()+back.size()-p)};
+		char* q{read(ibf,p,p+(len<room?len:room))};
+		if(q==p)
+			break;
+		p=q;
+	}
+	back.resize(static_cast<std::size_t>(p-back.data()));
+	return back;
+}
+
+/*
+The gzip output must be an ordinary multi-member gzip file.
+*/
+inline std::vector<char> gunzip(fast_io::native_io_observer in,std::size_t expected)
+{
+	seek(in,0,fast_io::seekdir::beg);
+	gzFile gz{gzdopen(::dup(in.fd),"rb")};
+	std::vector<char> back(expected+100);
+	std::size_t size{};
+	for(int r;(r=gzread(gz,back.data()+size,static_cast<unsigned>(back.size()-size)))>0;)
+		size+=static_cast<std::size_t>(r);
+	gzclose(gz);
+	back.resize(size);
+	return back;
+}
+
+template<std::size_t out_bfs,std::size_t in_bfs>
+inline void test_round_trip(zstream_format format,std::size_t threads,std::size_t block_size,std::size_t size)
+{
+	std::mt19937_64 eng(size+threads);
+	auto const text{make_text(size,eng)};
+	fast_io::native_file file(fast_io::io_temp);
+	write_compressed<out_bfs>(file,text,fast_io::zlib::deflate_deco_t(format,6,threads,block_size),eng);
+	check(read_decompressed<in_bfs>(file,format,text.size(),eng)==text,"round trip");
+	if(format==zstream_format::gzip)
+		check(gunzip(file,text.size())==text,"gunzip reads the gzip stream");
+}
+
+inline void test_corrupt()
+{
+	std::mt19937_64 eng;
+	auto const text{make_text(300000,eng)};
+	fast_io::native_file file(fast_io::io_temp);
+	write_compressed<131072>(file,text,fast_io::zlib::deflate_deco_t(),eng);
+	std::vector<char> compressed(600000);
+	seek(file,0,fast_io::seekdir::beg);
+	compressed.resize(static_cast<std::size_t>(read(file,compressed.data(),compressed.data()+compressed.size())-compressed.data()));
+	compressed[compressed.size()/2]^=0x55;
+	fast_io::native_file corrupt(fast_io::io_temp);
+	write(corrupt,compressed.data(),compressed.data()+compressed.size());
+	bool thrown{};
+	try
+	{
+		read_decompressed<4096>(corrupt,zstream_format::gzip,text.size(),eng);
+	}
+	catch(fast_io::error const&)
+	{
+		thrown=true;
+	}
+	check(thrown,"corruption is detected");
+}
+
+/*
+A stream cut inside a member must raise at end of file, wherever the cut falls; one cut between members is only
+shorter.
+*/
+inline void test_truncated()
+{
+	std::mt19937_64 eng(7);
+	auto const text{make_text(300000,eng)};
+	fast_io::native_file file(fast_io::io_temp);
+	write_compressed<131072>(file,text,fast_io::zlib::deflate_deco_t(zstream_format::gzip,6,1,65536),eng);
+	std::vector<char> compressed(600000);
+	seek(file,0,fast_io::seekdir::beg);
+	compressed.resize(static_cast<std::size_t>(read(file,compressed.data(),compressed.data()+compressed.size())-compressed.data()));
+	for(std::size_t const cut:{static_cast<std::size_t>(1),static_cast<std::size_t>(10),compressed.size()/3,compressed.size()-8,compressed.size()-1})
+	{
+		fast_io::native_file truncated(fast_io::io_temp);
+		write(truncated,compressed.data(),compressed.data()+cut);
+		bool thrown{};
+		try
+		{
+			read_decompressed<4096>(truncated,zstream_format::gzip,text.size(),eng);
+		}
+		catch(fast_io::error const&)
+		{
+			thrown=true;
+		}
+		check(thrown,"truncation is detected");
+	}
+	fast_io::native_file empty(fast_io::io_temp);
+	check(read_decompressed<4096>(empty,zstream_format::gzip,0,eng).empty(),"an empty stream is empty");
+}
+
+int main()
+{
+	test_round_trip<131072,131072>(zstream_format::gzip,1,fast_io::zlib::deflate_default_block_size,20000000);
+	test_round_trip<131072,1000>(zstream_format::zlib,1,fast_io::zlib::deflate_default_block_size,5000000);
+	test_round_trip<65536,65536>(zstream_format::deflate,1,10000,5000000);
+	test_round_trip<4194304,131072>(zstream_format::gzip,4,131072,30000000);
+	test_round_trip<4194304,131072>(zstream_format::gzip,0,100000,30000000);
+	test_corrupt();
+	test_truncated();
+	return report();
+}
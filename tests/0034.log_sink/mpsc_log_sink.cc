@@ -0,0 +1,132 @@
+//also build with -fsanitize=thread: several producers share one sink
+#include<string>
+#include<string_view>
+#include<vector>
+#include<thread>
+#include<fast_io.h>
+#include<fast_io_device.h>
+#include"../check.h"
+
+using namespace fast_io::io;
+using namespace fast_io_test;
+
+inline std::string read_back(fast_io::native_file& file)
+{
+	seek(file,0,fast_io::seekdir::beg);
+	std::string text;
+	char buffer[65536];
+	for(char* p;(p=read(file,buffer,buffer+sizeof(buffer)))!=buffer;)
+		text.append(buffer,p);
+	return text;
+}
+
+/*
+Every thread prints "thread index payload" lines with consecutive indices; every long_every-th line carries a payload
+too large for the ring so it takes the heap path. The output must hold each line exactly once, whole, and in
+per-thread order.
+*/
+template<std::size_t ring_size>
+inline void test_threads(std::size_t threads,std::size_t lines,std::size_t long_every)
+{
+	fast_io::native_file file(fast_io::io_temp);
+	std::string const long_payload(ring_size/4,'L');
+	std::string_view const short_payload{"x"};
+	{
+		fast_io::basic_mpsc_log_sink<fast_io::native_io_observer,ring_size> sink{fast_io::native_io_observer{file.fd}};
+		std::vector<std::thread> workers;
+		for(std::size_t t{};t!=threads;++t)
+			workers.emplace_back([&,t]
+			{
+				for(std::size_t i{};i!=lines;++i)
+				{
+					if(long_every&&i%long_every==0)
+						println(sink,t," ",i," ",long_payload);
+					else
+						println(sink,t," ",i," ",short_payload);
+				}
+			});
+		for(auto& w : workers)
+			w.join();
+	}
+	auto const text{read_back(file)};
+	std::vector<std::size_t> next(threads);
+	std::size_t total{},torn{},out_of_order{};
+	for(std::size_t pos{};pos!=text.size();)
+	{
+		std::size_t const eol{text.find('\n',pos)};
+		if(eol==std::string::npos)
+		{
+			++torn;
+			break;
+		}
+		std::string_view line(text.data()+pos,eol-pos);
+		pos=eol+1;
+		std::size_t t{},i{};
+		std::string_view payload;
+		try
+		{
+			std::size_t const sp1{line.find(' ')},sp2{line.find(' ',sp1+1)};
+			t=std::stoul(std::string(line.substr(0,sp1)));
+			i=std::stoul(std::string(line.substr(sp1+1,sp2-sp1-1)));
+			payload=line.substr(sp2+1);
+		}
+		catch(...)
+		{
+			++torn;
+			continue;
+		}
+		if(threads<=t||(payload!=short_payload&&payload!=long_payload))
+		{
+			++torn;
+			continue;
+		}
+		out_of_order+=next[t]!=i;
+		next[t]=i+1;
+		++total;
+	}
+	check(torn==0,"records are whole");
+	check(out_of_order==0,"per-thread order");
+	check(total==threads*lines,"every record written");
+}
+
+inline void test_flush_and_write()
+{
+	fast_io::native_file file(fast_io::io_temp);
+	fast_io::basic_mpsc_log_sink<fast_io::native_io_observer> sink{fast_io::native_io_observer{file.fd}};
+	constexpr std::string_view raw{"raw bytes\n"};
+	write(sink,raw.data(),raw.data()+raw.size());
+	println(sink,"line ",1);
+	flush(sink);
+	check(read_back(file)=="raw bytes\nline 1\n","flush waits for earlier records");
+	print(sink,"");
+	flush(sink);
+	check(read_back(file)=="raw bytes\nline 1\n","empty record");
+}
+
+inline void test_error()
+{
+	fast_io::native_file file(fast_io::io_temp);
+	fast_io::native_file readonly(u8"/dev/null",fast_io::open_mode::in);
+	fast_io::basic_mpsc_log_sink<fast_io::native_io_observer> sink{fast_io::native_io_observer{readonly.fd}};
+	println(sink,"cannot be written");
+	bool thrown{};
+	try
+	{
+		flush(sink);
+	}
+	catch(fast_io::error const& e)
+	{
+		thrown=e.domain==fast_io::posix_domain_value;
+	}
+	check(thrown,"writer error reaches flush");
+}
+
+int main()
+{
+	test_threads<4096>(64,2000,0);
+	test_threads<4096>(16,2000,97);
+	test_threads<fast_io::mpsc_log_sink_default_ring_size>(64,20000,1001);
+	test_flush_and_write();
+	test_error();
+	return report();
+}
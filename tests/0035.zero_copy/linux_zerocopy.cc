@@ -0,0 +1,189 @@
+#include<string>
+#include<string_view>
+#include<thread>
+#include<random>
+#include<fast_io.h>
+#include<fast_io_device.h>
+#include<sys/socket.h>
+#include"../check.h"
+
+using namespace fast_io::io;
+using namespace fast_io_test;
+
+inline std::string make_payload(std::size_t n,std::uint_least64_t seed)
+{
+	std::mt19937_64 eng(seed);
+	std::string s(n,'\0');
+	for(auto& ch:s)
+		ch=static_cast<char>(eng());
+	return s;
+}
+
+inline std::string read_all_from(fast_io::posix_io_observer piob)
+{
+	std::string s;
+	char buffer[65536];
+	for(char* it;(it=read(piob,buffer,buffer+sizeof(buffer)))!=buffer;)
+		s.append(buffer,it);
+	return s;
+}
+
+inline std::string file_contents(fast_io::posix_io_observer piob)
+{
+	seek(piob,0,fast_io::seekdir::beg);
+	return read_all_from(piob);
+}
+
+inline fast_io::posix_file temp_with(std::string_view payload)
+{
+	fast_io::posix_file file(fast_io::io_temp);
+	write(file,payload.data(),payload.data()+payload.size());
+	seek(file,0,fast_io::seekdir::beg);
+	return file;
+}
+
+/*
+regular -> regular goes through copy_file_range.
+*/
+inline void test_file_to_file(std::string const& payload)
+{
+	auto src{temp_with(payload)};
+	fast_io::posix_file dst(fast_io::io_temp);
+	check(transmit(dst,src)==payload.size(),"file to file count");
+	check(file_contents(dst)==payload,"file to file contents");
+	seek(src,4097,fast_io::seekdir::beg);
+	fast_io::posix_file part(fast_io::io_temp);
+	check(transmit64(part,src,100000)==100000,"bounded file to file count");
+	check(file_contents(part)==std::string_view(payload).substr(4097,100000),"bounded file to file contents");
+}
+
+/*
+A pipe on either side goes through splice; the other end runs on a thread so payloads larger than the pipe
+capacity do not block.
+*/
+inline void test_file_to_pipe(std::string const& payload)
+{
+	auto src{temp_with(payload)};
+	fast_io::posix_pipe pipe;
+	std::string received;
+	std::jthread reader([&]{received=read_all_from(pipe.in());});
+	check(transmit(pipe.out(),src)==payload.size(),"file to pipe count");
+	pipe.out().close();
+	reader.join();
+	check(received==payload,"file to pipe contents");
+}
+
+inline void test_pipe_to_file(std::string const& payload)
+{
+	fast_io::posix_pipe pipe;
+	std::jthread writer([&]
+	{
+		write(pipe.out(),payload.data(),payload.data()+payload.size());
+		pipe.out().close();
+	});
+	fast_io::posix_file dst(fast_io::io_temp);
+	check(transmit(dst,pipe.in())==payload.size(),"pipe to file count");
+	writer.join();
+	check(file_contents(dst)==payload,"pipe to file contents");
+}
+
+/*
+Neither side is a pipe nor a regular input, so the bytes go through the internal splice pipe.
+*/
+inline void test_socket_to_file(std::string const& payload)
+{
+	int fds[2];
+	if(::socketpair(AF_UNIX,SOCK_STREAM,0,fds)!=0)
+	{
+		check(false,"socketpair");
+		return;
+	}
+	fast_io::posix_file in_end(fds[0]);
+	std::jthread writer([&]
+	{
+		write(fast_io::posix_io_observer{fds[1]},payload.data(),payload.data()+payload.size());
+		::close(fds[1]);
+	});
+	fast_io::posix_file dst(fast_io::io_temp);
+	check(transmit(dst,in_end)==payload.size(),"socket to file count");
+	writer.join();
+	check(file_contents(dst)==payload,"socket to file contents");
+}
+
+/*
+copy_file_range rejects O_APPEND outputs with EBADF, sendfile and splice reject them with EINVAL; transmit must
+still deliver everything through the next strategy down.
+*/
+inline void test_fallback(std::string const& payload)
+{
+	constexpr char8_t name[]{u8"zerocopy_append.txt"};
+	{
+		fast_io::posix_file dst(name,fast_io::open_mode::out|fast_io::open_mode::trunc);
+	}
+	fast_io::posix_file append(name,fast_io::open_mode::out|fast_io::open_mode::app);
+	{
+		auto src{temp_with(payload)};
+		auto const res{fast_io::details::linux_copy_file_range_transmit_impl(append.fd,src.fd,payload.size())};
+		check(!res.finished&&res.transmitted==0,"copy_file_range refuses an O_APPEND output");
+		auto const sres{fast_io::details::linux_sendfile_transmit_impl(append.fd,src.fd,payload.size())};
+		check(!sres.finished&&sres.transmitted==0,"sendfile refuses an O_APPEND output");
+		check(transmit(append,src)==payload.size(),"file to O_APPEND file count");
+	}
+	{
+		fast_io::posix_pipe pipe;
+		std::jthread writer([&]
+		{
+			write(pipe.out(),payload.data(),payload.data()+payload.size());
+			pipe.out().close();
+		});
+		auto const res{fast_io::details::linux_splice_transmit_impl(append.fd,pipe.in().fd,payload.size())};
+		check(!res.finished&&res.transmitted==0,"splice refuses an O_APPEND output");
+		check(transmit(append,pipe.in())==payload.size(),"pipe to O_APPEND file count");
+	}
+	fast_io::posix_file reader(name,fast_io::open_mode::in);
+	check(read_all_from(reader)==payload+payload,"fallback contents");
+	fast_io::native_unlinkat(fast_io::at_fdcwd(),name);
+}
+
+/*
+procfs files report a size of 0, so copy_file_range copies nothing on the first call; transmit must fall back to a
+strategy that reads the file instead of reporting an empty transfer.
+*/
+inline void test_procfs()
+{
+	fast_io::posix_file src(u8"/proc/self/status",fast_io::open_mode::in);
+	{
+		fast_io::posix_file probe(fast_io::io_temp);
+		auto const res{fast_io::details::linux_copy_file_range_transmit_impl(probe.fd,src.fd,65536)};
+		check(!res.finished||res.transmitted!=0,"copy_file_range does not report an empty procfs file as finished");
+		seek(src,0,fast_io::seekdir::beg);
+	}
+	fast_io::posix_file dst(fast_io::io_temp);
+	auto const n{transmit(dst,src)};
+	check(n!=0,"procfs to file count");
+	auto const contents{file_contents(dst)};
+	check(contents.size()==n&&contents.starts_with("Name:"),"procfs to file contents");
+}
+
+inline void test_vmsplice(std::string const& payload)
+{
+	fast_io::posix_pipe pipe;
+	std::string_view const chunk{std::string_view(payload).substr(0,4096)};
+	auto it{fast_io::vmsplice_write(pipe,chunk.data(),chunk.data()+chunk.size())};
+	pipe.out().close();
+	check(read_all_from(pipe.in())==chunk.substr(0,static_cast<std::size_t>(it-chunk.data())),"vmsplice contents");
+	check(it==chunk.data()+chunk.size(),"vmsplice takes a page at once");
+}
+
+int main()
+{
+	auto const payload{make_payload(3u<<20u,1)};
+	test_file_to_file(payload);
+	test_file_to_pipe(payload);
+	test_pipe_to_file(payload);
+	test_socket_to_file(payload);
+	test_fallback(payload);
+	test_procfs();
+	test_vmsplice(payload);
+	return report();
+}
@@ -0,0 +1,144 @@
+#include<string>
+#include<string_view>
+#include<thread>
+#include<vector>
+#include<random>
+#include<fast_io.h>
+#include<fast_io_device.h>
+#include"../check.h"
+
+using namespace fast_io::io;
+using namespace fast_io_test;
+
+inline std::string make_payload(std::size_t n,std::uint_least64_t seed)
+{
+	std::mt19937_64 eng(seed);
+	std::string s(n,'\0');
+	for(auto& ch:s)
+		ch=static_cast<char>(eng());
+	return s;
+}
+
+inline std::string read_all_from(fast_io::posix_io_observer piob)
+{
+	std::string s;
+	char buffer[65536];
+	for(char* it;(it=read(piob,buffer,buffer+sizeof(buffer)))!=buffer;)
+		s.append(buffer,it);
+	return s;
+}
+
+inline std::string file_contents(fast_io::posix_io_observer piob)
+{
+	seek(piob,0,fast_io::seekdir::beg);
+	return read_all_from(piob);
+}
+
+inline constexpr std::uintmax_t source_position{12345};
+
+inline fast_io::posix_file make_source(std::string_view payload)
+{
+	fast_io::posix_file file(fast_io::io_temp);
+	write(file,payload.data(),payload.data()+payload.size());
+	seek(file,static_cast<std::intmax_t>(source_position),fast_io::seekdir::beg);
+	return file;
+}
+
+inline bool source_untouched(fast_io::posix_io_observer src)
+{
+	return seek(src,0,fast_io::seekdir::cur)==source_position;
+}
+
+inline void test_ranges(std::string const& payload)
+{
+	auto src{make_source(payload)};
+	fast_io::posix_file dst(fast_io::io_temp);
+	check(random_access_transmit64(dst,src,5000,100000)==100000,"range count");
+	check(file_contents(dst)==std::string_view(payload).substr(5000,100000),"range contents");
+	check(source_untouched(src),"source offset unchanged");
+
+	fast_io::posix_file tail(fast_io::io_temp);
+	check(random_access_transmit(tail,payload.size()-777,src)==777,"unbounded range stops at end of file");
+	check(file_contents(tail)==std::string_view(payload).substr(payload.size()-777),"tail contents");
+	check(random_access_transmit(tail,payload.size()+10,src,std::size_t{10})==0,"range past end of file");
+	check(source_untouched(src),"source offset unchanged after tail");
+}
+
+/*
+Threads serving disjoint ranges of one shared descriptor.
+*/
+inline void test_concurrent(std::string const& payload)
+{
+	auto src{make_source(payload)};
+	constexpr std::size_t threads{4};
+	std::size_t const part{payload.size()/threads};
+	std::vector<fast_io::posix_file> outputs;
+	for(std::size_t i{};i!=threads;++i)
+		outputs.emplace_back(fast_io::io_temp);
+	{
+		std::vector<std::jthread> workers;
+		for(std::size_t i{};i!=threads;++i)
+			workers.emplace_back([&,i]{random_access_transmit64(outputs[i],src,i*part,part);});
+	}
+	std::string joined;
+	for(auto& out:outputs)
+		joined.append(file_contents(out));
+	check(joined==std::string_view(payload).substr(0,threads*part),"concurrent ranges");
+	check(source_untouched(src),"source offset unchanged after concurrent ranges");
+}
+
+/*
+A pipe output skips copy_file_range and goes through sendfile; an O_APPEND output is refused by both and falls
+back to pread + write.
+*/
+inline void test_strategies(std::string const& payload)
+{
+	auto src{make_source(payload)};
+	{
+		fast_io::posix_pipe pipe;
+		std::string received;
+		std::jthread reader([&]{received=read_all_from(pipe.in());});
+		check(fast_io::details::linux_zero_copy_pread_transmit_impl(pipe.out().fd,src.fd,3,1u<<20u)==1u<<20u,"sendfile count");
+		pipe.out().close();
+		reader.join();
+		check(received==std::string_view(payload).substr(3,1u<<20u),"sendfile contents");
+	}
+	constexpr char8_t name[]{u8"random_access_append.txt"};
+	{
+		fast_io::posix_file append(name,fast_io::open_mode::out|fast_io::open_mode::trunc|fast_io::open_mode::app);
+		check(fast_io::details::linux_zero_copy_pread_transmit_impl(append.fd,src.fd,99,200000)==200000,"pread fallback count");
+	}
+	fast_io::posix_file reader(name,fast_io::open_mode::in);
+	check(read_all_from(reader)==std::string_view(payload).substr(99,200000),"pread fallback contents");
+	fast_io::native_unlinkat(fast_io::at_fdcwd(),name);
+	check(source_untouched(src),"source offset unchanged by every strategy");
+}
+
+/*
+procfs files report a size of 0; a first empty copy_file_range must hand over to the next strategy.
+*/
+inline void test_procfs()
+{
+	fast_io::posix_file src(u8"/proc/self/status",fast_io::open_mode::in);
+	{
+		fast_io::posix_file probe(fast_io::io_temp);
+		std::uint_least64_t offset{};
+		auto const res{fast_io::details::linux_copy_file_range_pread_transmit_impl(probe.fd,src.fd,offset,65536)};
+		check(!res.finished||res.transmitted!=0,"copy_file_range does not report an empty procfs file as finished");
+	}
+	fast_io::posix_file dst(fast_io::io_temp);
+	auto const n{random_access_transmit(dst,0,src)};
+	check(n!=0,"procfs range count");
+	auto const contents{file_contents(dst)};
+	check(contents.size()==n&&contents.starts_with("Name:"),"procfs range contents");
+}
+
+int main()
+{
+	auto const payload{make_payload((2u<<20u)+333u,2)};
+	test_ranges(payload);
+	test_concurrent(payload);
+	test_strategies(payload);
+	test_procfs();
+	return report();
+}
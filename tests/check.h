@@ -0,0 +1,33 @@
+#pragma once
+/*
+Shared by the self-checking tests; build them with -fsanitize=address -fsanitize=undefined to verify the code under
+test. check() reports and counts a failed condition on stderr and may be called from any thread, report() prints the
+count and returns the exit status of main.
+*/
+#include<atomic>
+#include<cstddef>
+#include<string_view>
+#include<fast_io.h>
+
+namespace fast_io_test
+{
+
+inline ::std::atomic<::std::size_t> failed{};
+
+inline void check(bool ok,::std::string_view what)
+{
+	if(!ok)
+	{
+		failed.fetch_add(1,::std::memory_order_relaxed);
+		::fast_io::io::perrln("failed: ",what);
+	}
+}
+
+inline int report()
+{
+	::std::size_t const n{failed.load()};
+	::fast_io::io::println("failed:",n);
+	return n!=0;
+}
+
+}